@@ -292,6 +292,12 @@ struct Settings {
   LogMessageCallback log_message_callback;
   bool enable_software_rendering = false;
   bool skia_deterministic_rendering_on_cpu = false;
+  // Whether the rasterizer may draw the layer trees of several views on
+  // worker threads when the surface supports it, which only the software
+  // surface does. Views drawn this way do not use the raster cache or partial
+  // repaint, and each of them is drawn into a raster surface of its own that
+  // is allocated every frame and then copied into the frame of the view.
+  bool enable_concurrent_view_rasterization = true;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
 
@@ -330,6 +336,11 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // Max bytes of decoded images that the image decoder keeps to skip decoding
+  // the same encoded image at the same size again, or 0 to disable the cache.
+  // The cache is emptied on low memory warnings.
+  size_t decoded_image_cache_max_bytes = 16 << 20;
+
   /// The minimum number of samples to require in multipsampled anti-aliasing.
   ///
   /// Setting this value to 0 or 1 disables MSAA.
@@ -6,7 +6,9 @@
 #include "flutter/display_list/dl_builder.h"
 #include "flutter/display_list/dl_op_flags.h"
 #include "flutter/display_list/skia/dl_sk_canvas.h"
+#include "flutter/display_list/skia/dl_sk_tiled_dispatcher.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
 
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -1339,8 +1341,60 @@ void BM_SaveLayer(benchmark::State& state,
   surface_provider->Snapshot(filename);
 }
 
+// Draws a large "data table" of rows of cells, each with a background rect,
+// a border and a text-like run of lines, and rasterizes it in software with a
+// |DlSkTiledDispatcher| that splits the work across |state.range(0)| workers.
+//
+// A worker count of 1 dispatches the whole DisplayList on the calling thread
+// and serves as the baseline for the scaling of the other runs.
+void BM_DrawDisplayListTiled(benchmark::State& state) {
+  const size_t worker_count = state.range(0);
+  const int width = kFixedCanvasSize;
+  const int height = kFixedCanvasSize * 2;
+  const int row_height = 8;
+  const int cell_width = 64;
+
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  DlPaint fill_paint = GetPaintForRun(kFilledStyle | kAntiAliasing);
+  DlPaint stroke_paint = GetPaintForRun(kStrokedStyle | kAntiAliasing);
+  for (int y = 0; y < height; y += row_height) {
+    for (int x = 0; x < width; x += cell_width) {
+      SkRect cell = SkRect::MakeXYWH(x, y, cell_width, row_height);
+      fill_paint.setColor(((x + y) / row_height) % 2 ? DlColor::kLightGrey()
+                                                     : DlColor::kWhite());
+      builder.DrawRect(cell, fill_paint);
+      builder.DrawRect(cell.makeInset(0.5f, 0.5f), stroke_paint);
+      for (int i = 0; i < 4; i++) {
+        SkScalar text_x = x + 4 + i * 14;
+        builder.DrawLine(SkPoint::Make(text_x, y + row_height * 0.5f),
+                         SkPoint::Make(text_x + 10, y + row_height * 0.5f),
+                         stroke_paint);
+      }
+    }
+  }
+  auto display_list = builder.Build();
+  state.counters["DrawCallCount"] = display_list->op_count();
+
+  auto surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(width, height));
+  auto loop = fml::ConcurrentMessageLoop::Create(worker_count);
+  DlSkTiledDispatcher dispatcher(loop->GetTaskRunner(), worker_count);
+  SkIRect cull_rect = SkIRect::MakeWH(width, height);
+  state.counters["TileCount"] =
+      display_list->ComputeDispatchTiles(cull_rect, worker_count).size();
+
+  for ([[maybe_unused]] auto _ : state) {
+    dispatcher.DrawDisplayList(surface->getCanvas(), display_list, cull_rect);
+  }
+}
+
 #ifdef ENABLE_SOFTWARE_BENCHMARKS
 RUN_DISPLAYLIST_BENCHMARKS(Software)
+
+BENCHMARK(BM_DrawDisplayListTiled)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
 #endif
 
 #ifdef ENABLE_OPENGL_BENCHMARKS
@@ -2,8 +2,36 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/dl_builder_pool.h"
+#include "flutter/display_list/dl_op_records.h"
+#include "flutter/display_list/dl_serialization.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
+
+// Counts the calls to the global operator new so that the benchmarks can
+// report the number of heap allocations made while recording.
+static std::atomic<size_t> g_operator_new_count{0};
+
+void* operator new(size_t size) {
+  g_operator_new_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
 
 namespace flutter {
 
@@ -11,6 +39,11 @@ DlOpReceiver& DisplayListBuilderBenchmarkAccessor(DisplayListBuilder& builder) {
   return builder.asReceiver();
 }
 
+const DisplayListStorage& DisplayListStorageBenchmarkAccessor(
+    const DisplayList& display_list) {
+  return display_list.storage_;
+}
+
 namespace {
 
 static std::vector<testing::DisplayListInvocationGroup> allRenderingOps =
@@ -149,6 +182,431 @@ static void BM_DisplayListBuilderWithSaveLayerAndImageFilter(
   }
 }
 
+// The number of pictures recorded per simulated frame, similar to what a
+// typical app records through PictureRecorder in a frame.
+static constexpr int kPicturesPerFrame = 20;
+
+// Records |kPicturesPerFrame| pictures of |state.range(0)| rects each, in
+// nested save/clip groups of 8 rects, with builders that are either created
+// for every picture or acquired from a |DisplayListBuilderPool| and recycled
+// once built, and reports the operator new allocations made per frame. The
+// blocks of the op storage are allocated with calloc and are measured
+// separately by the DisplayListStorage benchmarks below.
+static void BM_DisplayListBuilderFrame(benchmark::State& state, bool pooled) {
+  const int rect_count = state.range(0);
+  DisplayListBuilderPool pool;
+  DlPaint paint;
+  SkRect cull_rect = SkRect::MakeWH(1000, 1000);
+  size_t allocations = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    size_t start_count = g_operator_new_count.load();
+    for (int picture = 0; picture < kPicturesPerFrame; picture++) {
+      sk_sp<DisplayListBuilder> builder =
+          pooled ? pool.Acquire(cull_rect, /*prepare_rtree=*/true)
+                 : sk_make_sp<DisplayListBuilder>(cull_rect,
+                                                  /*prepare_rtree=*/true);
+      for (int i = 0; i < rect_count; i++) {
+        if (i % 8 == 0) {
+          builder->Save();
+          builder->ClipRect(SkRect::MakeXYWH(i, i, 100, 100));
+        }
+        builder->DrawRect(SkRect::MakeXYWH(i, i, 20, 20), paint);
+        if (i % 8 == 7) {
+          builder->Restore();
+        }
+      }
+      auto display_list = builder->Build();
+      benchmark::DoNotOptimize(display_list);
+      if (pooled) {
+        pool.Recycle(std::move(builder));
+      }
+    }
+    allocations += g_operator_new_count.load() - start_count;
+  }
+  state.counters["AllocationsPerFrame"] =
+      static_cast<double>(allocations) / state.iterations();
+}
+
+// A receiver that ignores every op so that the dispatch benchmarks below
+// only measure the cost of producing the ops.
+class NopReceiver final : public IgnoreAttributeDispatchHelper,
+                          public IgnoreClipDispatchHelper,
+                          public IgnoreTransformDispatchHelper,
+                          public IgnoreDrawDispatchHelper {};
+
+// Records a chart with |bar_count| bars, each with a gradient, an outline
+// path, a clip and a label rect, which is the kind of static content that
+// an application would cache between runs. The label of the
+// |highlighted_bar|, if any, is drawn in white.
+static void RecordChart(DisplayListBuilder& builder,
+                        int bar_count,
+                        int highlighted_bar = -1) {
+  SkPath outline;
+  outline.moveTo(0, 0);
+  outline.lineTo(10, 0);
+  outline.quadTo(12, 20, 10, 40);
+  outline.lineTo(0, 40);
+  outline.close();
+  DlPaint fill;
+  DlPaint stroke;
+  stroke.setDrawStyle(DlDrawStyle::kStroke);
+  stroke.setStrokeWidth(2);
+  for (int i = 0; i < bar_count; i++) {
+    SkScalar x = (i % 100) * 12;
+    SkScalar y = (i / 100) * 50;
+    builder.Save();
+    builder.Translate(x, y);
+    builder.ClipRect(SkRect::MakeWH(12, 48));
+    fill.setColorSource(i % 2 == 0 ? kTestSource2 : kTestSource3);
+    builder.DrawRect(SkRect::MakeWH(10, 40), fill);
+    builder.DrawPath(outline, stroke);
+    fill.setColorSource(nullptr);
+    fill.setColor(i == highlighted_bar
+                      ? DlColor::kWhite()
+                      : DlColor(0xFF000000 | (i * 2654435761u >> 8)));
+    builder.DrawRect(SkRect::MakeXYWH(0, 42, 10, 4), fill);
+    builder.Restore();
+  }
+}
+
+// Produces the ops of a chart of |state.range(0)| bars by recording it
+// again, as an application does when it has no cached copy.
+static void BM_DisplayListRecordAndDispatch(benchmark::State& state) {
+  const int bar_count = state.range(0);
+  NopReceiver receiver;
+  for ([[maybe_unused]] auto _ : state) {
+    DisplayListBuilder builder;
+    RecordChart(builder, bar_count);
+    auto display_list = builder.Build();
+    display_list->Dispatch(receiver);
+  }
+  state.SetItemsProcessed(state.iterations() * bar_count);
+}
+
+// Produces the same ops by loading a serialized copy of the chart and
+// dispatching them directly from its memory.
+static void BM_SerializedDisplayListLoadAndDispatch(benchmark::State& state) {
+  const int bar_count = state.range(0);
+  DisplayListBuilder builder;
+  RecordChart(builder, bar_count);
+  std::shared_ptr<const fml::Mapping> mapping =
+      SerializedDisplayList::Serialize(
+          *builder.Build(),
+          [](const DlImage& image) { return std::optional<uint64_t>(); });
+  auto resolver = [](uint64_t hash) { return sk_sp<DlImage>(); };
+  NopReceiver receiver;
+  for ([[maybe_unused]] auto _ : state) {
+    auto serialized = SerializedDisplayList::Load(mapping, resolver);
+    serialized->Dispatch(receiver);
+  }
+  state.SetItemsProcessed(state.iterations() * bar_count);
+  state.counters["SerializedBytes"] = mapping->GetSize();
+}
+
+// Computes the damage between two frames of a chart that only differ in
+// the label of one of its bars, which is the cost that a changed picture
+// adds to the diff of the layer tree. The fraction of the bounds of the
+// chart that is damaged is the part of the repaint that it saves.
+static void BM_DisplayListComputeDamage(benchmark::State& state) {
+  const int bar_count = state.range(0);
+  DisplayListBuilder old_builder(/*prepare_rtree=*/true);
+  RecordChart(old_builder, bar_count, bar_count / 2);
+  auto old_display_list = old_builder.Build();
+  DisplayListBuilder new_builder(/*prepare_rtree=*/true);
+  RecordChart(new_builder, bar_count, bar_count / 2 + 1);
+  auto new_display_list = new_builder.Build();
+
+  std::vector<SkRect> damage;
+  for ([[maybe_unused]] auto _ : state) {
+    damage.clear();
+    new_display_list->ComputeDamage(*old_display_list, damage);
+  }
+  SkRect bounds = new_display_list->bounds();
+  double damaged_area = 0;
+  for (const SkRect& rect : damage) {
+    damaged_area += rect.width() * rect.height();
+  }
+  state.SetItemsProcessed(state.iterations() * new_display_list->op_count());
+  state.counters["DamageRects"] = damage.size();
+  state.counters["DamagedAreaFraction"] =
+      damaged_area / (bounds.width() * bounds.height());
+}
+
+// The bounds of |count| ops laid out in rows from top to bottom, the way
+// that the content of a scrolling page is recorded.
+static std::vector<SkRect> MakePageRects(int count) {
+  std::vector<SkRect> rects;
+  rects.reserve(count);
+  for (int i = 0; i < count; i++) {
+    SkScalar x = (i % 64) * 16 + (i % 3);
+    SkScalar y = (i / 64) * 12;
+    rects.push_back(SkRect::MakeXYWH(x, y, 20 + (i % 7) * 4, 14));
+  }
+  return rects;
+}
+
+// Builds an R-Tree from all of the bounds at once, which is the work that
+// DisplayListBuilder::Build used to do at the end of a recording.
+static void BM_DlRTreeConstruct(benchmark::State& state) {
+  const int count = state.range(0);
+  std::vector<SkRect> rects = MakePageRects(count);
+  std::vector<int> ids(count);
+  for (int i = 0; i < count; i++) {
+    ids[i] = i;
+  }
+  for ([[maybe_unused]] auto _ : state) {
+    auto rtree = sk_make_sp<DlRTree>(rects.data(), count, ids.data());
+    benchmark::DoNotOptimize(rtree);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Adds the bounds one at a time as they would be recorded and then builds
+// the R-Tree, which is the total work of building it incrementally.
+static void BM_DlRTreeBuilderAddAndBuild(benchmark::State& state) {
+  const int count = state.range(0);
+  std::vector<SkRect> rects = MakePageRects(count);
+  DlRTree::Builder builder;
+  for ([[maybe_unused]] auto _ : state) {
+    builder.reset();
+    for (int i = 0; i < count; i++) {
+      builder.add(rects[i], i);
+    }
+    auto rtree = builder.build();
+    benchmark::DoNotOptimize(rtree);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Only builds the R-Tree from bounds that were already added, which is the
+// part of the incremental work left for the end of a recording.
+static void BM_DlRTreeBuilderBuild(benchmark::State& state) {
+  const int count = state.range(0);
+  std::vector<SkRect> rects = MakePageRects(count);
+  DlRTree::Builder builder;
+  for (int i = 0; i < count; i++) {
+    builder.add(rects[i], i);
+  }
+  for ([[maybe_unused]] auto _ : state) {
+    auto rtree = builder.build();
+    benchmark::DoNotOptimize(rtree);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Queries a screen sized area that scrolls down the page, either into a
+// new vector for each query or into one vector that is reused.
+static void BM_DlRTreeSearch(benchmark::State& state, bool reuse_results) {
+  const int count = state.range(0);
+  std::vector<SkRect> rects = MakePageRects(count);
+  DlRTree rtree(rects.data(), count);
+  const SkScalar page_height = (count / 64 + 1) * 12;
+  std::vector<int> reused_results;
+  size_t hits = 0;
+  SkScalar y = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    SkRect query = SkRect::MakeXYWH(0, y, 1024, 400);
+    if (reuse_results) {
+      rtree.searchInto(query, reused_results);
+      hits += reused_results.size();
+    } else {
+      std::vector<int> results;
+      rtree.search(query, &results);
+      hits += results.size();
+    }
+    y += 37;
+    if (y > page_height) {
+      y = 0;
+    }
+  }
+  state.counters["HitsPerQuery"] =
+      static_cast<double>(hits) / state.iterations();
+}
+
+// The op records of a chart of |bar_count| bars as recorded by a
+// DisplayListBuilder, in the order that they were recorded. The records
+// point into |display_list|, which keeps the objects they reference alive.
+struct RecordedChartOps {
+  explicit RecordedChartOps(int bar_count) {
+    DisplayListBuilder builder;
+    RecordChart(builder, bar_count);
+    display_list = builder.Build();
+    const DisplayListStorage& storage =
+        DisplayListStorageBenchmarkAccessor(*display_list);
+    for (auto* block = storage.head(); block; block = block->next()) {
+      for (uint8_t* ptr = block->begin(); ptr < block->end();) {
+        auto* op = reinterpret_cast<const DLOp*>(ptr);
+        ops.push_back(op);
+        ptr += op->size;
+      }
+    }
+  }
+
+  sk_sp<DisplayList> display_list;
+  std::vector<const DLOp*> ops;
+};
+
+static void ReportStorageCounters(benchmark::State& state,
+                                  size_t op_count,
+                                  size_t allocations,
+                                  size_t bytes_copied) {
+  double ops = static_cast<double>(state.iterations()) * op_count;
+  state.counters["AllocationsPerOp"] = allocations / ops;
+  state.counters["BytesCopiedPerOp"] = bytes_copied / ops;
+}
+
+// Copies the ops that a DisplayListBuilder records for a chart of
+// |state.range(0)| bars into a single buffer that is grown with realloc in
+// 4k pages and trimmed to size when built, which is how the builder managed
+// its storage before it used the blocks of a |DisplayListStorage|. This
+// provides the baseline for |BM_DisplayListStorageBlocks|, which copies the
+// same ops. The copies are never dispatched or disposed.
+static void BM_DisplayListStorageRealloc(benchmark::State& state) {
+  static constexpr size_t kPageSize = 4096;
+  RecordedChartOps chart(state.range(0));
+  size_t allocations = 0;
+  size_t bytes_copied = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    uint8_t* ptr = nullptr;
+    size_t used = 0;
+    size_t allocated = 0;
+    for (const DLOp* op : chart.ops) {
+      if (used + op->size > allocated) {
+        allocated = (used + op->size + kPageSize) & ~(kPageSize - 1);
+        uint8_t* grown = static_cast<uint8_t*>(std::realloc(ptr, allocated));
+        allocations++;
+        if (ptr != nullptr && grown != ptr) {
+          bytes_copied += used;
+        }
+        ptr = grown;
+        memset(ptr + used, 0, allocated - used);
+      }
+      memcpy(ptr + used, op, op->size);
+      used += op->size;
+    }
+    uint8_t* trimmed = static_cast<uint8_t*>(std::realloc(ptr, used));
+    if (trimmed != ptr) {
+      bytes_copied += used;
+    }
+    benchmark::DoNotOptimize(trimmed);
+    std::free(trimmed);
+  }
+  ReportStorageCounters(state, chart.ops.size(), allocations, bytes_copied);
+}
+
+// Copies the same ops as |BM_DisplayListStorageRealloc| into a
+// |DisplayListStorage| and trims it the way that |DisplayListBuilder::Build|
+// does. The storage never copies the ops that it has recorded so the bytes
+// copied are always zero and are only reported for comparison. Destroying
+// the storage only frees its blocks, so the copies are not disposed.
+static void BM_DisplayListStorageBlocks(benchmark::State& state) {
+  RecordedChartOps chart(state.range(0));
+  size_t allocations = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    DisplayListStorage storage;
+    for (const DLOp* op : chart.ops) {
+      memcpy(storage.allocate(op->size), op, op->size);
+    }
+    storage.trim();
+    benchmark::DoNotOptimize(storage.head());
+    allocations += storage.block_count();
+  }
+  ReportStorageCounters(state, chart.ops.size(), allocations, 0u);
+}
+
+// Records a chart of |state.range(0)| bars through a new DisplayListBuilder
+// for every DisplayList, so that the storage grows from empty each time as it
+// does in |BM_DisplayListStorageBlocks|, but with the cost of recording the
+// ops included.
+static void BM_DisplayListStorageBuilder(benchmark::State& state) {
+  const int bar_count = state.range(0);
+  size_t op_count = 0;
+  size_t allocations = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    DisplayListBuilder builder;
+    RecordChart(builder, bar_count);
+    auto display_list = builder.Build();
+    op_count = display_list->op_count();
+    allocations +=
+        DisplayListStorageBenchmarkAccessor(*display_list).block_count();
+  }
+  ReportStorageCounters(state, op_count, allocations, 0u);
+}
+
+// Records a chart of |state.range(0)| bars with an R-Tree, which groups the
+// bounds of the ops as they are recorded, and builds the DisplayList.
+static void BM_DisplayListRecordWithRTree(benchmark::State& state) {
+  const int bar_count = state.range(0);
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  for ([[maybe_unused]] auto _ : state) {
+    RecordChart(builder, bar_count);
+    auto display_list = builder.Build();
+    benchmark::DoNotOptimize(display_list);
+  }
+  state.SetItemsProcessed(state.iterations() * bar_count);
+}
+
+BENCHMARK_CAPTURE(BM_DisplayListBuilderFrame, Fresh, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListBuilderFrame, Pooled, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListStorageRealloc)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListStorageBlocks)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListStorageBuilder)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListRecordAndDispatch)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SerializedDisplayListLoadAndDispatch)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListComputeDamage)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DlRTreeConstruct)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DlRTreeBuilderAddAndBuild)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DlRTreeBuilderBuild)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTreeSearch, NewResults, false)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 16)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(BM_DlRTreeSearch, ReusedResults, true)
+    ->RangeMultiplier(8)
+    ->Range(64, 1 << 16)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_DisplayListRecordWithRTree)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DisplayListBuilderDefault,
                   kDefault,
                   DisplayListBuilderBenchmarkType::kDefault)
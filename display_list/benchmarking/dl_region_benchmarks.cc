@@ -173,7 +173,8 @@ void RunRegionOpBenchmark(benchmark::State& state,
                           RegionOp op,
                           bool withSingleRect,
                           int maxSize,
-                          double sizeFactor) {
+                          double sizeFactor,
+                          int rectCount = 500) {
   std::random_device d;
   std::seed_seq seed{2, 1, 3};
   std::mt19937 rng(seed);
@@ -181,11 +182,11 @@ void RunRegionOpBenchmark(benchmark::State& state,
   SkIRect bounds1 = SkIRect::MakeWH(4000, 4000);
   SkIRect bounds2 = RandomSubRect(rng, bounds1, sizeFactor);
 
-  auto rects = GenerateRects(rng, bounds1, 500, maxSize);
+  auto rects = GenerateRects(rng, bounds1, rectCount, maxSize);
   Region region1(rects);
 
-  rects = GenerateRects(rng, bounds2, withSingleRect ? 1 : 500 * sizeFactor,
-                        maxSize);
+  rects = GenerateRects(rng, bounds2,
+                        withSingleRect ? 1 : rectCount * sizeFactor, maxSize);
   Region region2(rects);
 
   switch (op) {
@@ -277,18 +278,20 @@ static void BM_DlRegion_Operation(benchmark::State& state,
                                   RegionOp op,
                                   bool withSingleRect,
                                   int maxSize,
-                                  double sizeFactor) {
+                                  double sizeFactor,
+                                  int rectCount = 500) {
   RunRegionOpBenchmark<DlRegionAdapter>(state, op, withSingleRect, maxSize,
-                                        sizeFactor);
+                                        sizeFactor, rectCount);
 }
 
 static void BM_SkRegion_Operation(benchmark::State& state,
                                   RegionOp op,
                                   bool withSingleRect,
                                   int maxSize,
-                                  double sizeFactor) {
+                                  double sizeFactor,
+                                  int rectCount = 500) {
   RunRegionOpBenchmark<SkRegionAdapter>(state, op, withSingleRect, maxSize,
-                                        sizeFactor);
+                                        sizeFactor, rectCount);
 }
 
 static void BM_DlRegion_IntersectsRegion(benchmark::State& state,
@@ -315,6 +318,9 @@ static void BM_SkRegion_IntersectsSingleRect(benchmark::State& state,
 
 const double kSizeFactorSmall = 0.3;
 
+// Thousands of overlapping rects, which produce lines with many spans.
+const int kDenseRectCount = 4000;
+
 BENCHMARK_CAPTURE(BM_DlRegion_IntersectsSingleRect, Tiny, 30)
     ->Unit(benchmark::kNanosecond);
 BENCHMARK_CAPTURE(BM_SkRegion_IntersectsSingleRect, Tiny, 30)
@@ -675,6 +681,72 @@ BENCHMARK_CAPTURE(BM_SkRegion_Operation,
                   1.0)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Union_SmallDense,
+                  RegionOp::kUnion,
+                  false,
+                  100,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Union_SmallDense,
+                  RegionOp::kUnion,
+                  false,
+                  100,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Union_MediumDense,
+                  RegionOp::kUnion,
+                  false,
+                  400,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Union_MediumDense,
+                  RegionOp::kUnion,
+                  false,
+                  400,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Intersection_SmallDense,
+                  RegionOp::kIntersection,
+                  false,
+                  100,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Intersection_SmallDense,
+                  RegionOp::kIntersection,
+                  false,
+                  100,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRegion_Operation,
+                  Intersection_MediumDense,
+                  RegionOp::kIntersection,
+                  false,
+                  400,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SkRegion_Operation,
+                  Intersection_MediumDense,
+                  RegionOp::kIntersection,
+                  false,
+                  400,
+                  1.0,
+                  kDenseRectCount)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DlRegion_FromRects, Tiny, 30)
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK_CAPTURE(BM_SkRegion_FromRects, Tiny, 30)
@@ -2,6 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
 #include <type_traits>
 
 #include "flutter/display_list/display_list.h"
@@ -14,6 +18,100 @@ const SaveLayerOptions SaveLayerOptions::kNoAttributes = SaveLayerOptions();
 const SaveLayerOptions SaveLayerOptions::kWithAttributes =
     kNoAttributes.with_renders_with_attributes();
 
+DisplayListStorage::DisplayListStorage(DisplayListStorage&& other) {
+  *this = std::move(other);
+}
+
+DisplayListStorage::~DisplayListStorage() {
+  reset();
+}
+
+DisplayListStorage& DisplayListStorage::operator=(DisplayListStorage&& other) {
+  if (this != &other) {
+    reset();
+    head_ = other.head_;
+    tail_ = other.tail_;
+    tail_link_ = (other.tail_link_ == &other.head_) ? &head_ : other.tail_link_;
+    last_allocation_ = other.last_allocation_;
+    size_ = other.size_;
+    block_count_ = other.block_count_;
+    allocated_bytes_ = other.allocated_bytes_;
+
+    other.head_ = other.tail_ = nullptr;
+    other.tail_link_ = &other.head_;
+    other.last_allocation_ = nullptr;
+    other.size_ = other.block_count_ = other.allocated_bytes_ = 0;
+  }
+  return *this;
+}
+
+void DisplayListStorage::AppendBlock(size_t capacity) {
+  // The memory is zeroed so that any padding within the op records
+  // compares equal in the bulk comparisons of |DisplayList::Equals|.
+  Block* block = static_cast<Block*>(std::calloc(1, kHeaderSize + capacity));
+  FML_CHECK(block);
+  block->next_ = nullptr;
+  block->used_ = 0;
+  block->capacity_ = capacity;
+  if (tail_ != nullptr) {
+    tail_->next_ = block;
+    tail_link_ = &tail_->next_;
+  } else {
+    head_ = block;
+    tail_link_ = &head_;
+  }
+  tail_ = block;
+  block_count_++;
+  allocated_bytes_ += kHeaderSize + capacity;
+}
+
+void DisplayListStorage::reserve(size_t size) {
+  if (head_ == nullptr && size > kBlockSize - kHeaderSize) {
+    AppendBlock(size);
+  }
+}
+
+uint8_t* DisplayListStorage::allocate(size_t size) {
+  if (tail_ == nullptr || tail_->used_ + size > tail_->capacity_) {
+    AppendBlock(std::max(kBlockSize - kHeaderSize, size));
+  }
+  uint8_t* ptr = tail_->begin() + tail_->used_;
+  tail_->used_ += size;
+  size_ += size;
+  last_allocation_ = ptr;
+  return ptr;
+}
+
+void DisplayListStorage::trim() {
+  if (tail_ == nullptr || tail_->used_ == tail_->capacity_) {
+    return;
+  }
+  size_t used = tail_->used_;
+  allocated_bytes_ -= tail_->capacity_ - used;
+  // Shrinking an allocation is normally done in place, but if the
+  // allocator does move the block then the link to it must be updated.
+  Block* block =
+      static_cast<Block*>(std::realloc(tail_, kHeaderSize + used));
+  FML_CHECK(block);
+  block->capacity_ = used;
+  *tail_link_ = block;
+  tail_ = block;
+  last_allocation_ = nullptr;
+}
+
+void DisplayListStorage::reset() {
+  Block* block = head_;
+  while (block != nullptr) {
+    Block* next = block->next_;
+    std::free(block);
+    block = next;
+  }
+  head_ = tail_ = nullptr;
+  tail_link_ = &head_;
+  last_allocation_ = nullptr;
+  size_ = block_count_ = allocated_bytes_ = 0;
+}
+
 DisplayList::DisplayList()
     : byte_count_(0),
       op_count_(0),
@@ -23,7 +121,8 @@ DisplayList::DisplayList()
       bounds_({0, 0, 0, 0}),
       can_apply_group_opacity_(true),
       is_ui_thread_safe_(true),
-      modifies_transparent_black_(false) {}
+      modifies_transparent_black_(false),
+      has_layer_filters_(false) {}
 
 DisplayList::DisplayList(DisplayListStorage&& storage,
                          size_t byte_count,
@@ -34,6 +133,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
                          bool can_apply_group_opacity,
                          bool is_ui_thread_safe,
                          bool modifies_transparent_black,
+                         bool has_layer_filters,
                          sk_sp<const DlRTree> rtree)
     : storage_(std::move(storage)),
       byte_count_(byte_count),
@@ -45,11 +145,11 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
       can_apply_group_opacity_(can_apply_group_opacity),
       is_ui_thread_safe_(is_ui_thread_safe),
       modifies_transparent_black_(modifies_transparent_black),
+      has_layer_filters_(has_layer_filters),
       rtree_(std::move(rtree)) {}
 
 DisplayList::~DisplayList() {
-  uint8_t* ptr = storage_.get();
-  DisposeOps(ptr, ptr + byte_count_);
+  DisposeOps(storage_);
 }
 
 uint32_t DisplayList::next_unique_id() {
@@ -139,8 +239,7 @@ class VectorCuller final : public Culler {
 };
 
 void DisplayList::Dispatch(DlOpReceiver& receiver) const {
-  uint8_t* ptr = storage_.get();
-  Dispatch(receiver, ptr, ptr + byte_count_, NopCuller::instance);
+  Dispatch(receiver, NopCuller::instance);
 }
 
 void DisplayList::Dispatch(DlOpReceiver& receiver,
@@ -159,17 +258,78 @@ void DisplayList::Dispatch(DlOpReceiver& receiver,
   }
   const DlRTree* rtree = this->rtree().get();
   FML_DCHECK(rtree != nullptr);
-  uint8_t* ptr = storage_.get();
   std::vector<int> rect_indices;
   rtree->search(cull_rect, &rect_indices);
   VectorCuller culler(rtree, rect_indices);
-  Dispatch(receiver, ptr, ptr + byte_count_, culler);
+  Dispatch(receiver, culler);
 }
 
-void DisplayList::Dispatch(DlOpReceiver& receiver,
-                           uint8_t* ptr,
-                           uint8_t* end,
-                           Culler& culler) const {
+std::vector<SkIRect> DisplayList::ComputeDispatchTiles(
+    const SkIRect& cull_rect,
+    int max_tiles) const {
+  // Splitting only pays off if each tile receives at least a handful
+  // of ops to amortize the cost of setting up its own dispatch.
+  static constexpr int kMinOpsPerTile = 16;
+
+  if (cull_rect.isEmpty()) {
+    return {};
+  }
+  if (max_tiles <= 1 || !has_rtree()) {
+    return {cull_rect};
+  }
+  const DlRTree* rtree = rtree_.get();
+  std::vector<int> rect_indices;
+  rtree->search(SkRect::Make(cull_rect), &rect_indices);
+  int op_count = static_cast<int>(rect_indices.size());
+  int tile_count = std::min(max_tiles, op_count / kMinOpsPerTile);
+  if (tile_count <= 1) {
+    return {cull_rect};
+  }
+
+  bool horizontal = cull_rect.width() > cull_rect.height();
+  int32_t start = horizontal ? cull_rect.fLeft : cull_rect.fTop;
+  int32_t end = horizontal ? cull_rect.fRight : cull_rect.fBottom;
+
+  // Place each op at the center of its bounds along the split axis and
+  // cut the axis at the quantiles of those centers.
+  std::vector<SkScalar> centers;
+  centers.reserve(op_count);
+  for (int index : rect_indices) {
+    const SkRect& bounds = rtree->bounds(index);
+    centers.push_back(horizontal ? bounds.centerX() : bounds.centerY());
+  }
+
+  std::vector<SkIRect> tiles;
+  tiles.reserve(tile_count);
+  int32_t tile_start = start;
+  for (int i = 1; i < tile_count; i++) {
+    auto nth = centers.begin() + (static_cast<size_t>(op_count) * i) /
+                                     tile_count;
+    std::nth_element(centers.begin(), nth, centers.end());
+    int32_t tile_end = std::clamp(static_cast<int32_t>(std::round(*nth)),
+                                  tile_start, end);
+    if (tile_end > tile_start) {
+      tiles.push_back(horizontal ? SkIRect::MakeLTRB(tile_start,
+                                                     cull_rect.fTop, tile_end,
+                                                     cull_rect.fBottom)
+                                 : SkIRect::MakeLTRB(cull_rect.fLeft,
+                                                     tile_start,
+                                                     cull_rect.fRight,
+                                                     tile_end));
+      tile_start = tile_end;
+    }
+  }
+  if (end > tile_start) {
+    tiles.push_back(horizontal
+                        ? SkIRect::MakeLTRB(tile_start, cull_rect.fTop, end,
+                                            cull_rect.fBottom)
+                        : SkIRect::MakeLTRB(cull_rect.fLeft, tile_start,
+                                            cull_rect.fRight, end));
+  }
+  return tiles;
+}
+
+void DisplayList::Dispatch(DlOpReceiver& receiver, Culler& culler) const {
   DispatchContext context = {
       .receiver = receiver,
       .cur_index = 0,
@@ -179,28 +339,38 @@ void DisplayList::Dispatch(DlOpReceiver& receiver,
   if (!culler.init(context)) {
     return;
   }
-  while (ptr < end) {
-    auto op = reinterpret_cast<const DLOp*>(ptr);
-    ptr += op->size;
-    FML_DCHECK(ptr <= end);
-    switch (op->type) {
+  for (auto block = storage_.head(); block != nullptr; block = block->next()) {
+    uint8_t* ptr = block->begin();
+    uint8_t* end = block->end();
+    while (ptr < end) {
+      auto op = reinterpret_cast<const DLOp*>(ptr);
+      ptr += op->size;
+      FML_DCHECK(ptr <= end);
+      switch (op->type) {
 #define DL_OP_DISPATCH(name)                             \
   case DisplayListOpType::k##name:                       \
     static_cast<const name##Op*>(op)->dispatch(context); \
     break;
 
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+        FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
 #ifdef IMPELLER_ENABLE_3D
-      DL_OP_DISPATCH(SetSceneColorSource)
+        DL_OP_DISPATCH(SetSceneColorSource)
 #endif  // IMPELLER_ENABLE_3D
 
 #undef DL_OP_DISPATCH
 
-      default:
-        FML_DCHECK(false);
-        return;
+        default:
+          FML_DCHECK(false);
+          return;
+      }
+      culler.update(context);
     }
-    culler.update(context);
+  }
+}
+
+void DisplayList::DisposeOps(const DisplayListStorage& storage) {
+  for (auto block = storage.head(); block != nullptr; block = block->next()) {
+    DisposeOps(block->begin(), block->end());
   }
 }
 
@@ -231,45 +401,99 @@ void DisplayList::DisposeOps(uint8_t* ptr, uint8_t* end) {
   }
 }
 
-static bool CompareOps(uint8_t* ptrA,
-                       uint8_t* endA,
-                       uint8_t* ptrB,
-                       uint8_t* endB) {
-  // These conditions are checked by the caller...
-  FML_DCHECK((endA - ptrA) == (endB - ptrB));
-  FML_DCHECK(ptrA != ptrB);
-  uint8_t* bulk_start_a = ptrA;
-  uint8_t* bulk_start_b = ptrB;
-  while (ptrA < endA && ptrB < endB) {
-    auto opA = reinterpret_cast<const DLOp*>(ptrA);
-    auto opB = reinterpret_cast<const DLOp*>(ptrB);
-    if (opA->type != opB->type || opA->size != opB->size) {
-      return false;
-    }
-    ptrA += opA->size;
-    ptrB += opB->size;
-    FML_DCHECK(ptrA <= endA);
-    FML_DCHECK(ptrB <= endB);
-    DisplayListCompare result;
-    switch (opA->type) {
-#define DL_OP_EQUALS(name)                              \
-  case DisplayListOpType::k##name:                      \
-    result = static_cast<const name##Op*>(opA)->equals( \
-        static_cast<const name##Op*>(opB));             \
-    break;
+// Walks the op records of a |DisplayListStorage| one block at a time.
+class OpCursor {
+ public:
+  explicit OpCursor(const DisplayListStorage& storage)
+      : block_(storage.head()) {
+    Load();
+  }
+
+  bool done() const { return block_ == nullptr; }
+  bool at_block_end() const { return ptr == end; }
+
+  void NextBlock() {
+    block_ = block_->next();
+    Load();
+  }
+
+  uint8_t* ptr;
+  uint8_t* end;
+
+ private:
+  void Load() {
+    ptr = block_ ? block_->begin() : nullptr;
+    end = block_ ? block_->end() : nullptr;
+  }
+
+  const DisplayListStorage::Block* block_;
+};
 
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_EQUALS)
+// Compares two ops of the same type.
+static DisplayListCompare CompareOp(const DLOp* a, const DLOp* b) {
+  switch (a->type) {
+#define DL_OP_EQUALS(name)                          \
+  case DisplayListOpType::k##name:                  \
+    return static_cast<const name##Op*>(a)->equals( \
+        static_cast<const name##Op*>(b));
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_EQUALS)
 #ifdef IMPELLER_ENABLE_3D
-      DL_OP_EQUALS(SetSceneColorSource)
+    DL_OP_EQUALS(SetSceneColorSource)
 #endif  // IMPELLER_ENABLE_3D
 
 #undef DL_OP_EQUALS
 
-      default:
-        FML_DCHECK(false);
-        return false;
+    default:
+      FML_DCHECK(false);
+      return DisplayListCompare::kNotEqual;
+  }
+}
+
+static bool CompareOps(const DisplayListStorage& storage_a,
+                       const DisplayListStorage& storage_b) {
+  // These conditions are checked by the caller...
+  FML_DCHECK(storage_a.size() == storage_b.size());
+  FML_DCHECK(storage_a.head() != storage_b.head());
+  OpCursor a(storage_a);
+  OpCursor b(storage_b);
+  uint8_t* bulk_start_a = a.ptr;
+  uint8_t* bulk_start_b = b.ptr;
+  while (true) {
+    if (a.at_block_end() || b.at_block_end()) {
+      // The bulk compare ranges are only contiguous within a block, so
+      // we perform any pending bulk compare whenever either list moves
+      // on to its next block. Both ranges always cover the same number
+      // of bytes since the ops were found to have matching sizes.
+      FML_DCHECK((a.ptr - bulk_start_a) == (b.ptr - bulk_start_b));
+      if (bulk_start_a < a.ptr) {
+        if (memcmp(bulk_start_a, bulk_start_b, a.ptr - bulk_start_a) != 0) {
+          return false;
+        }
+      }
+      if (a.at_block_end() && !a.done()) {
+        a.NextBlock();
+      }
+      if (b.at_block_end() && !b.done()) {
+        b.NextBlock();
+      }
+      if (a.done() || b.done()) {
+        return a.done() && b.done();
+      }
+      bulk_start_a = a.ptr;
+      bulk_start_b = b.ptr;
+      continue;
+    }
+    auto opA = reinterpret_cast<const DLOp*>(a.ptr);
+    auto opB = reinterpret_cast<const DLOp*>(b.ptr);
+    if (opA->type != opB->type || opA->size != opB->size) {
+      return false;
     }
-    switch (result) {
+    a.ptr += opA->size;
+    b.ptr += opB->size;
+    FML_DCHECK(a.ptr <= a.end);
+    FML_DCHECK(b.ptr <= b.end);
+    switch (CompareOp(opA, opB)) {
       case DisplayListCompare::kNotEqual:
         return false;
       case DisplayListCompare::kUseBulkCompare:
@@ -283,21 +507,11 @@ static bool CompareOps(uint8_t* ptrA,
             return false;
           }
         }
-        bulk_start_a = ptrA;
-        bulk_start_b = ptrB;
+        bulk_start_a = a.ptr;
+        bulk_start_b = b.ptr;
         break;
     }
   }
-  if (ptrA != endA || ptrB != endB) {
-    return false;
-  }
-  if (bulk_start_a < ptrA) {
-    // Perform a final bulk compare if we have remaining bytes waiting
-    if (memcmp(bulk_start_a, bulk_start_b, ptrA - bulk_start_a) != 0) {
-      return false;
-    }
-  }
-  return true;
 }
 
 bool DisplayList::Equals(const DisplayList* other) const {
@@ -307,12 +521,294 @@ bool DisplayList::Equals(const DisplayList* other) const {
   if (byte_count_ != other->byte_count_ || op_count_ != other->op_count_) {
     return false;
   }
-  uint8_t* ptr = storage_.get();
-  uint8_t* o_ptr = other->storage_.get();
-  if (ptr == o_ptr) {
+  if (storage_.head() == other->storage_.head()) {
     return true;
   }
-  return CompareOps(ptr, ptr + byte_count_, o_ptr, o_ptr + other->byte_count_);
+  return CompareOps(storage_, other->storage_);
+}
+
+// The attributes that are set by the attribute ops. Each attribute op
+// replaces the value of exactly one of them.
+enum DamageAttribute {
+  kAntiAliasAttribute,
+  kInvertColorsAttribute,
+  kStrokeCapAttribute,
+  kStrokeJoinAttribute,
+  kStyleAttribute,
+  kStrokeWidthAttribute,
+  kStrokeMiterAttribute,
+  kColorAttribute,
+  kBlendModeAttribute,
+  kPathEffectAttribute,
+  kColorFilterAttribute,
+  kColorSourceAttribute,
+  kImageFilterAttribute,
+  kMaskFilterAttribute,
+  kDamageAttributeCount,
+};
+
+// Returns the attribute that the op of the indicated |type| sets, or -1 if
+// it does not set an attribute.
+static int GetDamageAttribute(DisplayListOpType type) {
+  switch (type) {
+    case DisplayListOpType::kSetAntiAlias:
+      return kAntiAliasAttribute;
+    case DisplayListOpType::kSetInvertColors:
+      return kInvertColorsAttribute;
+    case DisplayListOpType::kSetStrokeCap:
+      return kStrokeCapAttribute;
+    case DisplayListOpType::kSetStrokeJoin:
+      return kStrokeJoinAttribute;
+    case DisplayListOpType::kSetStyle:
+      return kStyleAttribute;
+    case DisplayListOpType::kSetStrokeWidth:
+      return kStrokeWidthAttribute;
+    case DisplayListOpType::kSetStrokeMiter:
+      return kStrokeMiterAttribute;
+    case DisplayListOpType::kSetColor:
+      return kColorAttribute;
+    case DisplayListOpType::kSetBlendMode:
+      return kBlendModeAttribute;
+    case DisplayListOpType::kSetPodPathEffect:
+    case DisplayListOpType::kClearPathEffect:
+      return kPathEffectAttribute;
+    case DisplayListOpType::kSetPodColorFilter:
+    case DisplayListOpType::kClearColorFilter:
+      return kColorFilterAttribute;
+    case DisplayListOpType::kClearColorSource:
+    case DisplayListOpType::kSetPodColorSource:
+    case DisplayListOpType::kSetImageColorSource:
+    case DisplayListOpType::kSetRuntimeEffectColorSource:
+#ifdef IMPELLER_ENABLE_3D
+    case DisplayListOpType::kSetSceneColorSource:
+#endif  // IMPELLER_ENABLE_3D
+      return kColorSourceAttribute;
+    case DisplayListOpType::kClearImageFilter:
+    case DisplayListOpType::kSetPodImageFilter:
+    case DisplayListOpType::kSetSharedImageFilter:
+      return kImageFilterAttribute;
+    case DisplayListOpType::kClearMaskFilter:
+    case DisplayListOpType::kSetPodMaskFilter:
+      return kMaskFilterAttribute;
+    default:
+      return -1;
+  }
+}
+
+static constexpr uint64_t kDamageHashSeed = 0xcbf29ce484222325;
+
+// FNV-1a, which is plenty for the few bytes of most state ops.
+static uint64_t HashDamageBytes(const void* data, size_t size, uint64_t hash) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3;
+  }
+  return hash;
+}
+
+// Hashes the effect that an attribute, transform, clip or save op has on
+// the ops that follow it. Ops that hold references hash the addresses of
+// the objects they refer to, which only ever reports more damage.
+static uint64_t HashStateOp(const DLOp* op, uint64_t hash) {
+  switch (op->type) {
+    case DisplayListOpType::kClipIntersectPath:
+    case DisplayListOpType::kClipDifferencePath: {
+      // Both clip ops have the same layout.
+      auto clip = static_cast<const ClipIntersectPathOp*>(op);
+      std::vector<uint8_t> path(clip->path.writeToMemory(nullptr));
+      clip->path.writeToMemory(path.data());
+      uint32_t header[] = {static_cast<uint32_t>(op->type), clip->is_aa};
+      hash = HashDamageBytes(header, sizeof(header), hash);
+      return HashDamageBytes(path.data(), path.size(), hash);
+    }
+    case DisplayListOpType::kSave:
+    case DisplayListOpType::kSaveLayer:
+    case DisplayListOpType::kSaveLayerBounds:
+    case DisplayListOpType::kSaveLayerBackdrop:
+    case DisplayListOpType::kSaveLayerBackdropBounds: {
+      // The restore index only depends on the number of ops in the layer.
+      auto save = static_cast<const SaveOpBase*>(op);
+      auto bytes = reinterpret_cast<const uint8_t*>(op);
+      auto restore_index =
+          reinterpret_cast<const uint8_t*>(&save->restore_index);
+      size_t skipped = restore_index + sizeof(save->restore_index) - bytes;
+      hash = HashDamageBytes(bytes, restore_index - bytes, hash);
+      return HashDamageBytes(bytes + skipped, op->size - skipped, hash);
+    }
+    default:
+      return HashDamageBytes(op, op->size, hash);
+  }
+}
+
+// A rendering op along with a hash of the state that it renders with,
+// which covers the attributes, transform and clip in effect as well as the
+// enclosing layers.
+struct DamageItem {
+  const DLOp* op;
+  uint64_t state;
+  SkRect bounds;
+
+  bool Matches(const DamageItem& other) const {
+    if (state != other.state || op->type != other.op->type ||
+        op->size != other.op->size) {
+      return false;
+    }
+    switch (op->type) {
+      case DisplayListOpType::kSaveLayer:
+      case DisplayListOpType::kSaveLayerBounds:
+      case DisplayListOpType::kSaveLayerBackdrop:
+      case DisplayListOpType::kSaveLayerBackdropBounds:
+        // The state of a layer already covers the layer.
+        return true;
+      default:
+        break;
+    }
+    switch (CompareOp(op, other.op)) {
+      case DisplayListCompare::kNotEqual:
+        return false;
+      case DisplayListCompare::kUseBulkCompare:
+        return memcmp(op, other.op, op->size) == 0;
+      case DisplayListCompare::kEqual:
+        return true;
+    }
+    FML_UNREACHABLE();
+  }
+};
+
+static std::vector<DamageItem> CollectDamageItems(
+    const DisplayListStorage& storage,
+    const DlRTree& rtree) {
+  std::vector<DamageItem> items;
+  uint64_t attributes[kDamageAttributeCount] = {};
+  uint64_t attribute_hash = kDamageHashSeed;
+  bool attributes_changed = false;
+  uint64_t scope_hash = kDamageHashSeed;
+  std::vector<uint64_t> scope_stack;
+
+  // The R-Tree lists the bounds of the ops in the order of the ops.
+  int leaf = 0;
+  const int leaf_count = rtree.leaf_count();
+  auto add_item = [&](const DLOp* op, int op_index, uint64_t extra_state) {
+    if (attributes_changed) {
+      attribute_hash = HashDamageBytes(attributes, sizeof(attributes),
+                                       kDamageHashSeed);
+      attributes_changed = false;
+    }
+    SkRect bounds = SkRect::MakeEmpty();
+    while (leaf < leaf_count && rtree.id(leaf) < op_index) {
+      leaf++;
+    }
+    while (leaf < leaf_count && rtree.id(leaf) == op_index) {
+      bounds.join(rtree.bounds(leaf++));
+    }
+    uint64_t state[] = {attribute_hash, scope_hash, extra_state};
+    items.push_back({
+        .op = op,
+        .state = HashDamageBytes(state, sizeof(state), kDamageHashSeed),
+        .bounds = bounds,
+    });
+  };
+
+  int op_index = 0;
+  for (auto block = storage.head(); block != nullptr; block = block->next()) {
+    uint8_t* ptr = block->begin();
+    uint8_t* end = block->end();
+    while (ptr < end) {
+      auto op = reinterpret_cast<const DLOp*>(ptr);
+      ptr += op->size;
+      int attribute = GetDamageAttribute(op->type);
+      if (attribute >= 0) {
+        attributes[attribute] = HashStateOp(op, kDamageHashSeed);
+        attributes_changed = true;
+        op_index++;
+        continue;
+      }
+      switch (op->type) {
+        case DisplayListOpType::kSave:
+          scope_stack.push_back(scope_hash);
+          break;
+        case DisplayListOpType::kSaveLayer:
+        case DisplayListOpType::kSaveLayerBounds:
+        case DisplayListOpType::kSaveLayerBackdrop:
+        case DisplayListOpType::kSaveLayerBackdropBounds: {
+          // A layer renders with the attributes and fills its bounds when
+          // it is unbounded, so it is an item as well as part of the state
+          // of the ops that it contains.
+          uint64_t layer_hash = HashStateOp(op, kDamageHashSeed);
+          add_item(op, op_index, layer_hash);
+          scope_stack.push_back(scope_hash);
+          scope_hash = HashStateOp(op, scope_hash);
+          break;
+        }
+        case DisplayListOpType::kRestore:
+          if (!scope_stack.empty()) {
+            scope_hash = scope_stack.back();
+            scope_stack.pop_back();
+          }
+          break;
+        case DisplayListOpType::kTranslate:
+        case DisplayListOpType::kScale:
+        case DisplayListOpType::kRotate:
+        case DisplayListOpType::kSkew:
+        case DisplayListOpType::kTransform2DAffine:
+        case DisplayListOpType::kTransformFullPerspective:
+        case DisplayListOpType::kTransformReset:
+        case DisplayListOpType::kClipIntersectRect:
+        case DisplayListOpType::kClipIntersectRRect:
+        case DisplayListOpType::kClipIntersectPath:
+        case DisplayListOpType::kClipDifferenceRect:
+        case DisplayListOpType::kClipDifferenceRRect:
+        case DisplayListOpType::kClipDifferencePath:
+          scope_hash = HashStateOp(op, scope_hash);
+          break;
+        default:
+          add_item(op, op_index, 0);
+          break;
+      }
+      op_index++;
+    }
+  }
+  return items;
+}
+
+bool DisplayList::ComputeDamage(const DisplayList& old_display_list,
+                                std::vector<SkRect>& damage) const {
+  if (!has_rtree() || !old_display_list.has_rtree()) {
+    return false;
+  }
+  if (this == &old_display_list) {
+    return true;
+  }
+  TRACE_EVENT0("flutter", "DisplayList::ComputeDamage");
+  std::vector<DamageItem> old_items =
+      CollectDamageItems(old_display_list.storage_, *old_display_list.rtree_);
+  std::vector<DamageItem> new_items = CollectDamageItems(storage_, *rtree_);
+
+  // Skip the items that match at the start and at the end, which leaves
+  // the items that were changed, inserted or removed in between.
+  size_t common = std::min(old_items.size(), new_items.size());
+  size_t prefix = 0;
+  while (prefix < common && new_items[prefix].Matches(old_items[prefix])) {
+    prefix++;
+  }
+  size_t suffix = 0;
+  while (prefix + suffix < common &&
+         new_items[new_items.size() - 1 - suffix].Matches(
+             old_items[old_items.size() - 1 - suffix])) {
+    suffix++;
+  }
+
+  auto add_damage = [&damage, prefix, suffix](
+                        const std::vector<DamageItem>& items) {
+    for (size_t i = prefix; i < items.size() - suffix; i++) {
+      if (!items[i].bounds.isEmpty()) {
+        damage.push_back(items[i].bounds);
+      }
+    }
+  };
+  add_damage(old_items);
+  add_damage(new_items);
+  return true;
 }
 
 }  // namespace flutter
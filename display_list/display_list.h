@@ -5,12 +5,15 @@
 #ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 #define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/display_list/dl_sampling_options.h"
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
 
 // The Flutter DisplayList mechanism encapsulates a persistent sequence of
 // rendering operations.
@@ -203,24 +206,101 @@ class SaveLayerOptions {
   };
 };
 
-// Manages a buffer allocated with malloc.
+// Manages a linked list of fixed-size blocks allocated with malloc into
+// which the ops of a DisplayList are recorded.
+//
+// Ops never straddle two blocks, so each block can be walked on its own and
+// the address of a recorded op never changes as the storage grows. Growing
+// the storage therefore never copies the ops that were already recorded,
+// and a DisplayListBuilder can hand its storage to the DisplayList that it
+// builds without copying it either.
 class DisplayListStorage {
  public:
+  // The size of the blocks, including their header. Ops that do not fit
+  // into a block of this size are given a block of their own.
+  static constexpr size_t kBlockSize = 4096;
+
+  class Block {
+   public:
+    const Block* next() const { return next_; }
+
+    uint8_t* begin() const {
+      return const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(this)) +
+             kHeaderSize;
+    }
+    uint8_t* end() const { return begin() + used_; }
+
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+
+   private:
+    friend class DisplayListStorage;
+
+    Block* next_;
+    size_t used_;
+    size_t capacity_;
+  };
+
   DisplayListStorage() = default;
-  DisplayListStorage(DisplayListStorage&&) = default;
+  DisplayListStorage(DisplayListStorage&& other);
+  ~DisplayListStorage();
 
-  uint8_t* get() const { return ptr_.get(); }
+  DisplayListStorage& operator=(DisplayListStorage&& other);
 
-  void realloc(size_t count) {
-    ptr_.reset(static_cast<uint8_t*>(std::realloc(ptr_.release(), count)));
-    FML_CHECK(ptr_);
-  }
+  // Returns |size| bytes of zero-initialized memory, aligned for any op
+  // record, that are guaranteed to lie within a single block.
+  uint8_t* allocate(size_t size);
+
+  // Allocates a single block large enough to hold |size| bytes of ops if
+  // nothing has been allocated yet and |size| is larger than the space in
+  // a default block, so that a recording of a known size needs only one
+  // block. The block is trimmed by |trim| as usual if it is not filled.
+  void reserve(size_t size);
+
+  // Returns the address of the memory returned from the most recent call
+  // to |allocate| or nullptr if nothing has been allocated.
+  uint8_t* last_allocation() const { return last_allocation_; }
+
+  // Releases the unused space at the end of the last block once no more
+  // ops will be recorded.
+  void trim();
+
+  // Frees all of the blocks. Any ops recorded in the storage must have
+  // been disposed by the caller beforehand.
+  void reset();
+
+  const Block* head() const { return head_; }
+
+  // The number of bytes that have been allocated for ops.
+  size_t size() const { return size_; }
+
+  // The number of blocks in the storage, which is also the number of
+  // times the storage has called malloc.
+  size_t block_count() const { return block_count_; }
+
+  // The number of bytes of memory used by the blocks, including their
+  // headers and any space at the end of each block that could not hold
+  // the following op.
+  size_t allocated_bytes() const { return allocated_bytes_; }
 
  private:
-  struct FreeDeleter {
-    void operator()(uint8_t* p) { std::free(p); }
-  };
-  std::unique_ptr<uint8_t, FreeDeleter> ptr_;
+  static constexpr size_t kHeaderSize =
+      (sizeof(Block) + alignof(std::max_align_t) - 1) &
+      ~(alignof(std::max_align_t) - 1);
+
+  void AppendBlock(size_t capacity);
+
+  Block* head_ = nullptr;
+  Block* tail_ = nullptr;
+  // The link that points to |tail_| so that it can be updated if |trim|
+  // moves the last block.
+  Block** tail_link_ = &head_;
+  uint8_t* last_allocation_ = nullptr;
+  size_t size_ = 0;
+  size_t block_count_ = 0;
+  size_t allocated_bytes_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListStorage);
 };
 
 class Culler;
@@ -238,6 +318,19 @@ class DisplayList : public SkRefCnt {
   void Dispatch(DlOpReceiver& ctx, const SkRect& cull_rect) const;
   void Dispatch(DlOpReceiver& ctx, const SkIRect& cull_rect) const;
 
+  /// @brief     Partitions |cull_rect| into at most |max_tiles| disjoint
+  ///            tiles that each cover a similar number of rendering ops
+  ///            as recorded in the R-Tree.
+  ///
+  /// The tiles are bands along the longer axis of |cull_rect| whose
+  /// boundaries are placed at the quantiles of the op bounds, so that
+  /// each tile can be dispatched independently (for example on its own
+  /// worker thread) using |Dispatch(ctx, tile)|. If the DisplayList has
+  /// no R-Tree, or there are too few ops to be worth splitting, the
+  /// single tile |cull_rect| is returned.
+  std::vector<SkIRect> ComputeDispatchTiles(const SkIRect& cull_rect,
+                                            int max_tiles) const;
+
   // From historical behavior, SkPicture always included nested bytes,
   // but nested ops are only included if requested. The defaults used
   // here for these accessors follow that pattern.
@@ -263,6 +356,19 @@ class DisplayList : public SkRefCnt {
     return Equals(other.get());
   }
 
+  /// @brief     Computes the areas in which this DisplayList renders
+  ///            differently than |old_display_list| and appends them to
+  ///            |damage|, in the coordinates of the DisplayLists.
+  ///
+  /// The rendering ops of both DisplayLists are matched from the start
+  /// and from the end, with each op compared along with the attributes,
+  /// transform and clip that it renders with. The bounds that the
+  /// R-Trees recorded for the ops that do not match are the damage.
+  /// Returns false, leaving |damage| unchanged, if either DisplayList
+  /// has no R-Tree to provide the bounds of its ops.
+  bool ComputeDamage(const DisplayList& old_display_list,
+                     std::vector<SkRect>& damage) const;
+
   bool can_apply_group_opacity() const { return can_apply_group_opacity_; }
   bool isUIThreadSafe() const { return is_ui_thread_safe_; }
 
@@ -279,6 +385,15 @@ class DisplayList : public SkRefCnt {
     return modifies_transparent_black_;
   }
 
+  /// @brief     Indicates if any layer of this DisplayList, or of the
+  ///            DisplayLists that it draws, applies an image filter to its
+  ///            contents or a backdrop filter to what was rendered before it.
+  ///
+  /// The output of such a layer depends on pixels outside the bounds of the
+  /// individual ops within it, so the DisplayList cannot be rendered in
+  /// separate tiles that each only dispatch the ops that intersect them.
+  bool has_layer_filters() const { return has_layer_filters_; }
+
  private:
   DisplayList(DisplayListStorage&& ptr,
               size_t byte_count,
@@ -289,11 +404,13 @@ class DisplayList : public SkRefCnt {
               bool can_apply_group_opacity,
               bool is_ui_thread_safe,
               bool modifies_transparent_black,
+              bool has_layer_filters,
               sk_sp<const DlRTree> rtree);
 
   static uint32_t next_unique_id();
 
   static void DisposeOps(uint8_t* ptr, uint8_t* end);
+  static void DisposeOps(const DisplayListStorage& storage);
 
   const DisplayListStorage storage_;
   const size_t byte_count_;
@@ -308,15 +425,18 @@ class DisplayList : public SkRefCnt {
   const bool can_apply_group_opacity_;
   const bool is_ui_thread_safe_;
   const bool modifies_transparent_black_;
+  const bool has_layer_filters_;
 
   const sk_sp<const DlRTree> rtree_;
 
-  void Dispatch(DlOpReceiver& ctx,
-                uint8_t* ptr,
-                uint8_t* end,
-                Culler& culler) const;
+  void Dispatch(DlOpReceiver& ctx, Culler& culler) const;
+
+  // Exposes the recorded ops to the storage benchmarks only.
+  friend const DisplayListStorage& DisplayListStorageBenchmarkAccessor(
+      const DisplayList& display_list);
 
   friend class DisplayListBuilder;
+  friend class SerializedDisplayList;
 };
 
 }  // namespace flutter
@@ -14,8 +14,10 @@
 #include "flutter/display_list/dl_paint.h"
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/display_list/skia/dl_sk_dispatcher.h"
+#include "flutter/display_list/skia/dl_sk_tiled_dispatcher.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
 #include "flutter/display_list/utils/dl_receiver_utils.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/math.h"
 #include "flutter/testing/display_list_testing.h"
@@ -3239,5 +3241,258 @@ TEST_F(DisplayListTest, NopOperationsOmittedFromRecords) {
             });
 }
 
+TEST_F(DisplayListTest, StorageSpanningManyBlocksRoundTrips) {
+  auto build = [](DlColor last_color) {
+    DisplayListBuilder builder;
+    DlPaint paint;
+    for (int i = 0; i < 2000; i++) {
+      paint.setColor(DlColor(0xFF000000 | i));
+      builder.DrawRect(SkRect::MakeXYWH(i % 100, i / 100, 10, 10), paint);
+    }
+    // An op larger than a whole block gets a block of its own.
+    std::vector<SkPoint> points;
+    for (int i = 0; i < 1000; i++) {
+      points.push_back(SkPoint::Make(i, i * 0.5f));
+    }
+    builder.DrawPoints(PointMode::kPolygon, points.size(), points.data(),
+                       paint);
+    paint.setColor(last_color);
+    builder.DrawRect(SkRect::MakeLTRB(0, 0, 5, 5), paint);
+    return builder.Build();
+  };
+  auto display_list = build(DlColor::kRed());
+  ASSERT_GT(display_list->bytes(false), DisplayListStorage::kBlockSize * 4);
+  EXPECT_TRUE(display_list->Equals(build(DlColor::kRed())));
+  EXPECT_FALSE(display_list->Equals(build(DlColor::kBlue())));
+
+  DisplayListBuilder copy_builder;
+  display_list->Dispatch(ToReceiver(copy_builder));
+  auto copy = copy_builder.Build();
+  EXPECT_EQ(copy->op_count(), display_list->op_count());
+  EXPECT_TRUE(copy->Equals(display_list));
+}
+
+TEST_F(DisplayListTest, StorageNeverMovesRecordedOps) {
+  DisplayListStorage storage;
+  uint8_t* first = storage.allocate(64);
+  first[0] = 42;
+  for (int i = 0; i < 1000; i++) {
+    uint8_t* ptr = storage.allocate(64);
+    // Allocations are zero-initialized.
+    ASSERT_EQ(ptr[0], 0);
+    ASSERT_EQ(storage.last_allocation(), ptr);
+  }
+  EXPECT_EQ(first[0], 42);
+  EXPECT_EQ(storage.size(), 1001u * 64u);
+  EXPECT_GT(storage.block_count(), 1u);
+
+  size_t ops_in_blocks = 0;
+  for (auto block = storage.head(); block; block = block->next()) {
+    ASSERT_EQ(block->used() % 64, 0u);
+    ops_in_blocks += block->used() / 64;
+  }
+  EXPECT_EQ(ops_in_blocks, 1001u);
+
+  DisplayListStorage moved(std::move(storage));
+  EXPECT_EQ(storage.head(), nullptr);
+  EXPECT_EQ(storage.size(), 0u);
+  EXPECT_EQ(moved.size(), 1001u * 64u);
+}
+
+TEST_F(DisplayListTest, ComputeDispatchTilesWithoutRTreeReturnsCullRect) {
+  DisplayListBuilder builder(/*prepare_rtree=*/false);
+  for (int i = 0; i < 100; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(0, i * 10, 100, 5), DlPaint());
+  }
+  auto display_list = builder.Build();
+  SkIRect cull_rect = SkIRect::MakeWH(100, 1000);
+  auto tiles = display_list->ComputeDispatchTiles(cull_rect, 4);
+  ASSERT_EQ(tiles.size(), 1u);
+  EXPECT_EQ(tiles[0], cull_rect);
+}
+
+TEST_F(DisplayListTest, ComputeDispatchTilesPartitionsCullRect) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  for (int i = 0; i < 400; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(0, i * 10, 100, 5), DlPaint());
+  }
+  auto display_list = builder.Build();
+  SkIRect cull_rect = SkIRect::MakeWH(100, 4000);
+  auto tiles = display_list->ComputeDispatchTiles(cull_rect, 4);
+  ASSERT_EQ(tiles.size(), 4u);
+  // The tiles are disjoint bands that exactly cover the cull rect.
+  int32_t top = cull_rect.fTop;
+  for (const SkIRect& tile : tiles) {
+    EXPECT_EQ(tile.fLeft, cull_rect.fLeft);
+    EXPECT_EQ(tile.fRight, cull_rect.fRight);
+    EXPECT_EQ(tile.fTop, top);
+    EXPECT_GT(tile.fBottom, tile.fTop);
+    top = tile.fBottom;
+  }
+  EXPECT_EQ(top, cull_rect.fBottom);
+  // The ops are evenly distributed so each band should be close to
+  // a quarter of the height.
+  for (const SkIRect& tile : tiles) {
+    EXPECT_NEAR(tile.height(), 1000, 20);
+  }
+}
+
+TEST_F(DisplayListTest, TiledDispatchMatchesDirectDispatch) {
+  const int width = 200;
+  const int height = 600;
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  DlPaint paint;
+  for (int i = 0; i < 300; i++) {
+    paint.setColor(DlColor(0xFF000000 | (i * 0x010305)));
+    builder.DrawRect(SkRect::MakeXYWH((i * 7) % width, i * 2, 30, 11), paint);
+  }
+  auto display_list = builder.Build();
+  auto info = SkImageInfo::MakeN32Premul(width, height);
+
+  sk_sp<SkSurface> direct_surface = SkSurfaces::Raster(info);
+  DlSkCanvasDispatcher dispatcher(direct_surface->getCanvas());
+  display_list->Dispatch(dispatcher);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DlSkTiledDispatcher tiled_dispatcher(loop->GetTaskRunner(), 4);
+  sk_sp<SkSurface> tiled_surface = SkSurfaces::Raster(info);
+  tiled_dispatcher.DrawDisplayList(tiled_surface->getCanvas(), display_list,
+                                   SkIRect::MakeWH(width, height));
+
+  SkPixmap direct_pixels;
+  SkPixmap tiled_pixels;
+  ASSERT_TRUE(direct_surface->peekPixels(&direct_pixels));
+  ASSERT_TRUE(tiled_surface->peekPixels(&tiled_pixels));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      ASSERT_EQ(*direct_pixels.addr32(x, y), *tiled_pixels.addr32(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST_F(DisplayListTest, TiledDispatchOfLayerFiltersMatchesDirectDispatch) {
+  const int width = 200;
+  const int height = 600;
+  auto info = SkImageInfo::MakeN32Premul(width, height);
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DlSkTiledDispatcher tiled_dispatcher(loop->GetTaskRunner(), 4);
+  DlBlurImageFilter blur(10, 10, DlTileMode::kDecal);
+
+  auto assert_tiled_matches_direct = [&](bool backdrop) {
+    DisplayListBuilder builder(/*prepare_rtree=*/true);
+    DlPaint paint;
+    for (int i = 0; i < 300; i++) {
+      paint.setColor(DlColor(0xFF000000 | (i * 0x010305)));
+      builder.DrawRect(SkRect::MakeXYWH((i * 7) % width, i * 2, 30, 11),
+                       paint);
+    }
+    // The layer spans the middle of the DisplayList, across the seams of
+    // the tiles that its ops are split into.
+    SkRect layer_bounds = SkRect::MakeLTRB(20, 100, 180, 500);
+    if (backdrop) {
+      builder.SaveLayer(&layer_bounds, nullptr, &blur);
+    } else {
+      DlPaint layer_paint;
+      layer_paint.setImageFilter(&blur);
+      builder.SaveLayer(&layer_bounds, &layer_paint);
+    }
+    for (int i = 0; i < 40; i++) {
+      paint.setColor(DlColor(0xFF0000FF | (i * 0x050300)));
+      builder.DrawRect(SkRect::MakeXYWH(40 + (i * 11) % 100, 110 + i * 9, 20,
+                                        5),
+                       paint);
+    }
+    builder.Restore();
+    auto display_list = builder.Build();
+    ASSERT_TRUE(display_list->has_layer_filters());
+    ASSERT_GT(display_list->ComputeDispatchTiles(SkIRect::MakeWH(width, height),
+                                                 4)
+                  .size(),
+              1u);
+
+    sk_sp<SkSurface> direct_surface = SkSurfaces::Raster(info);
+    DlSkCanvasDispatcher dispatcher(direct_surface->getCanvas());
+    display_list->Dispatch(dispatcher);
+
+    sk_sp<SkSurface> tiled_surface = SkSurfaces::Raster(info);
+    tiled_dispatcher.DrawDisplayList(tiled_surface->getCanvas(), display_list,
+                                     SkIRect::MakeWH(width, height));
+
+    SkPixmap direct_pixels;
+    SkPixmap tiled_pixels;
+    ASSERT_TRUE(direct_surface->peekPixels(&direct_pixels));
+    ASSERT_TRUE(tiled_surface->peekPixels(&tiled_pixels));
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        ASSERT_EQ(*direct_pixels.addr32(x, y), *tiled_pixels.addr32(x, y))
+            << "at " << x << ", " << y << (backdrop ? " with" : " without")
+            << " backdrop";
+      }
+    }
+  };
+
+  assert_tiled_matches_direct(/*backdrop=*/false);
+  assert_tiled_matches_direct(/*backdrop=*/true);
+}
+
+TEST_F(DisplayListTest, HasLayerFiltersIncludesNestedDisplayLists) {
+  DlBlurImageFilter blur(5, 5, DlTileMode::kDecal);
+  DisplayListBuilder plain_builder;
+  DlPaint filter_paint;
+  filter_paint.setImageFilter(&blur);
+  // A filter on a single draw only reads the pixels of that draw.
+  plain_builder.DrawRect(SkRect::MakeLTRB(0, 0, 10, 10), filter_paint);
+  auto plain = plain_builder.Build();
+  EXPECT_FALSE(plain->has_layer_filters());
+
+  DisplayListBuilder filtered_builder;
+  filtered_builder.SaveLayer(nullptr, &filter_paint);
+  filtered_builder.DrawRect(SkRect::MakeLTRB(0, 0, 10, 10), DlPaint());
+  filtered_builder.Restore();
+  auto filtered = filtered_builder.Build();
+  EXPECT_TRUE(filtered->has_layer_filters());
+
+  DisplayListBuilder nesting_builder;
+  nesting_builder.DrawDisplayList(plain);
+  EXPECT_FALSE(nesting_builder.Build()->has_layer_filters());
+  nesting_builder.DrawDisplayList(filtered);
+  EXPECT_TRUE(nesting_builder.Build()->has_layer_filters());
+}
+
+TEST_F(DisplayListTest, ComputeDamageOfChangedAttributeCoversLaterDraws) {
+  auto record = [](DlColor color) {
+    DisplayListBuilder builder(/*prepare_rtree=*/true);
+    builder.DrawRect(SkRect::MakeLTRB(0, 0, 10, 10), DlPaint());
+    builder.DrawRect(SkRect::MakeLTRB(20, 0, 30, 10), DlPaint(color));
+    builder.DrawRect(SkRect::MakeLTRB(40, 0, 50, 10), DlPaint(color));
+    builder.DrawRect(SkRect::MakeLTRB(60, 0, 70, 10), DlPaint());
+    return builder.Build();
+  };
+  auto old_display_list = record(DlColor::kRed());
+  auto new_display_list = record(DlColor::kBlue());
+
+  std::vector<SkRect> damage;
+  ASSERT_TRUE(new_display_list->ComputeDamage(*old_display_list, damage));
+  SkRect damaged = SkRect::MakeEmpty();
+  for (const SkRect& rect : damage) {
+    damaged.join(rect);
+  }
+  EXPECT_EQ(damaged, SkRect::MakeLTRB(20, 0, 50, 10));
+
+  damage.clear();
+  ASSERT_TRUE(new_display_list->ComputeDamage(*new_display_list, damage));
+  EXPECT_TRUE(damage.empty());
+}
+
+TEST_F(DisplayListTest, ComputeDamageWithoutRTreeFails) {
+  DisplayListBuilder builder;
+  builder.DrawRect(SkRect::MakeLTRB(0, 0, 10, 10), DlPaint());
+  auto display_list = builder.Build();
+  std::vector<SkRect> damage;
+  EXPECT_FALSE(display_list->ComputeDamage(*display_list, damage));
+  EXPECT_TRUE(damage.empty());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -15,8 +15,6 @@
 
 namespace flutter {
 
-#define DL_BUILDER_PAGE 4096
-
 // CopyV(dst, src,n, src,n, ...) copies any number of typed srcs into dst.
 static void CopyV(void* dst) {}
 
@@ -35,26 +33,11 @@ static void CopyV(void* dst, const S* src, int n, Rest&&... rest) {
   CopyV(dst, std::forward<Rest>(rest)...);
 }
 
-static constexpr inline bool is_power_of_two(int value) {
-  return (value & (value - 1)) == 0;
-}
-
 template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int render_op_inc, Args&&... args) {
   size_t size = SkAlignPtr(sizeof(T) + pod);
   FML_DCHECK(size < (1 << 24));
-  if (used_ + size > allocated_) {
-    static_assert(is_power_of_two(DL_BUILDER_PAGE),
-                  "This math needs updating for non-pow2.");
-    // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
-    storage_.realloc(allocated_);
-    FML_DCHECK(storage_.get());
-    memset(storage_.get() + used_, 0, allocated_ - used_);
-  }
-  FML_DCHECK(used_ + size <= allocated_);
-  auto op = reinterpret_cast<T*>(storage_.get() + used_);
-  used_ += size;
+  auto op = reinterpret_cast<T*>(storage_.allocate(size));
   new (op) T{std::forward<Args>(args)...};
   op->type = T::kType;
   op->size = size;
@@ -68,26 +51,53 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
     restore();
   }
 
-  size_t bytes = used_;
+  size_t bytes = storage_.size();
   int count = render_op_count_;
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
   bool compatible = current_layer_->is_group_opacity_compatible();
   bool is_safe = is_ui_thread_safe_;
+  bool has_layer_filters = has_layer_filters_;
   bool affects_transparency = current_layer_->affects_transparent_layer();
+  SkRect dl_bounds = bounds();
+  sk_sp<DlRTree> dl_rtree = rtree();
 
-  used_ = allocated_ = render_op_count_ = op_index_ = 0;
+  render_op_count_ = op_index_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
   is_ui_thread_safe_ = true;
-  storage_.realloc(bytes);
+  has_layer_filters_ = false;
+  last_build_bytes_ = bytes;
+  storage_.trim();
   layer_stack_.pop_back();
   layer_stack_.emplace_back();
   tracker_.reset();
+  accumulator_->reset();
   current_ = DlPaint();
+  current_opacity_compatibility_ = true;
 
   return sk_sp<DisplayList>(new DisplayList(
-      std::move(storage_), bytes, count, nested_bytes, nested_count, bounds(),
-      compatible, is_safe, affects_transparency, rtree()));
+      std::move(storage_), bytes, count, nested_bytes, nested_count, dl_bounds,
+      compatible, is_safe, affects_transparency, has_layer_filters,
+      std::move(dl_rtree)));
+}
+
+void DisplayListBuilder::Reset(const SkRect& cull_rect, bool prepare_rtree) {
+  FML_DCHECK(layer_stack_.size() == 1);
+  FML_DCHECK(storage_.size() == 0);
+  tracker_ = DisplayListMatrixClipTracker(cull_rect, SkMatrix::I());
+  BoundsAccumulatorType type = prepare_rtree ? BoundsAccumulatorType::kRTree
+                                             : BoundsAccumulatorType::kRect;
+  if (accumulator_->type() != type) {
+    if (prepare_rtree) {
+      accumulator_ = std::make_unique<RTreeBoundsAccumulator>();
+    } else {
+      accumulator_ = std::make_unique<RectBoundsAccumulator>();
+    }
+  }
+  // The previous recording is the best predictor of the size of the next
+  // one, so we pre-size the first block of the storage to hold as many
+  // bytes as were last recorded.
+  storage_.reserve(last_build_bytes_);
 }
 
 DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
@@ -104,10 +114,7 @@ DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
 }
 
 DisplayListBuilder::~DisplayListBuilder() {
-  uint8_t* ptr = storage_.get();
-  if (ptr) {
-    DisplayList::DisposeOps(ptr, ptr + used_);
-  }
+  DisplayList::DisposeOps(storage_);
 }
 
 SkISize DisplayListBuilder::GetBaseLayerSize() const {
@@ -378,9 +385,9 @@ void DisplayListBuilder::SetAttributesFromPaint(
 
 void DisplayListBuilder::checkForDeferredSave() {
   if (current_layer_->has_deferred_save_op_) {
-    size_t save_offset_ = used_;
     Push<SaveOp>(0, 1);
-    current_layer_->save_offset_ = save_offset_;
+    current_layer_->save_op_ =
+        reinterpret_cast<SaveOpBase*>(storage_.last_allocation());
     current_layer_->has_deferred_save_op_ = false;
   }
 }
@@ -397,8 +404,7 @@ void DisplayListBuilder::Save() {
 
 void DisplayListBuilder::Restore() {
   if (layer_stack_.size() > 1) {
-    SaveOpBase* op = reinterpret_cast<SaveOpBase*>(
-        storage_.get() + current_layer_->save_offset());
+    SaveOpBase* op = current_layer_->save_op();
     if (!current_layer_->has_deferred_save_op_) {
       op->restore_index = op_index_;
       Push<RestoreOp>(0, 1);
@@ -486,7 +492,6 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
     current_layer_->is_nop_ = true;
     return;
   }
-  size_t save_layer_offset = used_;
   if (options.renders_with_attributes()) {
     // The actual flood of the outer layer clip will occur after the
     // (eventual) corresponding restore is called, but rather than
@@ -505,17 +510,21 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
       FML_DCHECK(unclipped);
     }
     CheckLayerOpacityCompatibility(true);
-    layer_stack_.emplace_back(save_layer_offset, true,
-                              current_.getImageFilter());
+    layer_stack_.emplace_back(true, current_.getImageFilter());
   } else {
     CheckLayerOpacityCompatibility(false);
-    layer_stack_.emplace_back(save_layer_offset, true, nullptr);
+    layer_stack_.emplace_back(true, nullptr);
   }
   current_layer_ = &layer_stack_.back();
 
   tracker_.save();
   accumulator()->save();
 
+  if (backdrop ||
+      (options.renders_with_attributes() && current_.getImageFilter())) {
+    has_layer_filters_ = true;
+  }
+
   if (backdrop) {
     // A backdrop will affect up to the entire surface, bounded by the clip
     // Accumulate should always return true here because if the
@@ -531,6 +540,8 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         ? Push<SaveLayerBoundsOp>(0, 1, options, *bounds)
         : Push<SaveLayerOp>(0, 1, options);
   }
+  current_layer_->save_op_ =
+      reinterpret_cast<SaveOpBase*>(storage_.last_allocation());
 
   if (options.renders_with_attributes()) {
     // |current_opacity_compatibility_| does not take an ImageFilter into
@@ -1240,6 +1251,7 @@ void DisplayListBuilder::DrawDisplayList(const sk_sp<DisplayList> display_list,
   Push<DrawDisplayListOp>(0, 1, display_list,
                           opacity < SK_Scalar1 ? opacity : SK_Scalar1);
   is_ui_thread_safe_ = is_ui_thread_safe_ && display_list->isUIThreadSafe();
+  has_layer_filters_ = has_layer_filters_ || display_list->has_layer_filters();
   // Not really necessary if the developer is interacting with us via
   // our attribute-state-less DlCanvas methods, but this avoids surprises
   // for those who may have been using the stateful Dispatcher methods.
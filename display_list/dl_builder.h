@@ -21,6 +21,8 @@
 
 namespace flutter {
 
+struct SaveOpBase;
+
 // The primary class used to build a display list. The list of methods
 // here matches the list of methods invoked on a |DlOpReceiver| combined
 // with the list of methods invoked on a |DlCanvas|.
@@ -260,6 +262,13 @@ class DisplayListBuilder final : public virtual DlCanvas,
   friend DlPaint DisplayListBuilderTestingAttributes(
       DisplayListBuilder& builder);
 
+  friend class DisplayListBuilderPool;
+
+  // Prepares a builder that was previously used to |Build| a DisplayList
+  // to record a new DisplayList with the indicated |cull_rect| and R-Tree
+  // preference, while retaining the memory of its internal buffers.
+  void Reset(const SkRect& cull_rect, bool prepare_rtree);
+
   void SetAttributesFromPaint(const DlPaint& paint,
                               const DisplayListAttributeFlags flags);
 
@@ -486,8 +495,8 @@ class DisplayListBuilder final : public virtual DlCanvas,
   void checkForDeferredSave();
 
   DisplayListStorage storage_;
-  size_t used_ = 0;
-  size_t allocated_ = 0;
+  // The number of bytes of ops in the most recently built DisplayList.
+  size_t last_build_bytes_ = 0;
   int render_op_count_ = 0;
   int op_index_ = 0;
 
@@ -496,6 +505,7 @@ class DisplayListBuilder final : public virtual DlCanvas,
   int nested_op_count_ = 0;
 
   bool is_ui_thread_safe_ = true;
+  bool has_layer_filters_ = false;
 
   template <typename T, typename... Args>
   void* Push(size_t extra, int op_inc, Args&&... args);
@@ -511,20 +521,18 @@ class DisplayListBuilder final : public virtual DlCanvas,
   class LayerInfo {
    public:
     explicit LayerInfo(
-        size_t save_offset = 0,
         bool has_layer = false,
         const std::shared_ptr<const DlImageFilter>& filter = nullptr)
-        : save_offset_(save_offset),
-          has_layer_(has_layer),
-          filter_(filter) {}
-
-    // The offset into the memory buffer where the saveLayer DLOp record
-    // for this saveLayer() call is placed. This may be needed if the
-    // eventual restore() call has discovered important information about
-    // the records inside the saveLayer that may impact how the saveLayer
-    // is handled (e.g., |cannot_inherit_opacity| == false).
-    // This offset is only valid if |has_layer| is true.
-    size_t save_offset() const { return save_offset_; }
+        : has_layer_(has_layer), filter_(filter) {}
+
+    // The save or saveLayer DLOp record for this save() or saveLayer()
+    // call. This may be needed if the eventual restore() call has
+    // discovered important information about the records inside the
+    // saveLayer that may impact how the saveLayer is handled (e.g.,
+    // |cannot_inherit_opacity| == false). The record never moves while
+    // it is being built as the |DisplayListStorage| never relocates ops.
+    // This record is null until the deferred save op has been recorded.
+    SaveOpBase* save_op() const { return save_op_; }
 
     bool has_layer() const { return has_layer_; }
     bool cannot_inherit_opacity() const { return cannot_inherit_opacity_; }
@@ -592,7 +600,7 @@ class DisplayListBuilder final : public virtual DlCanvas,
     bool is_unbounded() const { return is_unbounded_; }
 
    private:
-    size_t save_offset_;
+    SaveOpBase* save_op_ = nullptr;
     bool has_layer_;
     bool cannot_inherit_opacity_ = false;
     bool has_compatible_op_ = false;
@@ -0,0 +1,46 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_builder_pool.h"
+
+#include "flutter/fml/thread_local.h"
+
+namespace flutter {
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<DisplayListBuilderPool>
+    tls_builder_pool;
+
+DisplayListBuilderPool& DisplayListBuilderPool::GetForCurrentThread() {
+  if (!tls_builder_pool.get()) {
+    tls_builder_pool.reset(new DisplayListBuilderPool());
+  }
+  return *tls_builder_pool.get();
+}
+
+sk_sp<DisplayListBuilder> DisplayListBuilderPool::Acquire(
+    const SkRect& cull_rect,
+    bool prepare_rtree) {
+  if (builders_.empty()) {
+    return sk_make_sp<DisplayListBuilder>(cull_rect, prepare_rtree);
+  }
+  sk_sp<DisplayListBuilder> builder = std::move(builders_.back());
+  builders_.pop_back();
+  builder->Reset(cull_rect, prepare_rtree);
+  return builder;
+}
+
+void DisplayListBuilderPool::Recycle(sk_sp<DisplayListBuilder> builder) {
+  if (!builder || !builder->unique()) {
+    return;
+  }
+  if (builder->storage_.size() > 0 || builder->layer_stack_.size() > 1) {
+    // The builder was abandoned in the middle of a recording.
+    return;
+  }
+  if (builders_.size() < kMaxPooledBuilders) {
+    builders_.push_back(std::move(builder));
+  }
+}
+
+}  // namespace flutter
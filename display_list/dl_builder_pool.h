@@ -0,0 +1,62 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DL_BUILDER_POOL_H_
+#define FLUTTER_DISPLAY_LIST_DL_BUILDER_POOL_H_
+
+#include <vector>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A per-thread pool of |DisplayListBuilder| objects that keeps
+///             the internal buffers of the builders alive from one recording
+///             to the next.
+///
+/// A builder that is returned to the pool with |Recycle| after it has built
+/// its DisplayList keeps the capacity of its layer stack and of the vectors
+/// in its bounds accumulator. The op storage is always handed off to the
+/// DisplayList that was built, so it cannot be reused, but the first block
+/// of the next recording is pre-sized from the number of bytes the builder
+/// recorded the last time so that a large recording of a similar size is
+/// recorded into a single allocation.
+///
+/// The pool is not thread safe; each thread has its own pool which is
+/// obtained from |GetForCurrentThread| and builders must be recycled on
+/// the thread from which they were acquired.
+class DisplayListBuilderPool {
+ public:
+  /// The maximum number of idle builders that are retained by a pool.
+  static constexpr size_t kMaxPooledBuilders = 16;
+
+  static DisplayListBuilderPool& GetForCurrentThread();
+
+  DisplayListBuilderPool() = default;
+
+  /// Returns a builder ready to record a DisplayList with the indicated
+  /// |cull_rect|, recycled from the pool if one is available.
+  sk_sp<DisplayListBuilder> Acquire(const SkRect& cull_rect,
+                                    bool prepare_rtree);
+
+  /// Returns a builder to the pool after its DisplayList has been built.
+  ///
+  /// The builder is only retained if no other references to it remain,
+  /// it has no partially recorded content, and the pool is not full.
+  void Recycle(sk_sp<DisplayListBuilder> builder);
+
+  /// The number of idle builders currently held by the pool.
+  size_t pooled_count() const { return builders_.size(); }
+
+ private:
+  std::vector<sk_sp<DisplayListBuilder>> builders_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListBuilderPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DL_BUILDER_POOL_H_
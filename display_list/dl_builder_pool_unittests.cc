@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_builder_pool.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<DisplayList> RecordRects(DisplayListBuilder& builder, int count) {
+  DlPaint paint;
+  for (int i = 0; i < count; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(i, i, 10, 10), paint);
+  }
+  return builder.Build();
+}
+
+TEST(DisplayListBuilderPool, RecycledBuilderIsReused) {
+  DisplayListBuilderPool pool;
+  auto builder = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  DisplayListBuilder* raw_builder = builder.get();
+  RecordRects(*builder, 10);
+  pool.Recycle(std::move(builder));
+  EXPECT_EQ(pool.pooled_count(), 1u);
+
+  auto reused = pool.Acquire(SkRect::MakeWH(50, 50), true);
+  EXPECT_EQ(reused.get(), raw_builder);
+  EXPECT_EQ(pool.pooled_count(), 0u);
+  EXPECT_EQ(reused->GetBaseLayerSize(), SkISize::Make(50, 50));
+}
+
+TEST(DisplayListBuilderPool, RecycledBuilderRecordsIdenticalDisplayList) {
+  DisplayListBuilderPool pool;
+  auto builder = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  builder->Save();
+  builder->ClipRect(SkRect::MakeWH(40, 40));
+  RecordRects(*builder, 20);
+  pool.Recycle(std::move(builder));
+
+  auto reused = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  auto reused_list = RecordRects(*reused, 5);
+
+  DisplayListBuilder fresh_builder(SkRect::MakeWH(100, 100), true);
+  auto fresh_list = RecordRects(fresh_builder, 5);
+
+  EXPECT_TRUE(reused_list->Equals(fresh_list));
+  EXPECT_EQ(reused_list->bounds(), fresh_list->bounds());
+  ASSERT_TRUE(reused_list->has_rtree());
+  EXPECT_EQ(reused_list->rtree()->leaf_count(),
+            fresh_list->rtree()->leaf_count());
+}
+
+TEST(DisplayListBuilderPool, RecycledBuilderCanSwitchAccumulatorType) {
+  DisplayListBuilderPool pool;
+  auto builder = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  RecordRects(*builder, 5);
+  pool.Recycle(std::move(builder));
+
+  auto reused = pool.Acquire(SkRect::MakeWH(100, 100), false);
+  EXPECT_FALSE(RecordRects(*reused, 5)->has_rtree());
+}
+
+TEST(DisplayListBuilderPool, DoesNotRecycleSharedOrUnfinishedBuilders) {
+  DisplayListBuilderPool pool;
+
+  auto shared = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  RecordRects(*shared, 5);
+  sk_sp<DisplayListBuilder> other_ref = shared;
+  pool.Recycle(std::move(shared));
+  EXPECT_EQ(pool.pooled_count(), 0u);
+
+  auto unfinished = pool.Acquire(SkRect::MakeWH(100, 100), true);
+  unfinished->DrawRect(SkRect::MakeWH(10, 10), DlPaint());
+  pool.Recycle(std::move(unfinished));
+  EXPECT_EQ(pool.pooled_count(), 0u);
+}
+
+TEST(DisplayListBuilderPool, PoolIsBounded) {
+  DisplayListBuilderPool pool;
+  std::vector<sk_sp<DisplayListBuilder>> builders;
+  for (size_t i = 0; i < DisplayListBuilderPool::kMaxPooledBuilders + 4; i++) {
+    builders.push_back(pool.Acquire(SkRect::MakeWH(100, 100), true));
+  }
+  for (auto& builder : builders) {
+    pool.Recycle(std::move(builder));
+  }
+  EXPECT_EQ(pool.pooled_count(), DisplayListBuilderPool::kMaxPooledBuilders);
+}
+
+}  // namespace testing
+}  // namespace flutter
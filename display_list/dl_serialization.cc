@@ -0,0 +1,1774 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_serialization.h"
+
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/dl_op_records.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+
+namespace flutter {
+
+namespace {
+
+// The ops whose records only hold numbers and are therefore written to the
+// serialized form as they are and dispatched in place.
+#define FOR_EACH_FLAT_DISPLAY_LIST_OP(V) \
+  V(SetAntiAlias)                        \
+  V(SetInvertColors)                     \
+  V(SetStrokeCap)                        \
+  V(SetStrokeJoin)                       \
+  V(SetStyle)                            \
+  V(SetStrokeWidth)                      \
+  V(SetStrokeMiter)                      \
+  V(SetColor)                            \
+  V(SetBlendMode)                        \
+  V(ClearPathEffect)                     \
+  V(ClearColorFilter)                    \
+  V(ClearColorSource)                    \
+  V(ClearImageFilter)                    \
+  V(ClearMaskFilter)                     \
+  V(Save)                                \
+  V(SaveLayer)                           \
+  V(SaveLayerBounds)                     \
+  V(Restore)                             \
+  V(Translate)                           \
+  V(Scale)                               \
+  V(Rotate)                              \
+  V(Skew)                                \
+  V(Transform2DAffine)                   \
+  V(TransformFullPerspective)            \
+  V(TransformReset)                      \
+  V(ClipIntersectRect)                   \
+  V(ClipIntersectRRect)                  \
+  V(ClipDifferenceRect)                  \
+  V(ClipDifferenceRRect)                 \
+  V(DrawPaint)                           \
+  V(DrawColor)                           \
+  V(DrawLine)                            \
+  V(DrawRect)                            \
+  V(DrawOval)                            \
+  V(DrawCircle)                          \
+  V(DrawRRect)                           \
+  V(DrawDRRect)                          \
+  V(DrawArc)                             \
+  V(DrawPoints)                          \
+  V(DrawLines)                           \
+  V(DrawPolygon)                         \
+  V(DrawVertices)
+
+// The records that replace the ops that refer to objects. The objects are
+// stored in the resource sections and the records hold their indices
+// there instead. The type of each record is that of the op it replaces.
+
+#define DEFINE_SET_REF_OP(name)                                         \
+  struct Set##name##RefOp final : DLOp {                                \
+    uint32_t index;                                                     \
+                                                                        \
+    void dispatch(DispatchContext& ctx,                                 \
+                  const std::vector<std::shared_ptr<Dl##name>>& table)  \
+        const {                                                         \
+      ctx.receiver.set##name(table[index].get());                       \
+    }                                                                   \
+  };
+DEFINE_SET_REF_OP(ColorSource)
+DEFINE_SET_REF_OP(ColorFilter)
+DEFINE_SET_REF_OP(ImageFilter)
+DEFINE_SET_REF_OP(MaskFilter)
+DEFINE_SET_REF_OP(PathEffect)
+#undef DEFINE_SET_REF_OP
+
+struct SaveLayerBackdropRefOp final : SaveOpBase {
+  explicit SaveLayerBackdropRefOp(const SaveOpBase* op)
+      : SaveOpBase(op->options) {
+    restore_index = op->restore_index;
+  }
+
+  SkRect rect;
+  uint32_t backdrop_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<std::shared_ptr<DlImageFilter>>& filters,
+                bool has_bounds) const {
+    if (save_needed(ctx)) {
+      ctx.receiver.saveLayer(has_bounds ? &rect : nullptr, options,
+                             filters[backdrop_index].get());
+    }
+  }
+};
+
+struct ClipPathRefOp final : TransformClipOpBase {
+  uint32_t is_aa;
+  uint32_t path_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<SkPath>& paths,
+                DlCanvas::ClipOp clip_op) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.clipPath(paths[path_index], clip_op, is_aa);
+    }
+  }
+};
+
+struct DrawPathRefOp final : DrawOpBase {
+  uint32_t path_index;
+
+  void dispatch(DispatchContext& ctx, const std::vector<SkPath>& paths) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawPath(paths[path_index]);
+    }
+  }
+};
+
+struct DrawShadowRefOp final : DrawOpBase {
+  DlColor color;
+  SkScalar elevation;
+  SkScalar dpr;
+  uint32_t path_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<SkPath>& paths,
+                bool transparent_occluder) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawShadow(paths[path_index], color, elevation,
+                              transparent_occluder, dpr);
+    }
+  }
+};
+
+struct DrawImageRefOp final : DrawOpBase {
+  SkPoint point;
+  DlImageSampling sampling;
+  uint32_t image_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<DlImage>>& images,
+                bool render_with_attributes) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawImage(images[image_index], point, sampling,
+                             render_with_attributes);
+    }
+  }
+};
+
+struct DrawImageRectRefOp final : DrawOpBase {
+  SkRect src;
+  SkRect dst;
+  DlImageSampling sampling;
+  uint32_t render_with_attributes;
+  DlCanvas::SrcRectConstraint constraint;
+  uint32_t image_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<DlImage>>& images) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawImageRect(images[image_index], src, dst, sampling,
+                                 render_with_attributes, constraint);
+    }
+  }
+};
+
+struct DrawImageNineRefOp final : DrawOpBase {
+  SkIRect center;
+  SkRect dst;
+  DlFilterMode mode;
+  uint32_t image_index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<DlImage>>& images,
+                bool render_with_attributes) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawImageNine(images[image_index], center, dst, mode,
+                                 render_with_attributes);
+    }
+  }
+};
+
+// Followed by the same lists of transforms, texture rects and colors as
+// the |DrawAtlasBaseOp| that it replaces.
+struct DrawAtlasRefOp final : DrawOpBase {
+  int32_t count;
+  uint16_t mode_index;
+  uint8_t has_colors;
+  uint8_t render_with_attributes;
+  DlImageSampling sampling;
+  uint32_t atlas_index;
+  SkRect cull_rect;
+
+  size_t pod_size() const {
+    size_t size = count * (sizeof(SkRSXform) + sizeof(SkRect));
+    if (has_colors) {
+      size += count * sizeof(DlColor);
+    }
+    return size;
+  }
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<DlImage>>& images,
+                bool culled) const {
+    if (op_needed(ctx)) {
+      const SkRSXform* xform = reinterpret_cast<const SkRSXform*>(this + 1);
+      const SkRect* tex = reinterpret_cast<const SkRect*>(xform + count);
+      const DlColor* colors =
+          has_colors ? reinterpret_cast<const DlColor*>(tex + count) : nullptr;
+      const DlBlendMode mode = static_cast<DlBlendMode>(mode_index);
+      ctx.receiver.drawAtlas(images[atlas_index], xform, tex, colors, count,
+                             mode, sampling, culled ? &cull_rect : nullptr,
+                             render_with_attributes);
+    }
+  }
+};
+
+struct DrawDisplayListRefOp final : DrawOpBase {
+  SkScalar opacity;
+  uint32_t index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<DisplayList>>& display_lists) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawDisplayList(display_lists[index], opacity);
+    }
+  }
+};
+
+struct DrawTextBlobRefOp final : DrawOpBase {
+  SkScalar x;
+  SkScalar y;
+  uint32_t index;
+
+  void dispatch(DispatchContext& ctx,
+                const std::vector<sk_sp<SkTextBlob>>& text_blobs) const {
+    if (op_needed(ctx)) {
+      ctx.receiver.drawTextBlob(text_blobs[index], x, y);
+    }
+  }
+};
+
+// A fingerprint of the layout of the op records, which differs between
+// builds for different architectures and changes with the op records and
+// with the values of the op types that they are stored under.
+constexpr uint32_t ComputeOpLayoutFingerprint() {
+  uint32_t fingerprint = sizeof(void*);
+  auto add = [&fingerprint](DisplayListOpType type, size_t size,
+                            size_t align) {
+    fingerprint = fingerprint * 31 + static_cast<uint32_t>(type);
+    fingerprint = fingerprint * 31 + size;
+    fingerprint = fingerprint * 31 + align;
+  };
+#define DL_OP_LAYOUT(name) \
+  add(DisplayListOpType::k##name, sizeof(name##Op), alignof(name##Op));
+  FOR_EACH_FLAT_DISPLAY_LIST_OP(DL_OP_LAYOUT)
+#undef DL_OP_LAYOUT
+#define DL_REF_OP_LAYOUT(name, type) \
+  add(DisplayListOpType::k##type, sizeof(name##RefOp), alignof(name##RefOp));
+  DL_REF_OP_LAYOUT(SetColorSource, SetPodColorSource)
+  DL_REF_OP_LAYOUT(SetColorSource, SetImageColorSource)
+  DL_REF_OP_LAYOUT(SetColorFilter, SetPodColorFilter)
+  DL_REF_OP_LAYOUT(SetImageFilter, SetPodImageFilter)
+  DL_REF_OP_LAYOUT(SetImageFilter, SetSharedImageFilter)
+  DL_REF_OP_LAYOUT(SetMaskFilter, SetPodMaskFilter)
+  DL_REF_OP_LAYOUT(SetPathEffect, SetPodPathEffect)
+  DL_REF_OP_LAYOUT(SaveLayerBackdrop, SaveLayerBackdrop)
+  DL_REF_OP_LAYOUT(SaveLayerBackdrop, SaveLayerBackdropBounds)
+  DL_REF_OP_LAYOUT(ClipPath, ClipIntersectPath)
+  DL_REF_OP_LAYOUT(ClipPath, ClipDifferencePath)
+  DL_REF_OP_LAYOUT(DrawPath, DrawPath)
+  DL_REF_OP_LAYOUT(DrawShadow, DrawShadow)
+  DL_REF_OP_LAYOUT(DrawShadow, DrawShadowTransparentOccluder)
+  DL_REF_OP_LAYOUT(DrawImage, DrawImage)
+  DL_REF_OP_LAYOUT(DrawImage, DrawImageWithAttr)
+  DL_REF_OP_LAYOUT(DrawImageRect, DrawImageRect)
+  DL_REF_OP_LAYOUT(DrawImageNine, DrawImageNine)
+  DL_REF_OP_LAYOUT(DrawImageNine, DrawImageNineWithAttr)
+  DL_REF_OP_LAYOUT(DrawAtlas, DrawAtlas)
+  DL_REF_OP_LAYOUT(DrawAtlas, DrawAtlasCulled)
+  DL_REF_OP_LAYOUT(DrawDisplayList, DrawDisplayList)
+  DL_REF_OP_LAYOUT(DrawTextBlob, DrawTextBlob)
+#undef DL_REF_OP_LAYOUT
+  fingerprint = fingerprint * 31 + sizeof(DlVertices);
+  return fingerprint;
+}
+
+constexpr uint32_t kMagic = 0x5A534C44;  // "DLSZ"
+constexpr uint32_t kOpLayoutFingerprint = ComputeOpLayoutFingerprint();
+constexpr size_t kAlignment = 16;
+
+constexpr uint32_t kHasRTreeFlag = 1 << 0;
+
+// The deepest that image filters may be nested in one another and that
+// DisplayLists may be nested in one another, which bounds the recursion
+// when they are loaded.
+constexpr int kMaxImageFilterDepth = 32;
+constexpr int kMaxDisplayListDepth = 32;
+
+enum ResourceSection : uint32_t {
+  kPathSection,
+  kTextBlobSection,
+  // Images are loaded before the color sources that refer to them.
+  kImageSection,
+  kColorSourceSection,
+  kColorFilterSection,
+  kImageFilterSection,
+  kMaskFilterSection,
+  kPathEffectSection,
+  kDisplayListSection,
+  kSectionCount,
+};
+
+// The offsets are relative to the start of the serialized DisplayList.
+struct SectionHeader {
+  // The offset of a table of |count| |EntryHeader| structures.
+  uint32_t entries_offset;
+  uint32_t count;
+};
+
+struct EntryHeader {
+  uint32_t offset;
+  uint32_t size;
+};
+
+struct SerializedHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t op_layout;
+  uint32_t flags;
+  uint32_t op_count;
+  uint32_t ops_offset;
+  uint32_t ops_size;
+  // The size of the whole serialized DisplayList, so that truncated data
+  // is rejected even if it ends in the padding after the last entry.
+  uint32_t size;
+  SkRect bounds;
+  SectionHeader sections[kSectionCount];
+};
+
+size_t Align(size_t offset) {
+  return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+bool InRange(size_t offset, size_t size, size_t limit) {
+  return offset <= limit && size <= limit - offset;
+}
+
+// Whether the |value| read from the serialized data is one of the values of
+// its enum, which run from 0 up to |last|.
+template <typename T>
+bool IsValidEnum(T value, T last) {
+  using U = std::underlying_type_t<T>;
+  return static_cast<U>(value) >= 0 &&
+         static_cast<U>(value) <= static_cast<U>(last);
+}
+
+// Appends plain values to the bytes of a resource.
+class ByteWriter {
+ public:
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Write(&value, sizeof(T));
+  }
+
+  void Write(const void* data, size_t size) {
+    bytes_.append(static_cast<const char*>(data), size);
+  }
+
+  std::string TakeBytes() { return std::move(bytes_); }
+
+ private:
+  std::string bytes_;
+};
+
+// Reads the values written by a |ByteWriter|, failing instead of reading
+// past the end of the resource.
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size)
+      : ptr_(data), end_(data + size) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const uint8_t* data = ReadBytes(sizeof(T));
+    if (data == nullptr) {
+      return false;
+    }
+    memcpy(&value, data, sizeof(T));
+    return true;
+  }
+
+  // Reads an enum, failing unless it is one of the values up to |last|.
+  template <typename T>
+  bool ReadEnum(T& value, T last) {
+    return Read(value) && IsValidEnum(value, last);
+  }
+
+  const uint8_t* ReadBytes(size_t size) {
+    if (static_cast<size_t>(end_ - ptr_) < size) {
+      return nullptr;
+    }
+    const uint8_t* data = ptr_;
+    ptr_ += size;
+    return data;
+  }
+
+ private:
+  const uint8_t* ptr_;
+  const uint8_t* end_;
+};
+
+void WriteMatrix(ByteWriter& writer, const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  writer.Write(values);
+}
+
+bool ReadMatrix(ByteReader& reader, SkMatrix& matrix) {
+  SkScalar values[9];
+  if (!reader.Read(values)) {
+    return false;
+  }
+  matrix.set9(values);
+  return true;
+}
+
+bool WriteColorFilter(ByteWriter& writer, const DlColorFilter& filter) {
+  writer.Write(filter.type());
+  switch (filter.type()) {
+    case DlColorFilterType::kBlend:
+      writer.Write(filter.asBlend()->color());
+      writer.Write(filter.asBlend()->mode());
+      return true;
+    case DlColorFilterType::kMatrix: {
+      float matrix[20];
+      filter.asMatrix()->get_matrix(matrix);
+      writer.Write(matrix);
+      return true;
+    }
+    case DlColorFilterType::kSrgbToLinearGamma:
+    case DlColorFilterType::kLinearToSrgbGamma:
+      return true;
+  }
+  return false;
+}
+
+std::shared_ptr<DlColorFilter> ReadColorFilter(ByteReader& reader) {
+  DlColorFilterType type;
+  if (!reader.Read(type)) {
+    return nullptr;
+  }
+  switch (type) {
+    case DlColorFilterType::kBlend: {
+      DlColor color;
+      DlBlendMode mode;
+      if (!reader.Read(color) ||
+          !reader.ReadEnum(mode, DlBlendMode::kLastMode)) {
+        return nullptr;
+      }
+      return std::make_shared<DlBlendColorFilter>(color, mode);
+    }
+    case DlColorFilterType::kMatrix: {
+      float matrix[20];
+      if (!reader.Read(matrix)) {
+        return nullptr;
+      }
+      return std::make_shared<DlMatrixColorFilter>(matrix);
+    }
+    case DlColorFilterType::kSrgbToLinearGamma:
+      return DlSrgbToLinearGammaColorFilter::kInstance;
+    case DlColorFilterType::kLinearToSrgbGamma:
+      return DlLinearToSrgbGammaColorFilter::kInstance;
+  }
+  return nullptr;
+}
+
+bool WriteImageFilter(ByteWriter& writer, const DlImageFilter& filter) {
+  writer.Write(filter.type());
+  switch (filter.type()) {
+    case DlImageFilterType::kBlur:
+      writer.Write(filter.asBlur()->sigma_x());
+      writer.Write(filter.asBlur()->sigma_y());
+      writer.Write(filter.asBlur()->tile_mode());
+      return true;
+    case DlImageFilterType::kDilate:
+      writer.Write(filter.asDilate()->radius_x());
+      writer.Write(filter.asDilate()->radius_y());
+      return true;
+    case DlImageFilterType::kErode:
+      writer.Write(filter.asErode()->radius_x());
+      writer.Write(filter.asErode()->radius_y());
+      return true;
+    case DlImageFilterType::kMatrix:
+      WriteMatrix(writer, filter.asMatrix()->matrix());
+      writer.Write(filter.asMatrix()->sampling());
+      return true;
+    case DlImageFilterType::kCompose: {
+      auto outer = filter.asCompose()->outer();
+      auto inner = filter.asCompose()->inner();
+      return outer && inner && WriteImageFilter(writer, *outer) &&
+             WriteImageFilter(writer, *inner);
+    }
+    case DlImageFilterType::kColorFilter: {
+      auto color_filter = filter.asColorFilter()->color_filter();
+      return color_filter && WriteColorFilter(writer, *color_filter);
+    }
+    case DlImageFilterType::kLocalMatrix: {
+      auto image_filter = filter.asLocalMatrix()->image_filter();
+      WriteMatrix(writer, filter.asLocalMatrix()->matrix());
+      return image_filter && WriteImageFilter(writer, *image_filter);
+    }
+  }
+  return false;
+}
+
+// Reads an image filter that may contain other image filters up to |depth|
+// levels deep.
+std::shared_ptr<DlImageFilter> ReadImageFilter(ByteReader& reader,
+                                               int depth) {
+  DlImageFilterType type;
+  if (depth <= 0 || !reader.Read(type)) {
+    return nullptr;
+  }
+  switch (type) {
+    case DlImageFilterType::kBlur: {
+      SkScalar sigma_x;
+      SkScalar sigma_y;
+      DlTileMode tile_mode;
+      if (!reader.Read(sigma_x) || !reader.Read(sigma_y) ||
+          !reader.ReadEnum(tile_mode, DlTileMode::kDecal)) {
+        return nullptr;
+      }
+      return std::make_shared<DlBlurImageFilter>(sigma_x, sigma_y, tile_mode);
+    }
+    case DlImageFilterType::kDilate:
+    case DlImageFilterType::kErode: {
+      SkScalar radius_x;
+      SkScalar radius_y;
+      if (!reader.Read(radius_x) || !reader.Read(radius_y)) {
+        return nullptr;
+      }
+      if (type == DlImageFilterType::kDilate) {
+        return std::make_shared<DlDilateImageFilter>(radius_x, radius_y);
+      }
+      return std::make_shared<DlErodeImageFilter>(radius_x, radius_y);
+    }
+    case DlImageFilterType::kMatrix: {
+      SkMatrix matrix;
+      DlImageSampling sampling;
+      if (!ReadMatrix(reader, matrix) ||
+          !reader.ReadEnum(sampling, DlImageSampling::kCubic)) {
+        return nullptr;
+      }
+      return std::make_shared<DlMatrixImageFilter>(matrix, sampling);
+    }
+    case DlImageFilterType::kCompose: {
+      auto outer = ReadImageFilter(reader, depth - 1);
+      auto inner = outer ? ReadImageFilter(reader, depth - 1) : nullptr;
+      if (!inner) {
+        return nullptr;
+      }
+      return std::make_shared<DlComposeImageFilter>(outer, inner);
+    }
+    case DlImageFilterType::kColorFilter: {
+      auto color_filter = ReadColorFilter(reader);
+      if (!color_filter) {
+        return nullptr;
+      }
+      return std::make_shared<DlColorFilterImageFilter>(color_filter);
+    }
+    case DlImageFilterType::kLocalMatrix: {
+      SkMatrix matrix;
+      if (!ReadMatrix(reader, matrix)) {
+        return nullptr;
+      }
+      auto image_filter = ReadImageFilter(reader, depth - 1);
+      if (!image_filter) {
+        return nullptr;
+      }
+      return std::make_shared<DlLocalMatrixImageFilter>(matrix, image_filter);
+    }
+  }
+  return nullptr;
+}
+
+bool WriteMaskFilter(ByteWriter& writer, const DlMaskFilter& filter) {
+  writer.Write(filter.type());
+  switch (filter.type()) {
+    case DlMaskFilterType::kBlur:
+      writer.Write(filter.asBlur()->style());
+      writer.Write(filter.asBlur()->sigma());
+      writer.Write<uint32_t>(filter.asBlur()->respectCTM());
+      return true;
+  }
+  return false;
+}
+
+std::shared_ptr<DlMaskFilter> ReadMaskFilter(ByteReader& reader) {
+  DlMaskFilterType type;
+  if (!reader.Read(type)) {
+    return nullptr;
+  }
+  switch (type) {
+    case DlMaskFilterType::kBlur: {
+      DlBlurStyle style;
+      SkScalar sigma;
+      uint32_t respect_ctm;
+      if (!reader.ReadEnum(style, DlBlurStyle::kInner) ||
+          !reader.Read(sigma) || !reader.Read(respect_ctm)) {
+        return nullptr;
+      }
+      return std::make_shared<DlBlurMaskFilter>(style, sigma, respect_ctm);
+    }
+  }
+  return nullptr;
+}
+
+bool WritePathEffect(ByteWriter& writer, const DlPathEffect& effect) {
+  writer.Write(effect.type());
+  switch (effect.type()) {
+    case DlPathEffectType::kDash: {
+      const DlDashPathEffect* dash = effect.asDash();
+      writer.Write<int32_t>(dash->count());
+      writer.Write(dash->phase());
+      writer.Write(dash->intervals(), dash->count() * sizeof(SkScalar));
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<DlPathEffect> ReadPathEffect(ByteReader& reader) {
+  DlPathEffectType type;
+  if (!reader.Read(type)) {
+    return nullptr;
+  }
+  switch (type) {
+    case DlPathEffectType::kDash: {
+      int32_t count;
+      SkScalar phase;
+      if (!reader.Read(count) || count < 0 || !reader.Read(phase)) {
+        return nullptr;
+      }
+      const uint8_t* intervals = reader.ReadBytes(count * sizeof(SkScalar));
+      if (intervals == nullptr) {
+        return nullptr;
+      }
+      return DlDashPathEffect::Make(
+          reinterpret_cast<const SkScalar*>(intervals), count, phase);
+    }
+  }
+  return nullptr;
+}
+
+void WriteGradient(ByteWriter& writer,
+                   const DlGradientColorSourceBase& gradient) {
+  writer.Write(gradient.tile_mode());
+  writer.Write<uint32_t>(gradient.stop_count());
+  writer.Write(gradient.colors(), gradient.stop_count() * sizeof(DlColor));
+  writer.Write(gradient.stops(), gradient.stop_count() * sizeof(float));
+  WriteMatrix(writer, gradient.matrix());
+}
+
+// The parameters shared by all gradients. The colors and stops point into
+// the serialized data.
+struct GradientParameters {
+  DlTileMode tile_mode;
+  uint32_t stop_count;
+  const DlColor* colors;
+  const float* stops;
+  SkMatrix matrix;
+};
+
+bool ReadGradient(ByteReader& reader, GradientParameters& gradient) {
+  if (!reader.ReadEnum(gradient.tile_mode, DlTileMode::kDecal) ||
+      !reader.Read(gradient.stop_count)) {
+    return false;
+  }
+  size_t count = gradient.stop_count;
+  const uint8_t* colors = reader.ReadBytes(count * sizeof(DlColor));
+  const uint8_t* stops = reader.ReadBytes(count * sizeof(float));
+  if (colors == nullptr || stops == nullptr) {
+    return false;
+  }
+  gradient.colors = reinterpret_cast<const DlColor*>(colors);
+  gradient.stops = reinterpret_cast<const float*>(stops);
+  return ReadMatrix(reader, gradient.matrix);
+}
+
+std::shared_ptr<DlColorSource> ReadColorSource(
+    ByteReader& reader,
+    const std::vector<sk_sp<DlImage>>& images) {
+  DlColorSourceType type;
+  if (!reader.Read(type)) {
+    return nullptr;
+  }
+  GradientParameters gradient;
+  switch (type) {
+    case DlColorSourceType::kColor: {
+      DlColor color;
+      if (!reader.Read(color)) {
+        return nullptr;
+      }
+      return std::make_shared<DlColorColorSource>(color);
+    }
+    case DlColorSourceType::kImage: {
+      uint32_t image_index;
+      DlTileMode horizontal_tile_mode;
+      DlTileMode vertical_tile_mode;
+      DlImageSampling sampling;
+      SkMatrix matrix;
+      if (!reader.Read(image_index) || image_index >= images.size() ||
+          !reader.ReadEnum(horizontal_tile_mode, DlTileMode::kDecal) ||
+          !reader.ReadEnum(vertical_tile_mode, DlTileMode::kDecal) ||
+          !reader.ReadEnum(sampling, DlImageSampling::kCubic) ||
+          !ReadMatrix(reader, matrix)) {
+        return nullptr;
+      }
+      return std::make_shared<DlImageColorSource>(
+          images[image_index], horizontal_tile_mode, vertical_tile_mode,
+          sampling, &matrix);
+    }
+    case DlColorSourceType::kLinearGradient: {
+      SkPoint start_point;
+      SkPoint end_point;
+      if (!reader.Read(start_point) || !reader.Read(end_point) ||
+          !ReadGradient(reader, gradient)) {
+        return nullptr;
+      }
+      return DlColorSource::MakeLinear(
+          start_point, end_point, gradient.stop_count, gradient.colors,
+          gradient.stops, gradient.tile_mode, &gradient.matrix);
+    }
+    case DlColorSourceType::kRadialGradient: {
+      SkPoint center;
+      SkScalar radius;
+      if (!reader.Read(center) || !reader.Read(radius) ||
+          !ReadGradient(reader, gradient)) {
+        return nullptr;
+      }
+      return DlColorSource::MakeRadial(center, radius, gradient.stop_count,
+                                       gradient.colors, gradient.stops,
+                                       gradient.tile_mode, &gradient.matrix);
+    }
+    case DlColorSourceType::kConicalGradient: {
+      SkPoint start_center;
+      SkScalar start_radius;
+      SkPoint end_center;
+      SkScalar end_radius;
+      if (!reader.Read(start_center) || !reader.Read(start_radius) ||
+          !reader.Read(end_center) || !reader.Read(end_radius) ||
+          !ReadGradient(reader, gradient)) {
+        return nullptr;
+      }
+      return DlColorSource::MakeConical(
+          start_center, start_radius, end_center, end_radius,
+          gradient.stop_count, gradient.colors, gradient.stops,
+          gradient.tile_mode, &gradient.matrix);
+    }
+    case DlColorSourceType::kSweepGradient: {
+      SkPoint center;
+      SkScalar start;
+      SkScalar end;
+      if (!reader.Read(center) || !reader.Read(start) || !reader.Read(end) ||
+          !ReadGradient(reader, gradient)) {
+        return nullptr;
+      }
+      return DlColorSource::MakeSweep(center, start, end, gradient.stop_count,
+                                      gradient.colors, gradient.stops,
+                                      gradient.tile_mode, &gradient.matrix);
+    }
+    default:
+      return nullptr;
+  }
+}
+
+// Calls |load| with the data of each entry of the |section|, stopping at
+// the first entry for which it returns false.
+template <typename Load>
+bool ForEachEntry(const uint8_t* data,
+                  size_t size,
+                  const SectionHeader& section,
+                  const Load& load) {
+  if (!InRange(section.entries_offset,
+               static_cast<size_t>(section.count) * sizeof(EntryHeader),
+               size)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < section.count; i++) {
+    EntryHeader entry;
+    memcpy(&entry, data + section.entries_offset + i * sizeof(EntryHeader),
+           sizeof(entry));
+    if (!InRange(entry.offset, entry.size, size) ||
+        entry.offset % kAlignment != 0 ||
+        !load(data + entry.offset, entry.size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks the |vertices| drawn by a DrawVertices op, which are followed by
+// their arrays in the |size| bytes that start at them. The arrays must lie
+// within those bytes and the indices must refer to the vertices.
+bool ValidateVertices(const DlVertices& vertices, size_t size) {
+  if (size < sizeof(DlVertices) ||
+      !IsValidEnum(vertices.mode(), DlVertexMode::kTriangleFan) ||
+      vertices.vertex_count() < 0 || vertices.index_count() < 0 ||
+      vertices.size() > size) {
+    return false;
+  }
+  auto base = reinterpret_cast<const uint8_t*>(&vertices);
+  auto valid_array = [base, size](const void* array, size_t element_size,
+                                  size_t count, bool required) {
+    if (array == nullptr) {
+      return !required || count == 0;
+    }
+    size_t offset = static_cast<const uint8_t*>(array) - base;
+    return offset >= sizeof(DlVertices) &&
+           InRange(offset, element_size * count, size);
+  };
+  const size_t vertex_count = vertices.vertex_count();
+  const size_t index_count = vertices.index_count();
+  if (!valid_array(vertices.vertices(), sizeof(SkPoint), vertex_count,
+                   true) ||
+      !valid_array(vertices.texture_coordinates(), sizeof(SkPoint),
+                   vertex_count, false) ||
+      !valid_array(vertices.colors(), sizeof(DlColor), vertex_count, false) ||
+      !valid_array(vertices.indices(), sizeof(uint16_t), index_count,
+                   true)) {
+    return false;
+  }
+  const uint16_t* indices = vertices.indices();
+  for (size_t i = 0; i < index_count; i++) {
+    if (indices[i] >= vertex_count) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// Writes a DisplayList and, recursively, the DisplayLists that it draws.
+class SerializedDisplayList::Writer {
+ public:
+  explicit Writer(const DlImageHasher& hash_image) : hash_image_(hash_image) {}
+
+  bool Write(const DisplayList& display_list, std::vector<uint8_t>& data);
+
+ private:
+  // The entries of a resource section, each of which is stored only once
+  // no matter how often it is referred to.
+  class ResourceTable {
+   public:
+    uint32_t Add(std::string bytes) {
+      auto it = indices_.find(bytes);
+      if (it != indices_.end()) {
+        return it->second;
+      }
+      uint32_t index = entries_.size();
+      entries_.push_back(std::move(bytes));
+      indices_.emplace(entries_.back(), index);
+      return index;
+    }
+
+    const std::deque<std::string>& entries() const { return entries_; }
+
+   private:
+    // A deque never moves its elements, so the views keep pointing at them.
+    std::deque<std::string> entries_;
+    std::unordered_map<std::string_view, uint32_t> indices_;
+  };
+
+  const DlImageHasher& hash_image_;
+  std::vector<uint8_t> ops_;
+  uint32_t op_count_ = 0;
+  ResourceTable sections_[kSectionCount];
+
+  bool WriteOp(const DLOp* op);
+
+  void CopyOp(const DLOp* op) {
+    auto bytes = reinterpret_cast<const uint8_t*>(op);
+    ops_.insert(ops_.end(), bytes, bytes + op->size);
+  }
+
+  // Appends a zero-initialized record of type |T| followed by |pod_size|
+  // bytes for the op of the indicated |type|. The record is only valid
+  // until the next one is appended.
+  template <typename T, typename... Args>
+  T* AppendOp(DisplayListOpType type, size_t pod_size, Args&&... args) {
+    size_t size = SkAlignPtr(sizeof(T) + pod_size);
+    size_t offset = ops_.size();
+    ops_.resize(offset + size);
+    T* op = new (ops_.data() + offset) T{std::forward<Args>(args)...};
+    op->type = type;
+    op->size = size;
+    return op;
+  }
+
+  uint32_t AddPath(const SkPath& path) {
+    std::string bytes(path.writeToMemory(nullptr), '\0');
+    path.writeToMemory(bytes.data());
+    return sections_[kPathSection].Add(std::move(bytes));
+  }
+
+  std::optional<uint32_t> AddTextBlob(const SkTextBlob* blob) {
+    if (blob == nullptr) {
+      return std::nullopt;
+    }
+    sk_sp<SkData> data = blob->serialize(SkSerialProcs{});
+    if (!data) {
+      return std::nullopt;
+    }
+    return sections_[kTextBlobSection].Add(
+        std::string(static_cast<const char*>(data->data()), data->size()));
+  }
+
+  std::optional<uint32_t> AddImage(const DlImage* image) {
+    if (image == nullptr) {
+      return std::nullopt;
+    }
+    std::optional<uint64_t> hash = hash_image_(*image);
+    if (!hash.has_value()) {
+      return std::nullopt;
+    }
+    ByteWriter writer;
+    writer.Write(hash.value());
+    return sections_[kImageSection].Add(writer.TakeBytes());
+  }
+
+  std::optional<uint32_t> AddColorSource(const DlColorSource* source) {
+    ByteWriter writer;
+    if (source == nullptr || !WriteColorSource(writer, *source)) {
+      return std::nullopt;
+    }
+    return sections_[kColorSourceSection].Add(writer.TakeBytes());
+  }
+
+  template <typename T>
+  std::optional<uint32_t> AddEffect(
+      ResourceSection section,
+      const T* effect,
+      bool (*write)(ByteWriter& writer, const T& effect)) {
+    ByteWriter writer;
+    if (effect == nullptr || !write(writer, *effect)) {
+      return std::nullopt;
+    }
+    return sections_[section].Add(writer.TakeBytes());
+  }
+
+  std::optional<uint32_t> AddDisplayList(const DisplayList* display_list) {
+    std::vector<uint8_t> data;
+    if (display_list == nullptr ||
+        !Writer(hash_image_).Write(*display_list, data)) {
+      return std::nullopt;
+    }
+    return sections_[kDisplayListSection].Add(
+        std::string(data.begin(), data.end()));
+  }
+
+  bool WriteColorSource(ByteWriter& writer, const DlColorSource& source) {
+    writer.Write(source.type());
+    switch (source.type()) {
+      case DlColorSourceType::kColor:
+        writer.Write(source.asColor()->color());
+        return true;
+      case DlColorSourceType::kImage: {
+        const DlImageColorSource* image = source.asImage();
+        std::optional<uint32_t> index = AddImage(image->image().get());
+        if (!index.has_value()) {
+          return false;
+        }
+        writer.Write(index.value());
+        writer.Write(image->horizontal_tile_mode());
+        writer.Write(image->vertical_tile_mode());
+        writer.Write(image->sampling());
+        WriteMatrix(writer, image->matrix());
+        return true;
+      }
+      case DlColorSourceType::kLinearGradient: {
+        auto gradient = source.asLinearGradient();
+        writer.Write(gradient->start_point());
+        writer.Write(gradient->end_point());
+        WriteGradient(writer, *gradient);
+        return true;
+      }
+      case DlColorSourceType::kRadialGradient: {
+        auto gradient = source.asRadialGradient();
+        writer.Write(gradient->center());
+        writer.Write(gradient->radius());
+        WriteGradient(writer, *gradient);
+        return true;
+      }
+      case DlColorSourceType::kConicalGradient: {
+        auto gradient = source.asConicalGradient();
+        writer.Write(gradient->start_center());
+        writer.Write(gradient->start_radius());
+        writer.Write(gradient->end_center());
+        writer.Write(gradient->end_radius());
+        WriteGradient(writer, *gradient);
+        return true;
+      }
+      case DlColorSourceType::kSweepGradient: {
+        auto gradient = source.asSweepGradient();
+        writer.Write(gradient->center());
+        writer.Write(gradient->start());
+        writer.Write(gradient->end());
+        WriteGradient(writer, *gradient);
+        return true;
+      }
+      default:
+        // Runtime effects and scenes refer to objects that only exist in
+        // the running application.
+        return false;
+    }
+  }
+
+  template <typename T>
+  bool WriteSetRefOp(const DLOp* op, std::optional<uint32_t> index) {
+    if (!index.has_value()) {
+      return false;
+    }
+    AppendOp<T>(op->type, 0)->index = index.value();
+    return true;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
+bool SerializedDisplayList::Writer::WriteOp(const DLOp* op) {
+  switch (op->type) {
+#define DL_OP_CASE(name) case DisplayListOpType::k##name:
+    FOR_EACH_FLAT_DISPLAY_LIST_OP(DL_OP_CASE)
+#undef DL_OP_CASE
+    CopyOp(op);
+    return true;
+
+#define DL_POD_ATTRIBUTE_OP(name, section, write)                          \
+  case DisplayListOpType::kSetPod##name: {                                 \
+    auto attribute = reinterpret_cast<const Dl##name*>(                    \
+        static_cast<const SetPod##name##Op*>(op) + 1);                     \
+    return WriteSetRefOp<Set##name##RefOp>(                                \
+        op, AddEffect<Dl##name>(section, attribute, write));               \
+  }
+    DL_POD_ATTRIBUTE_OP(ColorFilter, kColorFilterSection, WriteColorFilter)
+    DL_POD_ATTRIBUTE_OP(ImageFilter, kImageFilterSection, WriteImageFilter)
+    DL_POD_ATTRIBUTE_OP(MaskFilter, kMaskFilterSection, WriteMaskFilter)
+    DL_POD_ATTRIBUTE_OP(PathEffect, kPathEffectSection, WritePathEffect)
+#undef DL_POD_ATTRIBUTE_OP
+
+    case DisplayListOpType::kSetPodColorSource:
+      return WriteSetRefOp<SetColorSourceRefOp>(
+          op, AddColorSource(reinterpret_cast<const DlColorSource*>(
+                  static_cast<const SetPodColorSourceOp*>(op) + 1)));
+    case DisplayListOpType::kSetImageColorSource:
+      return WriteSetRefOp<SetColorSourceRefOp>(
+          op, AddColorSource(
+                  &static_cast<const SetImageColorSourceOp*>(op)->source));
+    case DisplayListOpType::kSetSharedImageFilter:
+      // Stored like any other image filter, as it is set the same way.
+      return WriteSetRefOp<SetImageFilterRefOp>(
+          op, AddEffect<DlImageFilter>(
+                  kImageFilterSection,
+                  static_cast<const SetSharedImageFilterOp*>(op)->filter.get(),
+                  WriteImageFilter));
+
+    case DisplayListOpType::kSaveLayerBackdrop:
+    case DisplayListOpType::kSaveLayerBackdropBounds: {
+      const DlImageFilter* backdrop;
+      SkRect rect = SkRect::MakeEmpty();
+      if (op->type == DisplayListOpType::kSaveLayerBackdrop) {
+        backdrop = static_cast<const SaveLayerBackdropOp*>(op)->backdrop.get();
+      } else {
+        auto bounds_op = static_cast<const SaveLayerBackdropBoundsOp*>(op);
+        backdrop = bounds_op->backdrop.get();
+        rect = bounds_op->rect;
+      }
+      std::optional<uint32_t> index =
+          AddEffect(kImageFilterSection, backdrop, WriteImageFilter);
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<SaveLayerBackdropRefOp>(
+          op->type, 0, static_cast<const SaveOpBase*>(op));
+      ref->rect = rect;
+      ref->backdrop_index = index.value();
+      return true;
+    }
+
+    case DisplayListOpType::kClipIntersectPath:
+    case DisplayListOpType::kClipDifferencePath: {
+      // Both clip ops have the same layout.
+      auto clip = static_cast<const ClipIntersectPathOp*>(op);
+      uint32_t index = AddPath(clip->path);
+      auto ref = AppendOp<ClipPathRefOp>(op->type, 0);
+      ref->is_aa = clip->is_aa;
+      ref->path_index = index;
+      return true;
+    }
+
+    case DisplayListOpType::kDrawPath:
+      AppendOp<DrawPathRefOp>(op->type, 0)->path_index =
+          AddPath(static_cast<const DrawPathOp*>(op)->path);
+      return true;
+
+    case DisplayListOpType::kDrawShadow:
+    case DisplayListOpType::kDrawShadowTransparentOccluder: {
+      // Both shadow ops have the same layout.
+      auto shadow = static_cast<const DrawShadowOp*>(op);
+      uint32_t index = AddPath(shadow->path);
+      auto ref = AppendOp<DrawShadowRefOp>(op->type, 0);
+      ref->color = shadow->color;
+      ref->elevation = shadow->elevation;
+      ref->dpr = shadow->dpr;
+      ref->path_index = index;
+      return true;
+    }
+
+    case DisplayListOpType::kDrawImage:
+    case DisplayListOpType::kDrawImageWithAttr: {
+      // Both image ops have the same layout.
+      auto image = static_cast<const DrawImageOp*>(op);
+      std::optional<uint32_t> index = AddImage(image->image.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<DrawImageRefOp>(op->type, 0);
+      ref->point = image->point;
+      ref->sampling = image->sampling;
+      ref->image_index = index.value();
+      return true;
+    }
+
+    case DisplayListOpType::kDrawImageRect: {
+      auto image = static_cast<const DrawImageRectOp*>(op);
+      std::optional<uint32_t> index = AddImage(image->image.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<DrawImageRectRefOp>(op->type, 0);
+      ref->src = image->src;
+      ref->dst = image->dst;
+      ref->sampling = image->sampling;
+      ref->render_with_attributes = image->render_with_attributes;
+      ref->constraint = image->constraint;
+      ref->image_index = index.value();
+      return true;
+    }
+
+    case DisplayListOpType::kDrawImageNine:
+    case DisplayListOpType::kDrawImageNineWithAttr: {
+      // Both image nine ops have the same layout.
+      auto image = static_cast<const DrawImageNineOp*>(op);
+      std::optional<uint32_t> index = AddImage(image->image.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<DrawImageNineRefOp>(op->type, 0);
+      ref->center = image->center;
+      ref->dst = image->dst;
+      ref->mode = image->mode;
+      ref->image_index = index.value();
+      return true;
+    }
+
+    case DisplayListOpType::kDrawAtlas:
+    case DisplayListOpType::kDrawAtlasCulled: {
+      const DrawAtlasBaseOp* atlas;
+      const void* pod;
+      SkRect cull_rect = SkRect::MakeEmpty();
+      if (op->type == DisplayListOpType::kDrawAtlas) {
+        auto atlas_op = static_cast<const DrawAtlasOp*>(op);
+        atlas = atlas_op;
+        pod = atlas_op + 1;
+      } else {
+        auto atlas_op = static_cast<const DrawAtlasCulledOp*>(op);
+        atlas = atlas_op;
+        pod = atlas_op + 1;
+        cull_rect = atlas_op->cull_rect;
+      }
+      std::optional<uint32_t> index = AddImage(atlas->atlas.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      size_t pod_size = atlas->count * (sizeof(SkRSXform) + sizeof(SkRect));
+      if (atlas->has_colors) {
+        pod_size += atlas->count * sizeof(DlColor);
+      }
+      auto ref = AppendOp<DrawAtlasRefOp>(op->type, pod_size);
+      ref->count = atlas->count;
+      ref->mode_index = atlas->mode_index;
+      ref->has_colors = atlas->has_colors;
+      ref->render_with_attributes = atlas->render_with_attributes;
+      ref->sampling = atlas->sampling;
+      ref->atlas_index = index.value();
+      ref->cull_rect = cull_rect;
+      memcpy(ref + 1, pod, pod_size);
+      return true;
+    }
+
+    case DisplayListOpType::kDrawDisplayList: {
+      auto draw = static_cast<const DrawDisplayListOp*>(op);
+      std::optional<uint32_t> index = AddDisplayList(draw->display_list.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<DrawDisplayListRefOp>(op->type, 0);
+      ref->opacity = draw->opacity;
+      ref->index = index.value();
+      return true;
+    }
+
+    case DisplayListOpType::kDrawTextBlob: {
+      auto draw = static_cast<const DrawTextBlobOp*>(op);
+      std::optional<uint32_t> index = AddTextBlob(draw->blob.get());
+      if (!index.has_value()) {
+        return false;
+      }
+      auto ref = AppendOp<DrawTextBlobRefOp>(op->type, 0);
+      ref->x = draw->x;
+      ref->y = draw->y;
+      ref->index = index.value();
+      return true;
+    }
+
+    default:
+      // Runtime effects, scenes and text frames refer to objects that only
+      // exist in the running application.
+      return false;
+  }
+}
+
+bool SerializedDisplayList::Writer::Write(const DisplayList& display_list,
+                                          std::vector<uint8_t>& data) {
+  const DisplayListStorage& storage = display_list.storage_;
+  ops_.reserve(storage.size());
+  for (auto block = storage.head(); block != nullptr; block = block->next()) {
+    uint8_t* ptr = block->begin();
+    uint8_t* end = block->end();
+    while (ptr < end) {
+      auto op = reinterpret_cast<const DLOp*>(ptr);
+      ptr += op->size;
+      if (!WriteOp(op)) {
+        return false;
+      }
+      op_count_++;
+    }
+  }
+
+  SerializedHeader header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.op_layout = kOpLayoutFingerprint;
+  header.flags = display_list.has_rtree() ? kHasRTreeFlag : 0;
+  header.op_count = op_count_;
+  header.bounds = display_list.bounds();
+
+  // Lay out the ops and then the resource sections, each entry table
+  // followed by the data of its entries.
+  size_t size = Align(sizeof(SerializedHeader));
+  header.ops_offset = size;
+  header.ops_size = ops_.size();
+  size = Align(size + ops_.size());
+  for (uint32_t section = 0; section < kSectionCount; section++) {
+    const auto& entries = sections_[section].entries();
+    header.sections[section].entries_offset = size;
+    header.sections[section].count = entries.size();
+    size = Align(size + entries.size() * sizeof(EntryHeader));
+    for (const std::string& entry : entries) {
+      size = Align(size + entry.size());
+    }
+  }
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  header.size = size;
+
+  data.assign(size, 0);
+  memcpy(data.data(), &header, sizeof(header));
+  memcpy(data.data() + header.ops_offset, ops_.data(), ops_.size());
+  for (uint32_t section = 0; section < kSectionCount; section++) {
+    const auto& entries = sections_[section].entries();
+    size_t entries_offset = header.sections[section].entries_offset;
+    size_t offset =
+        Align(entries_offset + entries.size() * sizeof(EntryHeader));
+    for (size_t i = 0; i < entries.size(); i++) {
+      EntryHeader entry = {
+          .offset = static_cast<uint32_t>(offset),
+          .size = static_cast<uint32_t>(entries[i].size()),
+      };
+      memcpy(data.data() + entries_offset + i * sizeof(EntryHeader), &entry,
+             sizeof(entry));
+      memcpy(data.data() + offset, entries[i].data(), entries[i].size());
+      offset = Align(offset + entries[i].size());
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> SerializedDisplayList::Serialize(
+    const DisplayList& display_list,
+    const DlImageHasher& hash_image) {
+  TRACE_EVENT0("flutter", "SerializedDisplayList::Serialize");
+  std::vector<uint8_t> data;
+  if (!Writer(hash_image).Write(display_list, data)) {
+    return nullptr;
+  }
+  return std::make_unique<fml::DataMapping>(std::move(data));
+}
+
+std::unique_ptr<SerializedDisplayList> SerializedDisplayList::Load(
+    std::shared_ptr<const fml::Mapping> mapping,
+    const DlImageResolver& resolve_image) {
+  TRACE_EVENT0("flutter", "SerializedDisplayList::Load");
+  if (!mapping || mapping->GetMapping() == nullptr) {
+    return nullptr;
+  }
+  const uint8_t* data = mapping->GetMapping();
+  size_t size = mapping->GetSize();
+  return LoadFrom(std::move(mapping), data, size, resolve_image,
+                  kMaxDisplayListDepth);
+}
+
+std::unique_ptr<SerializedDisplayList> SerializedDisplayList::LoadFrom(
+    std::shared_ptr<const fml::Mapping> mapping,
+    const uint8_t* data,
+    size_t size,
+    const DlImageResolver& resolve_image,
+    int depth) {
+  // The op records are dispatched in place and must be aligned as they
+  // were when they were recorded.
+  if (depth <= 0 || reinterpret_cast<uintptr_t>(data) % kAlignment != 0 ||
+      size < sizeof(SerializedHeader)) {
+    return nullptr;
+  }
+  SerializedHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.op_layout != kOpLayoutFingerprint || header.size != size ||
+      header.ops_offset % kAlignment != 0 ||
+      !InRange(header.ops_offset, header.ops_size, size)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<SerializedDisplayList> result(new SerializedDisplayList());
+  result->mapping_ = std::move(mapping);
+  result->ops_begin_ = data + header.ops_offset;
+  result->ops_end_ = result->ops_begin_ + header.ops_size;
+  result->op_count_ = header.op_count;
+  result->bounds_ = header.bounds;
+  result->has_rtree_ = (header.flags & kHasRTreeFlag) != 0;
+  if (!result->LoadResources(data, size, resolve_image, depth) ||
+      !result->ValidateOps()) {
+    return nullptr;
+  }
+  return result;
+}
+
+SerializedDisplayList::~SerializedDisplayList() = default;
+
+bool SerializedDisplayList::LoadResources(
+    const uint8_t* data,
+    size_t size,
+    const DlImageResolver& resolve_image,
+    int depth) {
+  SerializedHeader header;
+  memcpy(&header, data, sizeof(header));
+  const SectionHeader* sections = header.sections;
+
+  auto load_effect = [&](ResourceSection section, auto& table, auto read) {
+    table.reserve(sections[section].count);
+    return ForEachEntry(data, size, sections[section],
+                        [&](const uint8_t* entry, size_t entry_size) {
+                          ByteReader reader(entry, entry_size);
+                          auto effect = read(reader);
+                          if (!effect) {
+                            return false;
+                          }
+                          table.push_back(std::move(effect));
+                          return true;
+                        });
+  };
+
+  paths_.reserve(sections[kPathSection].count);
+  text_blobs_.reserve(sections[kTextBlobSection].count);
+  images_.reserve(sections[kImageSection].count);
+  display_lists_.reserve(sections[kDisplayListSection].count);
+  return ForEachEntry(data, size, sections[kPathSection],
+                      [&](const uint8_t* entry, size_t entry_size) {
+                        SkPath path;
+                        if (path.readFromMemory(entry, entry_size) == 0) {
+                          return false;
+                        }
+                        paths_.push_back(std::move(path));
+                        return true;
+                      }) &&
+         ForEachEntry(data, size, sections[kTextBlobSection],
+                      [&](const uint8_t* entry, size_t entry_size) {
+                        sk_sp<SkTextBlob> blob = SkTextBlob::Deserialize(
+                            entry, entry_size, SkDeserialProcs{});
+                        if (!blob) {
+                          return false;
+                        }
+                        text_blobs_.push_back(std::move(blob));
+                        return true;
+                      }) &&
+         ForEachEntry(data, size, sections[kImageSection],
+                      [&](const uint8_t* entry, size_t entry_size) {
+                        uint64_t hash;
+                        ByteReader reader(entry, entry_size);
+                        sk_sp<DlImage> image;
+                        if (!reader.Read(hash) ||
+                            !(image = resolve_image(hash))) {
+                          return false;
+                        }
+                        images_.push_back(std::move(image));
+                        return true;
+                      }) &&
+         load_effect(kColorSourceSection, color_sources_,
+                     [this](ByteReader& reader) {
+                       return ReadColorSource(reader, images_);
+                     }) &&
+         load_effect(kColorFilterSection, color_filters_, ReadColorFilter) &&
+         load_effect(kImageFilterSection, image_filters_,
+                     [](ByteReader& reader) {
+                       return ReadImageFilter(reader, kMaxImageFilterDepth);
+                     }) &&
+         load_effect(kMaskFilterSection, mask_filters_, ReadMaskFilter) &&
+         load_effect(kPathEffectSection, path_effects_, ReadPathEffect) &&
+         ForEachEntry(data, size, sections[kDisplayListSection],
+                      [&](const uint8_t* entry, size_t entry_size) {
+                        auto nested = LoadFrom(mapping_, entry, entry_size,
+                                               resolve_image, depth - 1);
+                        if (!nested) {
+                          return false;
+                        }
+                        display_lists_.push_back(nested->Build());
+                        return true;
+                      });
+}
+
+bool SerializedDisplayList::ValidateOps() const {
+  unsigned int op_count = 0;
+  int save_depth = 0;
+  const uint8_t* ptr = ops_begin_;
+  while (ptr < ops_end_) {
+    size_t remaining = ops_end_ - ptr;
+    if (remaining < sizeof(DLOp)) {
+      return false;
+    }
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    if (op->size < sizeof(DLOp) || op->size > remaining ||
+        op->size % alignof(void*) != 0) {
+      return false;
+    }
+    ptr += op->size;
+    op_count++;
+
+    // The size of the record including any data that follows it, and the
+    // index of the resource it refers to along with the number of such
+    // resources, if any.
+    size_t size = 0;
+    size_t index = 0;
+    size_t table_size = 1;
+    switch (op->type) {
+#define DL_OP_SIZE(name)              \
+  case DisplayListOpType::k##name:    \
+    size = sizeof(name##Op);          \
+    break;
+      FOR_EACH_FLAT_DISPLAY_LIST_OP(DL_OP_SIZE)
+#undef DL_OP_SIZE
+
+#define DL_SET_REF_OP_SIZE(name, table)                            \
+  size = sizeof(Set##name##RefOp);                                 \
+  index = static_cast<const Set##name##RefOp*>(op)->index;         \
+  table_size = table.size();                                       \
+  break;
+      case DisplayListOpType::kSetPodColorSource:
+      case DisplayListOpType::kSetImageColorSource:
+        DL_SET_REF_OP_SIZE(ColorSource, color_sources_)
+      case DisplayListOpType::kSetPodColorFilter:
+        DL_SET_REF_OP_SIZE(ColorFilter, color_filters_)
+      case DisplayListOpType::kSetPodImageFilter:
+      case DisplayListOpType::kSetSharedImageFilter:
+        DL_SET_REF_OP_SIZE(ImageFilter, image_filters_)
+      case DisplayListOpType::kSetPodMaskFilter:
+        DL_SET_REF_OP_SIZE(MaskFilter, mask_filters_)
+      case DisplayListOpType::kSetPodPathEffect:
+        DL_SET_REF_OP_SIZE(PathEffect, path_effects_)
+#undef DL_SET_REF_OP_SIZE
+
+      case DisplayListOpType::kSaveLayerBackdrop:
+      case DisplayListOpType::kSaveLayerBackdropBounds:
+        size = sizeof(SaveLayerBackdropRefOp);
+        index = static_cast<const SaveLayerBackdropRefOp*>(op)->backdrop_index;
+        table_size = image_filters_.size();
+        break;
+      case DisplayListOpType::kClipIntersectPath:
+      case DisplayListOpType::kClipDifferencePath:
+        size = sizeof(ClipPathRefOp);
+        index = static_cast<const ClipPathRefOp*>(op)->path_index;
+        table_size = paths_.size();
+        break;
+      case DisplayListOpType::kDrawPath:
+        size = sizeof(DrawPathRefOp);
+        index = static_cast<const DrawPathRefOp*>(op)->path_index;
+        table_size = paths_.size();
+        break;
+      case DisplayListOpType::kDrawShadow:
+      case DisplayListOpType::kDrawShadowTransparentOccluder:
+        size = sizeof(DrawShadowRefOp);
+        index = static_cast<const DrawShadowRefOp*>(op)->path_index;
+        table_size = paths_.size();
+        break;
+      case DisplayListOpType::kDrawImage:
+      case DisplayListOpType::kDrawImageWithAttr:
+        size = sizeof(DrawImageRefOp);
+        index = static_cast<const DrawImageRefOp*>(op)->image_index;
+        table_size = images_.size();
+        break;
+      case DisplayListOpType::kDrawImageRect:
+        size = sizeof(DrawImageRectRefOp);
+        index = static_cast<const DrawImageRectRefOp*>(op)->image_index;
+        table_size = images_.size();
+        break;
+      case DisplayListOpType::kDrawImageNine:
+      case DisplayListOpType::kDrawImageNineWithAttr:
+        size = sizeof(DrawImageNineRefOp);
+        index = static_cast<const DrawImageNineRefOp*>(op)->image_index;
+        table_size = images_.size();
+        break;
+      case DisplayListOpType::kDrawAtlas:
+      case DisplayListOpType::kDrawAtlasCulled: {
+        auto atlas = static_cast<const DrawAtlasRefOp*>(op);
+        if (op->size < sizeof(DrawAtlasRefOp) || atlas->count < 0) {
+          return false;
+        }
+        size = sizeof(DrawAtlasRefOp) + atlas->pod_size();
+        index = atlas->atlas_index;
+        table_size = images_.size();
+        break;
+      }
+      case DisplayListOpType::kDrawDisplayList:
+        size = sizeof(DrawDisplayListRefOp);
+        index = static_cast<const DrawDisplayListRefOp*>(op)->index;
+        table_size = display_lists_.size();
+        break;
+      case DisplayListOpType::kDrawTextBlob:
+        size = sizeof(DrawTextBlobRefOp);
+        index = static_cast<const DrawTextBlobRefOp*>(op)->index;
+        table_size = text_blobs_.size();
+        break;
+      default:
+        return false;
+    }
+    if (op->size < size || index >= table_size) {
+      return false;
+    }
+
+    // Check the enums, the data that follows the records of variable size,
+    // and that every restore has a save to pop.
+    bool valid = true;
+    switch (op->type) {
+      case DisplayListOpType::kSetStrokeCap:
+        valid = IsValidEnum(static_cast<const SetStrokeCapOp*>(op)->value,
+                            DlStrokeCap::kLastCap);
+        break;
+      case DisplayListOpType::kSetStrokeJoin:
+        valid = IsValidEnum(static_cast<const SetStrokeJoinOp*>(op)->value,
+                            DlStrokeJoin::kLastJoin);
+        break;
+      case DisplayListOpType::kSetStyle:
+        valid = IsValidEnum(static_cast<const SetStyleOp*>(op)->style,
+                            DlDrawStyle::kLastStyle);
+        break;
+      case DisplayListOpType::kSetBlendMode:
+        valid = IsValidEnum(static_cast<const SetBlendModeOp*>(op)->mode,
+                            DlBlendMode::kLastMode);
+        break;
+      case DisplayListOpType::kDrawColor:
+        valid = IsValidEnum(static_cast<const DrawColorOp*>(op)->mode,
+                            DlBlendMode::kLastMode);
+        break;
+      case DisplayListOpType::kDrawPoints:
+      case DisplayListOpType::kDrawLines:
+      case DisplayListOpType::kDrawPolygon:
+        // All of the point ops have the same layout.
+        size += static_cast<const DrawPointsOp*>(op)->count * sizeof(SkPoint);
+        break;
+      case DisplayListOpType::kDrawVertices: {
+        auto draw = static_cast<const DrawVerticesOp*>(op);
+        valid = IsValidEnum(draw->mode, DlBlendMode::kLastMode) &&
+                ValidateVertices(*reinterpret_cast<const DlVertices*>(draw + 1),
+                                 op->size - sizeof(DrawVerticesOp));
+        break;
+      }
+      case DisplayListOpType::kDrawImage:
+      case DisplayListOpType::kDrawImageWithAttr:
+        valid = IsValidEnum(static_cast<const DrawImageRefOp*>(op)->sampling,
+                            DlImageSampling::kCubic);
+        break;
+      case DisplayListOpType::kDrawImageRect: {
+        auto image = static_cast<const DrawImageRectRefOp*>(op);
+        valid = IsValidEnum(image->sampling, DlImageSampling::kCubic) &&
+                IsValidEnum(image->constraint,
+                            DlCanvas::SrcRectConstraint::kFast);
+        break;
+      }
+      case DisplayListOpType::kDrawImageNine:
+      case DisplayListOpType::kDrawImageNineWithAttr:
+        valid = IsValidEnum(static_cast<const DrawImageNineRefOp*>(op)->mode,
+                            DlFilterMode::kLast);
+        break;
+      case DisplayListOpType::kDrawAtlas:
+      case DisplayListOpType::kDrawAtlasCulled: {
+        auto atlas = static_cast<const DrawAtlasRefOp*>(op);
+        valid = atlas->mode_index <=
+                    static_cast<uint16_t>(DlBlendMode::kLastMode) &&
+                IsValidEnum(atlas->sampling, DlImageSampling::kCubic);
+        break;
+      }
+      case DisplayListOpType::kSave:
+      case DisplayListOpType::kSaveLayer:
+      case DisplayListOpType::kSaveLayerBounds:
+      case DisplayListOpType::kSaveLayerBackdrop:
+      case DisplayListOpType::kSaveLayerBackdropBounds:
+        save_depth++;
+        break;
+      case DisplayListOpType::kRestore:
+        if (--save_depth < 0) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+    if (!valid || op->size < size) {
+      return false;
+    }
+  }
+  return op_count == op_count_;
+}
+
+void SerializedDisplayList::Dispatch(DlOpReceiver& receiver) const {
+  DispatchContext context = {
+      .receiver = receiver,
+      .cur_index = 0,
+      // All of the ops are dispatched, as they are by a DisplayList that
+      // is dispatched without a cull rect.
+      .next_render_index = 0,
+      .next_restore_index = std::numeric_limits<int>::max(),
+  };
+  const uint8_t* ptr = ops_begin_;
+  while (ptr < ops_end_) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    switch (op->type) {
+#define DL_OP_DISPATCH(name)                             \
+  case DisplayListOpType::k##name:                       \
+    static_cast<const name##Op*>(op)->dispatch(context); \
+    break;
+
+      FOR_EACH_FLAT_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+
+#undef DL_OP_DISPATCH
+
+#define DL_SET_REF_OP_DISPATCH(name, table)                           \
+  static_cast<const Set##name##RefOp*>(op)->dispatch(context, table); \
+  break;
+      case DisplayListOpType::kSetPodColorSource:
+      case DisplayListOpType::kSetImageColorSource:
+        DL_SET_REF_OP_DISPATCH(ColorSource, color_sources_)
+      case DisplayListOpType::kSetPodColorFilter:
+        DL_SET_REF_OP_DISPATCH(ColorFilter, color_filters_)
+      case DisplayListOpType::kSetPodImageFilter:
+      case DisplayListOpType::kSetSharedImageFilter:
+        DL_SET_REF_OP_DISPATCH(ImageFilter, image_filters_)
+      case DisplayListOpType::kSetPodMaskFilter:
+        DL_SET_REF_OP_DISPATCH(MaskFilter, mask_filters_)
+      case DisplayListOpType::kSetPodPathEffect:
+        DL_SET_REF_OP_DISPATCH(PathEffect, path_effects_)
+#undef DL_SET_REF_OP_DISPATCH
+
+      case DisplayListOpType::kSaveLayerBackdrop:
+      case DisplayListOpType::kSaveLayerBackdropBounds:
+        static_cast<const SaveLayerBackdropRefOp*>(op)->dispatch(
+            context, image_filters_,
+            op->type == DisplayListOpType::kSaveLayerBackdropBounds);
+        break;
+      case DisplayListOpType::kClipIntersectPath:
+        static_cast<const ClipPathRefOp*>(op)->dispatch(
+            context, paths_, DlCanvas::ClipOp::kIntersect);
+        break;
+      case DisplayListOpType::kClipDifferencePath:
+        static_cast<const ClipPathRefOp*>(op)->dispatch(
+            context, paths_, DlCanvas::ClipOp::kDifference);
+        break;
+      case DisplayListOpType::kDrawPath:
+        static_cast<const DrawPathRefOp*>(op)->dispatch(context, paths_);
+        break;
+      case DisplayListOpType::kDrawShadow:
+      case DisplayListOpType::kDrawShadowTransparentOccluder:
+        static_cast<const DrawShadowRefOp*>(op)->dispatch(
+            context, paths_,
+            op->type == DisplayListOpType::kDrawShadowTransparentOccluder);
+        break;
+      case DisplayListOpType::kDrawImage:
+      case DisplayListOpType::kDrawImageWithAttr:
+        static_cast<const DrawImageRefOp*>(op)->dispatch(
+            context, images_,
+            op->type == DisplayListOpType::kDrawImageWithAttr);
+        break;
+      case DisplayListOpType::kDrawImageRect:
+        static_cast<const DrawImageRectRefOp*>(op)->dispatch(context,
+                                                             images_);
+        break;
+      case DisplayListOpType::kDrawImageNine:
+      case DisplayListOpType::kDrawImageNineWithAttr:
+        static_cast<const DrawImageNineRefOp*>(op)->dispatch(
+            context, images_,
+            op->type == DisplayListOpType::kDrawImageNineWithAttr);
+        break;
+      case DisplayListOpType::kDrawAtlas:
+      case DisplayListOpType::kDrawAtlasCulled:
+        static_cast<const DrawAtlasRefOp*>(op)->dispatch(
+            context, images_,
+            op->type == DisplayListOpType::kDrawAtlasCulled);
+        break;
+      case DisplayListOpType::kDrawDisplayList:
+        static_cast<const DrawDisplayListRefOp*>(op)->dispatch(
+            context, display_lists_);
+        break;
+      case DisplayListOpType::kDrawTextBlob:
+        static_cast<const DrawTextBlobRefOp*>(op)->dispatch(context,
+                                                            text_blobs_);
+        break;
+
+      default:
+        FML_DCHECK(false);
+        return;
+    }
+    context.cur_index++;
+  }
+}
+
+sk_sp<DisplayList> SerializedDisplayList::Build() const {
+  DisplayListBuilder builder(has_rtree_);
+  Dispatch(builder.asReceiver());
+  return builder.Build();
+}
+
+}  // namespace flutter
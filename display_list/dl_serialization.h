@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
+#define FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/dl_op_receiver.h"
+#include "flutter/display_list/effects/dl_color_filter.h"
+#include "flutter/display_list/effects/dl_color_source.h"
+#include "flutter/display_list/effects/dl_image_filter.h"
+#include "flutter/display_list/effects/dl_mask_filter.h"
+#include "flutter/display_list/effects/dl_path_effect.h"
+#include "flutter/display_list/image/dl_image.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace flutter {
+
+/// Computes the hash of the contents of an image by which a serialized
+/// DisplayList refers to it, or returns std::nullopt if the image cannot
+/// be referred to.
+using DlImageHasher =
+    std::function<std::optional<uint64_t>(const DlImage& image)>;
+
+/// Returns the image whose contents have the indicated hash, or nullptr if
+/// there is no such image.
+using DlImageResolver = std::function<sk_sp<DlImage>(uint64_t hash)>;
+
+//------------------------------------------------------------------------------
+/// @brief      A DisplayList in a flat serialized form that dispatches its
+///             ops directly from the memory holding it, typically an
+///             |fml::FileMapping| of a file that an earlier run of the
+///             application wrote to disk.
+///
+/// The serialized form starts with a versioned header followed by the op
+/// records and a number of resource sections. Ops that only hold numbers,
+/// such as attribute changes, transforms, clips and simple shapes, are
+/// stored as the very records of dl_op_records.h and are dispatched in
+/// place. Ops that refer to objects, such as paths, text blobs, images,
+/// effects and nested DisplayLists, are stored as records that index into
+/// the resource sections instead. Resources are stored once per distinct
+/// content, and images are only stored as the hash of their contents so
+/// that they can be decoded by the application when loading.
+///
+/// Loading decodes the resources into objects but never copies the op
+/// records. The op records are only valid for the build that wrote them,
+/// which is checked against a fingerprint of the layout of the records
+/// in the header, so the serialized form is meant as a cache that is
+/// regenerated when the engine changes rather than as a transfer format.
+///
+/// Runtime effects, scene color sources and text frames cannot be
+/// serialized.
+class SerializedDisplayList {
+ public:
+  /// The version of the serialized form, which changes whenever the
+  /// layout of the header or of the resource sections changes.
+  static constexpr uint32_t kVersion = 1;
+
+  /// Serializes the |display_list|, using |hash_image| to compute the
+  /// references to the images that it draws. Returns nullptr if the
+  /// DisplayList contains ops that cannot be serialized.
+  static std::unique_ptr<fml::Mapping> Serialize(
+      const DisplayList& display_list,
+      const DlImageHasher& hash_image);
+
+  /// Loads a DisplayList that was serialized by |Serialize| from the
+  /// |mapping|, which must remain unchanged for the lifetime of the
+  /// returned object. The images are looked up with |resolve_image|.
+  ///
+  /// Returns nullptr if the mapping does not hold a DisplayList in the
+  /// serialized form of this build, if the data is malformed, or if any
+  /// of the resources fail to load.
+  static std::unique_ptr<SerializedDisplayList> Load(
+      std::shared_ptr<const fml::Mapping> mapping,
+      const DlImageResolver& resolve_image);
+
+  ~SerializedDisplayList();
+
+  /// Dispatches the ops to the |receiver| the same way that
+  /// |DisplayList::Dispatch| would have for the DisplayList that was
+  /// serialized.
+  void Dispatch(DlOpReceiver& receiver) const;
+
+  /// Records the ops into a new DisplayList, with an R-Tree if the
+  /// DisplayList that was serialized had one.
+  sk_sp<DisplayList> Build() const;
+
+  const SkRect& bounds() const { return bounds_; }
+
+  unsigned int op_count() const { return op_count_; }
+
+  bool has_rtree() const { return has_rtree_; }
+
+ private:
+  class Writer;
+
+  SerializedDisplayList() = default;
+
+  // Loads the DisplayList serialized in the |size| bytes at |data|, which
+  // lie within the |mapping|, and which may draw DisplayLists nested up to
+  // |depth| levels deep.
+  static std::unique_ptr<SerializedDisplayList> LoadFrom(
+      std::shared_ptr<const fml::Mapping> mapping,
+      const uint8_t* data,
+      size_t size,
+      const DlImageResolver& resolve_image,
+      int depth);
+
+  bool LoadResources(const uint8_t* data,
+                     size_t size,
+                     const DlImageResolver& resolve_image,
+                     int depth);
+  bool ValidateOps() const;
+
+  std::shared_ptr<const fml::Mapping> mapping_;
+  const uint8_t* ops_begin_ = nullptr;
+  const uint8_t* ops_end_ = nullptr;
+  unsigned int op_count_ = 0;
+  SkRect bounds_ = SkRect::MakeEmpty();
+  bool has_rtree_ = false;
+
+  std::vector<SkPath> paths_;
+  std::vector<sk_sp<SkTextBlob>> text_blobs_;
+  std::vector<sk_sp<DlImage>> images_;
+  std::vector<std::shared_ptr<DlColorSource>> color_sources_;
+  std::vector<std::shared_ptr<DlColorFilter>> color_filters_;
+  std::vector<std::shared_ptr<DlImageFilter>> image_filters_;
+  std::vector<std::shared_ptr<DlMaskFilter>> mask_filters_;
+  std::vector<std::shared_ptr<DlPathEffect>> path_effects_;
+  std::vector<sk_sp<DisplayList>> display_lists_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SerializedDisplayList);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
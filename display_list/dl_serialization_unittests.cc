@@ -0,0 +1,406 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_serialization.h"
+
+#include <unordered_map>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/dl_op_records.h"
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/file.h"
+#include "flutter/testing/testing.h"
+
+#include "third_party/skia/include/effects/SkRuntimeEffect.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Refers to images by an id assigned to each of them, standing in for the
+// hash of the encoded image that an application would use.
+class TestImageRegistry {
+ public:
+  uint64_t Register(const sk_sp<DlImage>& image) {
+    uint64_t hash = images_.size() + 1;
+    images_[hash] = image;
+    hashes_[image.get()] = hash;
+    return hash;
+  }
+
+  DlImageHasher hasher() const {
+    return [this](const DlImage& image) -> std::optional<uint64_t> {
+      auto it = hashes_.find(&image);
+      if (it == hashes_.end()) {
+        return std::nullopt;
+      }
+      return it->second;
+    };
+  }
+
+  DlImageResolver resolver() const {
+    return [this](uint64_t hash) -> sk_sp<DlImage> {
+      auto it = images_.find(hash);
+      return it == images_.end() ? nullptr : it->second;
+    };
+  }
+
+ private:
+  std::unordered_map<uint64_t, sk_sp<DlImage>> images_;
+  std::unordered_map<const DlImage*, uint64_t> hashes_;
+};
+
+std::shared_ptr<const fml::Mapping> Share(
+    std::unique_ptr<fml::Mapping> mapping) {
+  return std::shared_ptr<const fml::Mapping>(std::move(mapping));
+}
+
+sk_sp<DisplayList> MakeDisplayListWithAllResources() {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  DlPaint paint;
+  paint.setColor(DlColor::kRed());
+  builder.DrawRect(SkRect::MakeLTRB(10, 10, 50, 50), paint);
+  builder.Save();
+  builder.Translate(5, 5);
+  builder.ClipPath(kTestPath1, DlCanvas::ClipOp::kIntersect, true);
+  builder.DrawPath(kTestPath1, paint);
+  builder.Restore();
+
+  DlPaint effects_paint;
+  effects_paint.setColorSource(kTestSource2);
+  effects_paint.setImageFilter(&kTestBlurImageFilter1);
+  effects_paint.setMaskFilter(&kTestMaskFilter1);
+  effects_paint.setPathEffect(kTestPathEffect1);
+  effects_paint.setColorFilter(DlBlendColorFilter::Make(
+      DlColor::kBlue(), DlBlendMode::kSrcIn));
+  effects_paint.setStrokeWidth(3);
+  effects_paint.setDrawStyle(DlDrawStyle::kStroke);
+  builder.DrawOval(SkRect::MakeLTRB(20, 20, 80, 60), effects_paint);
+
+  DlPaint gradient_paint;
+  gradient_paint.setColorSource(kTestSource3);
+  builder.DrawCircle({40, 40}, 10, gradient_paint);
+  gradient_paint.setColorSource(kTestSource4);
+  builder.DrawCircle({50, 40}, 10, gradient_paint);
+  gradient_paint.setColorSource(kTestSource5);
+  builder.DrawCircle({60, 40}, 10, gradient_paint);
+  gradient_paint.setColorSource(&kTestSource1);
+  builder.DrawCircle({70, 40}, 10, gradient_paint);
+
+  builder.SaveLayer(nullptr, nullptr, &kTestBlurImageFilter1);
+  builder.DrawImage(TestImage1, {10, 10}, kLinearSampling, &paint);
+  builder.DrawImageRect(TestImage2, SkRect::MakeWH(50, 50),
+                        SkRect::MakeLTRB(60, 60, 90, 90), kNearestSampling,
+                        nullptr);
+  builder.DrawImageNine(TestImage1, SkIRect::MakeLTRB(10, 10, 20, 20),
+                        SkRect::MakeLTRB(0, 0, 100, 100),
+                        DlFilterMode::kLinear, nullptr);
+  builder.Restore();
+
+  SkRSXform xforms[] = {{1, 0, 0, 0}, {0, 1, 0, 0}};
+  SkRect texs[] = {{10, 10, 20, 20}, {20, 20, 30, 30}};
+  DlColor colors[] = {DlColor::kBlue(), DlColor::kGreen()};
+  builder.DrawAtlas(TestImage2, xforms, texs, colors, 2, DlBlendMode::kSrcIn,
+                    kNearestSampling, nullptr, nullptr);
+  builder.DrawPoints(DlCanvas::PointMode::kPolygon, TestPointCount,
+                     kTestPoints, paint);
+  builder.DrawVertices(TestVertices1, DlBlendMode::kSrcOver, paint);
+  builder.DrawShadow(kTestPath1, DlColor::kBlack(), 4, true, 2);
+  builder.DrawDisplayList(TestDisplayList1, 0.5);
+  return builder.Build();
+}
+
+std::vector<uint8_t> SerializeToBytes(const DisplayList& display_list,
+                                      const TestImageRegistry& registry) {
+  auto mapping = SerializedDisplayList::Serialize(display_list,
+                                                  registry.hasher());
+  if (!mapping) {
+    return {};
+  }
+  return std::vector<uint8_t>(mapping->GetMapping(),
+                              mapping->GetMapping() + mapping->GetSize());
+}
+
+std::unique_ptr<SerializedDisplayList> LoadFromBytes(
+    std::vector<uint8_t> bytes,
+    const TestImageRegistry& registry) {
+  return SerializedDisplayList::Load(
+      std::make_shared<fml::DataMapping>(std::move(bytes)),
+      registry.resolver());
+}
+
+// Returns the offset of the first op record of the |type| in the serialized
+// |data|, or 0 if there is none.
+size_t FindOpRecord(const std::vector<uint8_t>& data, DisplayListOpType type) {
+  // The offset and size of the op records follow the magic number, the
+  // version, the op layout, the flags and the op count in the header.
+  uint32_t ops_offset;
+  uint32_t ops_size;
+  memcpy(&ops_offset, data.data() + 5 * sizeof(uint32_t), sizeof(uint32_t));
+  memcpy(&ops_size, data.data() + 6 * sizeof(uint32_t), sizeof(uint32_t));
+  size_t offset = ops_offset;
+  while (offset < ops_offset + ops_size) {
+    auto op = reinterpret_cast<const DLOp*>(data.data() + offset);
+    if (op->type == type) {
+      return offset;
+    }
+    offset += op->size;
+  }
+  return 0;
+}
+
+}  // namespace
+
+TEST(SerializedDisplayList, RoundTripsEveryResource) {
+  TestImageRegistry registry;
+  registry.Register(TestImage1);
+  registry.Register(TestImage2);
+  auto original = MakeDisplayListWithAllResources();
+
+  auto mapping = SerializedDisplayList::Serialize(*original, registry.hasher());
+  ASSERT_NE(mapping, nullptr);
+  auto loaded =
+      SerializedDisplayList::Load(Share(std::move(mapping)),
+                                  registry.resolver());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->op_count(), original->op_count());
+  EXPECT_EQ(loaded->bounds(), original->bounds());
+  EXPECT_TRUE(loaded->has_rtree());
+
+  auto rebuilt = loaded->Build();
+  EXPECT_TRUE(original->Equals(rebuilt));
+  EXPECT_NE(rebuilt->rtree(), nullptr);
+}
+
+TEST(SerializedDisplayList, DispatchesTextBlobs) {
+  DisplayListBuilder builder;
+  builder.DrawTextBlob(GetTestTextBlob(1), 10, 20, DlPaint());
+  auto original = builder.Build();
+
+  TestImageRegistry registry;
+  auto mapping = SerializedDisplayList::Serialize(*original, registry.hasher());
+  ASSERT_NE(mapping, nullptr);
+  auto loaded =
+      SerializedDisplayList::Load(Share(std::move(mapping)),
+                                  registry.resolver());
+  ASSERT_NE(loaded, nullptr);
+
+  // The blob is a new object after loading so the DisplayLists are not
+  // equal, but it draws the same glyphs.
+  auto rebuilt = loaded->Build();
+  EXPECT_EQ(rebuilt->op_count(), original->op_count());
+  EXPECT_EQ(rebuilt->bounds(), original->bounds());
+}
+
+TEST(SerializedDisplayList, LoadsFromFileMapping) {
+  TestImageRegistry registry;
+  registry.Register(TestImage1);
+  registry.Register(TestImage2);
+  auto original = MakeDisplayListWithAllResources();
+  auto mapping = SerializedDisplayList::Serialize(*original, registry.hasher());
+  ASSERT_NE(mapping, nullptr);
+
+  fml::ScopedTemporaryDirectory temp_dir;
+  ASSERT_TRUE(
+      fml::WriteAtomically(temp_dir.fd(), "display_list.bin", *mapping));
+  auto file_mapping = fml::FileMapping::CreateReadOnly(temp_dir.fd(),
+                                                       "display_list.bin");
+  ASSERT_NE(file_mapping, nullptr);
+
+  auto loaded =
+      SerializedDisplayList::Load(Share(std::move(file_mapping)),
+                                  registry.resolver());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(original->Equals(loaded->Build()));
+}
+
+TEST(SerializedDisplayList, StoresRepeatedResourcesOnce) {
+  TestImageRegistry registry;
+  DisplayListBuilder once_builder;
+  once_builder.DrawPath(kTestPath1, DlPaint());
+  auto once = SerializedDisplayList::Serialize(*once_builder.Build(),
+                                               registry.hasher());
+
+  DisplayListBuilder repeated_builder;
+  for (int i = 0; i < 100; i++) {
+    repeated_builder.DrawPath(kTestPath1, DlPaint());
+  }
+  auto repeated = SerializedDisplayList::Serialize(*repeated_builder.Build(),
+                                                   registry.hasher());
+
+  ASSERT_NE(once, nullptr);
+  ASSERT_NE(repeated, nullptr);
+  // Each additional op only adds its small record that refers to the path.
+  EXPECT_LE(repeated->GetSize() - once->GetSize(), 99 * 16u);
+}
+
+TEST(SerializedDisplayList, FailsToSerializeUnknownImages) {
+  TestImageRegistry registry;
+  DisplayListBuilder builder;
+  builder.DrawImage(TestImage1, {0, 0}, kNearestSampling, nullptr);
+  EXPECT_EQ(
+      SerializedDisplayList::Serialize(*builder.Build(), registry.hasher()),
+      nullptr);
+}
+
+TEST(SerializedDisplayList, FailsToSerializeRuntimeEffects) {
+  auto effect = DlRuntimeEffect::MakeSkia(
+      SkRuntimeEffect::MakeForShader(
+          SkString("vec4 main(vec2 p) { return vec4(0); }"))
+          .effect);
+  DlPaint paint;
+  paint.setColorSource(DlColorSource::MakeRuntimeEffect(
+      effect, {}, std::make_shared<std::vector<uint8_t>>()));
+  DisplayListBuilder builder;
+  builder.DrawRect(SkRect::MakeWH(10, 10), paint);
+
+  TestImageRegistry registry;
+  EXPECT_EQ(
+      SerializedDisplayList::Serialize(*builder.Build(), registry.hasher()),
+      nullptr);
+}
+
+TEST(SerializedDisplayList, FailsToLoadUnresolvedImages) {
+  TestImageRegistry writer_registry;
+  writer_registry.Register(TestImage1);
+  DisplayListBuilder builder;
+  builder.DrawImage(TestImage1, {0, 0}, kNearestSampling, nullptr);
+  auto mapping = SerializedDisplayList::Serialize(*builder.Build(),
+                                                  writer_registry.hasher());
+  ASSERT_NE(mapping, nullptr);
+
+  TestImageRegistry reader_registry;
+  EXPECT_EQ(SerializedDisplayList::Load(Share(std::move(mapping)),
+                                        reader_registry.resolver()),
+            nullptr);
+}
+
+TEST(SerializedDisplayList, RejectsMalformedData) {
+  TestImageRegistry registry;
+  registry.Register(TestImage1);
+  registry.Register(TestImage2);
+  auto mapping = SerializedDisplayList::Serialize(
+      *MakeDisplayListWithAllResources(), registry.hasher());
+  ASSERT_NE(mapping, nullptr);
+  std::vector<uint8_t> data(mapping->GetMapping(),
+                            mapping->GetMapping() + mapping->GetSize());
+
+  auto load = [&registry](std::vector<uint8_t> bytes) {
+    return SerializedDisplayList::Load(
+        std::make_shared<fml::DataMapping>(std::move(bytes)),
+        registry.resolver());
+  };
+  ASSERT_NE(load(data), nullptr);
+
+  // A different version.
+  std::vector<uint8_t> wrong_version = data;
+  wrong_version[4] ^= 0xFF;
+  EXPECT_EQ(load(wrong_version), nullptr);
+
+  // Data cut off at any of a number of points.
+  for (size_t size = 0; size < data.size(); size += data.size() / 17 + 1) {
+    EXPECT_EQ(load(std::vector<uint8_t>(data.begin(), data.begin() + size)),
+              nullptr)
+        << size;
+  }
+
+  EXPECT_EQ(SerializedDisplayList::Load(nullptr, registry.resolver()),
+            nullptr);
+}
+
+TEST(SerializedDisplayList, RejectsOutOfRangeEnums) {
+  DisplayListBuilder builder;
+  DlPaint paint;
+  paint.setBlendMode(DlBlendMode::kSrcIn);
+  paint.setDrawStyle(DlDrawStyle::kStroke);
+  paint.setStrokeCap(DlStrokeCap::kRound);
+  paint.setStrokeJoin(DlStrokeJoin::kBevel);
+  builder.DrawRect(SkRect::MakeLTRB(10, 10, 50, 50), paint);
+  builder.DrawColor(DlColor::kRed(), DlBlendMode::kDstOver);
+  TestImageRegistry registry;
+  std::vector<uint8_t> data = SerializeToBytes(*builder.Build(), registry);
+  ASSERT_FALSE(data.empty());
+  ASSERT_NE(LoadFromBytes(data, registry), nullptr);
+
+  // Each of these ops holds nothing but its enum after the op header.
+  for (DisplayListOpType type :
+       {DisplayListOpType::kSetBlendMode, DisplayListOpType::kSetStyle,
+        DisplayListOpType::kSetStrokeCap, DisplayListOpType::kSetStrokeJoin}) {
+    size_t offset = FindOpRecord(data, type);
+    ASSERT_NE(offset, 0u) << static_cast<int>(type);
+    for (int32_t value : {-1, 100}) {
+      std::vector<uint8_t> corrupted = data;
+      memcpy(corrupted.data() + offset + sizeof(DLOp), &value, sizeof(value));
+      EXPECT_EQ(LoadFromBytes(std::move(corrupted), registry), nullptr)
+          << static_cast<int>(type) << " " << value;
+    }
+  }
+
+  size_t offset = FindOpRecord(data, DisplayListOpType::kDrawColor);
+  ASSERT_NE(offset, 0u);
+  std::vector<uint8_t> corrupted = data;
+  int32_t mode = static_cast<int32_t>(DlBlendMode::kLastMode) + 1;
+  memcpy(corrupted.data() + offset + offsetof(DrawColorOp, mode), &mode,
+         sizeof(mode));
+  EXPECT_EQ(LoadFromBytes(std::move(corrupted), registry), nullptr);
+}
+
+TEST(SerializedDisplayList, RejectsVertexIndicesOutOfRange) {
+  SkPoint points[] = {{0, 0}, {10, 0}, {0, 10}};
+  uint16_t indices[] = {0, 1, 2};
+  auto vertices = DlVertices::Make(DlVertexMode::kTriangles, 3, points,
+                                   nullptr, nullptr, 3, indices);
+  DisplayListBuilder builder;
+  builder.DrawVertices(vertices, DlBlendMode::kSrcOver, DlPaint());
+  TestImageRegistry registry;
+  std::vector<uint8_t> data = SerializeToBytes(*builder.Build(), registry);
+  ASSERT_FALSE(data.empty());
+  ASSERT_NE(LoadFromBytes(data, registry), nullptr);
+
+  size_t offset = FindOpRecord(data, DisplayListOpType::kDrawVertices);
+  ASSERT_NE(offset, 0u);
+  auto serialized_vertices = reinterpret_cast<const DlVertices*>(
+      data.data() + offset + sizeof(DrawVerticesOp));
+  size_t indices_offset =
+      reinterpret_cast<const uint8_t*>(serialized_vertices->indices()) -
+      data.data();
+  ASSERT_LT(indices_offset, data.size());
+
+  std::vector<uint8_t> corrupted = data;
+  uint16_t index = 3;
+  memcpy(corrupted.data() + indices_offset + sizeof(uint16_t), &index,
+         sizeof(index));
+  EXPECT_EQ(LoadFromBytes(std::move(corrupted), registry), nullptr);
+}
+
+TEST(SerializedDisplayList, RejectsDeeplyNestedImageFilters) {
+  auto make_display_list = [](int depth) {
+    std::shared_ptr<const DlImageFilter> filter =
+        std::make_shared<DlBlurImageFilter>(2, 2, DlTileMode::kClamp);
+    for (int i = 1; i < depth; i++) {
+      filter = std::make_shared<DlLocalMatrixImageFilter>(
+          SkMatrix::Translate(1, 1), filter);
+    }
+    DisplayListBuilder builder;
+    builder.SaveLayer(nullptr, nullptr, filter.get());
+    builder.DrawRect(SkRect::MakeLTRB(10, 10, 50, 50), DlPaint());
+    builder.Restore();
+    return builder.Build();
+  };
+  TestImageRegistry registry;
+
+  std::vector<uint8_t> shallow =
+      SerializeToBytes(*make_display_list(8), registry);
+  ASSERT_FALSE(shallow.empty());
+  EXPECT_NE(LoadFromBytes(std::move(shallow), registry), nullptr);
+
+  std::vector<uint8_t> deep =
+      SerializeToBytes(*make_display_list(1000), registry);
+  ASSERT_FALSE(deep.empty());
+  EXPECT_EQ(LoadFromBytes(std::move(deep), registry), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
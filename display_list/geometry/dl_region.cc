@@ -6,6 +6,14 @@
 
 #include "flutter/fml/logging.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace flutter {
 
 // Threshold for switching from linear search through span lines to binary
@@ -131,6 +139,61 @@ DlRegion::SpanLine DlRegion::makeLine(int32_t top,
   return {top, bottom, handle};
 }
 
+size_t DlRegion::countSpansEndingBefore(const Span* begin,
+                                        const Span* end,
+                                        int32_t x) {
+  // The spans of a line are sorted and separated, so the spans that end
+  // before x are all at the start. The vector loops test the right edges of
+  // 4 spans at a time and stop at the first group that is not entirely
+  // before x, which the scalar loop then finishes.
+  static_assert(sizeof(Span) == 2 * sizeof(int32_t));
+  const Span* span = begin;
+#if defined(__AVX2__)
+  const __m256i xs = _mm256_set1_epi32(x);
+  while (end - span >= 4) {
+    __m256i edges = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(span));
+    // The odd lanes hold the right edges.
+    int before = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(xs, edges)));
+    if ((before & 0xAA) != 0xAA) {
+      break;
+    }
+    span += 4;
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128i xs = _mm_set1_epi32(x);
+  while (end - span >= 4) {
+    __m128i edges0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(span));
+    __m128i edges1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(span + 2));
+    // The odd lanes hold the right edges.
+    int before0 =
+        _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(xs, edges0)));
+    int before1 =
+        _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(xs, edges1)));
+    if ((before0 & before1 & 0xA) != 0xA) {
+      break;
+    }
+    span += 4;
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const int32x4_t xs = vdupq_n_s32(x);
+  while (end - span >= 4) {
+    // Deinterleaves the left edges into val[0] and the right edges into
+    // val[1].
+    int32x4x2_t edges = vld2q_s32(reinterpret_cast<const int32_t*>(span));
+    if (vminvq_u32(vcltq_s32(edges.val[1], xs)) == 0) {
+      break;
+    }
+    span += 4;
+  }
+#endif
+  while (span < end && span->right < x) {
+    ++span;
+  }
+  return span - begin;
+}
+
 // Returns number of valid spans in res. For performance reasons res is never
 // downsized.
 size_t DlRegion::unionLineSpans(std::vector<Span>& res,
@@ -153,6 +216,21 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
       }
     }
 
+    // Same as accumulating each of the sorted spans in turn. Once a span
+    // starts past the accumulated spans, the rest are already separated and
+    // are copied as they are.
+    void accumulate(const Span* begin, const Span* end) {
+      while (begin < end && len > 0 && begin->left <= last_) {
+        accumulate(*begin++);
+      }
+      if (begin < end) {
+        size_t count = end - begin;
+        memcpy(res.data() + len, begin, count * sizeof(Span));
+        len += count;
+        last_ = end[-1].right;
+      }
+    }
+
     size_t len = 0;
     std::vector<Span>& res;
 
@@ -175,14 +253,22 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
 
   while (true) {
     if (begin1->left < begin2->left) {
-      accumulator.accumulate(*begin1++);
+      // The spans of 1 that end before 2 starts would be taken one at a
+      // time, so they are taken as a run instead.
+      const Span* run_end =
+          begin1 + 1 + countSpansEndingBefore(begin1 + 1, end1, begin2->left);
+      accumulator.accumulate(begin1, run_end);
+      begin1 = run_end;
       if (begin1 == end1) {
         break;
       }
     } else {
       // Either 2 is first, or they are equal, in which case add 2 now
       // and we might combine 1 with it next time around
-      accumulator.accumulate(*begin2++);
+      const Span* run_end =
+          begin2 + 1 + countSpansEndingBefore(begin2 + 1, end2, begin1->left);
+      accumulator.accumulate(begin2, run_end);
+      begin2 = run_end;
       if (begin2 == end2) {
         break;
       }
@@ -191,14 +277,8 @@ size_t DlRegion::unionLineSpans(std::vector<Span>& res,
 
   FML_DCHECK(begin1 == end1 || begin2 == end2);
 
-  while (begin1 < end1) {
-    accumulator.accumulate(*begin1++);
-  }
-  while (begin2 < end2) {
-    accumulator.accumulate(*begin2++);
-  }
-
-  FML_DCHECK(begin1 == end1 && begin2 == end2);
+  accumulator.accumulate(begin1, end1);
+  accumulator.accumulate(begin2, end2);
 
   return accumulator.len;
 }
@@ -227,9 +307,9 @@ size_t DlRegion::intersectLineSpans(std::vector<Span>& res,
 
   while (begin1 != end1 && begin2 != end2) {
     if (begin1->right <= begin2->left) {
-      ++begin1;
+      begin1 += countSpansEndingBefore(begin1, end1, begin2->left + 1);
     } else if (begin2->right <= begin1->left) {
-      ++begin2;
+      begin2 += countSpansEndingBefore(begin2, end2, begin1->left + 1);
     } else {
       int32_t left = std::max(begin1->left, begin2->left);
       int32_t right = std::min(begin1->right, begin2->right);
@@ -664,9 +744,9 @@ bool DlRegion::spansIntersect(const Span* begin1,
                               const Span* end2) {
   while (begin1 != end1 && begin2 != end2) {
     if (begin1->right <= begin2->left) {
-      ++begin1;
+      begin1 += countSpansEndingBefore(begin1, end1, begin2->left + 1);
     } else if (begin2->right <= begin1->left) {
-      ++begin2;
+      begin2 += countSpansEndingBefore(begin2, end2, begin1->left + 1);
     } else {
       return true;
     }
@@ -152,6 +152,13 @@ class DlRegion {
 
   bool spansEqual(SpanLine& line, const Span* begin, const Span* end) const;
 
+  /// Returns the number of spans at the start of the sorted spans of a line
+  /// that end before |x|. Uses vector instructions where available to skip
+  /// over long runs of spans.
+  static size_t countSpansEndingBefore(const Span* begin,
+                                       const Span* end,
+                                       int32_t x);
+
   static bool spansIntersect(const Span* begin1,
                              const Span* end1,
                              const Span* begin2,
@@ -429,5 +429,55 @@ TEST(DisplayListRegion, TestAgainstSkRegion) {
   }
 }
 
+TEST(DisplayListRegion, TestLongSpanLinesAgainstSkRegion) {
+  // Lines with hundreds of narrow spans, which the span merging skips over
+  // in runs.
+  std::seed_seq seed{::testing::UnitTest::GetInstance()->random_seed()};
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution offset(0, 6);
+  std::uniform_int_distribution width(1, 4);
+
+  for (int iteration = 0; iteration < 20; ++iteration) {
+    std::vector<SkIRect> rects_in1;
+    std::vector<SkIRect> rects_in2;
+    for (int i = 0; i < 400; ++i) {
+      rects_in1.push_back(
+          SkIRect::MakeXYWH(i * 8 + offset(rng), 0, width(rng), 100));
+      rects_in2.push_back(
+          SkIRect::MakeXYWH(i * 8 + offset(rng), 50, width(rng), 100));
+    }
+    // A few wide rects that cover many of the spans of the other region.
+    for (int i = 0; i < 4; ++i) {
+      rects_in2.push_back(SkIRect::MakeXYWH(i * 800 + offset(rng) * 50, 60,
+                                            width(rng) * 40, 20));
+    }
+
+    DlRegion region1(rects_in1);
+    SkRegion sk_region1;
+    sk_region1.setRects(rects_in1.data(), rects_in1.size());
+    CheckEquality(region1, sk_region1);
+
+    DlRegion region2(rects_in2);
+    SkRegion sk_region2;
+    sk_region2.setRects(rects_in2.data(), rects_in2.size());
+    CheckEquality(region2, sk_region2);
+
+    EXPECT_EQ(region1.intersects(region2),
+              sk_region1.intersects(sk_region2));
+
+    SkRegion sk_union(sk_region1);
+    sk_union.op(sk_region2, SkRegion::kUnion_Op);
+    CheckEquality(DlRegion::MakeUnion(region1, region2), sk_union);
+    CheckEquality(DlRegion::MakeUnion(region2, region1), sk_union);
+
+    SkRegion sk_intersection(sk_region1);
+    sk_intersection.op(sk_region2, SkRegion::kIntersect_Op);
+    CheckEquality(DlRegion::MakeIntersection(region1, region2),
+                  sk_intersection);
+    CheckEquality(DlRegion::MakeIntersection(region2, region1),
+                  sk_intersection);
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -160,6 +160,12 @@ void DlRTree::search(const SkRect& query, std::vector<int>* results) const {
   }
 }
 
+void DlRTree::searchInto(const SkRect& query,
+                         std::vector<int>& results) const {
+  results.clear();
+  search(query, &results);
+}
+
 std::list<SkRect> DlRTree::searchAndConsolidateRects(const SkRect& query,
                                                      bool deband) const {
   // Get the indexes for the operations that intersect with the query rect.
@@ -213,6 +219,85 @@ const DlRegion& DlRTree::region() const {
   return *region_;
 }
 
+void DlRTree::Builder::add(const SkRect& rect, int id) {
+  if (rect.isEmpty()) {
+    return;
+  }
+  Node node;
+  node.bounds = rect;
+  node.id = id;
+  for (size_t level = 0;; level++) {
+    if (level == levels_.size()) {
+      levels_.emplace_back();
+    }
+    std::vector<Node>& nodes = levels_[level];
+    nodes.push_back(node);
+    uint32_t count = nodes.size();
+    if (count % kMaxChildren != 0) {
+      break;
+    }
+    // The node completed a group, whose parent is added to the next level.
+    node.bounds.setEmpty();
+    node.child.index = count - kMaxChildren;
+    node.child.count = kMaxChildren;
+    for (uint32_t i = node.child.index; i < count; i++) {
+      node.bounds.join(nodes[i].bounds);
+    }
+  }
+}
+
+sk_sp<DlRTree> DlRTree::Builder::build(int invalid_id) const {
+  sk_sp<DlRTree> tree(new DlRTree(invalid_id));
+  if (levels_.empty() || levels_.front().empty()) {
+    return tree;
+  }
+  const std::vector<Node>& leaves = levels_.front();
+  tree->leaf_count_ = leaves.size();
+
+  std::vector<Node>& nodes = tree->nodes_;
+  nodes.reserve(leaves.size() + leaves.size() / (kMaxChildren - 1) +
+                levels_.size());
+  nodes.insert(nodes.end(), leaves.begin(), leaves.end());
+
+  // Each generation consists of the nodes of its level that the builder
+  // has already grouped, followed by the parent of the partial group of
+  // the previous generation, if any.
+  uint32_t gen_start = 0;
+  uint32_t gen_count = leaves.size();
+  for (size_t level = 1; gen_count > 1; level++) {
+    uint32_t gen_end = gen_start + gen_count;
+    uint32_t grouped_count = 0;
+    if (level < levels_.size()) {
+      for (Node parent : levels_[level]) {
+        parent.child.index += gen_start;
+        nodes.push_back(parent);
+      }
+      grouped_count = levels_[level].size() * kMaxChildren;
+    }
+    FML_DCHECK(grouped_count <= gen_count);
+    if (grouped_count < gen_count) {
+      Node parent;
+      parent.bounds.setEmpty();
+      parent.child.index = gen_start + grouped_count;
+      parent.child.count = gen_count - grouped_count;
+      for (uint32_t i = parent.child.index; i < gen_end; i++) {
+        parent.bounds.join(nodes[i].bounds);
+      }
+      nodes.push_back(parent);
+    }
+    gen_start = gen_end;
+    gen_count = nodes.size() - gen_end;
+  }
+  FML_DCHECK(gen_start + gen_count == nodes.size());
+  return tree;
+}
+
+void DlRTree::Builder::reset() {
+  for (std::vector<Node>& nodes : levels_) {
+    nodes.clear();
+  }
+}
+
 const SkRect& DlRTree::bounds() const {
   if (!nodes_.empty()) {
     return nodes_.back().bounds;
@@ -80,6 +80,12 @@ class DlRTree : public SkRefCnt {
   /// |DlRTree::id| and |DlRTree::bounds| methods.
   void search(const SkRect& query, std::vector<int>* results) const;
 
+  /// Search the rectangles like |search|, but replace the contents of
+  /// |results| rather than appending to them. A caller that keeps the
+  /// vector across queries reuses its storage instead of allocating a new
+  /// one for every query.
+  void searchInto(const SkRect& query, std::vector<int>& results) const;
+
   /// Return the ID for the indicated result of a query or
   /// invalid_id if the index is not a valid leaf node index.
   int id(int result_index) const {
@@ -136,9 +142,46 @@ class DlRTree : public SkRefCnt {
     return DlRegion::MakeIntersection(region(), DlRegion(query.roundOut()));
   }
 
+  /// Builds an R-Tree from rectangles that are added one at a time, such
+  /// as while the rendering operations they bound are being recorded.
+  ///
+  /// The tree has the same leaves in the same order as one constructed
+  /// from the same rectangles, but groups them as it goes. Each time
+  /// |kMaxChildren| nodes of a level have been added, their parent node is
+  /// created, so most of the work of building the tree is done by the time
+  /// |build| is called, which only has to add the parents of the last,
+  /// partial groups of each level.
+  class Builder {
+   public:
+    /// Adds a rectangle with an associated ID. Empty rectangles are not
+    /// stored in the R-Tree.
+    void add(const SkRect& rect, int id);
+
+    /// Returns the number of leaf nodes that have been added.
+    int leaf_count() const {
+      return levels_.empty() ? 0 : static_cast<int>(levels_.front().size());
+    }
+
+    /// Returns an R-Tree holding all of the rectangles added so far. The
+    /// builder is left unchanged and can continue adding rectangles.
+    sk_sp<DlRTree> build(int invalid_id = -1) const;
+
+    /// Removes all of the rectangles, keeping the memory allocated for
+    /// them to build another R-Tree of a similar size.
+    void reset();
+
+   private:
+    // The leaves in the first level, then for each level the parents of
+    // its complete groups of |kMaxChildren| nodes in the next one, with
+    // child indices relative to the start of their level.
+    std::vector<std::vector<Node>> levels_;
+  };
+
  private:
   static constexpr SkRect kEmpty = SkRect::MakeEmpty();
 
+  explicit DlRTree(int invalid_id) : invalid_id_(invalid_id) {}
+
   void search(const Node& parent,
               const SkRect& query,
               std::vector<int>* results) const;
@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "flutter/display_list/geometry/dl_rtree.h"
+
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "third_party/skia/include/core/SkRect.h"
@@ -319,5 +322,74 @@ TEST(DisplayListRTree, Region) {
   EXPECT_EQ(rects.size(), expected_rects.size());
 }
 
+TEST(DisplayListRTree, BuilderMatchesConstructor) {
+  // A grid of overlapping 15x15 rectangles with an empty rectangle every
+  // so often, which neither form of construction stores.
+  const int kMaxN = 1500;
+  std::vector<SkRect> rects;
+  std::vector<int> ids;
+  for (int i = 0; i < kMaxN; i++) {
+    if (i % 97 == 0) {
+      rects.push_back(SkRect::MakeEmpty());
+    } else {
+      rects.push_back(SkRect::MakeXYWH((i % 50) * 10, (i / 50) * 10, 15, 15));
+    }
+    ids.push_back(i);
+  }
+
+  DlRTree::Builder builder;
+  std::vector<int> expected;
+  std::vector<int> actual;
+  for (int N = 0; N <= kMaxN; N++) {
+    if (N > 0) {
+      builder.add(rects[N - 1], ids[N - 1]);
+    }
+    if (N > 300 && N % 53 != 0) {
+      continue;
+    }
+    DlRTree tree(rects.data(), N, ids.data());
+    auto built = builder.build();
+    auto desc = "node count = " + std::to_string(N);
+    ASSERT_EQ(built->leaf_count(), tree.leaf_count()) << desc;
+    ASSERT_EQ(built->bounds(), tree.bounds()) << desc;
+    for (int i = 0; i < tree.leaf_count(); i++) {
+      ASSERT_EQ(built->id(i), tree.id(i)) << desc;
+      ASSERT_EQ(built->bounds(i), tree.bounds(i)) << desc;
+    }
+    for (int y = 0; y < 320; y += 45) {
+      for (int x = 0; x < 520; x += 65) {
+        auto query = SkRect::MakeXYWH(x, y, 40, 30);
+        expected.clear();
+        tree.search(query, &expected);
+        built->searchInto(query, actual);
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        ASSERT_EQ(actual, expected) << desc;
+      }
+    }
+  }
+
+  builder.reset();
+  EXPECT_EQ(builder.leaf_count(), 0);
+  EXPECT_EQ(builder.build()->node_count(), 0);
+  builder.add(SkRect::MakeLTRB(0, 0, 10, 10), 7);
+  auto single = builder.build();
+  EXPECT_EQ(single->leaf_count(), 1);
+  EXPECT_EQ(single->node_count(), 1);
+  single->searchInto(SkRect::MakeLTRB(5, 5, 20, 20), actual);
+  EXPECT_EQ(actual, std::vector<int>({0}));
+}
+
+TEST(DisplayListRTree, SearchIntoReplacesResults) {
+  SkRect rects[] = {SkRect::MakeLTRB(0, 0, 10, 10),
+                    SkRect::MakeLTRB(20, 0, 30, 10)};
+  DlRTree tree(rects, 2);
+  std::vector<int> results = {5, 6, 7};
+  tree.searchInto(SkRect::MakeLTRB(22, 2, 28, 8), results);
+  EXPECT_EQ(results, std::vector<int>({1}));
+  tree.searchInto(SkRect::MakeLTRB(40, 40, 50, 50), results);
+  EXPECT_TRUE(results.empty());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/skia/dl_sk_tiled_dispatcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "flutter/display_list/skia/dl_sk_dispatcher.h"
+#include "flutter/fml/parallel_for.h"
+#include "flutter/fml/trace_event.h"
+
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+DlSkTiledDispatcher::DlSkTiledDispatcher(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_runner,
+    int max_tiles)
+    : worker_runner_(std::move(worker_runner)),
+      max_tiles_(std::max(max_tiles, 1)) {}
+
+static sk_sp<SkImage> RenderTile(const DisplayList& display_list,
+                                 const SkIRect& tile) {
+  TRACE_EVENT0("flutter", "DlSkTiledDispatcher::RenderTile");
+  sk_sp<SkSurface> surface = SkSurfaces::Raster(
+      SkImageInfo::MakeN32Premul(tile.width(), tile.height()));
+  if (!surface) {
+    return nullptr;
+  }
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->translate(-tile.fLeft, -tile.fTop);
+  // The dispatcher records the transform of the canvas at construction
+  // time so that a transformReset op is still relative to the tile origin.
+  DlSkCanvasDispatcher dispatcher(canvas);
+  display_list.Dispatch(dispatcher, tile);
+  return surface->makeImageSnapshot();
+}
+
+void DlSkTiledDispatcher::DrawDisplayList(
+    SkCanvas* canvas,
+    const sk_sp<DisplayList>& display_list,
+    const SkIRect& cull_rect,
+    SkScalar opacity) const {
+  TRACE_EVENT0("flutter", "DlSkTiledDispatcher::DrawDisplayList");
+  if (!display_list || opacity <= 0) {
+    return;
+  }
+  SkIRect bounded_cull;
+  if (!bounded_cull.intersect(cull_rect, display_list->bounds().roundOut())) {
+    return;
+  }
+  std::vector<SkIRect> tiles =
+      display_list->has_layer_filters()
+          ? std::vector<SkIRect>{bounded_cull}
+          : display_list->ComputeDispatchTiles(bounded_cull, max_tiles_);
+  if (tiles.empty()) {
+    return;
+  }
+
+  // The caller renders tiles along with the workers instead of waiting for
+  // them, so this completes even when it is called from one of the workers.
+  std::vector<sk_sp<SkImage>> images(tiles.size());
+  fml::ParallelFor(tiles.size() > 1 ? worker_runner_ : nullptr, tiles.size(),
+                   [&display_list, &tiles, &images](size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; i++) {
+                       images[i] = RenderTile(*display_list, tiles[i]);
+                     }
+                   });
+
+  SkPaint paint;
+  paint.setAlphaf(opacity);
+  for (size_t i = 0; i < tiles.size(); i++) {
+    if (images[i]) {
+      canvas->drawImage(images[i], tiles[i].fLeft, tiles[i].fTop,
+                        SkSamplingOptions(), &paint);
+    }
+  }
+}
+
+}  // namespace flutter
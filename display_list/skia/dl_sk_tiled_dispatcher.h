@@ -0,0 +1,62 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_DISPATCHER_H_
+#define FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_DISPATCHER_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/skia/dl_sk_types.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Rasterizes a |DisplayList| in software by splitting its cull
+///             area into tiles and dispatching each tile concurrently.
+///
+/// The tiles are computed by |DisplayList::ComputeDispatchTiles| from the
+/// R-Tree of the DisplayList, so the DisplayList should have been built
+/// with an R-Tree for this to provide any benefit. Each tile replays only
+/// the ops that intersect it into its own raster surface. The tiles are
+/// rendered with |fml::ParallelFor| on the workers of the |worker_runner|,
+/// with the caller rendering tiles as well rather than blocking on the
+/// workers. The tile images are then composited into the destination
+/// canvas in order.
+///
+/// Layers with image filters or backdrop filters read pixels across the
+/// seams between tiles, which a tile does not render, so a DisplayList
+/// that |DisplayList::has_layer_filters| is always rendered as one tile.
+///
+/// Otherwise, the result matches rendering the DisplayList into a
+/// transparent layer the size of the cull rect and drawing that layer
+/// into the destination at the current transform. That matches direct
+/// dispatch when the destination transform is an integer translation.
+///
+/// @see       DisplayList::ComputeDispatchTiles
+class DlSkTiledDispatcher {
+ public:
+  DlSkTiledDispatcher(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_runner,
+      int max_tiles);
+
+  int max_tiles() const { return max_tiles_; }
+
+  void DrawDisplayList(SkCanvas* canvas,
+                       const sk_sp<DisplayList>& display_list,
+                       const SkIRect& cull_rect,
+                       SkScalar opacity = SK_Scalar1) const;
+
+ private:
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_runner_;
+  const int max_tiles_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlSkTiledDispatcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_DISPATCHER_H_
@@ -46,6 +46,11 @@ void RectBoundsAccumulator::pop_and_accumulate(SkRect& layer_bounds,
   }
 }
 
+void RectBoundsAccumulator::reset() {
+  rect_ = AccumulationRect();
+  saved_rects_.clear();
+}
+
 RectBoundsAccumulator::AccumulationRect::AccumulationRect() {
   min_x_ = std::numeric_limits<SkScalar>::infinity();
   min_y_ = std::numeric_limits<SkScalar>::infinity();
@@ -75,8 +80,12 @@ SkRect RectBoundsAccumulator::AccumulationRect::bounds() const {
 
 void RTreeBoundsAccumulator::accumulate(const SkRect& r, int index) {
   if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
-    rects_.push_back(r);
-    rect_indices_.push_back(index);
+    if (saved_offsets_.empty()) {
+      add_final(r, index);
+    } else {
+      rects_.push_back(r);
+      rect_indices_.push_back(index);
+    }
   }
 }
 void RTreeBoundsAccumulator::save() {
@@ -88,6 +97,9 @@ void RTreeBoundsAccumulator::restore() {
   }
 
   saved_offsets_.pop_back();
+  if (saved_offsets_.empty()) {
+    add_final_rects();
+  }
 }
 bool RTreeBoundsAccumulator::restore(
     std::function<bool(const SkRect& original, SkRect& modified)> map,
@@ -113,22 +125,44 @@ bool RTreeBoundsAccumulator::restore(
   }
   rects_.resize(previous_size);
   rect_indices_.resize(previous_size);
+  if (saved_offsets_.empty()) {
+    add_final_rects();
+  }
   return success;
 }
 
-SkRect RTreeBoundsAccumulator::bounds() const {
+void RTreeBoundsAccumulator::add_final(const SkRect& r, int index) {
+  final_bounds_.join(r);
+  if (index >= 0) {
+    rtree_builder_.add(r, index);
+  }
+}
+
+void RTreeBoundsAccumulator::add_final_rects() {
   FML_DCHECK(saved_offsets_.empty());
-  RectBoundsAccumulator accumulator;
-  for (auto& rect : rects_) {
-    accumulator.accumulate(rect, 0);
+  for (size_t i = 0; i < rects_.size(); i++) {
+    add_final(rects_[i], rect_indices_[i]);
   }
-  return accumulator.bounds();
+  rects_.clear();
+  rect_indices_.clear();
+}
+
+SkRect RTreeBoundsAccumulator::bounds() const {
+  FML_DCHECK(saved_offsets_.empty());
+  return final_bounds_;
 }
 
 sk_sp<DlRTree> RTreeBoundsAccumulator::rtree() const {
   FML_DCHECK(saved_offsets_.empty());
-  return sk_make_sp<DlRTree>(rects_.data(), rects_.size(), rect_indices_.data(),
-                             [](int id) { return id >= 0; });
+  return rtree_builder_.build();
+}
+
+void RTreeBoundsAccumulator::reset() {
+  rects_.clear();
+  rect_indices_.clear();
+  saved_offsets_.clear();
+  rtree_builder_.reset();
+  final_bounds_.setEmpty();
 }
 
 }  // namespace flutter
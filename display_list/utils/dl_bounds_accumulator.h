@@ -86,6 +86,11 @@ class BoundsAccumulator {
 
   virtual sk_sp<DlRTree> rtree() const = 0;
 
+  /// Discard all accumulated rects/bounds, and any saved accumulations,
+  /// while retaining any memory that was allocated to hold them so that
+  /// the accumulator can be reused for a new recording.
+  virtual void reset() = 0;
+
   virtual BoundsAccumulatorType type() const = 0;
 };
 
@@ -114,6 +119,8 @@ class RectBoundsAccumulator final : public virtual BoundsAccumulator {
 
   sk_sp<DlRTree> rtree() const override { return nullptr; }
 
+  void reset() override;
+
  private:
   class AccumulationRect {
    public:
@@ -153,14 +160,30 @@ class RTreeBoundsAccumulator final : public virtual BoundsAccumulator {
 
   sk_sp<DlRTree> rtree() const override;
 
+  void reset() override;
+
   BoundsAccumulatorType type() const override {
     return BoundsAccumulatorType::kRTree;
   }
 
  private:
+  // Adds a rect that can no longer be modified by a restore to the R-Tree.
+  void add_final(const SkRect& r, int index);
+
+  // Adds the rects accumulated since the outermost save to the R-Tree once
+  // that save has been restored.
+  void add_final_rects();
+
+  // The rects accumulated since the outermost save, which may still be
+  // modified when the saves are restored.
   std::vector<SkRect> rects_;
   std::vector<int> rect_indices_;
   std::vector<size_t> saved_offsets_;
+
+  // The rects accumulated outside of any save, which are added to the
+  // R-Tree as they are accumulated rather than all at once at the end.
+  DlRTree::Builder rtree_builder_;
+  SkRect final_bounds_ = SkRect::MakeEmpty();
 };
 
 }  // namespace flutter
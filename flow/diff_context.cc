@@ -180,18 +180,26 @@ void DiffContext::MarkSubtreeDirty(const SkRect& previous_paint_region) {
   state_.dirty = true;
 }
 
-void DiffContext::AddLayerBounds(const SkRect& rect) {
+SkRect DiffContext::MapLayerRect(const SkRect& rect) {
   // During painting we cull based on non-overriden transform and then
   // override the transform right before paint. Do the same thing here to get
   // identical paint rect.
   auto transformed_rect = ApplyFilterBoundsAdjustment(MapRect(rect));
-  if (transformed_rect.intersects(clip_tracker_.device_cull_rect())) {
-    if (state_.integral_transform) {
-      clip_tracker_.save();
-      MakeCurrentTransformIntegral();
-      transformed_rect = ApplyFilterBoundsAdjustment(MapRect(rect));
-      clip_tracker_.restore();
-    }
+  if (!transformed_rect.intersects(clip_tracker_.device_cull_rect())) {
+    return SkRect::MakeEmpty();
+  }
+  if (state_.integral_transform) {
+    clip_tracker_.save();
+    MakeCurrentTransformIntegral();
+    transformed_rect = ApplyFilterBoundsAdjustment(MapRect(rect));
+    clip_tracker_.restore();
+  }
+  return transformed_rect;
+}
+
+void DiffContext::AddLayerBounds(const SkRect& rect) {
+  auto transformed_rect = MapLayerRect(rect);
+  if (!transformed_rect.isEmpty()) {
     rects_->push_back(transformed_rect);
     if (IsSubtreeDirty()) {
       AddDamage(transformed_rect);
@@ -199,6 +207,14 @@ void DiffContext::AddLayerBounds(const SkRect& rect) {
   }
 }
 
+void DiffContext::AddLayerDamage(const SkRect& rect) {
+  // Damage only needs to be tracked separately while the subtree is clean,
+  // the bounds of a dirty subtree are damaged in their entirety.
+  if (!IsSubtreeDirty()) {
+    AddDamage(MapLayerRect(rect));
+  }
+}
+
 void DiffContext::MarkSubtreeHasTextureLayer() {
   // Set the has_texture flag on current state and all parent states. That
   // way we'll know that we can't skip diff for retained layers because
@@ -115,6 +115,12 @@ class DiffContext {
   // coordinates.
   void AddLayerBounds(const SkRect& rect);
 
+  // Adds the part of the layer that changed since the previous frame to
+  // damage; rect is in "local" (layer) coordinates. Used by layers that are
+  // diffed against the layer they update rather than being marked dirty, so
+  // that only the area that changed needs to be repainted.
+  void AddLayerDamage(const SkRect& rect);
+
   // Add entire paint region of retained layer for current subtree. This can
   // only be used in subtrees that are not dirty, otherwise ancestor transforms
   // or clips may result in different paint region.
@@ -256,6 +262,11 @@ class DiffContext {
 
   void AddDamage(const SkRect& rect);
 
+  // Maps a rect in layer coordinates to the rect that the layer paints to in
+  // screen coordinates, or to an empty rect if the layer paints nothing
+  // there.
+  SkRect MapLayerRect(const SkRect& rect);
+
   void AlignRect(SkIRect& rect,
                  int horizontal_alignment,
                  int vertical_clip_alignment) const;
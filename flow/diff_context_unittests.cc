@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "flutter/display_list/dl_builder.h"
 #include "flutter/flow/testing/diff_context_test.h"
 
 namespace flutter {
@@ -32,5 +33,89 @@ TEST_F(DiffContextTest, ClipAlignment) {
   EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(16, 16, 64, 64));
 }
 
+// Records a grid of static rects with a "clock" rect in its middle that is
+// drawn in the given color.
+static sk_sp<DisplayList> CreateClockDisplayList(DlColor clock_color,
+                                                 bool prepare_rtree) {
+  DisplayListBuilder builder(prepare_rtree);
+  DlPaint paint;
+  for (int i = 0; i < 10; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(i * 50, 0, 40, 40), paint);
+  }
+  builder.Save();
+  builder.Translate(200, 100);
+  builder.DrawRect(SkRect::MakeWH(20, 10), DlPaint(clock_color));
+  builder.Restore();
+  for (int i = 0; i < 10; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(i * 50, 200, 40, 40), paint);
+  }
+  return builder.Build();
+}
+
+TEST_F(DiffContextTest, ChangedDisplayListOnlyDamagesChangedOps) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kRed(), true), SkPoint::Make(10, 10)));
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 500, 250));
+
+  MockLayerTree t2;
+  t2.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kBlue(), true), SkPoint::Make(10, 10)));
+  damage = DiffLayerTree(t2, t1);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(210, 110, 230, 120));
+
+  // Moving the clock damages both where it was and where it is now.
+  MockLayerTree t3;
+  DisplayListBuilder builder(true);
+  for (int i = 0; i < 10; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(i * 50, 0, 40, 40), DlPaint());
+  }
+  builder.Save();
+  builder.Translate(300, 100);
+  builder.DrawRect(SkRect::MakeWH(20, 10), DlPaint(DlColor::kBlue()));
+  builder.Restore();
+  for (int i = 0; i < 10; i++) {
+    builder.DrawRect(SkRect::MakeXYWH(i * 50, 200, 40, 40), DlPaint());
+  }
+  t3.root()->Add(
+      CreateDisplayListLayer(builder.Build(), SkPoint::Make(10, 10)));
+  damage = DiffLayerTree(t3, t2);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(210, 110, 330, 120));
+
+  // Without R-Trees the bounds of the ops are unknown and the whole display
+  // list is damaged.
+  MockLayerTree t4;
+  t4.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kRed(), false), SkPoint::Make(10, 10)));
+  MockLayerTree t5;
+  t5.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kBlue(), false), SkPoint::Make(10, 10)));
+  DiffLayerTree(t4, MockLayerTree());
+  damage = DiffLayerTree(t5, t4);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 500, 250));
+}
+
+TEST_F(DiffContextTest, ChangedDisplayListNextToInsertedLayer) {
+  auto static_layer =
+      CreateDisplayListLayer(CreateDisplayList(SkRect::MakeWH(50, 50)));
+  MockLayerTree t1;
+  t1.root()->Add(static_layer);
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kRed(), true), SkPoint::Make(10, 10)));
+  DiffLayerTree(t1, MockLayerTree());
+
+  // The layers can not be paired up when a layer is inserted, so the old
+  // clock layer is damaged in full.
+  MockLayerTree t2;
+  t2.root()->Add(static_layer);
+  t2.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeXYWH(600, 600, 10, 10))));
+  t2.root()->Add(CreateDisplayListLayer(
+      CreateClockDisplayList(DlColor::kBlue(), true), SkPoint::Make(10, 10)));
+  auto damage = DiffLayerTree(t2, t1);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 610, 610));
+}
+
 }  // namespace testing
 }  // namespace flutter
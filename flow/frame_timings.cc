@@ -101,6 +101,13 @@ size_t FrameTimingsRecorder::GetPictureCacheBytes() const {
   return picture_cache_bytes_;
 }
 
+std::map<int64_t, FrameTimingsRecorder::ViewRasterTiming>
+FrameTimingsRecorder::GetViewRasterTimings() const {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ >= State::kRasterEnd);
+  return view_raster_timings_;
+}
+
 void FrameTimingsRecorder::RecordVsync(fml::TimePoint vsync_start,
                                        fml::TimePoint vsync_target) {
   fml::Status status = RecordVsyncImpl(vsync_start, vsync_target);
@@ -126,6 +133,14 @@ void FrameTimingsRecorder::RecordRasterStart(fml::TimePoint raster_start) {
   (void)status;
 }
 
+void FrameTimingsRecorder::RecordViewRaster(int64_t view_id,
+                                            fml::TimePoint raster_start,
+                                            fml::TimePoint raster_end) {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ == State::kRasterStart);
+  view_raster_timings_[view_id] = {raster_start, raster_end};
+}
+
 fml::Status FrameTimingsRecorder::RecordVsyncImpl(fml::TimePoint vsync_start,
                                                   fml::TimePoint vsync_target) {
   std::scoped_lock state_lock(state_mutex_);
@@ -241,6 +256,7 @@ std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
     recorder->layer_cache_bytes_ = layer_cache_bytes_;
     recorder->picture_cache_count_ = picture_cache_count_;
     recorder->picture_cache_bytes_ = picture_cache_bytes_;
+    recorder->view_raster_timings_ = view_raster_timings_;
   }
 
   return recorder;
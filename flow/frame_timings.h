@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_FRAME_TIMINGS_H_
 #define FLUTTER_FLOW_FRAME_TIMINGS_H_
 
+#include <map>
 #include <mutex>
 
 #include "flutter/common/settings.h"
@@ -29,6 +30,12 @@ namespace flutter {
 /// synchronization.
 class FrameTimingsRecorder {
  public:
+  /// When the layer tree of a single view was rasterized.
+  struct ViewRasterTiming {
+    fml::TimePoint raster_start;
+    fml::TimePoint raster_end;
+  };
+
   /// Various states that the recorder can be in. When created the recorder is
   /// in an unitialized state and transtions in sequential order of the states.
   enum class State : uint32_t {
@@ -86,6 +93,9 @@ class FrameTimingsRecorder {
   /// Total Bytes in all picture cache entries
   size_t GetPictureCacheBytes() const;
 
+  /// The raster timings of each view drawn in this frame, by view ID.
+  std::map<int64_t, ViewRasterTiming> GetViewRasterTimings() const;
+
   /// Records a vsync event.
   void RecordVsync(fml::TimePoint vsync_start, fml::TimePoint vsync_target);
 
@@ -98,6 +108,13 @@ class FrameTimingsRecorder {
   /// Records a raster start event.
   void RecordRasterStart(fml::TimePoint raster_start);
 
+  /// Records when the layer tree of a view was rasterized. Views can be
+  /// rasterized concurrently, so this can be called from any thread between
+  /// the raster start and raster end events.
+  void RecordViewRaster(int64_t view_id,
+                        fml::TimePoint raster_start,
+                        fml::TimePoint raster_end);
+
   /// Clones the recorder until (and including) the specified state.
   std::unique_ptr<FrameTimingsRecorder> CloneUntil(State state);
 
@@ -154,6 +171,7 @@ class FrameTimingsRecorder {
   size_t layer_cache_bytes_;
   size_t picture_cache_count_;
   size_t picture_cache_bytes_;
+  std::map<int64_t, ViewRasterTiming> view_raster_timings_;
 
   // Set when `RecordRasterEnd` is called. Cannot be reset once set.
   FrameTiming timing_;
@@ -121,6 +121,33 @@ TEST(FrameTimingsRecorderTest, RecordRasterTimesWithCache) {
   ASSERT_EQ(recorder->GetPictureCacheBytes(), picture_bytes);
 }
 
+TEST(FrameTimingsRecorderTest, RecordViewRasterTimes) {
+  auto recorder = std::make_unique<FrameTimingsRecorder>();
+
+  const auto now = fml::TimePoint::Now();
+  recorder->RecordVsync(now, now + fml::TimeDelta::FromMilliseconds(16));
+  recorder->RecordBuildStart(fml::TimePoint::Now());
+  recorder->RecordBuildEnd(fml::TimePoint::Now());
+
+  const auto raster_start = fml::TimePoint::Now();
+  recorder->RecordRasterStart(raster_start);
+  const auto view_1_end = raster_start + fml::TimeDelta::FromMilliseconds(2);
+  const auto view_2_end = raster_start + fml::TimeDelta::FromMilliseconds(3);
+  recorder->RecordViewRaster(1, raster_start, view_1_end);
+  recorder->RecordViewRaster(2, raster_start, view_2_end);
+  recorder->RecordRasterEnd();
+
+  auto timings = recorder->GetViewRasterTimings();
+  ASSERT_EQ(timings.size(), 2u);
+  ASSERT_EQ(timings[1].raster_start, raster_start);
+  ASSERT_EQ(timings[1].raster_end, view_1_end);
+  ASSERT_EQ(timings[2].raster_start, raster_start);
+  ASSERT_EQ(timings[2].raster_end, view_2_end);
+
+  auto cloned = recorder->CloneUntil(FrameTimingsRecorder::State::kRasterEnd);
+  ASSERT_EQ(cloned->GetViewRasterTimings().size(), 2u);
+}
+
 // Windows and Fuchsia don't allow testing with killed by signal.
 #if !defined(OS_FUCHSIA) && !defined(FML_OS_WIN) && \
     (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG)
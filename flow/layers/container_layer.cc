@@ -64,14 +64,39 @@ void ContainerLayer::DiffChildren(DiffContext* context,
     --old_children_bottom;
   }
 
+  // When as many layers were changed as there were before, each one may just
+  // update the old layer at its position, in which case the layer can tell
+  // which parts of the old layer it changes.
+  bool same_changed_count = new_children_bottom - new_children_top ==
+                            old_children_bottom - old_children_top;
+  auto updates_old_layer = [&](int i) {
+    if (!same_changed_count) {
+      return false;
+    }
+    const auto& prev_layer = prev_layers[i - new_children_top +
+                                         old_children_top];
+    auto paint_region = context->GetOldLayerPaintRegion(prev_layer.get());
+    return paint_region.is_valid() && !paint_region.has_readback() &&
+           !paint_region.has_texture() &&
+           layers_[i]->CanDiffContents(prev_layer.get());
+  };
+
   // old layers that don't match
   for (int i = old_children_top; i <= old_children_bottom; ++i) {
+    if (updates_old_layer(i - old_children_top + new_children_top)) {
+      continue;
+    }
     auto layer = prev_layers[i];
     context->AddDamage(context->GetOldLayerPaintRegion(layer.get()));
   }
 
   for (int i = 0; i < static_cast<int>(layers_.size()); ++i) {
-    if (i < new_children_top || i > new_children_bottom) {
+    if (i >= new_children_top && i <= new_children_bottom &&
+        updates_old_layer(i)) {
+      auto layer = layers_[i];
+      layer->DiffContents(
+          context, prev_layers[i - new_children_top + old_children_top].get());
+    } else if (i < new_children_top || i > new_children_bottom) {
       int i_prev =
           i < new_children_top ? i : prev_layers.size() - (layers_.size() - i);
       auto layer = layers_[i];
@@ -37,22 +37,51 @@ bool DisplayListLayer::IsReplacing(DiffContext* context,
          Compare(context->statistics(), this, old_layer);
 }
 
+bool DisplayListLayer::CanDiffContents(const Layer* layer) const {
+  // The ops of the display lists can only be matched up if they are drawn
+  // in the same place, and need R-Trees to tell where each op draws.
+  auto old_layer = layer->as_display_list_layer();
+  return old_layer != nullptr && offset_ == old_layer->offset_ &&
+         display_list_->has_rtree() && old_layer->display_list_->has_rtree();
+}
+
 void DisplayListLayer::Diff(DiffContext* context, const Layer* old_layer) {
+  // IsReplacing has already determined that the display list is the same.
+  DiffWithOldLayer(context, old_layer, false);
+}
+
+void DisplayListLayer::DiffContents(DiffContext* context,
+                                    const Layer* old_layer) {
+  // CanDiffContents has determined that the display lists can be diffed. They
+  // were not compared, so ComputeDamage finds whether they differ at all.
+  DiffWithOldLayer(context, old_layer, true);
+}
+
+void DisplayListLayer::DiffWithOldLayer(DiffContext* context,
+                                        const Layer* old_layer,
+                                        bool contents_may_differ) {
   DiffContext::AutoSubtreeRestore subtree(context);
+  const DisplayListLayer* prev = nullptr;
   if (!context->IsSubtreeDirty()) {
-#ifndef NDEBUG
     FML_DCHECK(old_layer);
-    auto prev = old_layer->as_display_list_layer();
-    DiffContext::Statistics dummy_statistics;
-    // IsReplacing has already determined that the display list is same
-    FML_DCHECK(prev->offset_ == offset_ &&
-               Compare(dummy_statistics, this, prev));
-#endif
+    prev = old_layer->as_display_list_layer();
+    FML_DCHECK(prev->offset_ == offset_);
   }
   context->PushTransform(SkMatrix::Translate(offset_.x(), offset_.y()));
   if (context->has_raster_cache()) {
     context->WillPaintWithIntegralTransform();
   }
+  if (prev != nullptr && contents_may_differ &&
+      display_list_ != prev->display_list_) {
+    std::vector<SkRect> damage;
+    if (display_list_->ComputeDamage(*prev->display_list_, damage)) {
+      for (const SkRect& rect : damage) {
+        context->AddLayerDamage(rect);
+      }
+    } else {
+      context->MarkSubtreeDirty(context->GetOldLayerPaintRegion(old_layer));
+    }
+  }
   context->AddLayerBounds(display_list()->bounds());
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
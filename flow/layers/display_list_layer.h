@@ -27,8 +27,12 @@ class DisplayListLayer : public Layer {
 
   bool IsReplacing(DiffContext* context, const Layer* layer) const override;
 
+  bool CanDiffContents(const Layer* old_layer) const override;
+
   void Diff(DiffContext* context, const Layer* old_layer) override;
 
+  void DiffContents(DiffContext* context, const Layer* old_layer) override;
+
   const DisplayListLayer* as_display_list_layer() const override {
     return this;
   }
@@ -54,6 +58,12 @@ class DisplayListLayer : public Layer {
 
   sk_sp<DisplayList> display_list_;
 
+  // Diffs with the old layer, adding the parts of it that the display list
+  // changes to damage if |contents_may_differ|.
+  void DiffWithOldLayer(DiffContext* context,
+                        const Layer* old_layer,
+                        bool contents_may_differ);
+
   static bool Compare(DiffContext::Statistics& statistics,
                       const DisplayListLayer* l1,
                       const DisplayListLayer* l2);
@@ -153,9 +153,22 @@ class Layer {
     return original_layer_id_ == old_layer->original_layer_id_;
   }
 
+  // Used to pair a changed layer with the old layer at the same position in
+  // the tree. If this method returns true, the layer is diffed against the
+  // old layer without marking its subtree dirty, and is expected to add the
+  // parts of the old layer that it changes to damage itself.
+  virtual bool CanDiffContents(const Layer* old_layer) const { return false; }
+
   // Performs diff with given layer
   virtual void Diff(DiffContext* context, const Layer* old_layer) {}
 
+  // Performs diff with the old layer that CanDiffContents paired this layer
+  // with. Unlike layers passed to Diff, which IsReplacing found to be the
+  // same, the old layer may differ from this one.
+  virtual void DiffContents(DiffContext* context, const Layer* old_layer) {
+    Diff(context, old_layer);
+  }
+
   // Used when diffing retained layer; In case the layer is identical, it
   // doesn't need to be diffed, but the paint region needs to be stored in diff
   // context so that it can be used in next frame
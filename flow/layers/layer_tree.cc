@@ -41,13 +41,14 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
   }
 
   SkColorSpace* color_space = GetColorSpace(frame.canvas());
-  frame.context().raster_cache().SetCheckboardCacheImages(
-      checkerboard_raster_cache_images_);
   LayerStateStack state_stack;
   state_stack.set_preroll_delegate(cull_rect,
                                    frame.root_surface_transformation());
   RasterCache* cache =
       ignore_raster_cache ? nullptr : &frame.context().raster_cache();
+  if (cache) {
+    cache->SetCheckboardCacheImages(checkerboard_raster_cache_images_);
+  }
   raster_cache_items_.clear();
 
   PrerollContext context = {
@@ -26,6 +26,10 @@ bool Surface::EnableRasterCache() const {
   return true;
 }
 
+bool Surface::SupportsConcurrentViewRasterization() const {
+  return false;
+}
+
 std::shared_ptr<impeller::AiksContext> Surface::GetAiksContext() const {
   return nullptr;
 }
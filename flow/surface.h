@@ -49,6 +49,13 @@ class Surface {
 
   virtual bool EnableRasterCache() const;
 
+  /// Whether the layer trees of several views can be drawn concurrently on
+  /// worker threads into raster surfaces and then copied into the frames of
+  /// this surface, with the same result as drawing them into the frames
+  /// directly. Views drawn this way do not use the raster cache and are
+  /// always fully repainted.
+  virtual bool SupportsConcurrentViewRasterization() const;
+
   virtual std::shared_ptr<impeller::AiksContext> GetAiksContext() const;
 
   /// Capture the `SurfaceData` currently present in the surface.
@@ -7,17 +7,38 @@
 #include <algorithm>
 
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
-ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
-    : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+namespace {
+
+// Identifies the work stealing worker that is running on the current thread
+// so that tasks it posts go to its own deque.
+struct WorkerIdentity {
+  const ConcurrentMessageLoop* loop;
+  size_t index;
+};
+
+}  // namespace
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<WorkerIdentity> tls_worker_identity;
+
+ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count,
+                                             SchedulingMode mode)
+    : worker_count_(std::max<size_t>(worker_count, 1ul)), mode_(mode) {
+  if (mode_ == SchedulingMode::kWorkStealing) {
+    for (size_t i = 0; i < worker_count_; ++i) {
+      worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+    }
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(i);
     });
   }
 
@@ -38,6 +59,11 @@ size_t ConcurrentMessageLoop::GetWorkerCount() const {
   return worker_count_;
 }
 
+ConcurrentMessageLoop::SchedulingMode ConcurrentMessageLoop::GetSchedulingMode()
+    const {
+  return mode_;
+}
+
 std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
@@ -47,6 +73,11 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
     return;
   }
 
+  if (mode_ == SchedulingMode::kWorkStealing) {
+    PostWorkStealingTask(task);
+    return;
+  }
+
   std::unique_lock lock(tasks_mutex_);
 
   // Don't just drop tasks on the floor in case of shutdown.
@@ -69,11 +100,115 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
   tasks_condition_.notify_one();
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
+void ConcurrentMessageLoop::PostPriorityTask(const fml::closure& task) {
+  if (!task) {
+    return;
+  }
+
+  std::unique_lock lock(tasks_mutex_);
+
+  if (shutdown_) {
+    FML_DLOG(WARNING)
+        << "Tried to post a task to shutdown concurrent message "
+           "loop. The task will be executed on the callers thread.";
+    lock.unlock();
+    ExecuteTask(task);
+    return;
+  }
+
+  priority_tasks_.push(task);
+  ++priority_task_count_;
+  if (mode_ == SchedulingMode::kWorkStealing) {
+    ++pending_task_count_;
+  }
+  lock.unlock();
+
+  tasks_condition_.notify_one();
+}
+
+void ConcurrentMessageLoop::PostWorkStealingTask(const fml::closure& task) {
+  const WorkerIdentity* worker = tls_worker_identity.get();
+  size_t index = (worker && worker->loop == this)
+                     ? worker->index
+                     : next_worker_queue_++ % worker_count_;
+
+  std::unique_lock lock(tasks_mutex_);
+
+  // Workers only exit once they have seen the shutdown with no pending tasks
+  // under this mutex, so a task that is queued here is always run.
+  if (shutdown_) {
+    FML_DLOG(WARNING)
+        << "Tried to post a task to shutdown concurrent message "
+           "loop. The task will be executed on the callers thread.";
+    lock.unlock();
+    ExecuteTask(task);
+    return;
+  }
+
+  {
+    auto& queue = worker_queues_[index];
+    std::scoped_lock queue_lock(queue->mutex);
+    queue->tasks.push_back(task);
+  }
+  ++pending_task_count_;
+  const bool has_sleeping_worker = sleeping_worker_count_ > 0;
+  lock.unlock();
+
+  // Workers only go to sleep after checking |pending_task_count_| under the
+  // tasks mutex, so one that is not counted as sleeping yet will see the
+  // task.
+  if (has_sleeping_worker) {
+    tasks_condition_.notify_one();
+  }
+}
+
+bool ConcurrentMessageLoop::TakeWorkStealingTask(size_t worker_index,
+                                                 fml::closure& task) {
+  if (priority_task_count_ > 0) {
+    std::scoped_lock lock(tasks_mutex_);
+    if (!priority_tasks_.empty()) {
+      task = std::move(priority_tasks_.front());
+      priority_tasks_.pop();
+      --priority_task_count_;
+      --pending_task_count_;
+      return true;
+    }
+  }
+
+  // The owner takes from the front of its deque, in the order the tasks were
+  // posted. Thieves take from the back, so they only contend with the owner
+  // when a single task is left.
+  for (size_t i = 0; i < worker_count_; ++i) {
+    const bool own_queue = i == 0;
+    auto& queue = worker_queues_[(worker_index + i) % worker_count_];
+    std::scoped_lock queue_lock(queue->mutex);
+    if (queue->tasks.empty()) {
+      continue;
+    }
+    if (own_queue) {
+      task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+    } else {
+      task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+    }
+    --pending_task_count_;
+    return true;
+  }
+  return false;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  if (mode_ == SchedulingMode::kWorkStealing) {
+    WorkStealingWorkerMain(worker_index);
+    return;
+  }
+
   while (true) {
     std::unique_lock lock(tasks_mutex_);
     tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
+      return !tasks_.empty() || !priority_tasks_.empty() || shutdown_ ||
+             HasThreadTasksLocked();
     });
 
     // Shutdown cannot be read with the task mutex unlocked.
@@ -81,7 +216,11 @@ void ConcurrentMessageLoop::WorkerMain() {
     fml::closure task;
     std::vector<fml::closure> thread_tasks;
 
-    if (!tasks_.empty()) {
+    if (!priority_tasks_.empty()) {
+      task = priority_tasks_.front();
+      priority_tasks_.pop();
+      --priority_task_count_;
+    } else if (!tasks_.empty()) {
       task = tasks_.front();
       tasks_.pop();
     }
@@ -112,6 +251,51 @@ void ConcurrentMessageLoop::WorkerMain() {
   }
 }
 
+void ConcurrentMessageLoop::WorkStealingWorkerMain(size_t worker_index) {
+  tls_worker_identity.reset(new WorkerIdentity{this, worker_index});
+  const auto& own_queue = worker_queues_[worker_index];
+
+  while (true) {
+    fml::closure task;
+    // Tasks that were queued before the loop was terminated still run.
+    if (!own_queue->has_thread_tasks &&
+        TakeWorkStealingTask(worker_index, task)) {
+      ExecuteTask(task);
+      continue;
+    }
+
+    std::unique_lock lock(tasks_mutex_);
+    ++sleeping_worker_count_;
+    tasks_condition_.wait(lock, [&]() {
+      return pending_task_count_ > 0 || shutdown_ || HasThreadTasksLocked();
+    });
+    --sleeping_worker_count_;
+
+    // No more tasks can be queued once the shutdown is seen here.
+    bool shutdown_now = shutdown_ && pending_task_count_ == 0;
+    std::vector<fml::closure> thread_tasks;
+
+    if (HasThreadTasksLocked()) {
+      thread_tasks = GetThreadTasksLocked();
+      FML_DCHECK(!HasThreadTasksLocked());
+    }
+    own_queue->has_thread_tasks = false;
+
+    lock.unlock();
+
+    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
+    for (const auto& thread_task : thread_tasks) {
+      ExecuteTask(thread_task);
+    }
+
+    if (shutdown_now) {
+      break;
+    }
+  }
+
+  tls_worker_identity.reset(nullptr);
+}
+
 void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
   task();
 }
@@ -131,6 +315,11 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
   for (const auto& worker_thread_id : worker_thread_ids_) {
     thread_tasks_[worker_thread_id].emplace_back(task);
   }
+  // Work stealing workers only take the tasks mutex once they run out of
+  // other work, so point them at their thread tasks explicitly.
+  for (const auto& worker_queue : worker_queues_) {
+    worker_queue->has_thread_tasks = true;
+  }
   tasks_condition_.notify_all();
 }
 
@@ -169,6 +358,29 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
+void ConcurrentTaskRunner::PostPriorityTask(const fml::closure& task) {
+  if (!task) {
+    return;
+  }
+
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostPriorityTask(task);
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the task on the callers thread.";
+  task();
+}
+
+size_t ConcurrentTaskRunner::GetWorkerCount() const {
+  if (auto loop = weak_loop_.lock()) {
+    return loop->GetWorkerCount();
+  }
+  return 0u;
+}
+
 bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
   std::scoped_lock lock(tasks_mutex_);
   for (const auto& worker_thread_id : worker_thread_ids_) {
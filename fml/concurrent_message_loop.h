@@ -5,8 +5,11 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <map>
+#include <memory>
 #include <queue>
 #include <thread>
 
@@ -21,13 +24,26 @@ class ConcurrentTaskRunner;
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
+  /// How tasks posted to the loop are handed to its workers.
+  enum class SchedulingMode {
+    /// All workers pull from a single task queue guarded by one mutex.
+    kSharedQueue,
+    /// Every worker has its own task deque. Tasks posted from a worker go to
+    /// the deque of that worker, other tasks are spread round-robin, and idle
+    /// workers steal from the back of the deques of busy ones.
+    kWorkStealing,
+  };
+
   static std::shared_ptr<ConcurrentMessageLoop> Create(
-      size_t worker_count = std::thread::hardware_concurrency());
+      size_t worker_count = std::thread::hardware_concurrency(),
+      SchedulingMode mode = SchedulingMode::kSharedQueue);
 
   virtual ~ConcurrentMessageLoop();
 
   size_t GetWorkerCount() const;
 
+  SchedulingMode GetSchedulingMode() const;
+
   std::shared_ptr<ConcurrentTaskRunner> GetTaskRunner();
 
   void Terminate();
@@ -37,25 +53,54 @@ class ConcurrentMessageLoop
   bool RunsTasksOnCurrentThread();
 
  protected:
-  explicit ConcurrentMessageLoop(size_t worker_count);
+  explicit ConcurrentMessageLoop(
+      size_t worker_count,
+      SchedulingMode mode = SchedulingMode::kSharedQueue);
   virtual void ExecuteTask(const fml::closure& task);
 
  private:
   friend ConcurrentTaskRunner;
 
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks;
+    // Set by |PostTaskToAllWorkers| until the worker has taken its tasks.
+    std::atomic_bool has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
+  const SchedulingMode mode_;
   std::vector<std::thread> workers_;
   std::mutex tasks_mutex_;
   std::condition_variable tasks_condition_;
   std::queue<fml::closure> tasks_;
+  // Tasks posted with |ConcurrentTaskRunner::PostPriorityTask|. Workers take
+  // these before any other task in both scheduling modes.
+  std::queue<fml::closure> priority_tasks_;
   std::vector<std::thread::id> worker_thread_ids_;
   std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_bool shutdown_ = false;
 
-  void WorkerMain();
+  // Only used in |SchedulingMode::kWorkStealing|.
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::atomic_size_t next_worker_queue_ = 0;
+  // The number of tasks in |worker_queues_| and |priority_tasks_|.
+  std::atomic_size_t pending_task_count_ = 0;
+  std::atomic_size_t priority_task_count_ = 0;
+  std::atomic_size_t sleeping_worker_count_ = 0;
+
+  void WorkerMain(size_t worker_index);
+
+  void WorkStealingWorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
+  void PostPriorityTask(const fml::closure& task);
+
+  void PostWorkStealingTask(const fml::closure& task);
+
+  bool TakeWorkStealingTask(size_t worker_index, fml::closure& task);
+
   bool HasThreadTasksLocked() const;
 
   std::vector<fml::closure> GetThreadTasksLocked();
@@ -71,6 +116,15 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  /// Posts a task that workers pick up before any task posted with
+  /// |PostTask|, such as decoding an image that is on screen while images
+  /// that are only being prefetched wait.
+  void PostPriorityTask(const fml::closure& task);
+
+  /// Returns the number of workers of the loop, or zero if the loop has
+  /// already been collected.
+  size_t GetWorkerCount() const;
+
  private:
   friend ConcurrentMessageLoop;
 
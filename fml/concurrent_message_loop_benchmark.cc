@@ -0,0 +1,214 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+using SchedulingMode = ConcurrentMessageLoop::SchedulingMode;
+
+constexpr size_t kWorkerCount = 4;
+
+// Stands in for a small slice of decode or tessellation work.
+void DoWork() {
+  uint64_t value = 0;
+  for (int i = 0; i < 256; i++) {
+    value = value * 31 + i;
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// Reports the median and tail of the time tasks spent queued, in
+// microseconds.
+void ReportLatencies(benchmark::State& state, std::vector<double>& latencies) {
+  if (latencies.empty()) {
+    return;
+  }
+  auto percentile = [&latencies](double p) {
+    size_t index = std::min(latencies.size() - 1,
+                            static_cast<size_t>(p * latencies.size()));
+    std::nth_element(latencies.begin(), latencies.begin() + index,
+                     latencies.end());
+    return latencies[index];
+  };
+  state.counters["LatencyP50us"] = percentile(0.5);
+  state.counters["LatencyP99us"] = percentile(0.99);
+  state.counters["LatencyMaxus"] = percentile(1.0);
+}
+
+}  // namespace
+
+// One thread posts a burst of |state.range(0)| independent tasks that spread
+// out over the workers, like a frame requesting a batch of image decodes.
+static void BM_ConcurrentLoopFanOut(benchmark::State& state,
+                                    SchedulingMode mode) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, mode);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = state.range(0);
+  std::vector<double> latencies;
+  std::vector<double> iteration_latencies(task_count);
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(task_count);
+    for (size_t i = 0; i < task_count; i++) {
+      task_runner->PostTask(
+          [&latch, &iteration_latencies, i, posted = TimePoint::Now()]() {
+            iteration_latencies[i] =
+                (TimePoint::Now() - posted).ToMicrosecondsF();
+            DoWork();
+            latch.CountDown();
+          });
+    }
+    latch.Wait();
+    latencies.insert(latencies.end(), iteration_latencies.begin(),
+                     iteration_latencies.end());
+  }
+
+  state.SetItemsProcessed(state.iterations() * task_count);
+  ReportLatencies(state, latencies);
+}
+
+// Every worker runs a task that posts |state.range(0)| more tasks from inside
+// the loop, all of which join on one latch. Work stealing keeps the spawned
+// tasks on the worker that posted them unless another worker runs dry.
+static void BM_ConcurrentLoopFanIn(benchmark::State& state,
+                                   SchedulingMode mode) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, mode);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t tasks_per_producer = state.range(0);
+  const size_t task_count = kWorkerCount * tasks_per_producer;
+  std::vector<double> latencies;
+  std::vector<double> iteration_latencies(task_count);
+
+  while (state.KeepRunning()) {
+    CountDownLatch spawned(kWorkerCount);
+    CountDownLatch latch(task_count);
+    for (size_t producer = 0; producer < kWorkerCount; producer++) {
+      task_runner->PostTask([&, producer]() {
+        for (size_t i = 0; i < tasks_per_producer; i++) {
+          size_t index = producer * tasks_per_producer + i;
+          task_runner->PostTask(
+              [&latch, &iteration_latencies, index,
+               posted = TimePoint::Now()]() {
+                iteration_latencies[index] =
+                    (TimePoint::Now() - posted).ToMicrosecondsF();
+                DoWork();
+                latch.CountDown();
+              });
+        }
+        spawned.CountDown();
+      });
+    }
+    spawned.Wait();
+    latch.Wait();
+    latencies.insert(latencies.end(), iteration_latencies.begin(),
+                     iteration_latencies.end());
+  }
+
+  state.SetItemsProcessed(state.iterations() * task_count);
+  ReportLatencies(state, latencies);
+}
+
+// Measures how long a handful of on-screen decodes wait behind a backlog of
+// |state.range(0)| prefetch decodes, with and without the priority lane.
+static void BM_ConcurrentLoopPriorityLatency(benchmark::State& state,
+                                             SchedulingMode mode,
+                                             bool use_priority_lane) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, mode);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t backlog_count = state.range(0);
+  const size_t urgent_count = 8;
+  std::vector<double> latencies;
+  std::vector<double> iteration_latencies(urgent_count);
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(backlog_count + urgent_count);
+    for (size_t i = 0; i < backlog_count; i++) {
+      task_runner->PostTask([&latch]() {
+        DoWork();
+        latch.CountDown();
+      });
+    }
+    for (size_t i = 0; i < urgent_count; i++) {
+      auto task = [&latch, &iteration_latencies, i,
+                   posted = TimePoint::Now()]() {
+        iteration_latencies[i] = (TimePoint::Now() - posted).ToMicrosecondsF();
+        DoWork();
+        latch.CountDown();
+      };
+      if (use_priority_lane) {
+        task_runner->PostPriorityTask(task);
+      } else {
+        task_runner->PostTask(task);
+      }
+    }
+    latch.Wait();
+    latencies.insert(latencies.end(), iteration_latencies.begin(),
+                     iteration_latencies.end());
+  }
+
+  ReportLatencies(state, latencies);
+}
+
+BENCHMARK_CAPTURE(BM_ConcurrentLoopFanOut,
+                  SharedQueue,
+                  SchedulingMode::kSharedQueue)
+    ->RangeMultiplier(8)
+    ->Range(64, 4096)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopFanOut,
+                  WorkStealing,
+                  SchedulingMode::kWorkStealing)
+    ->RangeMultiplier(8)
+    ->Range(64, 4096)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopFanIn,
+                  SharedQueue,
+                  SchedulingMode::kSharedQueue)
+    ->RangeMultiplier(8)
+    ->Range(16, 1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopFanIn,
+                  WorkStealing,
+                  SchedulingMode::kWorkStealing)
+    ->RangeMultiplier(8)
+    ->Range(16, 1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopPriorityLatency,
+                  SharedQueue,
+                  SchedulingMode::kSharedQueue,
+                  false)
+    ->Arg(1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopPriorityLatency,
+                  SharedQueuePriorityLane,
+                  SchedulingMode::kSharedQueue,
+                  true)
+    ->Arg(1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopPriorityLatency,
+                  WorkStealing,
+                  SchedulingMode::kWorkStealing,
+                  false)
+    ->Arg(1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ConcurrentLoopPriorityLatency,
+                  WorkStealingPriorityLane,
+                  SchedulingMode::kWorkStealing,
+                  true)
+    ->Arg(1024)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -45,6 +45,7 @@ fml::RefPtr<MessageLoopImpl> MessageLoopImpl::Create() {
 MessageLoopImpl::MessageLoopImpl()
     : task_queue_(MessageLoopTaskQueues::GetInstance()),
       queue_id_(task_queue_->CreateTaskQueue()),
+      queue_entry_(task_queue_->GetTaskQueueEntry(queue_id_)),
       terminated_(false) {
   task_queue_->SetWakeable(queue_id_, this);
 }
@@ -61,7 +62,7 @@ void MessageLoopImpl::PostTask(const fml::closure& task,
     // |task| synchronously within this function.
     return;
   }
-  task_queue_->RegisterTask(queue_id_, task, target_time);
+  task_queue_->RegisterTask(*queue_entry_, task, target_time);
 }
 
 void MessageLoopImpl::AddTaskObserver(intptr_t key,
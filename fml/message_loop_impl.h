@@ -8,6 +8,7 @@
 #include <atomic>
 #include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <utility>
@@ -66,6 +67,9 @@ class MessageLoopImpl : public Wakeable,
  private:
   fml::MessageLoopTaskQueues* task_queue_;
   TaskQueueId queue_id_;
+  // Looked up once so that posting a task does not go through the entries
+  // of every queue.
+  std::shared_ptr<TaskQueueEntry> queue_entry_;
 
   std::atomic_bool terminated_;
 
@@ -35,8 +35,59 @@ class TaskSourceGradeHolder {
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
+TaskQueueInbox::TaskQueueInbox() : head_(nullptr) {}
+
+TaskQueueInbox::~TaskQueueInbox() {
+  Node* node = head_.exchange(nullptr);
+  while (node) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+void TaskQueueInbox::Push(const fml::closure& task,
+                          fml::TimePoint target_time,
+                          fml::TaskSourceGrade task_source_grade) {
+  Node* node = new Node{task, target_time, task_source_grade,
+                        head_.load(std::memory_order_relaxed)};
+  while (!head_.compare_exchange_weak(node->next, node)) {
+  }
+}
+
+size_t TaskQueueInbox::DrainInto(TaskSource* task_source) {
+  Node* node = head_.exchange(nullptr);
+  // The list is in reverse push order, which is undone before numbering the
+  // tasks so that tasks with the same target time run in push order.
+  Node* reversed = nullptr;
+  while (node) {
+    Node* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+  size_t count = 0;
+  while (reversed) {
+    Node* next = reversed->next;
+    task_source->RegisterTask({next_order_++, reversed->task,
+                               reversed->target_time,
+                               reversed->task_source_grade});
+    delete reversed;
+    reversed = next;
+    ++count;
+  }
+  return count;
+}
+
+bool TaskQueueInbox::IsEmpty() const {
+  return head_.load() == nullptr;
+}
+
 TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
-    : subsumed_by(kUnmerged), created_for(created_for_arg) {
+    : subsumed_by(kUnmerged),
+      created_for(created_for_arg),
+      secondary_paused(false),
+      wake_time(fml::TimePoint::Max()) {
   wakeable = NULL;
   task_observers = TaskObservers();
   task_source = std::make_unique<TaskSource>(created_for);
@@ -48,14 +99,15 @@ MessageLoopTaskQueues* MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  UniqueLock entries_lock(*entries_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  queue_entries_[loop_id] = std::make_shared<TaskQueueEntry>(loop_id);
   return loop_id;
 }
 
-MessageLoopTaskQueues::MessageLoopTaskQueues() : order_(0) {
+MessageLoopTaskQueues::MessageLoopTaskQueues()
+    : entries_mutex_(fml::SharedMutex::Create()) {
   tls_task_source_grade.reset(
       new TaskSourceGradeHolder{TaskSourceGrade::kUnspecified});
 }
@@ -63,9 +115,15 @@ MessageLoopTaskQueues::MessageLoopTaskQueues() : order_(0) {
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  UniqueLock entries_lock(*entries_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
+  FML_DCHECK(queue_entry->subsumed_by.load() == kUnmerged);
+  // Producers may still hold the entry, so make sure they do not wake a loop
+  // that is going away.
+  {
+    std::lock_guard wake_guard(queue_entry->wake_mutex);
+    queue_entry->wakeable = nullptr;
+  }
   auto& subsumed_set = queue_entry->owner_of;
   for (auto& subsumed : subsumed_set) {
     queue_entries_.erase(subsumed);
@@ -75,9 +133,11 @@ void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
+  FML_DCHECK(queue_entry->subsumed_by.load() == kUnmerged);
+  DrainInboxesUnlocked(queue_id);
   auto& subsumed_set = queue_entry->owner_of;
   queue_entry->task_source->ShutDown();
   for (auto& subsumed : subsumed_set) {
@@ -94,40 +154,69 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
-  size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
-      {order, task, target_time, task_source_grade});
-  TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
+  RegisterTask(*GetTaskQueueEntry(queue_id), task, target_time,
+               task_source_grade);
+}
+
+void MessageLoopTaskQueues::RegisterTask(
+    TaskQueueEntry& queue_entry,
+    const fml::closure& task,
+    fml::TimePoint target_time,
+    fml::TaskSourceGrade task_source_grade) {
+  queue_entry.inbox.Push(task, target_time, task_source_grade);
+
+  // Paused secondary tasks cannot run yet. ResumeSecondarySource drains the
+  // inbox after clearing the flag, so the wake up is not lost.
+  if (task_source_grade == TaskSourceGrade::kDartMicroTasks &&
+      queue_entry.secondary_paused) {
+    return;
   }
 
-  // This can happen when the secondary tasks are paused.
-  if (HasPendingTasksUnlocked(loop_to_wake)) {
-    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  // Read after the push, see invariant 4 in the header.
+  const TaskQueueId owner = queue_entry.subsumed_by;
+  if (owner == kUnmerged) {
+    WakeUpNoLaterThan(queue_entry, target_time);
+    return;
+  }
+  SharedLock entries_lock(*entries_mutex_);
+  auto found = queue_entries_.find(owner);
+  if (found != queue_entries_.end()) {
+    WakeUpNoLaterThan(*found->second, target_time);
   }
 }
 
+std::shared_ptr<TaskQueueEntry> MessageLoopTaskQueues::GetTaskQueueEntry(
+    TaskQueueId queue_id) const {
+  SharedLock entries_lock(*entries_mutex_);
+  return queue_entries_.at(queue_id);
+}
+
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
+  DrainInboxesUnlocked(queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
-  if (!HasPendingTasksUnlocked(queue_id)) {
+  const auto& entry = queue_entries_.at(queue_id);
+  const TaskQueueId owner = entry->subsumed_by;
+  if (owner != kUnmerged) {
+    // A producer that raced with Merge may have woken this loop instead of
+    // the owner. Hand its tasks over.
+    if (entry->inbox.DrainInto(entry->task_source.get()) > 0) {
+      ScheduleWakeUpUnlocked(owner);
+    }
     return nullptr;
   }
-  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
 
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
-  } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+  if (!ScheduleWakeUpUnlocked(queue_id)) {
+    return nullptr;
   }
+  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
 
   if (top.task.GetTargetTime() > from_time) {
     return nullptr;
@@ -140,19 +229,87 @@ fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
   return invocation;
 }
 
-void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
-                                           fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+// Whether a loop that is due to wake up at |wake_time| will run a task that
+// targets |time| without being woken up again.
+static bool IsWakeUpPendingBy(fml::TimePoint wake_time, fml::TimePoint time) {
+  return wake_time != fml::TimePoint::Max() && wake_time <= time;
+}
+
+void MessageLoopTaskQueues::WakeUpNoLaterThan(TaskQueueEntry& entry,
+                                              fml::TimePoint time) {
+  // The task was pushed before this load. If the consumer replaces the wake
+  // time after it, the consumer finds the task in the inbox when it checks
+  // for inboxed tasks after the store and wakes up right away for it.
+  if (IsWakeUpPendingBy(entry.wake_time, time)) {
+    return;
+  }
+  std::lock_guard wake_guard(entry.wake_mutex);
+  if (IsWakeUpPendingBy(entry.wake_time, time) || !entry.wakeable) {
+    return;
+  }
+  entry.wake_time = time;
+  entry.wakeable->WakeUp(time);
+}
+
+void MessageLoopTaskQueues::DrainInboxesUnlocked(TaskQueueId queue_id) const {
+  const auto& entry = queue_entries_.at(queue_id);
+  entry->inbox.DrainInto(entry->task_source.get());
+  for (TaskQueueId subsumed : entry->owner_of) {
+    const auto& subsumed_entry = queue_entries_.at(subsumed);
+    subsumed_entry->inbox.DrainInto(subsumed_entry->task_source.get());
+  }
+}
+
+bool MessageLoopTaskQueues::HasInboxedTasksUnlocked(
+    TaskQueueId queue_id) const {
+  const auto& entry = queue_entries_.at(queue_id);
+  if (!entry->inbox.IsEmpty()) {
+    return true;
+  }
+  return std::any_of(
+      entry->owner_of.begin(), entry->owner_of.end(),
+      [&](const auto& subsumed) {
+        return !queue_entries_.at(subsumed)->inbox.IsEmpty();
+      });
+}
+
+bool MessageLoopTaskQueues::ScheduleWakeUpUnlocked(TaskQueueId queue_id) const {
+  DrainInboxesUnlocked(queue_id);
+  const bool has_pending_tasks = HasPendingTasksUnlocked(queue_id);
+  fml::TimePoint wake_time = has_pending_tasks
+                                 ? GetNextWakeTimeUnlocked(queue_id)
+                                 : fml::TimePoint::Max();
+
+  const auto& entry = queue_entries_.at(queue_id);
+  std::lock_guard wake_guard(entry->wake_mutex);
+  if (!entry->wakeable) {
+    entry->wake_time = fml::TimePoint::Max();
+    return has_pending_tasks;
+  }
+  entry->wake_time = wake_time;
+  // A producer that pushed after the drain above may have skipped waking the
+  // loop because of the wake time replaced here, or may have asked for an
+  // earlier time that this wake up overrides. Its task is still in an inbox,
+  // so wake up right away and let the next call drain it rather than going
+  // around again while holding the queue lock.
+  if (HasInboxedTasksUnlocked(queue_id)) {
+    wake_time = std::min(wake_time, fml::TimePoint::Now());
+    entry->wake_time = wake_time;
+  }
+  if (wake_time != fml::TimePoint::Max()) {
+    entry->wakeable->WakeUp(wake_time);
   }
+  return has_pending_tasks;
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
-  if (queue_entry->subsumed_by != kUnmerged) {
+  if (queue_entry->subsumed_by.load() != kUnmerged) {
     return 0;
   }
+  DrainInboxesUnlocked(queue_id);
 
   size_t total_tasks = 0;
   total_tasks += queue_entry->task_source->GetNumPendingTasks();
@@ -168,6 +325,7 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
   queue_entries_.at(queue_id)->task_observers[key] = callback;
@@ -175,16 +333,18 @@ void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   queue_entries_.at(queue_id)->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != kUnmerged) {
+  if (queue_entries_.at(queue_id)->subsumed_by.load() != kUnmerged) {
     return observers;
   }
 
@@ -204,16 +364,19 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  const auto& entry = queue_entries_.at(queue_id);
+  std::lock_guard wake_guard(entry->wake_mutex);
+  FML_CHECK(!entry->wakeable) << "Wakeable can only be set once.";
+  entry->wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   auto& owner_entry = queue_entries_.at(owner);
   auto& subsumed_entry = queue_entries_.at(subsumed);
@@ -226,11 +389,12 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   // merged with other different queues.
 
   // Ensure owner_entry->subsumed_by being kUnmerged
-  if (owner_entry->subsumed_by != kUnmerged) {
+  if (owner_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: owner_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
-                     << ", owner->subsumed_by=" << owner_entry->subsumed_by;
+                     << ", owner->subsumed_by="
+                     << owner_entry->subsumed_by.load();
     return false;
   }
   // Ensure subsumed_entry->owner_of being empty
@@ -242,26 +406,25 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
   // Ensure subsumed_entry->subsumed_by being kUnmerged
-  if (subsumed_entry->subsumed_by != kUnmerged) {
+  if (subsumed_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: subsumed_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
                      << ", subsumed->subsumed_by="
-                     << subsumed_entry->subsumed_by;
+                     << subsumed_entry->subsumed_by.load();
     return false;
   }
   // All checking is OK, set merged state.
   owner_entry->owner_of.insert(subsumed);
   subsumed_entry->subsumed_by = owner;
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
-  }
+  ScheduleWakeUpUnlocked(owner);
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   const auto& owner_entry = queue_entries_.at(owner);
   if (owner_entry->owner_of.empty()) {
@@ -270,14 +433,14 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
         << owner << ", subsumed=" << subsumed;
     return false;
   }
-  if (owner_entry->subsumed_by != kUnmerged) {
+  if (owner_entry->subsumed_by.load() != kUnmerged) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry was subsumed by others, owner="
         << owner << ", subsumed=" << subsumed
-        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by;
+        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by.load();
     return false;
   }
-  if (queue_entries_.at(subsumed)->subsumed_by == kUnmerged) {
+  if (queue_entries_.at(subsumed)->subsumed_by.load() == kUnmerged) {
     FML_LOG(WARNING) << "Thread unmerging failed: subsumed_entry wasn't "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed;
@@ -293,19 +456,15 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
   queue_entries_.at(subsumed)->subsumed_by = kUnmerged;
   owner_entry->owner_of.erase(subsumed);
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
-  }
-
-  if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
-  }
+  ScheduleWakeUpUnlocked(owner);
+  ScheduleWakeUpUnlocked(subsumed);
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   if (owner == kUnmerged || subsumed == kUnmerged) {
     return false;
@@ -316,22 +475,27 @@ bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
   return queue_entries_.at(owner)->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  const auto& entry = queue_entries_.at(queue_id);
+  entry->task_source->PauseSecondary();
+  entry->secondary_paused = true;
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
+  SharedLock entries_lock(*entries_mutex_);
   std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
+  const auto& entry = queue_entries_.at(queue_id);
+  entry->task_source->ResumeSecondary();
+  entry->secondary_paused = entry->task_source->IsSecondaryPaused();
   // Schedule a wake as needed.
-  if (HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
-  }
+  ScheduleWakeUpUnlocked(queue_id);
 }
 
 // Subsumed queues will never have pending tasks.
@@ -339,7 +503,7 @@ void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
   const auto& entry = queue_entries_.at(queue_id);
-  bool is_subsumed = entry->subsumed_by != kUnmerged;
+  bool is_subsumed = entry->subsumed_by.load() != kUnmerged;
   if (is_subsumed) {
     return false;
   }
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -24,6 +25,46 @@ namespace fml {
 
 static const TaskQueueId kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 
+/// A lock-free multi-producer, single-consumer list of the tasks registered
+/// with one TaskQueue that have not yet been moved into its TaskSource.
+///
+/// Any thread may push. The consumer is whichever thread holds the queue lock
+/// of \p fml::MessageLoopTaskQueues, so the TaskSource heaps are only ever
+/// touched by one thread at a time. Tasks are numbered in push order by the
+/// consumer as it drains them, so producers share no counter.
+class TaskQueueInbox {
+ public:
+  TaskQueueInbox();
+
+  ~TaskQueueInbox();
+
+  /// Adds a task to the inbox without taking a lock.
+  void Push(const fml::closure& task,
+            fml::TimePoint target_time,
+            fml::TaskSourceGrade task_source_grade);
+
+  /// Moves every task pushed so far into \p task_source and returns how many
+  /// tasks were moved.
+  size_t DrainInto(TaskSource* task_source);
+
+  bool IsEmpty() const;
+
+ private:
+  struct Node {
+    fml::closure task;
+    fml::TimePoint target_time;
+    fml::TaskSourceGrade task_source_grade;
+    Node* next;
+  };
+
+  std::atomic<Node*> head_;
+
+  // The order given to the next task drained. Only touched by the consumer.
+  size_t next_order_ = 0;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskQueueInbox);
+};
+
 /// A collection of tasks and observers associated with one TaskQueue.
 ///
 /// Often a TaskQueue has a one-to-one relationship with a fml::MessageLoop,
@@ -36,16 +77,34 @@ class TaskQueueEntry {
   TaskObservers task_observers;
   std::unique_ptr<TaskSource> task_source;
 
+  /// Tasks registered with this TaskQueue that the consumer has not moved
+  /// into \p task_source yet.
+  TaskQueueInbox inbox;
+
   /// Set of the TaskQueueIds which is owned by this TaskQueue. If the set is
   /// empty, this TaskQueue does not own any other TaskQueues.
   std::set<TaskQueueId> owner_of;
 
   /// Identifies the TaskQueue that subsumes this TaskQueue. If it is kUnmerged
   /// it indicates that this TaskQueue is not owned by any other TaskQueue.
-  TaskQueueId subsumed_by;
+  std::atomic<TaskQueueId> subsumed_by;
 
   TaskQueueId created_for;
 
+  /// Mirrors whether the secondary heap of \p task_source is paused so that
+  /// producers can skip waking the loop for tasks that cannot run yet.
+  std::atomic_bool secondary_paused;
+
+  /// Serializes the calls into \p wakeable made by producers and by the
+  /// consumer, and the updates of \p wake_time.
+  std::mutex wake_mutex;
+
+  /// The time the wakeable of this TaskQueue was last asked to wake up at, or
+  /// fml::TimePoint::Max() if no wake up is pending. Producers read it without
+  /// taking \p wake_mutex to skip waking the loop when it is already due to
+  /// wake up in time for their task.
+  std::atomic<fml::TimePoint> wake_time;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -83,6 +142,20 @@ class MessageLoopTaskQueues {
                     fml::TaskSourceGrade task_source_grade =
                         fml::TaskSourceGrade::kUnspecified);
 
+  /// Like the overload above, for an entry returned by \p GetTaskQueueEntry.
+  /// Neither looks up the entry nor takes the entries lock unless the queue
+  /// is subsumed by another one.
+  void RegisterTask(TaskQueueEntry& queue_entry,
+                    const fml::closure& task,
+                    fml::TimePoint target_time,
+                    fml::TaskSourceGrade task_source_grade =
+                        fml::TaskSourceGrade::kUnspecified);
+
+  /// Returns the entry of \p queue_id so that producers that post to it often
+  /// can look it up once. Tasks registered with it after the queue has been
+  /// disposed never run.
+  std::shared_ptr<TaskQueueEntry> GetTaskQueueEntry(TaskQueueId queue_id) const;
+
   bool HasPendingTasks(TaskQueueId queue_id) const;
 
   fml::closure GetNextTaskToRun(TaskQueueId queue_id, fml::TimePoint from_time);
@@ -117,6 +190,12 @@ class MessageLoopTaskQueues {
   //     b. Be subsumed by a TaskQueue (an owner can never be subsumed).
   //     c. Be independent, i.e, neither owner nor be subsumed.
   //
+  //  4. RegisterTask pushes to the inbox of the queue without a lock, and
+  //     only takes the entries lock shared to find the owner of a subsumed
+  //     queue. It reads |subsumed_by| after the push, and Merge and Unmerge
+  //     drain the inboxes after updating it, so a task that races with either
+  //     is always seen by one of the two sides.
+  //
   //  Methods currently aware of the merged state of the queues:
   //  HasPendingTasks, GetNextTaskToRun, GetNumPendingTasks
   bool Merge(TaskQueueId owner, TaskQueueId subsumed);
@@ -144,7 +223,20 @@ class MessageLoopTaskQueues {
 
   ~MessageLoopTaskQueues();
 
-  void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
+  // Wakes the loop at |time| unless it is already due to wake up no later than
+  // that, in which case neither the wake lock nor the wakeable is touched.
+  // Safe to call without holding |queue_mutex_|.
+  static void WakeUpNoLaterThan(TaskQueueEntry& entry, fml::TimePoint time);
+
+  // Moves the inboxed tasks of |queue_id| and the queues it owns into their
+  // task sources.
+  void DrainInboxesUnlocked(TaskQueueId queue_id) const;
+
+  bool HasInboxedTasksUnlocked(TaskQueueId queue_id) const;
+
+  // Drains the inboxes once and wakes the loop for the next pending task, if
+  // any. Returns whether there are pending tasks.
+  bool ScheduleWakeUpUnlocked(TaskQueueId queue_id) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
 
@@ -152,13 +244,17 @@ class MessageLoopTaskQueues {
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
+  // Guards the structure of |queue_entries_|. RegisterTask only takes it
+  // shared, so producers never block each other.
+  std::unique_ptr<fml::SharedMutex> entries_mutex_;
+
+  // Guards the task sources, observers and merge state of the entries. Always
+  // acquired after |entries_mutex_|.
   mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  std::map<TaskQueueId, std::shared_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_ = 0;
 
-  std::atomic_int order_;
-
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(MessageLoopTaskQueues);
 };
 
@@ -66,5 +66,119 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Registers tasks from |state.range(0)| threads. When |shared_queue| is true
+// all of the threads post to the same task queue, like platform channel
+// traffic flooding the platform and UI threads. Otherwise every thread posts
+// to its own queue, which should not contend at all.
+static void BM_RegisterTasksFromManyThreads(benchmark::State& state,
+                                            bool shared_queue) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  std::vector<TaskQueueId> queue_ids;
+  std::vector<std::shared_ptr<TaskQueueEntry>> queue_entries;
+  queue_ids.reserve(num_producers);
+  queue_entries.reserve(num_producers);
+  queue_ids.push_back(task_queue->CreateTaskQueue());
+  for (int i = 1; i < num_producers; i++) {
+    queue_ids.push_back(shared_queue ? queue_ids[0]
+                                     : task_queue->CreateTaskQueue());
+  }
+  // Producers look up their queue once, like the message loops do.
+  for (TaskQueueId queue_id : queue_ids) {
+    queue_entries.push_back(task_queue->GetTaskQueueEntry(queue_id));
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_producers);
+    CountDownLatch ready(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      threads.emplace_back([queue_entry = queue_entries[i].get(), &task_queue,
+                            past, &ready]() {
+        ready.CountDown();
+        ready.Wait();
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(*queue_entry, [] {}, past);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    state.PauseTiming();
+    task_queue->DisposeTasks(queue_ids[0]);
+    if (!shared_queue) {
+      for (int i = 1; i < num_producers; i++) {
+        task_queue->DisposeTasks(queue_ids[i]);
+      }
+    }
+    state.ResumeTiming();
+  }
+
+  for (int i = 0; i < (shared_queue ? 1 : num_producers); i++) {
+    task_queue->Dispose(queue_ids[i]);
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          num_tasks_per_producer);
+}
+
+// Registers tasks from |state.range(0)| threads into one queue while its loop
+// thread keeps draining it, so producers also contend with the consumer.
+static void BM_RegisterTasksWhileDraining(benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const int num_tasks = num_producers * num_tasks_per_producer;
+  const fml::TimePoint past = fml::TimePoint::Now();
+  const TaskQueueId queue_id = task_queue->CreateTaskQueue();
+  TaskQueueEntry* queue_entry = task_queue->GetTaskQueueEntry(queue_id).get();
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      threads.emplace_back([queue_entry, &task_queue, past]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(*queue_entry, [] {}, past);
+        }
+      });
+    }
+
+    int num_invocations = 0;
+    while (num_invocations < num_tasks) {
+      fml::closure invocation =
+          task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Max());
+      if (invocation) {
+        invocation();
+        num_invocations++;
+      }
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  task_queue->Dispose(queue_id);
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK_CAPTURE(BM_RegisterTasksFromManyThreads, SharedQueue, true)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_RegisterTasksFromManyThreads, QueuePerThread, false)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK(BM_RegisterTasksWhileDraining)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
@@ -124,18 +124,24 @@ TEST(MessageLoopTaskQueue, RegisterTasksOnMergedQueuesPreserveTaskOrdering) {
   auto raster1_queue = task_queue->CreateTaskQueue();
   auto raster2_queue = task_queue->CreateTaskQueue();
   int test_val = 0;
+  // Tasks of different queues are ordered by their target times, which are
+  // kept apart and in the past so the order does not depend on the clock.
+  const auto base = fml::TimePoint::Now() - fml::TimeDelta::FromSeconds(1);
+  auto time = [base](int i) {
+    return base + fml::TimeDelta::FromMicroseconds(i);
+  };
 
   // order 0 in raster1_queue
   task_queue->RegisterTask(
-      raster1_queue, [&test_val]() { test_val = 0; }, fml::TimePoint::Now());
+      raster1_queue, [&test_val]() { test_val = 0; }, time(0));
 
   // order 1 in platform_queue
   task_queue->RegisterTask(
-      platform_queue, [&test_val]() { test_val = 1; }, fml::TimePoint::Now());
+      platform_queue, [&test_val]() { test_val = 1; }, time(1));
 
   // order 2 in raster2_queue
   task_queue->RegisterTask(
-      raster2_queue, [&test_val]() { test_val = 2; }, fml::TimePoint::Now());
+      raster2_queue, [&test_val]() { test_val = 2; }, time(2));
 
   task_queue->Merge(platform_queue, raster1_queue);
   ASSERT_TRUE(task_queue->Owns(platform_queue, raster1_queue));
@@ -163,25 +169,31 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   auto platform_queue = task_queue->CreateTaskQueue();
   auto raster_queue = task_queue->CreateTaskQueue();
   int test_val = 0;
+  // Tasks of different queues are ordered by their target times, which are
+  // kept apart and in the past so the order does not depend on the clock.
+  const auto base = fml::TimePoint::Now() - fml::TimeDelta::FromSeconds(1);
+  auto time = [base](int i) {
+    return base + fml::TimeDelta::FromMicroseconds(i);
+  };
 
   // order 0 in platform_queue
   task_queue->RegisterTask(
-      platform_queue, [&test_val]() { test_val = 0; }, fml::TimePoint::Now());
+      platform_queue, [&test_val]() { test_val = 0; }, time(0));
   // order 1 in platform_queue
   task_queue->RegisterTask(
-      platform_queue, [&test_val]() { test_val = 1; }, fml::TimePoint::Now());
+      platform_queue, [&test_val]() { test_val = 1; }, time(1));
   // order 2 in raster_queue
   task_queue->RegisterTask(
-      raster_queue, [&test_val]() { test_val = 2; }, fml::TimePoint::Now());
+      raster_queue, [&test_val]() { test_val = 2; }, time(2));
   // order 3 in raster_queue
   task_queue->RegisterTask(
-      raster_queue, [&test_val]() { test_val = 3; }, fml::TimePoint::Now());
+      raster_queue, [&test_val]() { test_val = 3; }, time(3));
   // order 4 in platform_queue
   task_queue->RegisterTask(
-      platform_queue, [&test_val]() { test_val = 4; }, fml::TimePoint::Now());
+      platform_queue, [&test_val]() { test_val = 4; }, time(4));
   // order 5 in raster_queue
   task_queue->RegisterTask(
-      raster_queue, [&test_val]() { test_val = 5; }, fml::TimePoint::Now());
+      raster_queue, [&test_val]() { test_val = 5; }, time(5));
 
   ASSERT_TRUE(task_queue->Merge(platform_queue, raster_queue));
   ASSERT_TRUE(task_queue->Owns(platform_queue, raster_queue));
@@ -270,14 +282,44 @@ TEST(MessageLoopTaskQueue, WakeUpIndependentOfTime) {
       [&num_wakes](fml::TimePoint wake_time) { ++num_wakes; });
   task_queue->SetWakeable(queue_id, wakeable.get());
 
-  task_queue->RegisterTask(
-      queue_id, []() {}, ChronoTicksSinceEpoch());
   task_queue->RegisterTask(
       queue_id, []() {}, fml::TimePoint::Max());
+  task_queue->RegisterTask(
+      queue_id, []() {}, ChronoTicksSinceEpoch());
 
   ASSERT_TRUE(num_wakes == 2);
 }
 
+TEST(MessageLoopTaskQueue, DoesNotWakeUpAgainForLaterTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+
+  std::vector<fml::TimePoint> wakes;
+  auto wakeable = std::make_unique<TestWakeable>(
+      [&wakes](fml::TimePoint wake_time) { wakes.push_back(wake_time); });
+  task_queue->SetWakeable(queue_id, wakeable.get());
+
+  const auto time1 = ChronoTicksSinceEpoch();
+  const auto time2 = time1 + fml::TimeDelta::FromMilliseconds(1);
+  const auto time0 = time1 - fml::TimeDelta::FromMilliseconds(1);
+
+  task_queue->RegisterTask(
+      queue_id, []() {}, time1);
+  task_queue->RegisterTask(
+      queue_id, []() {}, time2);
+  task_queue->RegisterTask(
+      queue_id, []() {}, time1);
+
+  ASSERT_EQ(1UL, wakes.size());
+  ASSERT_EQ(time1, wakes[0]);
+
+  task_queue->RegisterTask(
+      queue_id, []() {}, time0);
+
+  ASSERT_EQ(2UL, wakes.size());
+  ASSERT_EQ(time0, wakes[1]);
+}
+
 TEST(MessageLoopTaskQueue, WokenUpWithNewerTime) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto queue_id = task_queue->CreateTaskQueue();
@@ -413,6 +455,110 @@ TEST(MessageLoopTaskQueue, ConcurrentQueueAndTaskCreatingCounts) {
   ASSERT_EQ(pending_tasks, kThreadCount * kThreadTaskCount);
 }
 
+//------------------------------------------------------------------------------
+/// Verifies that tasks registered from many threads while the queue is being
+/// drained all run exactly once, in order for each producer.
+///
+TEST(MessageLoopTaskQueue, ConcurrentProducersWithConcurrentConsumer) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queues->CreateTaskQueue();
+
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kThreadTaskCount = 1000;
+
+  std::vector<size_t> last_seen(kThreadCount, 0);
+  size_t tasks_run = 0;
+  bool ordered = true;
+
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < kThreadCount; thread++) {
+    threads.emplace_back([&, thread]() {
+      for (size_t i = 1; i <= kThreadTaskCount; i++) {
+        task_queues->RegisterTask(
+            queue_id,
+            [&, thread, i]() {
+              ordered = ordered && last_seen[thread] + 1 == i;
+              last_seen[thread] = i;
+              tasks_run++;
+            },
+            ChronoTicksSinceEpoch());
+      }
+    });
+  }
+
+  while (tasks_run < kThreadCount * kThreadTaskCount) {
+    auto invocation =
+        task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Max());
+    if (invocation) {
+      invocation();
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_TRUE(ordered);
+  ASSERT_FALSE(task_queues->HasPendingTasks(queue_id));
+}
+
+TEST(MessageLoopTaskQueue, PausedSecondaryTasksDoNotWakeUntilResumed) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+
+  std::vector<fml::TimePoint> wakes;
+  auto wakeable = std::make_unique<TestWakeable>(
+      [&wakes](fml::TimePoint wake_time) { wakes.push_back(wake_time); });
+  task_queue->SetWakeable(queue_id, wakeable.get());
+
+  task_queue->PauseSecondarySource(queue_id);
+  const auto time = ChronoTicksSinceEpoch();
+  task_queue->RegisterTask(
+      queue_id, []() {}, time, fml::TaskSourceGrade::kDartMicroTasks);
+
+  ASSERT_EQ(0UL, wakes.size());
+  ASSERT_FALSE(task_queue->HasPendingTasks(queue_id));
+
+  task_queue->ResumeSecondarySource(queue_id);
+
+  ASSERT_EQ(1UL, wakes.size());
+  ASSERT_EQ(time, wakes[0]);
+  ASSERT_TRUE(task_queue->HasPendingTasks(queue_id));
+}
+
+TEST(MessageLoopTaskQueue, RegisterTasksThroughTaskQueueEntry) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  auto queue_entry = task_queue->GetTaskQueueEntry(queue_id);
+
+  std::vector<fml::TimePoint> wakes;
+  auto wakeable = std::make_unique<TestWakeable>(
+      [&wakes](fml::TimePoint wake_time) { wakes.push_back(wake_time); });
+  task_queue->SetWakeable(queue_id, wakeable.get());
+
+  // Tasks that target the same time run in the order they were registered.
+  std::vector<int> values;
+  const auto time = ChronoTicksSinceEpoch();
+  for (int i = 0; i < 3; i++) {
+    task_queue->RegisterTask(
+        *queue_entry, [&values, i]() { values.push_back(i); }, time);
+  }
+  ASSERT_EQ(1UL, wakes.size());
+  ASSERT_EQ(time, wakes[0]);
+  ASSERT_EQ(3UL, task_queue->GetNumPendingTasks(queue_id));
+  while (fml::closure invocation =
+             task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Max())) {
+    invocation();
+  }
+  ASSERT_EQ(values, std::vector<int>({0, 1, 2}));
+
+  // The loop of a disposed queue is not woken up anymore.
+  task_queue->Dispose(queue_id);
+  const size_t wake_count = wakes.size();
+  task_queue->RegisterTask(*queue_entry, []() {}, time);
+  ASSERT_EQ(wake_count, wakes.size());
+}
+
 TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto platform_queue = task_queue->CreateTaskQueue();
@@ -443,12 +589,21 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
 
   task_queue->Merge(platform_queue, raster_queue);
 
+  ASSERT_EQ(2UL, wakes.size());
+  ASSERT_EQ(time1, wakes[1]);
+
+  // The platform queue is already due to wake up before the task.
   task_queue->RegisterTask(
       raster_queue, []() {}, time2);
 
+  ASSERT_EQ(2UL, wakes.size());
+
+  auto time0 = time1 - fml::TimeDelta::FromMilliseconds(1);
+  task_queue->RegisterTask(
+      raster_queue, []() {}, time0);
+
   ASSERT_EQ(3UL, wakes.size());
-  ASSERT_EQ(time1, wakes[1]);
-  ASSERT_EQ(time1, wakes[2]);
+  ASSERT_EQ(time0, wakes[2]);
 }
 
 }  // namespace testing
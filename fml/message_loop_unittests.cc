@@ -6,6 +6,7 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
 #include <thread>
 
@@ -191,6 +192,108 @@ TEST(MessageLoop, CanCreateAndShutdownConcurrentMessageLoopsOverAndOver) {
   }
 }
 
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopRunsAllTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      4, fml::ConcurrentMessageLoop::SchedulingMode::kWorkStealing);
+  ASSERT_EQ(loop->GetSchedulingMode(),
+            fml::ConcurrentMessageLoop::SchedulingMode::kWorkStealing);
+  auto task_runner = loop->GetTaskRunner();
+  // Every task posted from outside the loop posts more tasks from a worker.
+  const size_t kCount = 64;
+  const size_t kNestedCount = 16;
+  fml::CountDownLatch posted_latch(kCount);
+  fml::CountDownLatch latch(kCount * kNestedCount);
+  std::atomic_size_t ran = 0;
+  for (size_t i = 0; i < kCount; ++i) {
+    task_runner->PostTask([&]() {
+      ASSERT_TRUE(loop->RunsTasksOnCurrentThread());
+      for (size_t j = 0; j < kNestedCount; ++j) {
+        task_runner->PostTask([&]() {
+          ++ran;
+          latch.CountDown();
+        });
+      }
+      // Posting briefly holds a reference to the loop. Don't let the loop be
+      // collected on a worker.
+      posted_latch.CountDown();
+    });
+  }
+  posted_latch.Wait();
+  latch.Wait();
+  ASSERT_EQ(ran, kCount * kNestedCount);
+}
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopRunsTasksOnAllWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      4, fml::ConcurrentMessageLoop::SchedulingMode::kWorkStealing);
+  fml::CountDownLatch latch(loop->GetWorkerCount());
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), loop->GetWorkerCount());
+}
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopRunsTasksPostedAtShutdown) {
+  const size_t kCount = 1000;
+  std::atomic_size_t ran = 0;
+  {
+    auto loop = fml::ConcurrentMessageLoop::Create(
+        2, fml::ConcurrentMessageLoop::SchedulingMode::kWorkStealing);
+    auto task_runner = loop->GetTaskRunner();
+    std::thread poster([&]() {
+      for (size_t i = 0; i < kCount; ++i) {
+        task_runner->PostTask([&]() { ++ran; });
+      }
+    });
+    loop->Terminate();
+    poster.join();
+    // Destroying the loop joins the workers.
+  }
+  // Each task ran either on a worker or on the posting thread.
+  ASSERT_EQ(ran, kCount);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsPriorityTasksFirst) {
+  using SchedulingMode = fml::ConcurrentMessageLoop::SchedulingMode;
+  for (auto mode :
+       {SchedulingMode::kSharedQueue, SchedulingMode::kWorkStealing}) {
+    auto loop = fml::ConcurrentMessageLoop::Create(1, mode);
+    auto task_runner = loop->GetTaskRunner();
+    fml::AutoResetWaitableEvent worker_busy;
+    fml::AutoResetWaitableEvent release_worker;
+    fml::CountDownLatch latch(3);
+    std::vector<int> order;
+    // Keep the only worker busy until everything else has been posted.
+    task_runner->PostTask([&]() {
+      worker_busy.Signal();
+      release_worker.Wait();
+    });
+    worker_busy.Wait();
+    task_runner->PostTask([&]() {
+      order.push_back(1);
+      latch.CountDown();
+    });
+    task_runner->PostTask([&]() {
+      order.push_back(2);
+      latch.CountDown();
+    });
+    task_runner->PostPriorityTask([&]() {
+      order.push_back(0);
+      latch.CountDown();
+    });
+    release_worker.Signal();
+    latch.Wait();
+    ASSERT_EQ(order, (std::vector<int>{0, 1, 2}));
+  }
+}
+
 TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   auto loop = fml::ConcurrentMessageLoop::Create();
   auto task_runner = loop->GetTaskRunner();
@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/parallel_for.h"
+
+#include <atomic>
+#include <condition_variable>
+
+#include "flutter/fml/logging.h"
+
+namespace fml {
+
+namespace {
+
+// Shared between the calling thread and the helpers it posts. Helpers that
+// only get to run after the range has been handed out still touch it, so it
+// is reference counted rather than living on the stack of the caller.
+class ParallelForState {
+ public:
+  ParallelForState(size_t count,
+                   size_t grain_size,
+                   size_t participants,
+                   const std::function<void(size_t, size_t)>* body)
+      : count_(count),
+        grain_size_(grain_size),
+        participants_(participants),
+        body_(body) {}
+
+  // Processes chunks until none are left.
+  void Run() {
+    size_t begin = 0;
+    size_t end = 0;
+    while (TakeChunk(begin, end)) {
+      // |body_| is only dereferenced for chunks that were taken, and the
+      // caller does not return until all of those are done.
+      (*body_)(begin, end);
+      size_t done = end - begin;
+      if (completed_.fetch_add(done) + done == count_) {
+        std::scoped_lock lock(mutex_);
+        completed_condition_.notify_all();
+      }
+    }
+  }
+
+  void WaitForCompletion() {
+    std::unique_lock lock(mutex_);
+    completed_condition_.wait(lock, [&]() { return completed_ == count_; });
+  }
+
+ private:
+  const size_t count_;
+  const size_t grain_size_;
+  const size_t participants_;
+  const std::function<void(size_t, size_t)>* body_;
+  std::atomic_size_t next_ = 0;
+  std::atomic_size_t completed_ = 0;
+  std::mutex mutex_;
+  std::condition_variable completed_condition_;
+
+  // Guided self-scheduling: every chunk is a fraction of what is left, so
+  // early chunks are large and cheap to hand out while the last ones are
+  // small enough for the participants to finish at about the same time.
+  bool TakeChunk(size_t& begin, size_t& end) {
+    begin = next_.load();
+    size_t size = 0;
+    do {
+      if (begin >= count_) {
+        return false;
+      }
+      size_t remaining = count_ - begin;
+      size = std::clamp(remaining / (2 * participants_), grain_size_,
+                        remaining);
+    } while (!next_.compare_exchange_weak(begin, begin + size));
+    end = begin + size;
+    return true;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParallelForState);
+};
+
+}  // namespace
+
+void ParallelFor(const std::shared_ptr<ConcurrentTaskRunner>& task_runner,
+                 size_t count,
+                 const std::function<void(size_t begin, size_t end)>& body,
+                 size_t grain_size) {
+  if (count == 0) {
+    return;
+  }
+  grain_size = std::max<size_t>(grain_size, 1u);
+  const size_t max_chunks = (count + grain_size - 1) / grain_size;
+  const size_t helper_count =
+      task_runner ? std::min(task_runner->GetWorkerCount(), max_chunks - 1)
+                  : 0u;
+  if (helper_count == 0) {
+    body(0, count);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>(count, grain_size,
+                                                  helper_count + 1, &body);
+  for (size_t i = 0; i < helper_count; i++) {
+    task_runner->PostTask([state]() { state->Run(); });
+  }
+  state->Run();
+  state->WaitForCompletion();
+}
+
+}  // namespace fml
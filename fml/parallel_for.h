@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_PARALLEL_FOR_H_
+#define FLUTTER_FML_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Invokes `body(begin, end)` over disjoint chunks that together
+///             cover `[0, count)`, using the workers of the loop behind
+///             `task_runner` as well as the calling thread.
+///
+///             Chunks are handed out on demand and shrink as the range runs
+///             out, starting at about an even share per participant and never
+///             going below `grain_size` items, so uneven per-item costs still
+///             balance across threads.
+///
+///             The calling thread does not block while there is work left. It
+///             processes chunks like any worker, so the call completes even if
+///             none of the posted helpers get to run, for instance when it is
+///             made from a task on the same loop. It returns once every chunk
+///             has been processed.
+///
+/// @param[in]  task_runner  The runner of the concurrent loop to borrow
+///                          workers from. If null, `body` is invoked once on
+///                          the calling thread for the whole range.
+/// @param[in]  count        The number of items.
+/// @param[in]  body         Processes the items in `[begin, end)`. Invoked
+///                          concurrently from multiple threads.
+/// @param[in]  grain_size   The smallest number of items worth handing to
+///                          another thread.
+///
+void ParallelFor(const std::shared_ptr<ConcurrentTaskRunner>& task_runner,
+                 size_t count,
+                 const std::function<void(size_t begin, size_t end)>& body,
+                 size_t grain_size = 1);
+
+//------------------------------------------------------------------------------
+/// @brief      Maps chunks of `[0, count)` to values of type `T` in parallel
+///             using `map(begin, end)` and folds them with `reduce`.
+///
+///             Partial results are folded in the order of the chunks they
+///             were computed for, starting with `identity`, so `reduce` only
+///             needs to be associative.
+///
+/// @see        `ParallelFor`
+///
+template <typename T, typename Map, typename Reduce>
+T ParallelReduce(const std::shared_ptr<ConcurrentTaskRunner>& task_runner,
+                 size_t count,
+                 T identity,
+                 const Map& map,
+                 const Reduce& reduce,
+                 size_t grain_size = 1) {
+  std::mutex partials_mutex;
+  std::vector<std::pair<size_t, T>> partials;
+  ParallelFor(
+      task_runner, count,
+      [&](size_t begin, size_t end) {
+        T partial = map(begin, end);
+        std::scoped_lock lock(partials_mutex);
+        partials.emplace_back(begin, std::move(partial));
+      },
+      grain_size);
+  std::sort(partials.begin(), partials.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  T result = std::move(identity);
+  for (auto& partial : partials) {
+    result = reduce(std::move(result), std::move(partial.second));
+  }
+  return result;
+}
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_PARALLEL_FOR_H_
@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/parallel_for.h"
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+constexpr size_t kWorkerCount = 4;
+
+// Fills a small cell of a shared buffer, like rasterizing one glyph into its
+// slot in the glyph atlas. The cost varies per item the way glyph sizes do.
+void RasterizeCell(std::vector<uint8_t>& pixels, size_t cell) {
+  const size_t cell_size = 64;
+  const size_t iterations = 1 + (cell * 7919) % 8;
+  uint8_t* data = pixels.data() + cell * cell_size;
+  for (size_t pass = 0; pass < iterations; pass++) {
+    for (size_t i = 0; i < cell_size; i++) {
+      data[i] = static_cast<uint8_t>(data[i] * 31 + i + pass);
+    }
+  }
+  benchmark::DoNotOptimize(data);
+}
+
+}  // namespace
+
+static void BM_ParallelForCells(benchmark::State& state, bool parallel) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = parallel ? loop->GetTaskRunner() : nullptr;
+  const size_t cell_count = state.range(0);
+  std::vector<uint8_t> pixels(cell_count * 64);
+
+  while (state.KeepRunning()) {
+    ParallelFor(
+        task_runner, cell_count,
+        [&pixels](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            RasterizeCell(pixels, i);
+          }
+        },
+        16);
+  }
+
+  state.SetItemsProcessed(state.iterations() * cell_count);
+}
+
+static void BM_ParallelReduceSum(benchmark::State& state, bool parallel) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = parallel ? loop->GetTaskRunner() : nullptr;
+  const size_t count = state.range(0);
+  std::vector<float> values(count, 0.5f);
+
+  while (state.KeepRunning()) {
+    float sum = ParallelReduce(
+        task_runner, count, 0.0f,
+        [&values](size_t begin, size_t end) {
+          float partial = 0.0f;
+          for (size_t i = begin; i < end; i++) {
+            partial += values[i];
+          }
+          return partial;
+        },
+        [](float a, float b) { return a + b; }, 4096);
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_CAPTURE(BM_ParallelForCells, Serial, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ParallelForCells, Parallel, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ParallelReduceSum, Serial, false)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ParallelReduceSum, Parallel, true)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
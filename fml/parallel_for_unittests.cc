@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(ParallelForTest, VisitsEveryIndexExactlyOnce) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  const size_t kCount = 10000;
+  std::vector<std::atomic_int> visits(kCount);
+  ParallelFor(loop->GetTaskRunner(), kCount, [&](size_t begin, size_t end) {
+    ASSERT_LT(begin, end);
+    ASSERT_LE(end, kCount);
+    for (size_t i = begin; i < end; i++) {
+      visits[i]++;
+    }
+  });
+  for (size_t i = 0; i < kCount; i++) {
+    ASSERT_EQ(visits[i], 1) << i;
+  }
+}
+
+TEST(ParallelForTest, RespectsGrainSize) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  const size_t kCount = 1000;
+  const size_t kGrainSize = 64;
+  std::mutex chunks_mutex;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  ParallelFor(
+      loop->GetTaskRunner(), kCount,
+      [&](size_t begin, size_t end) {
+        std::scoped_lock lock(chunks_mutex);
+        chunks.emplace_back(begin, end);
+      },
+      kGrainSize);
+  std::sort(chunks.begin(), chunks.end());
+  size_t next = 0;
+  for (const auto& [begin, end] : chunks) {
+    ASSERT_EQ(begin, next);
+    // Only the last chunk may be smaller than the grain size.
+    if (end != kCount) {
+      ASSERT_GE(end - begin, kGrainSize);
+    }
+    next = end;
+  }
+  ASSERT_EQ(next, kCount);
+}
+
+TEST(ParallelForTest, RunsSeriallyWithoutTaskRunner) {
+  size_t calls = 0;
+  ParallelFor(nullptr, 100, [&](size_t begin, size_t end) {
+    ASSERT_EQ(begin, 0u);
+    ASSERT_EQ(end, 100u);
+    calls++;
+  });
+  ASSERT_EQ(calls, 1u);
+}
+
+TEST(ParallelForTest, CompletesWhenCalledFromEveryWorker) {
+  // Every worker is busy in its own ParallelFor, so none of the helpers get
+  // to run until the callers are done. The callers must not wait for them.
+  const size_t kWorkerCount = 2;
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  CountDownLatch latch(kWorkerCount);
+  std::atomic_size_t total = 0;
+  for (size_t i = 0; i < kWorkerCount; i++) {
+    task_runner->PostTask([&]() {
+      ParallelFor(task_runner, 1000, [&](size_t begin, size_t end) {
+        total += end - begin;
+      });
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+  ASSERT_EQ(total, kWorkerCount * 1000);
+}
+
+TEST(ParallelForTest, ReduceFoldsChunksInOrder) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  const size_t kCount = 500;
+  // String concatenation is associative but not commutative.
+  std::string result = ParallelReduce(
+      loop->GetTaskRunner(), kCount, std::string(),
+      [](size_t begin, size_t end) {
+        std::string partial;
+        for (size_t i = begin; i < end; i++) {
+          partial += static_cast<char>('a' + i % 26);
+        }
+        return partial;
+      },
+      [](std::string a, std::string b) { return a + b; });
+  ASSERT_EQ(result.size(), kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    ASSERT_EQ(result[i], static_cast<char>('a' + i % 26));
+  }
+
+  std::vector<size_t> values(kCount);
+  std::iota(values.begin(), values.end(), 1);
+  size_t sum = ParallelReduce(
+      loop->GetTaskRunner(), kCount, size_t{0},
+      [&](size_t begin, size_t end) {
+        return std::accumulate(values.begin() + begin, values.begin() + end,
+                               size_t{0});
+      },
+      [](size_t a, size_t b) { return a + b; });
+  ASSERT_EQ(sum, kCount * (kCount + 1) / 2);
+}
+
+}  // namespace testing
+}  // namespace fml
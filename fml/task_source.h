@@ -71,6 +71,10 @@ class TaskSource {
   /// Resume providing tasks from secondary task heap.
   void ResumeSecondary();
 
+  /// Returns true if there are outstanding pause requests for the secondary
+  /// task heap.
+  bool IsSecondaryPaused() const;
+
  private:
   const fml::TaskQueueId task_queue_id_;
   fml::DelayedTaskQueue primary_task_queue_;
@@ -40,16 +40,21 @@ ContentContext& AiksContext::GetContentContext() const {
   return *content_context_;
 }
 
-bool AiksContext::Render(const Picture& picture, RenderTarget& render_target) {
+bool AiksContext::Render(const Picture& picture,
+                         RenderTarget& render_target,
+                         bool reset_host_buffer) {
   if (!IsValid()) {
     return false;
   }
 
+  bool result = true;
   if (picture.pass) {
-    return picture.pass->Render(*content_context_, render_target);
+    result = picture.pass->Render(*content_context_, render_target);
   }
-
-  return true;
+  if (reset_host_buffer) {
+    content_context_->GetTransientsBuffer()->Reset();
+  }
+  return result;
 }
 
 }  // namespace impeller
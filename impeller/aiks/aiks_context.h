@@ -39,7 +39,24 @@ class AiksContext {
 
   ContentContext& GetContentContext() const;
 
-  bool Render(const Picture& picture, RenderTarget& render_target);
+  //----------------------------------------------------------------------------
+  /// @brief      Renders the picture into the render target.
+  ///
+  /// @param[in]  reset_host_buffer  Whether this render ends a frame, after
+  ///                                which the transients buffer of the
+  ///                                content context moves on to the device
+  ///                                buffers of the next frame. This must be
+  ///                                set for at most one render per frame,
+  ///                                and not for offscreen renders such as
+  ///                                snapshots. Frames that render several
+  ///                                views or backing stores leave it unset
+  ///                                and reset the transients buffer once
+  ///                                they are all rendered, as the
+  ///                                rasterizer does.
+  ///
+  bool Render(const Picture& picture,
+              RenderTarget& render_target,
+              bool reset_host_buffer);
 
  private:
   std::shared_ptr<Context> context_;
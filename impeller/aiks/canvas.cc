@@ -116,6 +116,10 @@ Canvas::~Canvas() = default;
 
 void Canvas::Initialize(std::optional<Rect> cull_rect) {
   initial_cull_rect_ = cull_rect;
+  if (use_arena_) {
+    arena_ = Arena::Create();
+  }
+  ArenaScope arena_scope(arena_);
   base_pass_ = std::make_unique<EntityPass>();
   current_pass_ = base_pass_.get();
   transform_stack_.emplace_back(CanvasStackEntry{.cull_rect = cull_rect});
@@ -127,6 +131,14 @@ void Canvas::Reset() {
   base_pass_ = nullptr;
   current_pass_ = nullptr;
   transform_stack_ = {};
+  arena_ = nullptr;
+}
+
+void Canvas::SetUseArena(bool use_arena) {
+  FML_DCHECK(GetSaveCount() == 1u && base_pass_->GetElementCount() == 0u);
+  use_arena_ = use_arena;
+  Reset();
+  Initialize(initial_cull_rect_);
 }
 
 void Canvas::Save() {
@@ -136,6 +148,7 @@ void Canvas::Save() {
 void Canvas::Save(bool create_subpass,
                   BlendMode blend_mode,
                   const std::shared_ptr<ImageFilter>& backdrop_filter) {
+  ArenaScope arena_scope(arena_);
   auto entry = CanvasStackEntry{};
   entry.transform = transform_stack_.back().transform;
   entry.cull_rect = transform_stack_.back().cull_rect;
@@ -166,6 +179,7 @@ void Canvas::Save(bool create_subpass,
 }
 
 bool Canvas::Restore() {
+  ArenaScope arena_scope(arena_);
   FML_DCHECK(transform_stack_.size() > 0);
   if (transform_stack_.size() == 1) {
     return false;
@@ -248,6 +262,7 @@ void Canvas::RestoreToCount(size_t count) {
 }
 
 void Canvas::DrawPath(Path path, const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   Entity entity;
   entity.SetTransform(GetCurrentTransform());
   entity.SetClipDepth(GetClipDepth());
@@ -258,6 +273,7 @@ void Canvas::DrawPath(Path path, const Paint& paint) {
 }
 
 void Canvas::DrawPaint(const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   Entity entity;
   entity.SetTransform(GetCurrentTransform());
   entity.SetClipDepth(GetClipDepth());
@@ -289,7 +305,7 @@ bool Canvas::AttemptDrawBlurredRRect(const Rect& rect,
   // For symmetrically mask blurred solid RRects, absorb the mask blur and use
   // a faster SDF approximation.
 
-  auto contents = std::make_shared<SolidRRectBlurContents>();
+  auto contents = Arena::MakeShared<SolidRRectBlurContents>();
   contents->SetColor(new_paint.color);
   contents->SetSigma(new_paint.mask_blur_descriptor->sigma);
   contents->SetRRect(rect, corner_radius);
@@ -308,6 +324,7 @@ bool Canvas::AttemptDrawBlurredRRect(const Rect& rect,
 }
 
 void Canvas::DrawLine(const Point& p0, const Point& p1, const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   Entity entity;
   entity.SetTransform(GetCurrentTransform());
   entity.SetClipDepth(GetClipDepth());
@@ -319,6 +336,7 @@ void Canvas::DrawLine(const Point& p0, const Point& p1, const Paint& paint) {
 }
 
 void Canvas::DrawRect(const Rect& rect, const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   if (paint.style == Paint::Style::kStroke) {
     DrawPath(PathBuilder{}.AddRect(rect).TakePath(), paint);
     return;
@@ -339,6 +357,7 @@ void Canvas::DrawRect(const Rect& rect, const Paint& paint) {
 }
 
 void Canvas::DrawOval(const Rect& rect, const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   if (rect.IsSquare()) {
     // Circles have slightly less overhead and can do stroking
     DrawCircle(rect.GetCenter(), rect.GetWidth() * 0.5f, paint);
@@ -368,6 +387,7 @@ void Canvas::DrawOval(const Rect& rect, const Paint& paint) {
 void Canvas::DrawRRect(const Rect& rect,
                        const Size& corner_radii,
                        const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   if (corner_radii.IsSquare() &&
       AttemptDrawBlurredRRect(rect, corner_radii.width, paint)) {
     return;
@@ -396,6 +416,7 @@ void Canvas::DrawRRect(const Rect& rect,
 void Canvas::DrawCircle(const Point& center,
                         Scalar radius,
                         const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   Size half_size(radius, radius);
   if (AttemptDrawBlurredRRect(
           Rect::MakeOriginSize(center - half_size, half_size * 2), radius,
@@ -418,6 +439,7 @@ void Canvas::DrawCircle(const Point& center,
 }
 
 void Canvas::ClipPath(Path path, Entity::ClipOperation clip_op) {
+  ArenaScope arena_scope(arena_);
   auto bounds = path.GetBoundingBox();
   ClipGeometry(Geometry::MakeFillPath(std::move(path)), clip_op);
   if (clip_op == Entity::ClipOperation::kIntersect) {
@@ -428,6 +450,7 @@ void Canvas::ClipPath(Path path, Entity::ClipOperation clip_op) {
 }
 
 void Canvas::ClipRect(const Rect& rect, Entity::ClipOperation clip_op) {
+  ArenaScope arena_scope(arena_);
   auto geometry = Geometry::MakeRect(rect);
   auto& cull_rect = transform_stack_.back().cull_rect;
   if (clip_op == Entity::ClipOperation::kIntersect &&                      //
@@ -449,6 +472,7 @@ void Canvas::ClipRect(const Rect& rect, Entity::ClipOperation clip_op) {
 }
 
 void Canvas::ClipOval(const Rect& bounds, Entity::ClipOperation clip_op) {
+  ArenaScope arena_scope(arena_);
   auto geometry = Geometry::MakeOval(bounds);
   auto& cull_rect = transform_stack_.back().cull_rect;
   if (clip_op == Entity::ClipOperation::kIntersect &&                      //
@@ -471,6 +495,7 @@ void Canvas::ClipOval(const Rect& bounds, Entity::ClipOperation clip_op) {
 void Canvas::ClipRRect(const Rect& rect,
                        const Size& corner_radii,
                        Entity::ClipOperation clip_op) {
+  ArenaScope arena_scope(arena_);
   // Does the rounded rect have a flat part on the top/bottom or left/right?
   bool flat_on_TB = corner_radii.width * 2 < rect.GetWidth();
   bool flat_on_LR = corner_radii.height * 2 < rect.GetHeight();
@@ -510,7 +535,7 @@ void Canvas::ClipRRect(const Rect& rect,
 
 void Canvas::ClipGeometry(const std::shared_ptr<Geometry>& geometry,
                           Entity::ClipOperation clip_op) {
-  auto contents = std::make_shared<ClipContents>();
+  auto contents = Arena::MakeShared<ClipContents>();
   contents->SetGeometry(geometry);
   contents->SetClipOperation(clip_op);
 
@@ -555,7 +580,7 @@ void Canvas::RestoreClip() {
   entity.SetTransform(GetCurrentTransform());
   // This path is empty because ClipRestoreContents just generates a quad that
   // takes up the full render target.
-  entity.SetContents(std::make_shared<ClipRestoreContents>());
+  entity.SetContents(Arena::MakeShared<ClipRestoreContents>());
   entity.SetClipDepth(GetClipDepth());
 
   GetCurrentPass().AddEntity(std::move(entity));
@@ -565,6 +590,7 @@ void Canvas::DrawPoints(std::vector<Point> points,
                         Scalar radius,
                         const Paint& paint,
                         PointStyle point_style) {
+  ArenaScope arena_scope(arena_);
   if (radius <= 0) {
     return;
   }
@@ -582,6 +608,7 @@ void Canvas::DrawPoints(std::vector<Point> points,
 }
 
 void Canvas::DrawPicture(const Picture& picture) {
+  ArenaScope arena_scope(arena_);
   if (!picture.pass) {
     return;
   }
@@ -629,6 +656,7 @@ void Canvas::DrawImageRect(const std::shared_ptr<Image>& image,
                            Rect dest,
                            const Paint& paint,
                            SamplerDescriptor sampler) {
+  ArenaScope arena_scope(arena_);
   if (!image || source.IsEmpty() || dest.IsEmpty()) {
     return;
   }
@@ -658,6 +686,7 @@ void Canvas::DrawImageRect(const std::shared_ptr<Image>& image,
 Picture Canvas::EndRecordingAsPicture() {
   Picture picture;
   picture.pass = std::move(base_pass_);
+  picture.arena = arena_;
 
   Reset();
   Initialize(initial_cull_rect_);
@@ -677,6 +706,7 @@ size_t Canvas::GetClipDepth() const {
 void Canvas::SaveLayer(const Paint& paint,
                        std::optional<Rect> bounds,
                        const std::shared_ptr<ImageFilter>& backdrop_filter) {
+  ArenaScope arena_scope(arena_);
   TRACE_EVENT0("flutter", "Canvas::saveLayer");
   Save(true, paint.blend_mode, backdrop_filter);
 
@@ -694,20 +724,21 @@ void Canvas::SaveLayer(const Paint& paint,
   // Only apply opacity peephole on default blending.
   if (paint.blend_mode == BlendMode::kSourceOver) {
     new_layer_pass.SetDelegate(
-        std::make_shared<OpacityPeepholePassDelegate>(paint));
+        Arena::MakeShared<OpacityPeepholePassDelegate>(paint));
   } else {
-    new_layer_pass.SetDelegate(std::make_shared<PaintPassDelegate>(paint));
+    new_layer_pass.SetDelegate(Arena::MakeShared<PaintPassDelegate>(paint));
   }
 }
 
 void Canvas::DrawTextFrame(const std::shared_ptr<TextFrame>& text_frame,
                            Point position,
                            const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   Entity entity;
   entity.SetClipDepth(GetClipDepth());
   entity.SetBlendMode(paint.blend_mode);
 
-  auto text_contents = std::make_shared<TextContents>();
+  auto text_contents = Arena::MakeShared<TextContents>();
   text_contents->SetTextFrame(text_frame);
   text_contents->SetColor(paint.color);
   text_contents->SetForceTextColor(paint.mask_blur_descriptor.has_value());
@@ -747,6 +778,7 @@ static bool UseColorSourceContents(
 void Canvas::DrawVertices(const std::shared_ptr<VerticesGeometry>& vertices,
                           BlendMode blend_mode,
                           const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   // Override the blend mode with kDestination in order to match the behavior
   // of Skia's SK_LEGACY_IGNORE_DRAW_VERTICES_BLEND_WITH_NO_SHADER flag, which
   // is enabled when the Flutter engine builds Skia.
@@ -794,7 +826,7 @@ void Canvas::DrawVertices(const std::shared_ptr<VerticesGeometry>& vertices,
         src_paint.CreateContentsForGeometry(Geometry::MakeRect(src_coverage));
   }
 
-  auto contents = std::make_shared<VerticesContents>();
+  auto contents = Arena::MakeShared<VerticesContents>();
   contents->SetAlpha(paint.color.alpha);
   contents->SetBlendMode(blend_mode);
   contents->SetGeometry(vertices);
@@ -812,11 +844,12 @@ void Canvas::DrawAtlas(const std::shared_ptr<Image>& atlas,
                        SamplerDescriptor sampler,
                        std::optional<Rect> cull_rect,
                        const Paint& paint) {
+  ArenaScope arena_scope(arena_);
   if (!atlas) {
     return;
   }
 
-  std::shared_ptr<AtlasContents> contents = std::make_shared<AtlasContents>();
+  std::shared_ptr<AtlasContents> contents = Arena::MakeShared<AtlasContents>();
   contents->SetColors(std::move(colors));
   contents->SetTransforms(std::move(transforms));
   contents->SetTextureCoordinates(std::move(texture_coordinates));
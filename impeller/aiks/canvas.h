@@ -167,11 +167,31 @@ class Canvas {
 
   Picture EndRecordingAsPicture();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the contents, geometry and element lists of
+  ///             the pictures recorded by this canvas are allocated from an
+  ///             arena, which is the default, or from the heap. Must be
+  ///             called before anything is recorded.
+  ///
+  ///             Each recording has an arena of its own that is handed over
+  ///             to the picture it ends in. The memory of the arena is freed
+  ///             at once when the last object in it is destroyed, which is
+  ///             normally when the picture is dropped after it has been
+  ///             rendered.
+  ///
+  void SetUseArena(bool use_arena);
+
+  /// @brief  Returns the arena of the picture being recorded, or null if it
+  ///         is recorded on the heap.
+  const std::shared_ptr<Arena>& GetArena() const { return arena_; }
+
  private:
   std::unique_ptr<EntityPass> base_pass_;
   EntityPass* current_pass_ = nullptr;
   std::deque<CanvasStackEntry> transform_stack_;
   std::optional<Rect> initial_cull_rect_;
+  bool use_arena_ = true;
+  std::shared_ptr<Arena> arena_;
 
   void Initialize(std::optional<Rect> cull_rect);
 
@@ -4,8 +4,35 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
 #include "impeller/aiks/canvas.h"
 
+namespace {
+
+std::atomic<size_t> gHeapAllocationCount = 0;
+
+}  // namespace
+
+// Count the heap allocations of the benchmarks.
+void* operator new(size_t size) {
+  gHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+  std::free(ptr);
+}
+
 namespace impeller {
 
 namespace {
@@ -38,26 +65,48 @@ size_t DrawLine(Canvas& canvas) {
 // A set of benchmarks that measures the CPU cost of encoding canvas operations.
 // These benchmarks do not measure the cost of conversion through the HAL, no
 // do they measure the GPU side cost of executing the required shader programs.
+//
+// Recording allocates contents, geometry and element lists from an arena that
+// is owned by the resulting picture, unless the `use_arena` argument is false.
+// The heap and arena allocations per draw call are reported as counters.
 template <class... Args>
 static void BM_CanvasRecord(benchmark::State& state, Args&&... args) {
   auto args_tuple = std::make_tuple(std::move(args)...);
   auto test_proc = std::get<CanvasCallback>(args_tuple);
+  bool use_arena = std::get<bool>(args_tuple);
 
   size_t op_count = 0u;
   size_t canvas_count = 0u;
+  size_t heap_allocation_count = 0u;
+  size_t arena_allocation_count = 0u;
   while (state.KeepRunning()) {
-    // A new canvas is allocated for each iteration to avoid the benchmark
-    // becoming a measurement of only the entity vector re-allocation time.
-    Canvas canvas;
-    op_count += test_proc(canvas);
-    canvas_count++;
+    size_t heap_allocations_before = gHeapAllocationCount;
+    {
+      // A new canvas is allocated for each iteration to avoid the benchmark
+      // becoming a measurement of only the entity vector re-allocation time.
+      Canvas canvas;
+      canvas.SetUseArena(use_arena);
+      op_count += test_proc(canvas);
+      canvas_count++;
+      if (canvas.GetArena()) {
+        arena_allocation_count += canvas.GetArena()->GetAllocationCount();
+      }
+    }
+    heap_allocation_count += gHeapAllocationCount - heap_allocations_before;
   }
   state.counters["TotalOpCount"] = op_count;
   state.counters["TotalCanvasCount"] = canvas_count;
+  state.counters["HeapAllocationsPerDraw"] =
+      static_cast<double>(heap_allocation_count) / op_count;
+  state.counters["ArenaAllocationsPerDraw"] =
+      static_cast<double>(arena_allocation_count) / op_count;
 }
 
-BENCHMARK_CAPTURE(BM_CanvasRecord, draw_rect, &DrawRect);
-BENCHMARK_CAPTURE(BM_CanvasRecord, draw_circle, &DrawCircle);
-BENCHMARK_CAPTURE(BM_CanvasRecord, draw_line, &DrawLine);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_rect, &DrawRect, true);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_rect_heap, &DrawRect, false);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_circle, &DrawCircle, true);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_circle_heap, &DrawCircle, false);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_line, &DrawLine, true);
+BENCHMARK_CAPTURE(BM_CanvasRecord, draw_line_heap, &DrawLine, false);
 
 }  // namespace impeller
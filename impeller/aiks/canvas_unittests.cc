@@ -354,6 +354,40 @@ TEST(AiksCanvasTest, DisableLocalBoundsRectForFilteredSaveLayers) {
   ASSERT_TRUE(canvas.GetCurrentLocalCullingBounds().has_value());
 }
 
+TEST(AiksCanvasTest, RecordsIntoAnArenaOwnedByThePicture) {
+  Canvas canvas;
+  std::shared_ptr<Arena> arena = canvas.GetArena();
+  ASSERT_NE(arena, nullptr);
+  for (int i = 0; i < 10; i++) {
+    canvas.DrawRect(Rect::MakeXYWH(i, i, 10, 10), {.color = Color::Red()});
+  }
+  // At least the contents and the geometry of every draw.
+  EXPECT_GE(arena->GetAllocationCount(), 20u);
+
+  Picture picture = canvas.EndRecordingAsPicture();
+  EXPECT_EQ(picture.arena, arena);
+  EXPECT_NE(canvas.GetArena(), arena);
+  EXPECT_GT(arena->GetLiveAllocationCount(), 0u);
+
+  std::weak_ptr<Arena> weak_arena = arena;
+  arena.reset();
+  picture.arena.reset();
+  ASSERT_FALSE(weak_arena.expired());
+  picture.pass.reset();
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(AiksCanvasTest, RecordsOnTheHeapWithoutAnArena) {
+  Canvas canvas;
+  canvas.SetUseArena(false);
+  EXPECT_EQ(canvas.GetArena(), nullptr);
+  canvas.DrawRect(Rect::MakeXYWH(0, 0, 10, 10), {.color = Color::Red()});
+
+  Picture picture = canvas.EndRecordingAsPicture();
+  EXPECT_EQ(picture.arena, nullptr);
+  EXPECT_EQ(picture.pass->GetElementCount(), 1u);
+}
+
 }  // namespace testing
 }  // namespace impeller
 
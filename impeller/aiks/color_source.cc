@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "impeller/aiks/paint.h"
+#include "impeller/base/arena.h"
 #include "impeller/core/sampler_descriptor.h"
 #include "impeller/entity/contents/conical_gradient_contents.h"
 #include "impeller/entity/contents/filters/color_filter_contents.h"
@@ -31,7 +32,7 @@ namespace impeller {
 
 ColorSource::ColorSource() noexcept
     : proc_([](const Paint& paint) -> std::shared_ptr<ColorSourceContents> {
-        auto contents = std::make_shared<SolidColorContents>();
+        auto contents = Arena::MakeShared<SolidColorContents>();
         contents->SetColor(paint.color);
         return contents;
       }){};
@@ -53,7 +54,7 @@ ColorSource ColorSource::MakeLinearGradient(Point start_point,
   result.proc_ = [start_point, end_point, colors = std::move(colors),
                   stops = std::move(stops), tile_mode,
                   effect_transform](const Paint& paint) {
-    auto contents = std::make_shared<LinearGradientContents>();
+    auto contents = Arena::MakeShared<LinearGradientContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetColors(colors);
     contents->SetStops(stops);
@@ -85,7 +86,7 @@ ColorSource ColorSource::MakeConicalGradient(Point center,
                   stops = std::move(stops), focus_center, focus_radius,
                   tile_mode, effect_transform](const Paint& paint) {
     std::shared_ptr<ConicalGradientContents> contents =
-        std::make_shared<ConicalGradientContents>();
+        Arena::MakeShared<ConicalGradientContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetColors(colors);
     contents->SetStops(stops);
@@ -116,7 +117,7 @@ ColorSource ColorSource::MakeRadialGradient(Point center,
   result.proc_ = [center, radius, colors = std::move(colors),
                   stops = std::move(stops), tile_mode,
                   effect_transform](const Paint& paint) {
-    auto contents = std::make_shared<RadialGradientContents>();
+    auto contents = Arena::MakeShared<RadialGradientContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetColors(colors);
     contents->SetStops(stops);
@@ -147,7 +148,7 @@ ColorSource ColorSource::MakeSweepGradient(Point center,
   result.proc_ = [center, start_angle, end_angle, colors = std::move(colors),
                   stops = std::move(stops), tile_mode,
                   effect_transform](const Paint& paint) {
-    auto contents = std::make_shared<SweepGradientContents>();
+    auto contents = Arena::MakeShared<SweepGradientContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetCenterAndAngles(center, start_angle, end_angle);
     contents->SetColors(colors);
@@ -170,7 +171,7 @@ ColorSource ColorSource::MakeImage(std::shared_ptr<Texture> texture,
   result.proc_ = [texture = std::move(texture), x_tile_mode, y_tile_mode,
                   sampler_descriptor = std::move(sampler_descriptor),
                   effect_transform](const Paint& paint) {
-    auto contents = std::make_shared<TiledTextureContents>();
+    auto contents = Arena::MakeShared<TiledTextureContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetTexture(texture);
     contents->SetTileModes(x_tile_mode, y_tile_mode);
@@ -200,7 +201,7 @@ ColorSource ColorSource::MakeRuntimeEffect(
                   uniform_data = std::move(uniform_data),
                   texture_inputs =
                       std::move(texture_inputs)](const Paint& paint) {
-    auto contents = std::make_shared<RuntimeEffectContents>();
+    auto contents = Arena::MakeShared<RuntimeEffectContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetRuntimeStage(runtime_stage);
     contents->SetUniformData(uniform_data);
@@ -217,7 +218,7 @@ ColorSource ColorSource::MakeScene(std::shared_ptr<scene::Node> scene_node,
   result.type_ = Type::kScene;
   result.proc_ = [scene_node = std::move(scene_node),
                   camera_transform](const Paint& paint) {
-    auto contents = std::make_shared<SceneContents>();
+    auto contents = Arena::MakeShared<SceneContents>();
     contents->SetOpacityFactor(paint.color.alpha);
     contents->SetNode(scene_node);
     contents->SetCameraTransform(camera_transform);
@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "impeller/base/arena.h"
 #include "impeller/entity/contents/color_source_contents.h"
 #include "impeller/entity/contents/filters/color_filter_contents.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
@@ -134,7 +135,7 @@ std::shared_ptr<FilterContents> Paint::MaskBlurDescriptor::CreateMaskBlur(
 
   /// 1. Create an opaque white mask of the original geometry.
 
-  auto mask = std::make_shared<SolidColorContents>();
+  auto mask = Arena::MakeShared<SolidColorContents>();
   mask->SetColor(Color::White());
   mask->SetGeometry(color_source_contents->GetGeometry());
 
@@ -84,7 +84,10 @@ std::shared_ptr<Texture> Picture::RenderToTexture(
     return nullptr;
   }
 
-  if (!context.Render(*this, target)) {
+  // Offscreen renders can happen in the middle of a frame, so they never move
+  // the transients buffer on to the next frame. Without onscreen frames, the
+  // memory it holds is bounded by |HostBuffer::kMaxFrameDeviceBufferCount|.
+  if (!context.Render(*this, target, /*reset_host_buffer=*/false)) {
     VALIDATION_LOG << "Could not render Picture to Texture.";
     return nullptr;
   }
@@ -20,6 +20,9 @@ namespace impeller {
 struct Picture {
   std::unique_ptr<EntityPass> pass;
 
+  /// The arena that the entities of the pass were allocated from, if any.
+  std::shared_ptr<Arena> arena;
+
   std::optional<Snapshot> Snapshot(AiksContext& context);
 
   std::shared_ptr<Image> ToImage(AiksContext& context, ISize size) const;
@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/base/arena.h"
+
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+namespace {
+
+thread_local Arena* tCurrentArena = nullptr;
+
+// Returns the offset of the first address at or after |data| + |offset| that
+// is aligned to |alignment|.
+size_t AlignOffset(const uint8_t* data, size_t offset, size_t alignment) {
+  auto address = reinterpret_cast<uintptr_t>(data) + offset;
+  auto aligned = (address + alignment - 1) & ~(alignment - 1);
+  return offset + (aligned - address);
+}
+
+}  // namespace
+
+std::shared_ptr<Arena> Arena::Create(size_t block_size) {
+  return std::shared_ptr<Arena>(new Arena(block_size));
+}
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {}
+
+Arena::~Arena() {
+  FML_DCHECK(live_allocation_count_ == 0);
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  FML_DCHECK(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  if (current_block_ < blocks_.size()) {
+    Block& block = blocks_[current_block_];
+    size_t start = AlignOffset(block.data.get(), offset_, alignment);
+    if (start + size <= block.size) {
+      byte_size_ += start + size - offset_;
+      offset_ = start + size;
+      allocation_count_++;
+      live_allocation_count_++;
+      return block.data.get() + start;
+    }
+  }
+  return AllocateInNewBlock(size, alignment);
+}
+
+void* Arena::AllocateInNewBlock(size_t size, size_t alignment) {
+  size_t padded_size = size + alignment - 1;
+  if (padded_size > block_size_ / 4) {
+    // Large allocations get a block of their own, so that the rest of the
+    // current block stays available.
+    Block& block = large_blocks_.emplace_back(
+        Block{std::unique_ptr<uint8_t[]>(new uint8_t[padded_size]),
+              padded_size});
+    byte_size_ += padded_size;
+    allocation_count_++;
+    live_allocation_count_++;
+    return block.data.get() + AlignOffset(block.data.get(), 0, alignment);
+  }
+
+  // Move on to the next block, reusing one that was kept by |Reset| if there
+  // is one.
+  if (!blocks_.empty()) {
+    current_block_++;
+  }
+  if (current_block_ == blocks_.size()) {
+    blocks_.push_back(
+        Block{std::unique_ptr<uint8_t[]>(new uint8_t[block_size_]),
+              block_size_});
+  }
+  offset_ = 0;
+  return Allocate(size, alignment);
+}
+
+void Arena::Deallocate(void* ptr, size_t size) {
+  FML_DCHECK(live_allocation_count_ > 0);
+  live_allocation_count_--;
+}
+
+void Arena::Reset() {
+  FML_DCHECK(live_allocation_count_ == 0);
+  large_blocks_.clear();
+  current_block_ = 0;
+  offset_ = 0;
+  allocation_count_ = 0;
+  byte_size_ = 0;
+}
+
+Arena* Arena::GetCurrent() {
+  return tCurrentArena;
+}
+
+ArenaScope::ArenaScope(const std::shared_ptr<Arena>& arena)
+    : previous_(tCurrentArena) {
+  tCurrentArena = arena.get();
+}
+
+ArenaScope::~ArenaScope() {
+  tCurrentArena = previous_;
+}
+
+}  // namespace impeller
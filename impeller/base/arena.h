@@ -0,0 +1,195 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_BASE_ARENA_H_
+#define FLUTTER_IMPELLER_BASE_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A bump allocator for objects that are created together and die
+///             together, such as the entities and contents of a frame.
+///
+///             Memory is carved out of large blocks and is only given back
+///             when the arena is reset or destroyed. Objects are allocated in
+///             an arena through an |ArenaAllocator|, which holds a reference
+///             to the arena so that it outlives every object in it.
+///
+///             Allocation and reset must happen on one thread at a time.
+///             Objects may be freed on any thread.
+///
+class Arena : public std::enable_shared_from_this<Arena> {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  static std::shared_ptr<Arena> Create(size_t block_size = kDefaultBlockSize);
+
+  ~Arena();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Allocates `size` bytes aligned to `alignment`, which must be
+  ///             a power of two. Allocations that do not fit in the rest of
+  ///             the current block and are larger than a quarter of the
+  ///             block size get a block of their own.
+  ///
+  void* Allocate(size_t size, size_t alignment);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Marks an allocation as no longer in use. The memory is not
+  ///             reused until the arena is reset.
+  ///
+  void Deallocate(void* ptr, size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Makes all memory of the arena available for reuse, keeping
+  ///             the blocks of the default size and freeing the rest. There
+  ///             must be no allocations in use.
+  ///
+  void Reset();
+
+  /// @brief  Returns the number of allocations since the last reset.
+  size_t GetAllocationCount() const { return allocation_count_; }
+
+  /// @brief  Returns the number of allocations that have not been freed.
+  size_t GetLiveAllocationCount() const { return live_allocation_count_; }
+
+  /// @brief  Returns the bytes handed out since the last reset, including
+  ///         alignment padding.
+  size_t GetByteSize() const { return byte_size_; }
+
+  size_t GetBlockCount() const {
+    return blocks_.size() + large_blocks_.size();
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the arena of the innermost |ArenaScope| on this
+  ///             thread, or null if there is none.
+  ///
+  static Arena* GetCurrent();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Makes a shared object in the arena of the innermost
+  ///             |ArenaScope| on this thread, or on the heap if there is none.
+  ///
+  template <class T, class... Args>
+  static std::shared_ptr<T> MakeShared(Args&&... args);
+
+ private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size = 0;
+  };
+
+  const size_t block_size_;
+  std::vector<Block> blocks_;
+  std::vector<Block> large_blocks_;
+  size_t current_block_ = 0;
+  size_t offset_ = 0;
+  size_t allocation_count_ = 0;
+  size_t byte_size_ = 0;
+  std::atomic<size_t> live_allocation_count_ = 0;
+
+  explicit Arena(size_t block_size);
+
+  void* AllocateInNewBlock(size_t size, size_t alignment);
+
+  Arena(const Arena&) = delete;
+
+  Arena& operator=(const Arena&) = delete;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Makes an arena the one that |Arena::MakeShared| and default
+///             constructed |ArenaAllocator|s use on this thread until the
+///             scope ends. A null arena makes them use the heap.
+///
+class ArenaScope {
+ public:
+  explicit ArenaScope(const std::shared_ptr<Arena>& arena);
+
+  ~ArenaScope();
+
+ private:
+  Arena* previous_;
+
+  ArenaScope(const ArenaScope&) = delete;
+
+  ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A standard allocator that allocates from an |Arena|, or from
+///             the heap if it has none.
+///
+template <class T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  /// @brief  Allocates from the arena of the innermost |ArenaScope|, if any.
+  ArenaAllocator()
+      : arena_(Arena::GetCurrent() ? Arena::GetCurrent()->shared_from_this()
+                                   : nullptr) {}
+
+  explicit ArenaAllocator(std::shared_ptr<Arena> arena)
+      : arena_(std::move(arena)) {}
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT
+      : arena_(other.GetArena()) {}
+
+  T* allocate(size_t n) {
+    if (!arena_) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (!arena_) {
+      ::operator delete(ptr);
+      return;
+    }
+    arena_->Deallocate(ptr, n * sizeof(T));
+  }
+
+  const std::shared_ptr<Arena>& GetArena() const { return arena_; }
+
+  template <class U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.GetArena();
+  }
+
+  template <class U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.GetArena();
+  }
+
+ private:
+  std::shared_ptr<Arena> arena_;
+};
+
+template <class T, class... Args>
+std::shared_ptr<T> Arena::MakeShared(Args&&... args) {
+  Arena* arena = GetCurrent();
+  if (!arena) {
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+  return std::allocate_shared<T>(ArenaAllocator<T>(arena->shared_from_this()),
+                                 std::forward<Args>(args)...);
+}
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_BASE_ARENA_H_
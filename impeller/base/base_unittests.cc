@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "flutter/testing/testing.h"
+#include "impeller/base/arena.h"
 #include "impeller/base/strings.h"
 #include "impeller/base/thread.h"
 
@@ -233,5 +236,101 @@ TEST(ConditionVariableTest, TestsCriticalSectionAfterWait) {
   ASSERT_EQ(sum, kThreadCount);
 }
 
+TEST(ArenaTest, AllocationsAreAlignedAndCounted) {
+  auto arena = Arena::Create(1024);
+  std::vector<uintptr_t> addresses;
+  for (size_t alignment : {1u, 2u, 4u, 8u, 16u, 64u}) {
+    auto address = reinterpret_cast<uintptr_t>(arena->Allocate(3, alignment));
+    EXPECT_EQ(address % alignment, 0u);
+    addresses.push_back(address);
+  }
+  EXPECT_EQ(arena->GetAllocationCount(), 6u);
+  EXPECT_EQ(arena->GetLiveAllocationCount(), 6u);
+  EXPECT_EQ(arena->GetBlockCount(), 1u);
+  for (size_t i = 1; i < addresses.size(); i++) {
+    EXPECT_GE(addresses[i], addresses[i - 1] + 3);
+  }
+
+  // Large allocations that do not fit get a block of their own.
+  void* large = arena->Allocate(1000, 8);
+  EXPECT_EQ(arena->GetBlockCount(), 2u);
+  auto next = reinterpret_cast<uintptr_t>(arena->Allocate(3, 1));
+  EXPECT_EQ(next, addresses.back() + 3);
+
+  arena->Deallocate(large, 1000);
+  EXPECT_EQ(arena->GetLiveAllocationCount(), 7u);
+}
+
+TEST(ArenaTest, ResetReusesBlocks) {
+  auto arena = Arena::Create(1024);
+  std::vector<void*> first;
+  for (int i = 0; i < 100; i++) {
+    first.push_back(arena->Allocate(32, 8));
+  }
+  void* large = arena->Allocate(1000, 8);
+  EXPECT_EQ(arena->GetBlockCount(), 5u);
+  for (void* ptr : first) {
+    arena->Deallocate(ptr, 32);
+  }
+  arena->Deallocate(large, 1000);
+
+  arena->Reset();
+  EXPECT_EQ(arena->GetAllocationCount(), 0u);
+  EXPECT_EQ(arena->GetByteSize(), 0u);
+  EXPECT_EQ(arena->GetBlockCount(), 4u);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(arena->Allocate(32, 8), first[i]);
+  }
+  EXPECT_EQ(arena->GetBlockCount(), 4u);
+  for (void* ptr : first) {
+    arena->Deallocate(ptr, 32);
+  }
+}
+
+TEST(ArenaTest, MakeSharedUsesTheArenaOfTheScope) {
+  std::weak_ptr<Arena> weak_arena;
+  std::shared_ptr<std::vector<int>> shared;
+  {
+    auto arena = Arena::Create();
+    weak_arena = arena;
+    ArenaScope scope(arena);
+    EXPECT_EQ(Arena::GetCurrent(), arena.get());
+    shared = Arena::MakeShared<std::vector<int>>(10, 1);
+    EXPECT_EQ(arena->GetAllocationCount(), 1u);
+    {
+      ArenaScope heap_scope(nullptr);
+      EXPECT_EQ(Arena::GetCurrent(), nullptr);
+      auto heap_shared = Arena::MakeShared<int>(1);
+      EXPECT_EQ(arena->GetAllocationCount(), 1u);
+    }
+    EXPECT_EQ(Arena::GetCurrent(), arena.get());
+  }
+  EXPECT_EQ(Arena::GetCurrent(), nullptr);
+
+  // Objects keep their arena alive.
+  ASSERT_FALSE(weak_arena.expired());
+  EXPECT_EQ(weak_arena.lock()->GetLiveAllocationCount(), 1u);
+  EXPECT_EQ(shared->size(), 10u);
+  shared.reset();
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(ArenaTest, ContainersAllocateFromTheArena) {
+  auto arena = Arena::Create();
+  {
+    std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 100; i++) {
+      values.push_back(i);
+    }
+    EXPECT_GT(arena->GetAllocationCount(), 1u);
+    EXPECT_EQ(arena->GetLiveAllocationCount(), 1u);
+
+    std::vector<int, ArenaAllocator<int>> heap_values;
+    heap_values.push_back(1);
+    EXPECT_EQ(heap_values.get_allocator().GetArena(), nullptr);
+  }
+  EXPECT_EQ(arena->GetLiveAllocationCount(), 0u);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -16,6 +16,8 @@ std::shared_ptr<const DeviceBuffer> DeviceBuffer::GetDeviceBuffer(
   return shared_from_this();
 }
 
+void DeviceBuffer::Flush(Range range) const {}
+
 BufferView DeviceBuffer::AsBufferView() const {
   BufferView view;
   view.buffer = shared_from_this();
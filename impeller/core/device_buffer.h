@@ -45,6 +45,13 @@ class DeviceBuffer : public Buffer,
 
   virtual uint8_t* OnGetContents() const = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Makes writes to the range of the contents of a host visible
+  ///             buffer visible to the device. Writes made through
+  ///             |CopyHostBuffer| need no flush.
+  ///
+  virtual void Flush(Range range) const;
+
  protected:
   const DeviceBufferDescriptor desc_;
 
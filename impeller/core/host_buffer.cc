@@ -9,6 +9,7 @@
 
 #include "flutter/fml/logging.h"
 
+#include "impeller/base/validation.h"
 #include "impeller/core/allocator.h"
 #include "impeller/core/buffer_view.h"
 #include "impeller/core/device_buffer.h"
@@ -19,8 +20,16 @@ std::shared_ptr<HostBuffer> HostBuffer::Create() {
   return std::shared_ptr<HostBuffer>(new HostBuffer());
 }
 
+std::shared_ptr<HostBuffer> HostBuffer::Create(
+    std::shared_ptr<Allocator> allocator) {
+  return std::shared_ptr<HostBuffer>(new HostBuffer(std::move(allocator)));
+}
+
 HostBuffer::HostBuffer() = default;
 
+HostBuffer::HostBuffer(std::shared_ptr<Allocator> allocator)
+    : allocator_(std::move(allocator)) {}
+
 HostBuffer::~HostBuffer() = default;
 
 void HostBuffer::SetLabel(std::string label) {
@@ -30,6 +39,13 @@ void HostBuffer::SetLabel(std::string label) {
 BufferView HostBuffer::Emplace(const void* buffer,
                                size_t length,
                                size_t align) {
+  if (allocator_) {
+    auto view = EmplaceInDeviceBuffer(buffer, length, align);
+    // Falls back to host memory if the device buffers cannot be mapped.
+    if (view || allocator_) {
+      return view;
+    }
+  }
   auto [device_buffer, range] = state_->Emplace(buffer, length, align);
   if (!device_buffer) {
     return {};
@@ -38,6 +54,12 @@ BufferView HostBuffer::Emplace(const void* buffer,
 }
 
 BufferView HostBuffer::Emplace(const void* buffer, size_t length) {
+  if (allocator_) {
+    auto view = EmplaceInDeviceBuffer(buffer, length, 0u);
+    if (view || allocator_) {
+      return view;
+    }
+  }
   auto [device_buffer, range] = state_->Emplace(buffer, length);
   if (!device_buffer) {
     return {};
@@ -48,6 +70,18 @@ BufferView HostBuffer::Emplace(const void* buffer, size_t length) {
 BufferView HostBuffer::Emplace(size_t length,
                                size_t align,
                                const EmplaceProc& cb) {
+  if (allocator_ && cb) {
+    auto [device_buffer, range] = ReserveDeviceBufferRange(length, align);
+    if (device_buffer) {
+      uint8_t* contents = device_buffer->OnGetContents();
+      cb(contents + range.offset);
+      AddPendingFlush(device_buffer, range);
+      return BufferView{std::move(device_buffer), contents, range};
+    }
+    if (allocator_) {
+      return {};
+    }
+  }
   auto [buffer, range] = state_->Emplace(length, align, cb);
   if (!buffer) {
     return {};
@@ -60,18 +94,151 @@ std::shared_ptr<const DeviceBuffer> HostBuffer::GetDeviceBuffer(
   return state_->GetDeviceBuffer(allocator);
 }
 
+void HostBuffer::FlushPendingWrites() {
+  for (const auto& [device_buffer, range] : pending_flushes_) {
+    device_buffer->Flush(range);
+  }
+  pending_flushes_.clear();
+}
+
 void HostBuffer::Reset() {
+  FlushPendingWrites();
+  if (allocator_) {
+    ResetDeviceBuffers();
+    return;
+  }
   state_->Reset();
 }
 
 size_t HostBuffer::GetSize() const {
+  if (allocator_) {
+    size_t size = 0u;
+    for (const auto& buffers : device_buffers_) {
+      size += buffers.size() * kDeviceBufferBlockSize;
+    }
+    return size;
+  }
   return state_->GetReservedLength();
 }
 
 size_t HostBuffer::GetLength() const {
+  if (allocator_) {
+    return current_buffer_ * kDeviceBufferBlockSize + offset_;
+  }
   return state_->GetLength();
 }
 
+std::shared_ptr<DeviceBuffer> HostBuffer::CreateDeviceBuffer(size_t length) {
+  DeviceBufferDescriptor desc;
+  desc.storage_mode = StorageMode::kHostVisible;
+  desc.size = length;
+  auto device_buffer = allocator_->CreateBuffer(desc);
+  if (!device_buffer) {
+    VALIDATION_LOG << "Could not create a device buffer of " << length
+                   << " bytes for the host buffer.";
+    return nullptr;
+  }
+  if (!device_buffer->OnGetContents()) {
+    // Host visible buffers of this allocator cannot be written directly, so
+    // stage all data in host memory from now on.
+    allocator_ = nullptr;
+    return nullptr;
+  }
+  if (!state_->label.empty()) {
+    device_buffer->SetLabel(state_->label);
+  }
+  device_buffer_allocation_count_++;
+  return device_buffer;
+}
+
+std::pair<std::shared_ptr<DeviceBuffer>, Range>
+HostBuffer::ReserveDeviceBufferRange(size_t length, size_t align) {
+  if (length > kDeviceBufferBlockSize) {
+    // Too large for the ring. The device buffer is kept alive by the commands
+    // that reference it for as long as the GPU needs it.
+    auto device_buffer = CreateDeviceBuffer(length);
+    if (!device_buffer) {
+      return {};
+    }
+    return {std::move(device_buffer), Range{0u, length}};
+  }
+
+  size_t index = current_buffer_;
+  size_t offset = offset_;
+  if (align > 1u && offset % align != 0u) {
+    offset += align - (offset % align);
+  }
+  if (offset + length > kDeviceBufferBlockSize) {
+    index++;
+    offset = 0u;
+  }
+
+  auto& buffers = device_buffers_[frame_index_];
+  if (index == buffers.size()) {
+    auto device_buffer = CreateDeviceBuffer(kDeviceBufferBlockSize);
+    if (!device_buffer) {
+      return {};
+    }
+    if (buffers.size() < kMaxFrameDeviceBufferCount) {
+      buffers.push_back(std::move(device_buffer));
+    } else {
+      // The full buffer stays alive for as long as commands reference it.
+      index = buffers.size() - 1u;
+      buffers.back() = std::move(device_buffer);
+    }
+  }
+  current_buffer_ = index;
+  offset_ = offset + length;
+
+  return {buffers[index], Range{offset, length}};
+}
+
+void HostBuffer::AddPendingFlush(
+    const std::shared_ptr<DeviceBuffer>& device_buffer,
+    Range range) {
+  if (!pending_flushes_.empty() &&
+      pending_flushes_.back().first == device_buffer) {
+    Range& pending = pending_flushes_.back().second;
+    const size_t begin = std::min(pending.offset, range.offset);
+    const size_t end = std::max(pending.offset + pending.length,
+                                range.offset + range.length);
+    pending = Range{begin, end - begin};
+    return;
+  }
+  pending_flushes_.emplace_back(device_buffer, range);
+}
+
+BufferView HostBuffer::EmplaceInDeviceBuffer(const void* buffer,
+                                             size_t length,
+                                             size_t align) {
+  auto [device_buffer, range] = ReserveDeviceBufferRange(length, align);
+  if (!device_buffer) {
+    return {};
+  }
+  uint8_t* contents = device_buffer->OnGetContents();
+  if (buffer) {
+    ::memmove(contents + range.offset, buffer, length);
+  }
+  AddPendingFlush(device_buffer, range);
+  return BufferView{std::move(device_buffer), contents, range};
+}
+
+void HostBuffer::ResetDeviceBuffers() {
+  // The next frame is expected to need about as many device buffers as the
+  // one that just ended. Any more of them are overflow from an unusually
+  // large frame and are released.
+  size_t used_count = device_buffers_[frame_index_].empty()
+                          ? 0u
+                          : current_buffer_ + 1u;
+  frame_index_ = (frame_index_ + 1u) % kHostBufferArenaSize;
+  auto& buffers = device_buffers_[frame_index_];
+  if (buffers.size() > std::max<size_t>(used_count, 1u)) {
+    buffers.resize(std::max<size_t>(used_count, 1u));
+  }
+  current_buffer_ = 0u;
+  offset_ = 0u;
+}
+
 std::pair<uint8_t*, Range> HostBuffer::HostBufferState::Emplace(
     size_t length,
     size_t align,
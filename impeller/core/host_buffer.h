@@ -6,9 +6,12 @@
 #define FLUTTER_IMPELLER_CORE_HOST_BUFFER_H_
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "impeller/base/allocation.h"
 #include "impeller/core/buffer.h"
@@ -17,10 +20,62 @@
 
 namespace impeller {
 
+class DeviceBuffer;
+
+/// The number of frames that the device buffers of a |HostBuffer| created with
+/// an allocator are cycled through.
+static constexpr size_t kHostBufferArenaSize = 3u;
+
+//------------------------------------------------------------------------------
+/// @brief      A bump allocator for the transient data (uniforms, vertices and
+///             indices) of the commands of a frame.
+///
+///             A host buffer created without an allocator collects the data in
+///             host memory, which is copied into a new device buffer when the
+///             buffer is bound after it has changed.
+///
+///             A host buffer created with an allocator writes the data
+///             directly into persistently mapped device buffers instead. It
+///             has a set of device buffers for each of |kHostBufferArenaSize|
+///             frames in flight. |Reset| moves on to the next set, whose
+///             buffers are reused once the GPU is done with the frame that
+///             last used them. A frame that does not fit in the buffers of
+///             its set adds an overflow buffer to it, and data larger than a
+///             buffer gets a device buffer of its own.
+///
+///             A set holds at most |kMaxFrameDeviceBufferCount| buffers. Past
+///             that, the last buffer of the set is replaced by a new one
+///             whenever it fills up, and the old one is released once the
+///             commands that reference it are done. This bounds the memory
+///             held by host buffers that are never reset, such as the ones
+///             of offscreen renders.
+///
+///             Writes into device buffers are made visible to the device in
+///             one flush per device buffer by |FlushPendingWrites|, which
+///             render passes call before they encode their commands.
+///
 class HostBuffer final : public Buffer {
  public:
+  /// The size of the device buffers of a host buffer created with an
+  /// allocator.
+  static constexpr size_t kDeviceBufferBlockSize = 1024u * 1024u;
+
+  /// The most device buffers that a frame of a host buffer created with an
+  /// allocator keeps for reuse.
+  static constexpr size_t kMaxFrameDeviceBufferCount = 4u;
+
   static std::shared_ptr<HostBuffer> Create();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a host buffer that writes into device buffers of the
+  ///             allocator that it reuses every |kHostBufferArenaSize| frames.
+  ///             |Reset| must be called once per frame. If the allocator
+  ///             cannot map its host visible buffers, the data is collected in
+  ///             host memory as if there was no allocator.
+  ///
+  static std::shared_ptr<HostBuffer> Create(
+      std::shared_ptr<Allocator> allocator);
+
   // |Buffer|
   virtual ~HostBuffer();
 
@@ -111,18 +166,38 @@ class HostBuffer final : public Buffer {
 
   //----------------------------------------------------------------------------
   /// @brief Resets the contents of the HostBuffer to nothing so it can be
-  ///        reused.
+  ///        reused. For a host buffer created with an allocator, this moves
+  ///        on to the device buffers of the next frame.
   void Reset();
 
+  //----------------------------------------------------------------------------
+  /// @brief Flushes the ranges of the device buffers that were written since
+  ///        the last flush, so that the device sees them. Does nothing for a
+  ///        host buffer that stages its data in host memory.
+  void FlushPendingWrites();
+
   //----------------------------------------------------------------------------
   /// @brief Returns the capacity of the HostBuffer in memory in bytes.
   size_t GetSize() const;
 
   //----------------------------------------------------------------------------
   /// @brief Returns the size of the currently allocated HostBuffer memory in
-  ///        bytes.
+  ///        bytes. For a host buffer created with an allocator, this is the
+  ///        memory used by the current frame.
   size_t GetLength() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief Returns the number of device buffers created by a host buffer
+  ///        created with an allocator.
+  size_t GetDeviceBufferAllocationCount() const {
+    return device_buffer_allocation_count_;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief Returns the index of the current frame in the ring of device
+  ///        buffers.
+  size_t GetFrameIndex() const { return frame_index_; }
+
  private:
   struct HostBufferState : public Buffer, public Allocation {
     std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
@@ -149,6 +224,37 @@ class HostBuffer final : public Buffer {
 
   std::shared_ptr<HostBufferState> state_ = std::make_shared<HostBufferState>();
 
+  // Only set for host buffers that write into device buffers.
+  std::shared_ptr<Allocator> allocator_;
+  std::array<std::vector<std::shared_ptr<DeviceBuffer>>, kHostBufferArenaSize>
+      device_buffers_;
+  size_t frame_index_ = 0u;
+  size_t current_buffer_ = 0u;
+  size_t offset_ = 0u;
+  size_t device_buffer_allocation_count_ = 0u;
+  // The ranges written since the last flush, coalesced per device buffer.
+  std::vector<std::pair<std::shared_ptr<DeviceBuffer>, Range>>
+      pending_flushes_;
+
+  std::shared_ptr<DeviceBuffer> CreateDeviceBuffer(size_t length);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reserves a range of a device buffer of the current frame. The
+  ///             caller writes into the range and flushes it.
+  ///
+  std::pair<std::shared_ptr<DeviceBuffer>, Range> ReserveDeviceBufferRange(
+      size_t length,
+      size_t align);
+
+  void AddPendingFlush(const std::shared_ptr<DeviceBuffer>& device_buffer,
+                       Range range);
+
+  BufferView EmplaceInDeviceBuffer(const void* buffer,
+                                   size_t length,
+                                   size_t align);
+
+  void ResetDeviceBuffers();
+
   // |Buffer|
   std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
       Allocator& allocator) const override;
@@ -157,6 +263,8 @@ class HostBuffer final : public Buffer {
 
   HostBuffer();
 
+  explicit HostBuffer(std::shared_ptr<Allocator> allocator);
+
   HostBuffer(const HostBuffer&) = delete;
 
   HostBuffer& operator=(const HostBuffer&) = delete;
@@ -123,6 +123,7 @@ Path ToPath(const SkPath& path, Point shift) {
   }
   builder.SetConvexity(path.isConvex() ? Convexity::kConvex
                                        : Convexity::kUnknown);
+  builder.SetVolatile(path.isVolatile());
   builder.Shift(shift);
   auto sk_bounds = path.getBounds().makeOutset(shift.x, shift.y);
   builder.SetBounds(ToRect(sk_bounds));
@@ -184,10 +184,13 @@ ContentContext::ContentContext(
       render_target_cache_(render_target_allocator == nullptr
                                ? std::make_shared<RenderTargetCache>(
                                      context_->GetResourceAllocator())
-                               : std::move(render_target_allocator)) {
+                               : std::move(render_target_allocator)),
+      transients_buffer_(
+          HostBuffer::Create(context_->GetResourceAllocator())) {
   if (!context_ || !context_->IsValid()) {
     return;
   }
+  transients_buffer_->SetLabel("ContentContext Transients");
   auto options = ContentContextOptions{
       .sample_count = SampleCount::kCount4,
       .color_attachment_pixel_format =
@@ -443,6 +446,7 @@ std::shared_ptr<Texture> ContentContext::MakeSubpass(
   if (!sub_renderpass) {
     return nullptr;
   }
+  sub_renderpass->SetTransientsBuffer(transients_buffer_);
   sub_renderpass->SetLabel(SPrintF("%s RenderPass", label.c_str()));
 
   if (!subpass_callback(*this, *sub_renderpass)) {
@@ -466,6 +470,10 @@ std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
   return tessellator_;
 }
 
+const std::shared_ptr<HostBuffer>& ContentContext::GetTransientsBuffer() const {
+  return transients_buffer_;
+}
+
 std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
@@ -478,4 +486,14 @@ void ContentContext::SetWireframe(bool wireframe) {
   wireframe_ = wireframe;
 }
 
+void ContentContext::SetWorkerTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  worker_task_runner_ = std::move(worker_task_runner);
+}
+
+const std::shared_ptr<fml::ConcurrentTaskRunner>&
+ContentContext::GetWorkerTaskRunner() const {
+  return worker_task_runner_;
+}
+
 }  // namespace impeller
@@ -11,9 +11,11 @@
 #include <unordered_map>
 
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
+#include "impeller/core/host_buffer.h"
 #include "impeller/entity/entity.h"
 #include "impeller/renderer/capabilities.h"
 #include "impeller/renderer/pipeline.h"
@@ -339,6 +341,14 @@ class ContentContext {
 
   std::shared_ptr<Tessellator> GetTessellator() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The host buffer that the render passes of the entity passes
+  ///             emplace their transient data in. It writes directly into
+  ///             device buffers that are cycled across frames, so it must be
+  ///             reset once per frame.
+  ///
+  const std::shared_ptr<HostBuffer>& GetTransientsBuffer() const;
+
 #ifdef IMPELLER_DEBUG
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetCheckerboardPipeline(
       ContentContextOptions opts) const {
@@ -687,6 +697,14 @@ class ContentContext {
 
   void SetWireframe(bool wireframe);
 
+  /// @brief  Sets the runner of the concurrent loop whose workers share CPU
+  ///         heavy work such as stroking long paths, or null to do all of
+  ///         that work on the calling thread.
+  void SetWorkerTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& GetWorkerTaskRunner() const;
+
   using SubpassCallback =
       std::function<bool(const ContentContext&, RenderPass&)>;
 
@@ -914,7 +932,9 @@ class ContentContext {
   std::shared_ptr<scene::SceneContext> scene_context_;
 #endif  // IMPELLER_ENABLE_3D
   std::shared_ptr<RenderTargetAllocator> render_target_cache_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
   bool wireframe_ = false;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
 
   ContentContext(const ContentContext&) = delete;
 
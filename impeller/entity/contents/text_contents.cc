@@ -8,6 +8,7 @@
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "impeller/core/formats.h"
 #include "impeller/core/sampler_descriptor.h"
@@ -107,20 +108,16 @@ bool TextContents::Render(const ContentContext& renderer,
   using VS = GlyphAtlasPipeline::VertexShader;
   using FS = GlyphAtlasPipeline::FragmentShader;
 
-  // Common vertex uniforms for all glyphs.
+  // Common vertex uniforms for all glyphs. The size of the atlas is set for
+  // each page.
   VS::FrameInfo frame_info;
   frame_info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize());
-  frame_info.atlas_size =
-      Vector2{static_cast<Scalar>(atlas->GetTexture()->GetSize().width),
-              static_cast<Scalar>(atlas->GetTexture()->GetSize().height)};
   frame_info.offset = offset_;
   frame_info.is_translation_scale =
       entity.GetTransform().IsTranslationScaleOnly();
   frame_info.entity_transform = entity.GetTransform();
   frame_info.text_color = ToVector(color.Premultiply());
 
-  VS::BindFrameInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frame_info));
-
   if (type == GlyphAtlas::Type::kColorBitmap) {
     using FSS = GlyphAtlasColorPipeline::FragmentShader;
     FSS::FragInfo frag_info;
@@ -143,13 +140,8 @@ bool TextContents::Render(const ContentContext& renderer,
     sampler_desc.mag_filter = MinMagFilter::kLinear;
   }
   sampler_desc.mip_filter = MipFilter::kNearest;
-
-  FS::BindGlyphAtlasSampler(
-      cmd,                  // command
-      atlas->GetTexture(),  // texture
-      renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-          sampler_desc)  // sampler
-  );
+  auto sampler =
+      renderer.GetContext()->GetSamplerLibrary()->GetSampler(sampler_desc);
 
   // Common vertex information for all glyphs.
   // All glyphs are given the same vertex information in the form of a
@@ -162,59 +154,104 @@ bool TextContents::Render(const ContentContext& renderer,
                                                 Point{0, 1}, Point{1, 0},
                                                 Point{0, 1}, Point{1, 1}};
 
-  auto& host_buffer = pass.GetTransientsBuffer();
-  size_t vertex_count = 0;
-  for (const auto& run : frame_->GetRuns()) {
-    vertex_count += run.GetGlyphPositions().size();
+  // Look up the slot of every glyph once, and count the glyphs of each page
+  // of the atlas.
+  const size_t page_count = atlas->GetPageCount();
+  std::vector<size_t> page_vertex_counts(page_count, 0u);
+  std::vector<std::pair<const GlyphAtlas::Slot*,
+                        const TextRun::GlyphPosition*>>
+      glyphs;
+  for (const TextRun& run : frame_->GetRuns()) {
+    const Font& font = run.GetFont();
+    Scalar rounded_scale =
+        TextFrame::RoundScaledFontSize(scale_, font.GetMetrics().point_size);
+    const FontGlyphAtlas* font_atlas =
+        atlas->GetFontGlyphAtlas(font, rounded_scale);
+    if (!font_atlas) {
+      VALIDATION_LOG << "Could not find font in the atlas.";
+      continue;
+    }
+    for (const TextRun::GlyphPosition& glyph_position :
+         run.GetGlyphPositions()) {
+      const GlyphAtlas::Slot* slot =
+          font_atlas->FindGlyphSlot(glyph_position.glyph);
+      if (!slot || slot->page >= page_count) {
+        VALIDATION_LOG << "Could not find glyph position in the atlas.";
+        continue;
+      }
+      page_vertex_counts[slot->page] += unit_points.size();
+      glyphs.emplace_back(slot, &glyph_position);
+    }
+  }
+  const size_t vertex_count = glyphs.size() * unit_points.size();
+  if (vertex_count == 0u) {
+    return true;
+  }
+
+  // The glyphs in each page of the atlas are drawn by a command of their own,
+  // so their vertices are written one page after the other.
+  std::vector<size_t> page_offsets(page_count, 0u);
+  for (size_t page = 1; page < page_count; page++) {
+    page_offsets[page] = page_offsets[page - 1] + page_vertex_counts[page - 1];
   }
-  vertex_count *= 6;
 
+  auto& host_buffer = pass.GetTransientsBuffer();
   auto buffer_view = host_buffer.Emplace(
       vertex_count * sizeof(VS::PerVertexData), alignof(VS::PerVertexData),
       [&](uint8_t* contents) {
         VS::PerVertexData vtx;
         VS::PerVertexData* vtx_contents =
             reinterpret_cast<VS::PerVertexData*>(contents);
-        for (const TextRun& run : frame_->GetRuns()) {
-          const Font& font = run.GetFont();
-          Scalar rounded_scale = TextFrame::RoundScaledFontSize(
-              scale_, font.GetMetrics().point_size);
-          const FontGlyphAtlas* font_atlas =
-              atlas->GetFontGlyphAtlas(font, rounded_scale);
-          if (!font_atlas) {
-            VALIDATION_LOG << "Could not find font in the atlas.";
-            continue;
-          }
-
-          for (const TextRun::GlyphPosition& glyph_position :
-               run.GetGlyphPositions()) {
-            std::optional<Rect> maybe_atlas_glyph_bounds =
-                font_atlas->FindGlyphBounds(glyph_position.glyph);
-            if (!maybe_atlas_glyph_bounds.has_value()) {
-              VALIDATION_LOG << "Could not find glyph position in the atlas.";
-              continue;
-            }
-            const Rect& atlas_glyph_bounds = maybe_atlas_glyph_bounds.value();
-            vtx.atlas_glyph_bounds = Vector4(atlas_glyph_bounds.GetXYWH());
-            vtx.glyph_bounds = Vector4(glyph_position.glyph.bounds.GetXYWH());
-            vtx.glyph_position = glyph_position.position;
-
-            for (const Point& point : unit_points) {
-              vtx.unit_position = point;
-              std::memcpy(vtx_contents++, &vtx, sizeof(VS::PerVertexData));
-            }
+        std::vector<size_t> page_cursors = page_offsets;
+        for (const auto& [slot, glyph_position] : glyphs) {
+          vtx.atlas_glyph_bounds = Vector4(slot->bounds.GetXYWH());
+          vtx.glyph_bounds = Vector4(glyph_position->glyph.bounds.GetXYWH());
+          vtx.glyph_position = glyph_position->position;
+
+          VS::PerVertexData* glyph_contents =
+              vtx_contents + page_cursors[slot->page];
+          for (const Point& point : unit_points) {
+            vtx.unit_position = point;
+            std::memcpy(glyph_contents++, &vtx, sizeof(VS::PerVertexData));
           }
+          page_cursors[slot->page] += unit_points.size();
         }
       });
 
-  cmd.BindVertices({
-      .vertex_buffer = buffer_view,
-      .index_buffer = {},
-      .vertex_count = vertex_count,
-      .index_type = IndexType::kNone,
-  });
-
-  return pass.AddCommand(std::move(cmd));
+  for (size_t page = 0; page < page_count; page++) {
+    size_t page_vertex_count = page_vertex_counts[page];
+    if (page_vertex_count == 0u) {
+      continue;
+    }
+    const std::shared_ptr<Texture>& texture = atlas->GetTexture(page);
+    Command page_cmd = page + 1 < page_count ? cmd : std::move(cmd);
+
+    frame_info.atlas_size =
+        Vector2{static_cast<Scalar>(texture->GetSize().width),
+                static_cast<Scalar>(texture->GetSize().height)};
+    VS::BindFrameInfo(page_cmd, host_buffer.EmplaceUniform(frame_info));
+    FS::BindGlyphAtlasSampler(page_cmd, texture, sampler);
+
+    // The contents of a buffer view point to the start of its buffer, the
+    // range alone selects the vertices of the page.
+    size_t offset = page_offsets[page] * sizeof(VS::PerVertexData);
+    size_t length = page_vertex_count * sizeof(VS::PerVertexData);
+    page_cmd.BindVertices({
+        .vertex_buffer =
+            BufferView{
+                .buffer = buffer_view.buffer,
+                .contents = buffer_view.contents,
+                .range = Range(buffer_view.range.offset + offset, length),
+            },
+        .index_buffer = {},
+        .vertex_count = page_vertex_count,
+        .index_type = IndexType::kNone,
+    });
+    if (!pass.AddCommand(std::move(page_cmd))) {
+      return false;
+    }
+  }
+  return true;
 }
 
 }  // namespace impeller
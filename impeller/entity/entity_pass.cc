@@ -79,7 +79,7 @@ void EntityPass::AddEntity(Entity entity) {
   elements_.emplace_back(std::move(entity));
 }
 
-void EntityPass::SetElements(std::vector<Element> elements) {
+void EntityPass::SetElements(ElementVector elements) {
   elements_ = std::move(elements);
 }
 
@@ -227,7 +227,7 @@ void EntityPass::AddSubpassInline(std::unique_ptr<EntityPass> pass) {
   }
   FML_DCHECK(pass->superpass_ == nullptr);
 
-  std::vector<Element>& elements = pass->elements_;
+  ElementVector& elements = pass->elements_;
   for (auto i = 0u; i < elements.size(); i++) {
     elements_.emplace_back(std::move(elements[i]));
   }
@@ -379,6 +379,7 @@ bool EntityPass::Render(ContentContext& renderer,
       }
     } else {
       auto render_pass = command_buffer->CreateRenderPass(root_render_target);
+      render_pass->SetTransientsBuffer(renderer.GetTransientsBuffer());
       render_pass->SetLabel("EntityPass Root Render Pass");
 
       {
@@ -839,9 +840,9 @@ bool EntityPass::OnRender(
   TRACE_EVENT0("impeller", "EntityPass::OnRender");
 
   auto context = renderer.GetContext();
-  InlinePassContext pass_context(context, pass_target,
-                                 GetTotalPassReads(renderer), GetElementCount(),
-                                 collapsed_parent_pass);
+  InlinePassContext pass_context(context, renderer.GetTransientsBuffer(),
+                                 pass_target, GetTotalPassReads(renderer),
+                                 GetElementCount(), collapsed_parent_pass);
   if (!pass_context.IsValid()) {
     VALIDATION_LOG << SPrintF("Pass context invalid (Depth=%d)", pass_depth);
     return false;
@@ -1082,7 +1083,7 @@ size_t EntityPass::GetElementCount() const {
 }
 
 std::unique_ptr<EntityPass> EntityPass::Clone() const {
-  std::vector<Element> new_elements;
+  ElementVector new_elements;
   new_elements.reserve(elements_.size());
 
   for (const auto& element : elements_) {
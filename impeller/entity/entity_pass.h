@@ -11,6 +11,7 @@
 #include <optional>
 #include <vector>
 
+#include "impeller/base/arena.h"
 #include "impeller/entity/contents/contents.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
 #include "impeller/entity/entity.h"
@@ -36,6 +37,10 @@ class EntityPass {
   /// `GetEntityForElement()`.
   using Element = std::variant<Entity, std::unique_ptr<EntityPass>>;
 
+  /// The elements of a pass are allocated from the arena of the
+  /// `ArenaScope` that the pass is created in, if any.
+  using ElementVector = std::vector<Element, ArenaAllocator<Element>>;
+
   static const std::string kCaptureDocumentName;
 
   using BackdropFilterProc = std::function<std::shared_ptr<FilterContents>(
@@ -76,7 +81,7 @@ class EntityPass {
   /// @brief Add an entity to the current entity pass.
   void AddEntity(Entity entity);
 
-  void SetElements(std::vector<Element> elements);
+  void SetElements(ElementVector elements);
 
   //----------------------------------------------------------------------------
   /// @brief  Appends a given pass as a subpass.
@@ -286,7 +291,7 @@ class EntityPass {
 
   /// The list of renderable items in the scene. Each of these items is
   /// evaluated and recorded to an `EntityPassTarget` by the `OnRender` method.
-  std::vector<Element> elements_;
+  ElementVector elements_;
 
   EntityPass* superpass_ = nullptr;
   Matrix transform_;
@@ -36,7 +36,7 @@ GeometryResult FillPathGeometry::GetPositionBuffer(
     };
   }
 
-  auto tesselation_result = renderer.GetTessellator()->Tessellate(
+  auto tesselation_result = renderer.GetTessellator()->TessellateCached(
       path_, entity.GetTransform().GetMaxBasisLength(),
       [&vertex_buffer, &host_buffer](
           const float* vertices, size_t vertices_count, const uint16_t* indices,
@@ -104,7 +104,7 @@ GeometryResult FillPathGeometry::GetPositionUVBuffer(
   }
 
   VertexBufferBuilder<VS::PerVertexData> vertex_builder;
-  auto tesselation_result = renderer.GetTessellator()->Tessellate(
+  auto tesselation_result = renderer.GetTessellator()->TessellateCached(
       path_, entity.GetTransform().GetMaxBasisLength(),
       [&vertex_builder, &uv_transform](
           const float* vertices, size_t vertices_count, const uint16_t* indices,
@@ -7,6 +7,7 @@
 #include <memory>
 #include <optional>
 
+#include "impeller/base/arena.h"
 #include "impeller/entity/geometry/circle_geometry.h"
 #include "impeller/entity/geometry/cover_geometry.h"
 #include "impeller/entity/geometry/ellipse_geometry.h"
@@ -153,13 +154,14 @@ GeometryResult Geometry::GetPositionUVBuffer(Rect texture_coverage,
 std::shared_ptr<Geometry> Geometry::MakeFillPath(
     Path path,
     std::optional<Rect> inner_rect) {
-  return std::make_shared<FillPathGeometry>(std::move(path), inner_rect);
+  return Arena::MakeShared<FillPathGeometry>(std::move(path), inner_rect);
 }
 
 std::shared_ptr<Geometry> Geometry::MakePointField(std::vector<Point> points,
                                                    Scalar radius,
                                                    bool round) {
-  return std::make_shared<PointFieldGeometry>(std::move(points), radius, round);
+  return Arena::MakeShared<PointFieldGeometry>(std::move(points), radius,
+                                               round);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeStrokePath(Path path,
@@ -171,43 +173,43 @@ std::shared_ptr<Geometry> Geometry::MakeStrokePath(Path path,
   if (miter_limit < 0) {
     miter_limit = 4.0;
   }
-  return std::make_shared<StrokePathGeometry>(
+  return Arena::MakeShared<StrokePathGeometry>(
       std::move(path), stroke_width, miter_limit, stroke_cap, stroke_join);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeCover() {
-  return std::make_shared<CoverGeometry>();
+  return Arena::MakeShared<CoverGeometry>();
 }
 
 std::shared_ptr<Geometry> Geometry::MakeRect(const Rect& rect) {
-  return std::make_shared<RectGeometry>(rect);
+  return Arena::MakeShared<RectGeometry>(rect);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeOval(const Rect& rect) {
-  return std::make_shared<EllipseGeometry>(rect);
+  return Arena::MakeShared<EllipseGeometry>(rect);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeLine(const Point& p0,
                                              const Point& p1,
                                              Scalar width,
                                              Cap cap) {
-  return std::make_shared<LineGeometry>(p0, p1, width, cap);
+  return Arena::MakeShared<LineGeometry>(p0, p1, width, cap);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeCircle(const Point& center,
                                                Scalar radius) {
-  return std::make_shared<CircleGeometry>(center, radius);
+  return Arena::MakeShared<CircleGeometry>(center, radius);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeStrokedCircle(const Point& center,
                                                       Scalar radius,
                                                       Scalar stroke_width) {
-  return std::make_shared<CircleGeometry>(center, radius, stroke_width);
+  return Arena::MakeShared<CircleGeometry>(center, radius, stroke_width);
 }
 
 std::shared_ptr<Geometry> Geometry::MakeRoundRect(const Rect& rect,
                                                   const Size& radii) {
-  return std::make_shared<RoundRectGeometry>(rect, radii);
+  return Arena::MakeShared<RoundRectGeometry>(rect, radii);
 }
 
 bool Geometry::CoversArea(const Matrix& transform, const Rect& rect) const {
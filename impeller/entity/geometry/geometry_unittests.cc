@@ -2,13 +2,32 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cmath>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/testing/testing.h"
 #include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/path_builder.h"
 
 namespace impeller {
 namespace testing {
 
+namespace {
+
+/// A line chart through |count| points, as a single open contour with one
+/// line component per segment.
+Path CreateLineChart(size_t count) {
+  PathBuilder builder;
+  builder.MoveTo({0, 500});
+  for (size_t i = 1; i < count; i++) {
+    builder.LineTo({i * 0.1f, 500 + std::sin(i * 0.05f) * 400});
+  }
+  return builder.TakePath();
+}
+
+}  // namespace
+
 TEST(EntityGeometryTest, RectGeometryCoversArea) {
   auto geometry = Geometry::MakeRect(Rect::MakeLTRB(0, 0, 100, 100));
   ASSERT_TRUE(geometry->CoversArea({}, Rect::MakeLTRB(0, 0, 100, 100)));
@@ -71,5 +90,69 @@ TEST(EntityGeometryTest, RoundRectGeometryCoversArea) {
   EXPECT_TRUE(geometry->CoversArea({}, Rect::MakeLTRB(1, 30, 99, 70)));
 }
 
+TEST(EntityGeometryTest, ParallelStrokeMatchesSerialStroke) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto path = CreateLineChart(100000);
+
+  for (auto join : {Join::kBevel, Join::kMiter, Join::kRound}) {
+    for (auto cap : {Cap::kButt, Cap::kRound, Cap::kSquare}) {
+      auto serial = StrokePathGeometry::GenerateSolidStrokeVertices(
+          path, 4, 4, join, cap, 1);
+      auto parallel = StrokePathGeometry::GenerateSolidStrokeVertices(
+          path, 4, 4, join, cap, 1, loop->GetTaskRunner());
+      ASSERT_GT(serial.size(), 400000u);
+      ASSERT_TRUE(serial == parallel)
+          << "join " << static_cast<int>(join) << ", cap "
+          << static_cast<int>(cap);
+    }
+  }
+}
+
+TEST(EntityGeometryTest, ParallelStrokeMatchesSerialStrokeAcrossContours) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  PathBuilder builder;
+  for (int i = 0; i < 200; i++) {
+    Scalar x = (i % 20) * 50;
+    Scalar y = (i / 20) * 50;
+    switch (i % 5) {
+      case 0:
+        builder.AddRoundedRect(Rect::MakeXYWH(x, y, 40, 40), 10);
+        break;
+      case 1:
+        builder.MoveTo({x, y});
+        builder.CubicCurveTo({x + 40, y}, {x, y + 40}, {x + 40, y + 40});
+        builder.QuadraticCurveTo({x, y + 40}, {x, y + 20});
+        break;
+      case 2:
+        builder.MoveTo({x, y});
+        break;
+      case 3:
+        builder.AddRect(Rect::MakeXYWH(x, y, 40, 40));
+        break;
+      case 4:
+        builder.MoveTo({x, y});
+        for (int j = 1; j < 200; j++) {
+          builder.LineTo({x + j * 0.2f, y + (j % 2) * 10});
+        }
+        builder.Close();
+        break;
+    }
+  }
+  builder.AddPath(CreateLineChart(20000));
+  auto path = builder.TakePath();
+
+  for (auto join : {Join::kBevel, Join::kMiter, Join::kRound}) {
+    for (auto cap : {Cap::kButt, Cap::kRound, Cap::kSquare}) {
+      auto serial = StrokePathGeometry::GenerateSolidStrokeVertices(
+          path, 3, 4, join, cap, 2);
+      auto parallel = StrokePathGeometry::GenerateSolidStrokeVertices(
+          path, 3, 4, join, cap, 2, loop->GetTaskRunner());
+      ASSERT_TRUE(serial == parallel)
+          << "join " << static_cast<int>(join) << ", cap "
+          << static_cast<int>(cap);
+    }
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,10 +4,23 @@
 
 #include "impeller/entity/geometry/stroke_path_geometry.h"
 
+#include "flutter/fml/parallel_for.h"
 #include "impeller/geometry/path_builder.h"
 
 namespace impeller {
 
+namespace {
+
+// Contours with more points than this are split at component boundaries into
+// chunks of about this many points that are stroked independently.
+constexpr size_t kStrokeChunkPointCount = 4096;
+
+// Polylines with fewer points than this are stroked on the calling thread,
+// where handing out the chunks would cost more than it saves.
+constexpr size_t kMinParallelStrokePointCount = 8192;
+
+}  // namespace
+
 StrokePathGeometry::StrokePathGeometry(Path path,
                                        Scalar stroke_width,
                                        Scalar miter_limit,
@@ -227,21 +240,44 @@ StrokePathGeometry::CapProc StrokePathGeometry::GetCapProc(Cap stroke_cap) {
 }
 
 // static
-VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
-StrokePathGeometry::CreateSolidStrokeVertices(
-    const Path& path,
+std::vector<StrokePathGeometry::StrokeChunk>
+StrokePathGeometry::SplitIntoStrokeChunks(const Path::Polyline& polyline) {
+  std::vector<StrokeChunk> chunks;
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    const auto& components = polyline.contours[contour_i].components;
+    size_t chunk_begin = 0;
+    for (size_t component_i = 1; component_i < components.size();
+         component_i++) {
+      if (components[component_i].component_start_index -
+              components[chunk_begin].component_start_index >=
+          kStrokeChunkPointCount) {
+        chunks.push_back({contour_i, chunk_begin, component_i});
+        chunk_begin = component_i;
+      }
+    }
+    chunks.push_back({contour_i, chunk_begin, components.size()});
+  }
+  return chunks;
+}
+
+// static
+void StrokePathGeometry::AddStrokeChunkVertices(
+    VertexBufferBuilder<SolidFillVertexShader::PerVertexData>& vtx_builder,
+    const Path::Polyline& polyline,
+    const StrokeChunk& chunk,
     Scalar stroke_width,
     Scalar scaled_miter_limit,
     const StrokePathGeometry::JoinProc& join_proc,
     const StrokePathGeometry::CapProc& cap_proc,
     Scalar scale) {
-  VertexBufferBuilder<VS::PerVertexData> vtx_builder;
-  auto point_buffer = std::make_unique<std::vector<Point>>();
-  // 512 is an arbitrary choice that should be big enough for most paths without
-  // needing to reallocate. If we have motivating benchmarks we should raise or
-  // lower this number, cause dnfield just made it up!
-  point_buffer->reserve(512);
-  auto polyline = path.CreatePolyline(scale, std::move(point_buffer));
+  const size_t contour_i = chunk.contour_index;
+  const Path::PolylineContour& contour = polyline.contours[contour_i];
+  size_t contour_start_point_i, contour_end_point_i;
+  std::tie(contour_start_point_i, contour_end_point_i) =
+      polyline.GetContourPointBounds(contour_i);
+  const bool is_first_chunk = chunk.component_begin == 0;
+  const bool is_last_chunk = chunk.component_end == contour.components.size();
 
   VS::PerVertexData vtx;
 
@@ -252,11 +288,8 @@ StrokePathGeometry::CreateSolidStrokeVertices(
   // Computes offset by calculating the direction from point_i - 1 to point_i if
   // point_i is within `contour_start_point_i` and `contour_end_point_i`;
   // Otherwise, it uses direction from contour.
-  auto compute_offset = [&polyline, &offset, &previous_offset, &stroke_width](
-                            const size_t point_i,
-                            const size_t contour_start_point_i,
-                            const size_t contour_end_point_i,
-                            const Path::PolylineContour& contour) {
+  auto offset_at = [&polyline, &contour, contour_start_point_i,
+                    contour_end_point_i, stroke_width](const size_t point_i) {
     Point direction;
     if (point_i >= contour_end_point_i) {
       direction = contour.end_direction;
@@ -266,16 +299,19 @@ StrokePathGeometry::CreateSolidStrokeVertices(
       direction = (polyline.GetPoint(point_i) - polyline.GetPoint(point_i - 1))
                       .Normalize();
     }
+    return Vector2{-direction.y, direction.x} * stroke_width * 0.5;
+  };
+  auto compute_offset = [&offset, &previous_offset,
+                         &offset_at](const size_t point_i) {
     previous_offset = offset;
-    offset = Vector2{-direction.y, direction.x} * stroke_width * 0.5;
+    offset = offset_at(point_i);
   };
 
   auto add_vertices_for_linear_component =
-      [&vtx_builder, &offset, &previous_offset, &vtx, &polyline,
+      [&vtx_builder, &offset, &previous_offset, &vtx, &polyline, &contour,
        &compute_offset, scaled_miter_limit, scale, &join_proc](
-          const size_t component_start_index, const size_t component_end_index,
-          const size_t contour_start_point_i, const size_t contour_end_point_i,
-          const Path::PolylineContour& contour) {
+          const size_t component_start_index,
+          const size_t component_end_index) {
         auto is_last_component =
             component_start_index ==
             contour.components.back().component_start_index;
@@ -295,8 +331,7 @@ StrokePathGeometry::CreateSolidStrokeVertices(
           vtx.position = polyline.GetPoint(point_i + 1) - offset;
           vtx_builder.AppendVertex(vtx);
 
-          compute_offset(point_i + 2, contour_start_point_i,
-                         contour_end_point_i, contour);
+          compute_offset(point_i + 2);
           if (!is_last_component && is_end_of_component) {
             // Generate join from the current line to the next line.
             join_proc(vtx_builder, polyline.GetPoint(point_i + 1),
@@ -306,11 +341,10 @@ StrokePathGeometry::CreateSolidStrokeVertices(
       };
 
   auto add_vertices_for_curve_component =
-      [&vtx_builder, &offset, &previous_offset, &vtx, &polyline,
+      [&vtx_builder, &offset, &previous_offset, &vtx, &polyline, &contour,
        &compute_offset, scaled_miter_limit, scale, &join_proc](
-          const size_t component_start_index, const size_t component_end_index,
-          const size_t contour_start_point_i, const size_t contour_end_point_i,
-          const Path::PolylineContour& contour) {
+          const size_t component_start_index,
+          const size_t component_end_index) {
         auto is_last_component =
             component_start_index ==
             contour.components.back().component_start_index;
@@ -324,8 +358,7 @@ StrokePathGeometry::CreateSolidStrokeVertices(
           vtx.position = polyline.GetPoint(point_i) - offset;
           vtx_builder.AppendVertex(vtx);
 
-          compute_offset(point_i + 2, contour_start_point_i,
-                         contour_end_point_i, contour);
+          compute_offset(point_i + 2);
           // For curve components, the polyline is detailed enough such that
           // it can avoid worrying about joins altogether.
           if (is_end_of_component) {
@@ -342,29 +375,21 @@ StrokePathGeometry::CreateSolidStrokeVertices(
         }
       };
 
-  for (size_t contour_i = 0; contour_i < polyline.contours.size();
-       contour_i++) {
-    auto contour = polyline.contours[contour_i];
-    size_t contour_start_point_i, contour_end_point_i;
-    std::tie(contour_start_point_i, contour_end_point_i) =
-        polyline.GetContourPointBounds(contour_i);
-
+  if (is_first_chunk) {
     switch (contour_end_point_i - contour_start_point_i) {
       case 1: {
         Point p = polyline.GetPoint(contour_start_point_i);
         cap_proc(vtx_builder, p, {-stroke_width * 0.5f, 0}, scale, false);
         cap_proc(vtx_builder, p, {stroke_width * 0.5f, 0}, scale, false);
-        continue;
+        return;
       }
       case 0:
-        continue;  // This contour has no renderable content.
+        return;  // This contour has no renderable content.
       default:
         break;
     }
 
-    compute_offset(contour_start_point_i, contour_start_point_i,
-                   contour_end_point_i, contour);
-    const Point contour_first_offset = offset;
+    compute_offset(contour_start_point_i);
 
     if (contour_i > 0) {
       // This branch only executes when we've just finished drawing a contour
@@ -389,53 +414,133 @@ StrokePathGeometry::CreateSolidStrokeVertices(
     }
 
     // Generate start cap.
-    if (!polyline.contours[contour_i].is_closed) {
+    if (!contour.is_closed) {
       auto cap_offset =
           Vector2(-contour.start_direction.y, contour.start_direction.x) *
           stroke_width * 0.5;  // Counterclockwise normal
       cap_proc(vtx_builder, polyline.GetPoint(contour_start_point_i),
                cap_offset, scale, true);
     }
+  } else {
+    // The offset only depends on the segment it is computed for, so a chunk
+    // that starts partway through a contour picks it up from the segment
+    // leading out of its first point, as the chunk before it left it.
+    compute_offset(
+        contour.components[chunk.component_begin].component_start_index + 1);
+  }
 
-    for (size_t contour_component_i = 0;
-         contour_component_i < contour.components.size();
-         contour_component_i++) {
-      auto component = contour.components[contour_component_i];
-      auto is_last_component =
-          contour_component_i == contour.components.size() - 1;
-
-      auto component_start_index = component.component_start_index;
-      auto component_end_index =
-          is_last_component ? contour_end_point_i - 1
-                            : contour.components[contour_component_i + 1]
-                                  .component_start_index;
-      if (component.is_curve) {
-        add_vertices_for_curve_component(
-            component_start_index, component_end_index, contour_start_point_i,
-            contour_end_point_i, contour);
-      } else {
-        add_vertices_for_linear_component(
-            component_start_index, component_end_index, contour_start_point_i,
-            contour_end_point_i, contour);
-      }
+  for (size_t contour_component_i = chunk.component_begin;
+       contour_component_i < chunk.component_end; contour_component_i++) {
+    auto component = contour.components[contour_component_i];
+    auto is_last_component =
+        contour_component_i == contour.components.size() - 1;
+
+    auto component_start_index = component.component_start_index;
+    auto component_end_index =
+        is_last_component ? contour_end_point_i - 1
+                          : contour.components[contour_component_i + 1]
+                                .component_start_index;
+    if (component.is_curve) {
+      add_vertices_for_curve_component(component_start_index,
+                                       component_end_index);
+    } else {
+      add_vertices_for_linear_component(component_start_index,
+                                        component_end_index);
     }
+  }
 
-    // Generate end cap or join.
-    if (!contour.is_closed) {
-      auto cap_offset =
-          Vector2(-contour.end_direction.y, contour.end_direction.x) *
-          stroke_width * 0.5;  // Clockwise normal
-      cap_proc(vtx_builder, polyline.GetPoint(contour_end_point_i - 1),
-               cap_offset, scale, false);
-    } else {
-      join_proc(vtx_builder, polyline.GetPoint(contour_start_point_i), offset,
-                contour_first_offset, scaled_miter_limit, scale);
+  if (!is_last_chunk) {
+    return;
+  }
+
+  // Generate end cap or join.
+  if (!contour.is_closed) {
+    auto cap_offset =
+        Vector2(-contour.end_direction.y, contour.end_direction.x) *
+        stroke_width * 0.5;  // Clockwise normal
+    cap_proc(vtx_builder, polyline.GetPoint(contour_end_point_i - 1),
+             cap_offset, scale, false);
+  } else {
+    join_proc(vtx_builder, polyline.GetPoint(contour_start_point_i), offset,
+              offset_at(contour_start_point_i), scaled_miter_limit, scale);
+  }
+}
+
+// static
+VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
+StrokePathGeometry::CreateSolidStrokeVertices(
+    const Path& path,
+    Scalar stroke_width,
+    Scalar scaled_miter_limit,
+    const StrokePathGeometry::JoinProc& join_proc,
+    const StrokePathGeometry::CapProc& cap_proc,
+    Scalar scale,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  auto point_buffer = std::make_unique<std::vector<Point>>();
+  // 512 is an arbitrary choice that should be big enough for most paths without
+  // needing to reallocate. If we have motivating benchmarks we should raise or
+  // lower this number, cause dnfield just made it up!
+  point_buffer->reserve(512);
+  auto polyline = path.CreatePolyline(scale, std::move(point_buffer));
+
+  auto chunks = SplitIntoStrokeChunks(polyline);
+
+  if (!worker_task_runner || chunks.size() < 2 ||
+      polyline.points->size() < kMinParallelStrokePointCount) {
+    VertexBufferBuilder<VS::PerVertexData> vtx_builder;
+    for (const auto& chunk : chunks) {
+      AddStrokeChunkVertices(vtx_builder, polyline, chunk, stroke_width,
+                             scaled_miter_limit, join_proc, cap_proc, scale);
     }
+    return vtx_builder;
   }
 
+  // Stroke the chunks into builders of their own and append them in order,
+  // so the strip is the same no matter which thread stroked which chunk.
+  std::vector<VertexBufferBuilder<VS::PerVertexData>> chunk_builders(
+      chunks.size());
+  fml::ParallelFor(worker_task_runner, chunks.size(),
+                   [&](size_t begin, size_t end) {
+                     for (size_t i = begin; i < end; i++) {
+                       AddStrokeChunkVertices(chunk_builders[i], polyline,
+                                              chunks[i], stroke_width,
+                                              scaled_miter_limit, join_proc,
+                                              cap_proc, scale);
+                     }
+                   });
+
+  size_t vertex_count = 0;
+  for (const auto& chunk_builder : chunk_builders) {
+    vertex_count += chunk_builder.GetVertexCount();
+  }
+  VertexBufferBuilder<VS::PerVertexData> vtx_builder;
+  vtx_builder.Reserve(vertex_count);
+  for (const auto& chunk_builder : chunk_builders) {
+    vtx_builder.AppendVertices(chunk_builder);
+  }
   return vtx_builder;
 }
 
+// static
+std::vector<Point> StrokePathGeometry::GenerateSolidStrokeVertices(
+    const Path& path,
+    Scalar stroke_width,
+    Scalar miter_limit,
+    Join stroke_join,
+    Cap stroke_cap,
+    Scalar scale,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  auto vtx_builder = CreateSolidStrokeVertices(
+      path, stroke_width, miter_limit * stroke_width * 0.5,
+      GetJoinProc(stroke_join), GetCapProc(stroke_cap), scale,
+      worker_task_runner);
+  std::vector<Point> points;
+  points.reserve(vtx_builder.GetVertexCount());
+  vtx_builder.IterateVertices(
+      [&points](VS::PerVertexData& vtx) { points.push_back(vtx.position); });
+  return points;
+}
+
 GeometryResult StrokePathGeometry::GetPositionBuffer(
     const ContentContext& renderer,
     const Entity& entity,
@@ -455,7 +560,8 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
   auto vertex_builder = CreateSolidStrokeVertices(
       path_, stroke_width, miter_limit_ * stroke_width_ * 0.5,
       GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
-      entity.GetTransform().GetMaxBasisLength());
+      entity.GetTransform().GetMaxBasisLength(),
+      renderer.GetWorkerTaskRunner());
 
   return GeometryResult{
       .type = PrimitiveType::kTriangleStrip,
@@ -487,7 +593,8 @@ GeometryResult StrokePathGeometry::GetPositionUVBuffer(
   auto stroke_builder = CreateSolidStrokeVertices(
       path_, stroke_width, miter_limit_ * stroke_width_ * 0.5,
       GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
-      entity.GetTransform().GetMaxBasisLength());
+      entity.GetTransform().GetMaxBasisLength(),
+      renderer.GetWorkerTaskRunner());
   auto vertex_builder = ComputeUVGeometryCPU(
       stroke_builder, {0, 0}, texture_coverage.GetSize(), effect_transform);
 
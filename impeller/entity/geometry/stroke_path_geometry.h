@@ -5,6 +5,10 @@
 #ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_STROKE_PATH_GEOMETRY_H_
 #define FLUTTER_IMPELLER_ENTITY_GEOMETRY_STROKE_PATH_GEOMETRY_H_
 
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "impeller/entity/geometry/geometry.h"
 
 namespace impeller {
@@ -28,6 +32,29 @@ class StrokePathGeometry final : public Geometry {
 
   Join GetStrokeJoin() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Generates the triangle strip that strokes the path at the
+  ///             given scale, as it is drawn by this geometry.
+  ///
+  ///             Long polylines are split into chunks at contour and
+  ///             component boundaries that are stroked on the workers of
+  ///             `worker_task_runner`. The chunks are appended in order, so
+  ///             the strip is the same with or without workers.
+  ///
+  /// @param[in]  worker_task_runner  The runner of the concurrent loop to
+  ///                                 stroke on, or null to stroke on the
+  ///                                 calling thread.
+  ///
+  static std::vector<Point> GenerateSolidStrokeVertices(
+      const Path& path,
+      Scalar stroke_width,
+      Scalar miter_limit,
+      Join stroke_join,
+      Cap stroke_cap,
+      Scalar scale,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner =
+          nullptr);
+
  private:
   using VS = SolidFillVertexShader;
 
@@ -63,6 +90,15 @@ class StrokePathGeometry final : public Geometry {
   // |Geometry|
   std::optional<Rect> GetCoverage(const Matrix& transform) const override;
 
+  /// A run of the components of a contour that is stroked independently of
+  /// the rest of the contour. The first chunk of a contour also strokes the
+  /// start cap, and the last one the end cap or the closing join.
+  struct StrokeChunk {
+    size_t contour_index;
+    size_t component_begin;
+    size_t component_end;
+  };
+
   bool SkipRendering() const;
 
   static Scalar CreateBevelAndGetDirection(
@@ -71,13 +107,28 @@ class StrokePathGeometry final : public Geometry {
       const Point& start_offset,
       const Point& end_offset);
 
+  static std::vector<StrokeChunk> SplitIntoStrokeChunks(
+      const Path::Polyline& polyline);
+
+  static void AddStrokeChunkVertices(
+      VertexBufferBuilder<SolidFillVertexShader::PerVertexData>& vtx_builder,
+      const Path::Polyline& polyline,
+      const StrokeChunk& chunk,
+      Scalar stroke_width,
+      Scalar scaled_miter_limit,
+      const JoinProc& join_proc,
+      const CapProc& cap_proc,
+      Scalar scale);
+
   static VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
-  CreateSolidStrokeVertices(const Path& path,
-                            Scalar stroke_width,
-                            Scalar scaled_miter_limit,
-                            const JoinProc& join_proc,
-                            const CapProc& cap_proc,
-                            Scalar scale);
+  CreateSolidStrokeVertices(
+      const Path& path,
+      Scalar stroke_width,
+      Scalar scaled_miter_limit,
+      const JoinProc& join_proc,
+      const CapProc& cap_proc,
+      Scalar scale,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner);
 
   static StrokePathGeometry::JoinProc GetJoinProc(Join stroke_join);
 
@@ -16,11 +16,13 @@ namespace impeller {
 
 InlinePassContext::InlinePassContext(
     std::shared_ptr<Context> context,
+    std::shared_ptr<HostBuffer> transients_buffer,
     EntityPassTarget& pass_target,
     uint32_t pass_texture_reads,
     uint32_t entity_count,
     std::optional<RenderPassResult> collapsed_parent_pass)
     : context_(std::move(context)),
+      transients_buffer_(std::move(transients_buffer)),
       pass_target_(pass_target),
       entity_count_(entity_count),
       is_collapsed_(collapsed_parent_pass.has_value()) {
@@ -151,6 +153,9 @@ InlinePassContext::RenderPassResult InlinePassContext::GetRenderPass(
     VALIDATION_LOG << "Could not create render pass.";
     return {};
   }
+  if (transients_buffer_) {
+    pass_->SetTransientsBuffer(transients_buffer_);
+  }
   // Commands are fairly large (500B) objects, so re-allocation of the command
   // buffer while encoding can add a surprising amount of overhead. We make a
   // conservative npot estimate to avoid this case.
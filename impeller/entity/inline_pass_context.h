@@ -7,6 +7,7 @@
 
 #include <cstdint>
 
+#include "impeller/core/host_buffer.h"
 #include "impeller/entity/entity_pass_target.h"
 #include "impeller/renderer/context.h"
 #include "impeller/renderer/render_pass.h"
@@ -23,6 +24,7 @@ class InlinePassContext {
 
   InlinePassContext(
       std::shared_ptr<Context> context,
+      std::shared_ptr<HostBuffer> transients_buffer,
       EntityPassTarget& pass_target,
       uint32_t pass_texture_reads,
       uint32_t entity_count,
@@ -46,6 +48,7 @@ class InlinePassContext {
 
  private:
   std::shared_ptr<Context> context_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
   EntityPassTarget& pass_target_;
   std::shared_ptr<CommandBuffer> command_buffer_;
   std::shared_ptr<RenderPass> pass_;
@@ -4,6 +4,10 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 
+#include <cmath>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/tessellator/tessellator.h"
@@ -18,6 +22,10 @@ Path CreateCubic();
 Path CreateQuadratic();
 /// Create a rounded rect.
 Path CreateRRect();
+/// A line chart through |count| points joined by cubics or quadratics.
+Path CreateCurvedChart(size_t count, bool cubic);
+/// A line chart through |count| points joined by lines.
+Path CreateLineChart(size_t count);
 }  // namespace
 
 static Tessellator tess;
@@ -62,6 +70,21 @@ static void BM_Polyline(benchmark::State& state, Args&&... args) {
   }
   state.counters["SinglePointCount"] = single_point_count;
   state.counters["TotalPointCount"] = point_count;
+  state.counters["PointsPerSecond"] =
+      benchmark::Counter(point_count, benchmark::Counter::kIsRate);
+  state.counters["PathStorageBytes"] = path.GetStorageByteSize();
+}
+
+template <class... Args>
+static void BM_Clone(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple).Clone();
+
+  while (state.KeepRunning()) {
+    auto clone = path.Clone();
+    benchmark::DoNotOptimize(clone);
+  }
+  state.counters["PathStorageBytes"] = path.GetStorageByteSize();
 }
 
 template <class... Args>
@@ -82,14 +105,244 @@ static void BM_Convex(benchmark::State& state, Args&&... args) {
   state.counters["TotalPointCount"] = point_count;
 }
 
+template <class... Args>
+static void BM_Fill(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple).Clone();
+  auto engine = std::get<Tessellator::FillEngine>(args_tuple);
+
+  size_t vertex_count = 0u;
+  size_t index_count = 0u;
+  while (state.KeepRunning()) {
+    tess.Tessellate(
+        path, 1.0f,
+        [&vertex_count, &index_count](const float* vertices,
+                                      size_t vertices_count,
+                                      const uint16_t* indices,
+                                      size_t indices_count) {
+          vertex_count = vertices_count;
+          index_count = indices_count;
+          return true;
+        },
+        engine);
+  }
+  state.counters["VertexCount"] = vertex_count;
+  state.counters["IndexCount"] = index_count;
+}
+
+/// Flattens a chart with |state.range(0)| curves.
+template <class... Args>
+static void BM_FlattenCurves(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  bool cubic = std::get<0>(args_tuple);
+  bool vectorized = std::get<1>(args_tuple);
+  size_t curve_count = state.range(0);
+
+  std::vector<CubicPathComponent> cubics;
+  std::vector<QuadraticPathComponent> quads;
+  CreateCurvedChart(curve_count, cubic)
+      .EnumerateComponents(
+          nullptr,
+          [&quads](size_t, const QuadraticPathComponent& quad) {
+            quads.push_back(quad);
+          },
+          [&cubics](size_t, const CubicPathComponent& cubic) {
+            cubics.push_back(cubic);
+          },
+          nullptr);
+
+  std::vector<Point> points;
+  size_t point_count = 0u;
+  while (state.KeepRunning()) {
+    points.clear();
+    for (const auto& cubic : cubics) {
+      cubic.AppendPolylinePoints(1.0f, points, vectorized);
+    }
+    for (const auto& quad : quads) {
+      quad.AppendPolylinePoints(1.0f, points, vectorized);
+    }
+    point_count += points.size();
+  }
+  state.counters["SinglePointCount"] = points.size();
+  state.counters["PointsPerSecond"] =
+      benchmark::Counter(point_count, benchmark::Counter::kIsRate);
+}
+
+/// Tessellates an equal copy of the path in every iteration, as a frame that
+/// redraws the same path does, through the tessellation cache.
+template <class... Args>
+static void BM_RepeatedDraw(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple).Clone();
+  bool cached = std::get<bool>(args_tuple);
+
+  Tessellator tessellator;
+  size_t point_count = 0u;
+  auto callback = [&point_count](const float* vertices, size_t vertices_count,
+                                 const uint16_t* indices,
+                                 size_t indices_count) {
+    point_count += indices_count > 0 ? indices_count : vertices_count;
+    return true;
+  };
+  while (state.KeepRunning()) {
+    auto frame_path = path.Clone();
+    if (cached) {
+      tessellator.TessellateCached(frame_path, 1.0f, callback);
+    } else {
+      tessellator.Tessellate(frame_path, 1.0f, callback);
+    }
+  }
+  state.counters["TotalPointCount"] = point_count;
+  state.counters["CacheHits"] = tessellator.GetCache().GetHitCount();
+  state.counters["CacheMisses"] = tessellator.GetCache().GetMissCount();
+}
+
+/// Strokes the path on the calling thread, or split across 4 workers and the
+/// calling thread.
+template <class... Args>
+static void BM_Stroke(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple).Clone();
+  auto join = std::get<Join>(args_tuple);
+  bool parallel = std::get<bool>(args_tuple);
+
+  auto loop = parallel ? fml::ConcurrentMessageLoop::Create(4) : nullptr;
+  auto worker_task_runner = parallel ? loop->GetTaskRunner() : nullptr;
+  size_t point_count = 0u;
+  size_t single_point_count = 0u;
+  while (state.KeepRunning()) {
+    auto vertices = StrokePathGeometry::GenerateSolidStrokeVertices(
+        path, 2.0f, 4.0f, join, Cap::kRound, 1.0f, worker_task_runner);
+    single_point_count = vertices.size();
+    point_count += single_point_count;
+  }
+  state.counters["SinglePointCount"] = single_point_count;
+  state.counters["PointsPerSecond"] =
+      benchmark::Counter(point_count, benchmark::Counter::kIsRate);
+}
+
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline, CreateCubic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline_tess, CreateCubic(), true);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline, CreateQuadratic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline_tess, CreateQuadratic(), true);
 BENCHMARK_CAPTURE(BM_Convex, rrect_convex, CreateRRect(), true);
+BENCHMARK_CAPTURE(BM_Clone, cubic_clone, CreateCubic());
+BENCHMARK_CAPTURE(BM_Polyline,
+                  chart_cubic_polyline,
+                  CreateCurvedChart(5000, true),
+                  false);
+BENCHMARK_CAPTURE(BM_Polyline,
+                  chart_quad_polyline,
+                  CreateCurvedChart(5000, false),
+                  false);
+BENCHMARK_CAPTURE(BM_FlattenCurves, cubic_scalar, true, false)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000);
+BENCHMARK_CAPTURE(BM_FlattenCurves, cubic_vectorized, true, true)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000);
+BENCHMARK_CAPTURE(BM_FlattenCurves, quad_scalar, false, false)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000);
+BENCHMARK_CAPTURE(BM_FlattenCurves, quad_vectorized, false, true)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000);
+BENCHMARK_CAPTURE(BM_Clone, rrect_clone, CreateRRect());
+BENCHMARK_CAPTURE(BM_Fill,
+                  cubic_trapezoids,
+                  CreateCubic(),
+                  Tessellator::FillEngine::kTrapezoids);
+BENCHMARK_CAPTURE(BM_Fill,
+                  cubic_libtess,
+                  CreateCubic(),
+                  Tessellator::FillEngine::kLibtess);
+BENCHMARK_CAPTURE(BM_Fill,
+                  quad_trapezoids,
+                  CreateQuadratic(),
+                  Tessellator::FillEngine::kTrapezoids);
+BENCHMARK_CAPTURE(BM_Fill,
+                  quad_libtess,
+                  CreateQuadratic(),
+                  Tessellator::FillEngine::kLibtess);
+BENCHMARK_CAPTURE(BM_Fill,
+                  rrect_trapezoids,
+                  CreateRRect(),
+                  Tessellator::FillEngine::kTrapezoids);
+BENCHMARK_CAPTURE(BM_Fill,
+                  rrect_libtess,
+                  CreateRRect(),
+                  Tessellator::FillEngine::kLibtess);
+BENCHMARK_CAPTURE(BM_RepeatedDraw, cubic_uncached, CreateCubic(), false);
+BENCHMARK_CAPTURE(BM_RepeatedDraw, cubic_cached, CreateCubic(), true);
+BENCHMARK_CAPTURE(BM_RepeatedDraw, quad_uncached, CreateQuadratic(), false);
+BENCHMARK_CAPTURE(BM_RepeatedDraw, quad_cached, CreateQuadratic(), true);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_miter_serial,
+                  CreateLineChart(100000),
+                  Join::kMiter,
+                  false)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_miter_parallel,
+                  CreateLineChart(100000),
+                  Join::kMiter,
+                  true)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_round_serial,
+                  CreateLineChart(100000),
+                  Join::kRound,
+                  false)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_round_parallel,
+                  CreateLineChart(100000),
+                  Join::kRound,
+                  true)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stroke,
+                  curved_chart_serial,
+                  CreateCurvedChart(5000, true),
+                  Join::kRound,
+                  false)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stroke,
+                  curved_chart_parallel,
+                  CreateCurvedChart(5000, true),
+                  Join::kRound,
+                  true)
+    ->UseRealTime();
 
 namespace {
 
+Path CreateCurvedChart(size_t count, bool cubic) {
+  PathBuilder builder;
+  Scalar previous_y = 200;
+  builder.MoveTo({0, previous_y});
+  for (size_t i = 1; i <= count; i++) {
+    // A deterministic series that rises and falls at several frequencies.
+    Scalar x = i * 4.0f;
+    Scalar y = 200 + 120 * std::sin(i * 0.05f) + 40 * std::sin(i * 0.7f);
+    if (cubic) {
+      builder.CubicCurveTo({x - 2.5f, previous_y}, {x - 1.5f, y}, {x, y});
+    } else {
+      builder.QuadraticCurveTo({x - 2, y + 30}, {x, y});
+    }
+    previous_y = y;
+  }
+  return builder.TakePath();
+}
+
+Path CreateLineChart(size_t count) {
+  PathBuilder builder;
+  builder.MoveTo({0, 200});
+  for (size_t i = 1; i < count; i++) {
+    Scalar y = 200 + 120 * std::sin(i * 0.05f) + 40 * std::sin(i * 0.7f);
+    builder.LineTo({i * 0.5f, y});
+  }
+  return builder.TakePath();
+}
+
 Path CreateRRect() {
   return PathBuilder{}
       .AddRoundedRect(Rect::MakeLTRB(0, 0, 400, 400), 16)
@@ -4,16 +4,19 @@
 
 #include "impeller/geometry/path.h"
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 #include <variant>
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "impeller/geometry/path_component.h"
 #include "impeller/geometry/point.h"
 
 namespace impeller {
 
-Path::Path() {
+Path::Path() : data_(std::make_shared<Data>()) {
   AddContourComponent({});
 };
 
@@ -31,21 +34,50 @@ std::tuple<size_t, size_t> Path::Polyline::GetContourPointBounds(
   return std::make_tuple(start_index, end_index);
 }
 
+size_t Path::GetPointCount(ComponentType type) {
+  static constexpr size_t kPointCounts[] = {
+      2,  // kLinear
+      3,  // kQuadratic
+      4,  // kCubic
+      1,  // kContour
+  };
+  return kPointCounts[static_cast<size_t>(type)];
+}
+
+const Path::Data& Path::GetData() const {
+  // Only a path that has been moved from has no data.
+  static const Data kEmptyData;
+  return data_ ? *data_ : kEmptyData;
+}
+
+Path::Data& Path::GetMutableData() {
+  if (!data_) {
+    data_ = std::make_shared<Data>();
+  } else if (data_.use_count() > 1) {
+    data_ = std::make_shared<Data>(*data_);
+  }
+  return *data_;
+}
+
+size_t Path::GetPointIndex(size_t component_index) const {
+  const Data& data = GetData();
+  size_t point_index = 0;
+  for (size_t i = 0; i < component_index; i++) {
+    point_index += GetPointCount(data.verbs[i]);
+  }
+  return point_index;
+}
+
 size_t Path::GetComponentCount(std::optional<ComponentType> type) const {
+  const Data& data = GetData();
   if (!type.has_value()) {
-    return components_.size();
+    return data.verbs.size();
   }
   auto type_value = type.value();
   if (type_value == ComponentType::kContour) {
-    return contours_.size();
-  }
-  size_t count = 0u;
-  for (const auto& component : components_) {
-    if (component.type == type_value) {
-      count++;
-    }
+    return data.closed_contours.size();
   }
-  return count;
+  return std::count(data.verbs.begin(), data.verbs.end(), type_value);
 }
 
 void Path::SetFillType(FillType fill) {
@@ -64,36 +96,88 @@ void Path::SetConvexity(Convexity value) {
   convexity_ = value;
 }
 
+bool Path::IsVolatile() const {
+  return is_volatile_;
+}
+
+void Path::SetVolatile(bool value) {
+  is_volatile_ = value;
+}
+
+bool Path::IsFinite() const {
+  const Data& data = GetData();
+  return std::all_of(data.points.begin(), data.points.end(),
+                     [](const Point& point) {
+                       return std::isfinite(point.x) && std::isfinite(point.y);
+                     });
+}
+
 void Path::Shift(Point shift) {
-  for (auto i = 0u; i < points_.size(); i++) {
-    points_[i] += shift;
-  }
-  for (auto& contour : contours_) {
-    contour.destination += shift;
+  for (auto& point : GetMutableData().points) {
+    point += shift;
   }
 }
 
+void Path::Reserve(size_t point_size, size_t verb_size) {
+  Data& data = GetMutableData();
+  data.points.reserve(point_size);
+  data.verbs.reserve(verb_size);
+}
+
 Path Path::Clone() const {
   Path new_path = *this;
   return new_path;
 }
 
+std::size_t Path::GetHash() const {
+  const Data& data = GetData();
+  std::size_t hash = fml::HashCombine(fill_, data.verbs.size(),
+                                      data.points.size());
+  for (ComponentType verb : data.verbs) {
+    fml::HashCombineSeed(hash, verb);
+  }
+  for (const auto& point : data.points) {
+    fml::HashCombineSeed(hash, point.x, point.y);
+  }
+  for (bool is_closed : data.closed_contours) {
+    fml::HashCombineSeed(hash, is_closed);
+  }
+  return hash;
+}
+
+bool Path::IsEqual(const Path& other) const {
+  if (fill_ != other.fill_) {
+    return false;
+  }
+  if (data_ == other.data_) {
+    return true;
+  }
+  const Data& data = GetData();
+  const Data& other_data = other.GetData();
+  return data.verbs == other_data.verbs && data.points == other_data.points &&
+         data.closed_contours == other_data.closed_contours;
+}
+
+size_t Path::GetStorageByteSize() const {
+  const Data& data = GetData();
+  return sizeof(Data) + data.verbs.capacity() * sizeof(ComponentType) +
+         data.points.capacity() * sizeof(Point) +
+         (data.closed_contours.capacity() + 7) / 8;
+}
+
 Path& Path::AddLinearComponent(const Point& p1, const Point& p2) {
-  auto index = points_.size();
-  points_.emplace_back(p1);
-  points_.emplace_back(p2);
-  components_.emplace_back(ComponentType::kLinear, index);
+  Data& data = GetMutableData();
+  data.points.insert(data.points.end(), {p1, p2});
+  data.verbs.push_back(ComponentType::kLinear);
   return *this;
 }
 
 Path& Path::AddQuadraticComponent(const Point& p1,
                                   const Point& cp,
                                   const Point& p2) {
-  auto index = points_.size();
-  points_.emplace_back(p1);
-  points_.emplace_back(cp);
-  points_.emplace_back(p2);
-  components_.emplace_back(ComponentType::kQuadratic, index);
+  Data& data = GetMutableData();
+  data.points.insert(data.points.end(), {p1, cp, p2});
+  data.verbs.push_back(ComponentType::kQuadratic);
   return *this;
 }
 
@@ -101,29 +185,28 @@ Path& Path::AddCubicComponent(const Point& p1,
                               const Point& cp1,
                               const Point& cp2,
                               const Point& p2) {
-  auto index = points_.size();
-  points_.emplace_back(p1);
-  points_.emplace_back(cp1);
-  points_.emplace_back(cp2);
-  points_.emplace_back(p2);
-  components_.emplace_back(ComponentType::kCubic, index);
+  Data& data = GetMutableData();
+  data.points.insert(data.points.end(), {p1, cp1, cp2, p2});
+  data.verbs.push_back(ComponentType::kCubic);
   return *this;
 }
 
 Path& Path::AddContourComponent(const Point& destination, bool is_closed) {
-  if (components_.size() > 0 &&
-      components_.back().type == ComponentType::kContour) {
+  Data& data = GetMutableData();
+  if (!data.verbs.empty() && data.verbs.back() == ComponentType::kContour) {
     // Never insert contiguous contours.
-    contours_.back() = ContourComponent(destination, is_closed);
+    data.points.back() = destination;
+    data.closed_contours.back() = is_closed;
   } else {
-    contours_.emplace_back(ContourComponent(destination, is_closed));
-    components_.emplace_back(ComponentType::kContour, contours_.size() - 1);
+    data.points.push_back(destination);
+    data.closed_contours.push_back(is_closed);
+    data.verbs.push_back(ComponentType::kContour);
   }
   return *this;
 }
 
 void Path::SetContourClosed(bool is_closed) {
-  contours_.back().is_closed = is_closed;
+  GetMutableData().closed_contours.back() = is_closed;
 }
 
 void Path::EnumerateComponents(
@@ -131,103 +214,107 @@ void Path::EnumerateComponents(
     const Applier<QuadraticPathComponent>& quad_applier,
     const Applier<CubicPathComponent>& cubic_applier,
     const Applier<ContourComponent>& contour_applier) const {
-  size_t currentIndex = 0;
-  for (const auto& component : components_) {
-    switch (component.type) {
+  const Data& data = GetData();
+  const Point* points = data.points.data();
+  size_t contour_index = 0;
+  for (size_t i = 0; i < data.verbs.size(); i++) {
+    ComponentType verb = data.verbs[i];
+    switch (verb) {
       case ComponentType::kLinear:
         if (linear_applier) {
-          linear_applier(currentIndex,
-                         LinearPathComponent(points_[component.index],
-                                             points_[component.index + 1]));
+          linear_applier(i, LinearPathComponent(points[0], points[1]));
         }
         break;
       case ComponentType::kQuadratic:
         if (quad_applier) {
-          quad_applier(currentIndex,
-                       QuadraticPathComponent(points_[component.index],
-                                              points_[component.index + 1],
-                                              points_[component.index + 2]));
+          quad_applier(
+              i, QuadraticPathComponent(points[0], points[1], points[2]));
         }
         break;
       case ComponentType::kCubic:
         if (cubic_applier) {
-          cubic_applier(currentIndex,
-                        CubicPathComponent(points_[component.index],
-                                           points_[component.index + 1],
-                                           points_[component.index + 2],
-                                           points_[component.index + 3]));
+          cubic_applier(i, CubicPathComponent(points[0], points[1], points[2],
+                                              points[3]));
         }
         break;
       case ComponentType::kContour:
         if (contour_applier) {
-          contour_applier(currentIndex, contours_[component.index]);
+          contour_applier(
+              i, ContourComponent(points[0],
+                                  data.closed_contours[contour_index]));
         }
+        contour_index++;
         break;
     }
-    currentIndex++;
+    points += GetPointCount(verb);
   }
 }
 
 bool Path::GetLinearComponentAtIndex(size_t index,
                                      LinearPathComponent& linear) const {
-  if (index >= components_.size()) {
+  const Data& data = GetData();
+  if (index >= data.verbs.size()) {
     return false;
   }
 
-  if (components_[index].type != ComponentType::kLinear) {
+  if (data.verbs[index] != ComponentType::kLinear) {
     return false;
   }
 
-  auto point_index = components_[index].index;
-  linear = LinearPathComponent(points_[point_index], points_[point_index + 1]);
+  const Point* points = &data.points[GetPointIndex(index)];
+  linear = LinearPathComponent(points[0], points[1]);
   return true;
 }
 
 bool Path::GetQuadraticComponentAtIndex(
     size_t index,
     QuadraticPathComponent& quadratic) const {
-  if (index >= components_.size()) {
+  const Data& data = GetData();
+  if (index >= data.verbs.size()) {
     return false;
   }
 
-  if (components_[index].type != ComponentType::kQuadratic) {
+  if (data.verbs[index] != ComponentType::kQuadratic) {
     return false;
   }
 
-  auto point_index = components_[index].index;
-  quadratic = QuadraticPathComponent(
-      points_[point_index], points_[point_index + 1], points_[point_index + 2]);
+  const Point* points = &data.points[GetPointIndex(index)];
+  quadratic = QuadraticPathComponent(points[0], points[1], points[2]);
   return true;
 }
 
 bool Path::GetCubicComponentAtIndex(size_t index,
                                     CubicPathComponent& cubic) const {
-  if (index >= components_.size()) {
+  const Data& data = GetData();
+  if (index >= data.verbs.size()) {
     return false;
   }
 
-  if (components_[index].type != ComponentType::kCubic) {
+  if (data.verbs[index] != ComponentType::kCubic) {
     return false;
   }
 
-  auto point_index = components_[index].index;
-  cubic =
-      CubicPathComponent(points_[point_index], points_[point_index + 1],
-                         points_[point_index + 2], points_[point_index + 3]);
+  const Point* points = &data.points[GetPointIndex(index)];
+  cubic = CubicPathComponent(points[0], points[1], points[2], points[3]);
   return true;
 }
 
 bool Path::GetContourComponentAtIndex(size_t index,
                                       ContourComponent& move) const {
-  if (index >= components_.size()) {
+  const Data& data = GetData();
+  if (index >= data.verbs.size()) {
     return false;
   }
 
-  if (components_[index].type != ComponentType::kContour) {
+  if (data.verbs[index] != ComponentType::kContour) {
     return false;
   }
 
-  move = contours_[components_[index].index];
+  size_t contour_index =
+      std::count(data.verbs.begin(), data.verbs.begin() + index,
+                 ComponentType::kContour);
+  move = ContourComponent(data.points[GetPointIndex(index)],
+                          data.closed_contours[contour_index]);
   return true;
 }
 
@@ -256,130 +343,142 @@ Path::Polyline Path::CreatePolyline(
     Path::Polyline::ReclaimPointBufferCallback reclaim) const {
   Polyline polyline(std::move(point_buffer), std::move(reclaim));
 
-  auto get_path_component = [this](size_t component_i) -> PathComponentVariant {
-    if (component_i >= components_.size()) {
-      return std::monostate{};
-    }
-    const auto& component = components_[component_i];
-    switch (component.type) {
+  const Data& data = GetData();
+  const std::vector<ComponentType>& verbs = data.verbs;
+  const Point* points = data.points.data();
+
+  auto get_path_component =
+      [points](ComponentType verb, size_t point_index) -> PathComponentVariant {
+    switch (verb) {
       case ComponentType::kLinear:
         return reinterpret_cast<const LinearPathComponent*>(
-            &points_[component.index]);
+            &points[point_index]);
       case ComponentType::kQuadratic:
         return reinterpret_cast<const QuadraticPathComponent*>(
-            &points_[component.index]);
+            &points[point_index]);
       case ComponentType::kCubic:
         return reinterpret_cast<const CubicPathComponent*>(
-            &points_[component.index]);
+            &points[point_index]);
       case ComponentType::kContour:
         return std::monostate{};
     }
   };
 
-  auto compute_contour_start_direction =
-      [&get_path_component](size_t current_path_component_index) {
-        size_t next_component_index = current_path_component_index + 1;
-        while (!std::holds_alternative<std::monostate>(
-            get_path_component(next_component_index))) {
-          auto next_component = get_path_component(next_component_index);
-          auto maybe_vector =
-              std::visit(PathComponentStartDirectionVisitor(), next_component);
-          if (maybe_vector.has_value()) {
-            return maybe_vector.value();
-          } else {
-            next_component_index++;
-          }
-        }
-        return Vector2(0, -1);
-      };
+  // The components of a contour follow its contour component in both
+  // streams, so the points of each are found by adding up point counts.
+  auto compute_contour_start_direction = [&verbs, &get_path_component](
+                                             size_t contour_verb_index,
+                                             size_t contour_point_index) {
+    size_t point_index = contour_point_index + 1;
+    for (size_t i = contour_verb_index + 1;
+         i < verbs.size() && verbs[i] != ComponentType::kContour; i++) {
+      auto maybe_vector = std::visit(PathComponentStartDirectionVisitor(),
+                                     get_path_component(verbs[i], point_index));
+      if (maybe_vector.has_value()) {
+        return maybe_vector.value();
+      }
+      point_index += GetPointCount(verbs[i]);
+    }
+    return Vector2(0, -1);
+  };
 
   std::vector<PolylineContour::Component> components;
-  std::optional<size_t> previous_path_component_index;
-  auto end_contour = [&polyline, &previous_path_component_index,
-                      &get_path_component, &components]() {
+  std::optional<size_t> previous_verb_index;
+  size_t previous_point_index = 0;
+  auto end_contour = [&polyline, &verbs, &previous_verb_index,
+                      &previous_point_index, &get_path_component,
+                      &components]() {
     // Whenever a contour has ended, extract the exact end direction from
     // the last component.
     if (polyline.contours.empty()) {
       return;
     }
 
-    if (!previous_path_component_index.has_value()) {
+    if (!previous_verb_index.has_value()) {
       return;
     }
 
     auto& contour = polyline.contours.back();
     contour.end_direction = Vector2(0, 1);
-    contour.components = components;
+    contour.components = std::move(components);
     components.clear();
 
-    size_t previous_index = previous_path_component_index.value();
-    while (!std::holds_alternative<std::monostate>(
-        get_path_component(previous_index))) {
-      auto previous_component = get_path_component(previous_index);
+    // Walk back through the components of the contour, whose points precede
+    // the points of the component after them.
+    size_t verb_index = previous_verb_index.value();
+    size_t point_index = previous_point_index;
+    while (verbs[verb_index] != ComponentType::kContour) {
       auto maybe_vector =
-          std::visit(PathComponentEndDirectionVisitor(), previous_component);
+          std::visit(PathComponentEndDirectionVisitor(),
+                     get_path_component(verbs[verb_index], point_index));
       if (maybe_vector.has_value()) {
         contour.end_direction = maybe_vector.value();
         break;
-      } else {
-        if (previous_index == 0) {
-          break;
-        }
-        previous_index--;
       }
+      if (verb_index == 0) {
+        break;
+      }
+      verb_index--;
+      point_index -= GetPointCount(verbs[verb_index]);
     }
   };
 
-  for (size_t component_i = 0; component_i < components_.size();
-       component_i++) {
-    const auto& component = components_[component_i];
-    switch (component.type) {
+  size_t point_index = 0;
+  size_t contour_index = 0;
+  for (size_t verb_index = 0; verb_index < verbs.size(); verb_index++) {
+    ComponentType verb = verbs[verb_index];
+    const Point* component_points = &points[point_index];
+    switch (verb) {
       case ComponentType::kLinear:
         components.push_back({
             .component_start_index = polyline.points->size() - 1,
             .is_curve = false,
         });
-        reinterpret_cast<const LinearPathComponent*>(&points_[component.index])
+        reinterpret_cast<const LinearPathComponent*>(component_points)
             ->AppendPolylinePoints(*polyline.points);
-        previous_path_component_index = component_i;
+        previous_verb_index = verb_index;
+        previous_point_index = point_index;
         break;
       case ComponentType::kQuadratic:
         components.push_back({
             .component_start_index = polyline.points->size() - 1,
             .is_curve = true,
         });
-        reinterpret_cast<const QuadraticPathComponent*>(
-            &points_[component.index])
+        reinterpret_cast<const QuadraticPathComponent*>(component_points)
             ->AppendPolylinePoints(scale, *polyline.points);
-        previous_path_component_index = component_i;
+        previous_verb_index = verb_index;
+        previous_point_index = point_index;
         break;
       case ComponentType::kCubic:
         components.push_back({
             .component_start_index = polyline.points->size() - 1,
             .is_curve = true,
         });
-        reinterpret_cast<const CubicPathComponent*>(&points_[component.index])
+        reinterpret_cast<const CubicPathComponent*>(component_points)
             ->AppendPolylinePoints(scale, *polyline.points);
-        previous_path_component_index = component_i;
+        previous_verb_index = verb_index;
+        previous_point_index = point_index;
         break;
       case ComponentType::kContour:
-        if (component_i == components_.size() - 1) {
-          // If the last component is a contour, that means it's an empty
-          // contour, so skip it.
-          continue;
+        // If the last component is a contour, that means it's an empty
+        // contour, so skip it.
+        if (verb_index != verbs.size() - 1) {
+          end_contour();
+
+          Vector2 start_direction =
+              compute_contour_start_direction(verb_index, point_index);
+          polyline.contours.push_back({
+              .start_index = polyline.points->size(),
+              .is_closed = data.closed_contours[contour_index],
+              .start_direction = start_direction,
+          });
+
+          polyline.points->push_back(*component_points);
         }
-        end_contour();
-
-        Vector2 start_direction = compute_contour_start_direction(component_i);
-        const auto& contour = contours_[component.index];
-        polyline.contours.push_back({.start_index = polyline.points->size(),
-                                     .is_closed = contour.is_closed,
-                                     .start_direction = start_direction,
-                                     .components = components});
-
-        polyline.points->push_back(contour.destination);
+        contour_index++;
         break;
     }
+    point_index += GetPointCount(verb);
   }
   end_contour();
   return polyline;
@@ -411,7 +510,8 @@ std::optional<Rect> Path::GetTransformedBoundingBox(
 }
 
 std::optional<std::pair<Point, Point>> Path::GetMinMaxCoveragePoints() const {
-  if (points_.empty()) {
+  const Data& data = GetData();
+  if (data.points.empty()) {
     return std::nullopt;
   }
 
@@ -431,33 +531,32 @@ std::optional<std::pair<Point, Point>> Path::GetMinMaxCoveragePoints() const {
     }
   };
 
-  for (const auto& component : components_) {
-    switch (component.type) {
+  const Point* points = data.points.data();
+  for (ComponentType verb : data.verbs) {
+    switch (verb) {
       case ComponentType::kLinear: {
-        auto* linear = reinterpret_cast<const LinearPathComponent*>(
-            &points_[component.index]);
+        auto* linear = reinterpret_cast<const LinearPathComponent*>(points);
         clamp(linear->p1);
         clamp(linear->p2);
         break;
       }
       case ComponentType::kQuadratic:
         for (const auto& extrema :
-             reinterpret_cast<const QuadraticPathComponent*>(
-                 &points_[component.index])
+             reinterpret_cast<const QuadraticPathComponent*>(points)
                  ->Extrema()) {
           clamp(extrema);
         }
         break;
       case ComponentType::kCubic:
-        for (const auto& extrema : reinterpret_cast<const CubicPathComponent*>(
-                                       &points_[component.index])
-                                       ->Extrema()) {
+        for (const auto& extrema :
+             reinterpret_cast<const CubicPathComponent*>(points)->Extrema()) {
           clamp(extrema);
         }
         break;
       case ComponentType::kContour:
         break;
     }
+    points += GetPointCount(verb);
   }
 
   if (!min.has_value() || !max.has_value()) {
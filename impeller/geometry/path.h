@@ -5,7 +5,9 @@
 #ifndef FLUTTER_IMPELLER_GEOMETRY_PATH_H_
 #define FLUTTER_IMPELLER_GEOMETRY_PATH_H_
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <set>
 #include <tuple>
@@ -52,9 +54,13 @@ enum class Convexity {
 ///             Paths are externally immutable once created, Creating paths must
 ///             be done using a path builder.
 ///
+///             The components are stored as a stream of component types and
+///             a stream of the points of the components. The streams are
+///             shared by clones of a path until one of them is modified.
+///
 class Path {
  public:
-  enum class ComponentType {
+  enum class ComponentType : uint8_t {
     kLinear,
     kQuadratic,
     kCubic,
@@ -135,15 +141,32 @@ class Path {
 
   Path(Path&& other) = default;
 
-  /// @brief Deeply clone this path and all data associated with it.
+  /// @brief Clone this path. The clone shares the components of this path
+  ///        until either of them is modified.
   Path Clone() const;
 
+  /// @brief Returns a hash of the fill type and the components of the path,
+  ///        which is the same for paths that are equal by |IsEqual|.
+  std::size_t GetHash() const;
+
+  /// @brief Returns whether this path has the same fill type and the same
+  ///        components with the same points as the other path.
+  bool IsEqual(const Path& other) const;
+
   size_t GetComponentCount(std::optional<ComponentType> type = {}) const;
 
   FillType GetFillType() const;
 
   bool IsConvex() const;
 
+  /// @brief Returns whether this path was marked as likely to change from
+  ///        one frame to the next, so that it is not worth caching work
+  ///        derived from it.
+  bool IsVolatile() const;
+
+  /// @brief Returns whether all points of this path are finite.
+  bool IsFinite() const;
+
   template <class T>
   using Applier = std::function<void(size_t index, const T& component)>;
   void EnumerateComponents(
@@ -181,6 +204,10 @@ class Path {
 
   std::optional<std::pair<Point, Point>> GetMinMaxCoveragePoints() const;
 
+  /// @brief Returns the number of bytes allocated to store the components of
+  ///        this path, which may be shared with its clones.
+  size_t GetStorageByteSize() const;
+
  private:
   friend class PathBuilder;
 
@@ -188,6 +215,8 @@ class Path {
 
   void SetConvexity(Convexity value);
 
+  void SetVolatile(bool value);
+
   void SetFillType(FillType fill);
 
   void SetBounds(Rect rect);
@@ -215,21 +244,37 @@ class Path {
 
   void Shift(Point shift);
 
-  struct ComponentIndexPair {
-    ComponentType type = ComponentType::kLinear;
-    size_t index = 0;
+  void Reserve(size_t point_size, size_t verb_size);
+
+  struct Data {
+    /// The type of each component, in order.
+    std::vector<ComponentType> verbs;
+    /// The points of each component, in order. Each linear, quadratic and
+    /// cubic component has 2, 3 and 4 points and each contour component has
+    /// its destination.
+    std::vector<Point> points;
+    /// Whether each contour component is closed.
+    std::vector<bool> closed_contours;
+  };
 
-    ComponentIndexPair() {}
+  /// @brief Returns the number of points in the point stream of a component
+  ///        of the given type.
+  static size_t GetPointCount(ComponentType type);
 
-    ComponentIndexPair(ComponentType a_type, size_t a_index)
-        : type(a_type), index(a_index) {}
-  };
+  const Data& GetData() const;
+
+  /// @brief Returns the data of this path to modify, first copying it if it
+  ///        is shared with a clone.
+  Data& GetMutableData();
+
+  /// @brief Returns the index of the first point of the component at the
+  ///        given index in the point stream.
+  size_t GetPointIndex(size_t component_index) const;
 
   FillType fill_ = FillType::kNonZero;
   Convexity convexity_ = Convexity::kUnknown;
-  std::vector<ComponentIndexPair> components_;
-  std::vector<Point> points_;
-  std::vector<ContourComponent> contours_;
+  bool is_volatile_ = false;
+  std::shared_ptr<Data> data_;
 
   std::optional<Rect> computed_bounds_;
 };
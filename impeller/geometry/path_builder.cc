@@ -22,6 +22,8 @@ Path PathBuilder::TakePath(FillType fill) {
   auto path = std::move(prototype_);
   path.SetFillType(fill);
   path.SetConvexity(convexity_);
+  path.SetVolatile(is_volatile_);
+  is_volatile_ = false;
   if (!did_compute_bounds_) {
     path.ComputeBounds();
   }
@@ -30,8 +32,7 @@ Path PathBuilder::TakePath(FillType fill) {
 }
 
 void PathBuilder::Reserve(size_t point_size, size_t verb_size) {
-  prototype_.points_.reserve(point_size);
-  prototype_.points_.reserve(verb_size);
+  prototype_.Reserve(point_size, verb_size);
 }
 
 PathBuilder& PathBuilder::MoveTo(Point point, bool relative) {
@@ -86,6 +87,11 @@ PathBuilder& PathBuilder::SetConvexity(Convexity value) {
   return *this;
 }
 
+PathBuilder& PathBuilder::SetVolatile(bool value) {
+  is_volatile_ = value;
+  return *this;
+}
+
 PathBuilder& PathBuilder::CubicCurveTo(Point controlPoint1,
                                        Point controlPoint2,
                                        Point point,
@@ -38,6 +38,10 @@ class PathBuilder {
 
   PathBuilder& SetConvexity(Convexity value);
 
+  /// @brief Marks the path as likely to change from one frame to the next,
+  ///        see `Path::IsVolatile`.
+  PathBuilder& SetVolatile(bool value);
+
   PathBuilder& MoveTo(Point point, bool relative = false);
 
   PathBuilder& Close();
@@ -160,6 +164,7 @@ class PathBuilder {
   Point current_;
   Path prototype_;
   Convexity convexity_;
+  bool is_volatile_ = false;
   bool did_compute_bounds_ = false;
 
   PathBuilder& AddRoundedRectTopLeft(Rect rect, RoundingRadii radii);
@@ -4,8 +4,17 @@
 
 #include "path_component.h"
 
+#include <algorithm>
 #include <cmath>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace impeller {
 
 /*
@@ -103,9 +112,205 @@ static Scalar ApproximateParabolaIntegral(Scalar x) {
   return x / (1.0 - d + sqrt(sqrt(pow(d, 4) + 0.25 * x * x)));
 }
 
+namespace {
+
+// A number of Scalars that are operated on together, with SIMD instructions
+// where they are available.
+#if defined(__AVX2__)
+struct Lanes {
+  static constexpr size_t kCount = 8;
+
+  __m256 v;
+
+  static Lanes Splat(Scalar s) { return {_mm256_set1_ps(s)}; }
+
+  static Lanes Sequence(Scalar first) {
+    return {_mm256_add_ps(_mm256_set1_ps(first),
+                          _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7))};
+  }
+
+  friend Lanes operator+(Lanes a, Lanes b) { return {_mm256_add_ps(a.v, b.v)}; }
+  friend Lanes operator-(Lanes a, Lanes b) { return {_mm256_sub_ps(a.v, b.v)}; }
+  friend Lanes operator*(Lanes a, Lanes b) { return {_mm256_mul_ps(a.v, b.v)}; }
+  friend Lanes operator/(Lanes a, Lanes b) { return {_mm256_div_ps(a.v, b.v)}; }
+  friend Lanes Sqrt(Lanes a) { return {_mm256_sqrt_ps(a.v)}; }
+
+  // Stores the lanes of |x| and |y| as the coordinates of |kCount| points.
+  static void StorePoints(Lanes x, Lanes y, Point* points) {
+    __m256 low = _mm256_unpacklo_ps(x.v, y.v);   // 0, 1, 4, 5
+    __m256 high = _mm256_unpackhi_ps(x.v, y.v);  // 2, 3, 6, 7
+    auto out = reinterpret_cast<float*>(points);
+    _mm256_storeu_ps(out, _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(low, high, 0x31));
+  }
+};
+#elif defined(__SSE2__) || defined(_M_X64)
+struct Lanes {
+  static constexpr size_t kCount = 4;
+
+  __m128 v;
+
+  static Lanes Splat(Scalar s) { return {_mm_set1_ps(s)}; }
+
+  static Lanes Sequence(Scalar first) {
+    return {_mm_add_ps(_mm_set1_ps(first), _mm_setr_ps(0, 1, 2, 3))};
+  }
+
+  friend Lanes operator+(Lanes a, Lanes b) { return {_mm_add_ps(a.v, b.v)}; }
+  friend Lanes operator-(Lanes a, Lanes b) { return {_mm_sub_ps(a.v, b.v)}; }
+  friend Lanes operator*(Lanes a, Lanes b) { return {_mm_mul_ps(a.v, b.v)}; }
+  friend Lanes operator/(Lanes a, Lanes b) { return {_mm_div_ps(a.v, b.v)}; }
+  friend Lanes Sqrt(Lanes a) { return {_mm_sqrt_ps(a.v)}; }
+
+  // Stores the lanes of |x| and |y| as the coordinates of |kCount| points.
+  static void StorePoints(Lanes x, Lanes y, Point* points) {
+    auto out = reinterpret_cast<float*>(points);
+    _mm_storeu_ps(out, _mm_unpacklo_ps(x.v, y.v));
+    _mm_storeu_ps(out + 4, _mm_unpackhi_ps(x.v, y.v));
+  }
+};
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+struct Lanes {
+  static constexpr size_t kCount = 4;
+
+  float32x4_t v;
+
+  static Lanes Splat(Scalar s) { return {vdupq_n_f32(s)}; }
+
+  static Lanes Sequence(Scalar first) {
+    static const float kOffsets[] = {0, 1, 2, 3};
+    return {vaddq_f32(vdupq_n_f32(first), vld1q_f32(kOffsets))};
+  }
+
+  friend Lanes operator+(Lanes a, Lanes b) { return {vaddq_f32(a.v, b.v)}; }
+  friend Lanes operator-(Lanes a, Lanes b) { return {vsubq_f32(a.v, b.v)}; }
+  friend Lanes operator*(Lanes a, Lanes b) { return {vmulq_f32(a.v, b.v)}; }
+  friend Lanes operator/(Lanes a, Lanes b) { return {vdivq_f32(a.v, b.v)}; }
+  friend Lanes Sqrt(Lanes a) { return {vsqrtq_f32(a.v)}; }
+
+  // Stores the lanes of |x| and |y| as the coordinates of |kCount| points.
+  static void StorePoints(Lanes x, Lanes y, Point* points) {
+    vst2q_f32(reinterpret_cast<float*>(points), (float32x4x2_t{{x.v, y.v}}));
+  }
+};
+#else
+// Without SIMD instructions, the compiler may still vectorize these loops.
+struct Lanes {
+  static constexpr size_t kCount = 4;
+
+  Scalar v[kCount];
+
+  template <class Op>
+  static Lanes Map(Lanes a, Lanes b, Op op) {
+    Lanes result;
+    for (size_t i = 0; i < kCount; i++) {
+      result.v[i] = op(a.v[i], b.v[i]);
+    }
+    return result;
+  }
+
+  static Lanes Splat(Scalar s) { return {{s, s, s, s}}; }
+
+  static Lanes Sequence(Scalar first) {
+    return {{first, first + 1, first + 2, first + 3}};
+  }
+
+  friend Lanes operator+(Lanes a, Lanes b) {
+    return Map(a, b, [](Scalar x, Scalar y) { return x + y; });
+  }
+  friend Lanes operator-(Lanes a, Lanes b) {
+    return Map(a, b, [](Scalar x, Scalar y) { return x - y; });
+  }
+  friend Lanes operator*(Lanes a, Lanes b) {
+    return Map(a, b, [](Scalar x, Scalar y) { return x * y; });
+  }
+  friend Lanes operator/(Lanes a, Lanes b) {
+    return Map(a, b, [](Scalar x, Scalar y) { return x / y; });
+  }
+  friend Lanes Sqrt(Lanes a) {
+    return Map(a, a, [](Scalar x, Scalar) { return std::sqrt(x); });
+  }
+
+  // Stores the lanes of |x| and |y| as the coordinates of |kCount| points.
+  static void StorePoints(Lanes x, Lanes y, Point* points) {
+    for (size_t i = 0; i < kCount; i++) {
+      points[i] = Point(x.v[i], y.v[i]);
+    }
+  }
+};
+#endif
+
+static_assert(sizeof(Point) == 2 * sizeof(Scalar));
+
+// The parameters of the points that |QuadraticPathComponent| flattens a
+// quadratic into, which map evenly spaced values through the approximate
+// integral of the parabola.
+struct ParabolaSteps {
+  Scalar a0;
+  Scalar a_step;
+  Scalar u0;
+  Scalar u_scale;
+};
+
+// Appends the points of the quadratic at steps [1, count] to |points|,
+// evaluating |Lanes::kCount| points at a time.
+void AppendParabolaPoints(const QuadraticPathComponent& quad,
+                          const ParabolaSteps& steps,
+                          size_t count,
+                          std::vector<Point>& points) {
+  const Lanes d_term = Lanes::Splat(1.0f - 0.67f);
+  const Lanes d4 = Lanes::Splat(0.67f * 0.67f * 0.67f * 0.67f);
+  const Lanes quarter = Lanes::Splat(0.25f);
+  const Lanes one = Lanes::Splat(1.0f);
+  const Lanes two = Lanes::Splat(2.0f);
+  const Lanes a0 = Lanes::Splat(steps.a0);
+  const Lanes a_step = Lanes::Splat(steps.a_step);
+  const Lanes u0 = Lanes::Splat(steps.u0);
+  const Lanes u_scale = Lanes::Splat(steps.u_scale);
+  const Lanes p1x = Lanes::Splat(quad.p1.x);
+  const Lanes p1y = Lanes::Splat(quad.p1.y);
+  const Lanes cpx = Lanes::Splat(quad.cp.x);
+  const Lanes cpy = Lanes::Splat(quad.cp.y);
+  const Lanes p2x = Lanes::Splat(quad.p2.x);
+  const Lanes p2y = Lanes::Splat(quad.p2.y);
+
+  auto solve = [&](size_t first_step, Point* out) {
+    Lanes a = a0 + a_step * Lanes::Sequence(static_cast<Scalar>(first_step));
+    Lanes integral = a / (d_term + Sqrt(Sqrt(d4 + quarter * a * a)));
+    Lanes t = (integral - u0) * u_scale;
+    Lanes mt = one - t;
+    Lanes w0 = mt * mt;
+    Lanes w1 = two * mt * t;
+    Lanes w2 = t * t;
+    Lanes::StorePoints(w0 * p1x + w1 * cpx + w2 * p2x,
+                       w0 * p1y + w1 * cpy + w2 * p2y, out);
+  };
+
+  size_t base = points.size();
+  points.resize(base + count);
+  Point* out = points.data() + base;
+  size_t i = 0;
+  for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+    solve(i + 1, out + i);
+  }
+  if (i < count) {
+    Point tail[Lanes::kCount];
+    solve(i + 1, tail);
+    std::copy(tail, tail + (count - i), out + i);
+  }
+}
+
+}  // namespace
+
 void QuadraticPathComponent::AppendPolylinePoints(
     Scalar scale_factor,
     std::vector<Point>& points) const {
+  AppendPolylinePoints(scale_factor, points, /*vectorized=*/true);
+}
+
+void QuadraticPathComponent::AppendPolylinePoints(Scalar scale_factor,
+                                                  std::vector<Point>& points,
+                                                  bool vectorized) const {
   auto tolerance = kDefaultCurveTolerance / scale_factor;
   auto sqrt_tolerance = sqrt(tolerance);
 
@@ -137,11 +342,22 @@ void QuadraticPathComponent::AppendPolylinePoints(
 
   auto line_count = std::max(1., ceil(0.5 * val / sqrt_tolerance));
   auto step = 1 / line_count;
-  for (size_t i = 1; i < line_count; i += 1) {
-    auto u = i * step;
-    auto a = a0 + (a2 - a0) * u;
-    auto t = (ApproximateParabolaIntegral(a) - u0) * uscale;
-    points.emplace_back(Solve(t));
+  if (vectorized && std::isfinite(line_count)) {
+    AppendParabolaPoints(*this,
+                         {
+                             .a0 = a0,
+                             .a_step = static_cast<Scalar>((a2 - a0) * step),
+                             .u0 = u0,
+                             .u_scale = uscale,
+                         },
+                         static_cast<size_t>(line_count) - 1, points);
+  } else {
+    for (size_t i = 1; i < line_count; i += 1) {
+      auto u = i * step;
+      auto a = a0 + (a2 - a0) * u;
+      auto t = (ApproximateParabolaIntegral(a) - u0) * uscale;
+      points.emplace_back(Solve(t));
+    }
   }
   points.emplace_back(p2);
 }
@@ -188,10 +404,15 @@ Point CubicPathComponent::SolveDerivative(Scalar time) const {
 void CubicPathComponent::AppendPolylinePoints(
     Scalar scale,
     std::vector<Point>& points) const {
-  auto quads = ToQuadraticPathComponents(.1);
-  for (const auto& quad : quads) {
-    quad.AppendPolylinePoints(scale, points);
-  }
+  AppendPolylinePoints(scale, points, /*vectorized=*/true);
+}
+
+void CubicPathComponent::AppendPolylinePoints(Scalar scale,
+                                              std::vector<Point>& points,
+                                              bool vectorized) const {
+  ToQuadraticPathComponents(.1, [&](const QuadraticPathComponent& quad) {
+    quad.AppendPolylinePoints(scale, points, vectorized);
+  });
 }
 
 inline QuadraticPathComponent CubicPathComponent::Lower() const {
@@ -212,6 +433,16 @@ CubicPathComponent CubicPathComponent::Subsegment(Scalar t0, Scalar t1) const {
 std::vector<QuadraticPathComponent>
 CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
   std::vector<QuadraticPathComponent> quads;
+  ToQuadraticPathComponents(accuracy,
+                            [&quads](const QuadraticPathComponent& quad) {
+                              quads.emplace_back(quad);
+                            });
+  return quads;
+}
+
+template <class Proc>
+void CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy,
+                                                   const Proc& proc) const {
   // The maximum error, as a vector from the cubic to the best approximating
   // quadratic, is proportional to the third derivative, which is constant
   // across the segment. Thus, the error scales down as the third power of
@@ -229,17 +460,14 @@ CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
   auto p = p2x2 - p1x2;
   auto err = p.Dot(p);
   auto quad_count = std::max(1., ceil(pow(err / max_hypot2, 1. / 6.0)));
-  quads.reserve(quad_count);
   for (size_t i = 0; i < quad_count; i++) {
     auto t0 = i / quad_count;
     auto t1 = (i + 1) / quad_count;
     auto seg = Subsegment(t0, t1);
     auto p1x2 = 3.0 * seg.cp1 - seg.p1;
     auto p2x2 = 3.0 * seg.cp2 - seg.p2;
-    quads.emplace_back(
-        QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
+    proc(QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
   }
-  return quads;
 }
 
 static inline bool NearEqual(Scalar a, Scalar b, Scalar epsilon) {
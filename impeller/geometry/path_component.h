@@ -76,9 +76,19 @@ struct QuadraticPathComponent {
   //   making it trivially parallelizable.
   //
   // See also the implementation in kurbo: https://github.com/linebender/kurbo.
+  //
+  // The points are evaluated several at a time with the SIMD instructions of
+  // the target (AVX2, SSE2 or NEON) where they are available.
   void AppendPolylinePoints(Scalar scale_factor,
                             std::vector<Point>& points) const;
 
+  // The same as above, but evaluates the points one at a time in double
+  // precision when |vectorized| is false. The vectorized points are within
+  // rounding error of these.
+  void AppendPolylinePoints(Scalar scale_factor,
+                            std::vector<Point>& points,
+                            bool vectorized) const;
+
   std::vector<Point> Extrema() const;
 
   bool operator==(const QuadraticPathComponent& other) const {
@@ -123,6 +133,12 @@ struct CubicPathComponent {
   // references.
   void AppendPolylinePoints(Scalar scale, std::vector<Point>& points) const;
 
+  // The same as above, selecting how the quadratics are flattened as in
+  // QuadraticPathComponent::AppendPolylinePoints.
+  void AppendPolylinePoints(Scalar scale,
+                            std::vector<Point>& points,
+                            bool vectorized) const;
+
   std::vector<Point> Extrema() const;
 
   std::vector<QuadraticPathComponent> ToQuadraticPathComponents(
@@ -141,6 +157,11 @@ struct CubicPathComponent {
 
  private:
   QuadraticPathComponent Lower() const;
+
+  // Calls |proc| with each of the quadratics that approximate the cubic,
+  // without collecting them in a vector.
+  template <class Proc>
+  void ToQuadraticPathComponents(Scalar accuracy, const Proc& proc) const;
 };
 
 struct ContourComponent {
@@ -22,6 +22,40 @@ TEST(PathTest, CubicPathComponentPolylineDoesNotIncludePointOne) {
   ASSERT_EQ(polyline.back().y, 40);
 }
 
+TEST(PathTest, VectorizedCurveFlatteningMatchesScalar) {
+  std::vector<QuadraticPathComponent> quads = {
+      {{10, 10}, {20, 35}, {40, 40}},
+      {{0, 0}, {500, 0}, {-500, 1000}},
+      // A cusp.
+      {{0, 0}, {100, 0}, {50, 0}},
+      // Degenerate.
+      {{20, 20}, {20, 20}, {20, 20}},
+  };
+  std::vector<CubicPathComponent> cubics = {
+      {{10, 10}, {20, 35}, {35, 20}, {40, 40}},
+      {{-400, 300}, {900, -600}, {-900, -600}, {400, 300}},
+      {{0, 0}, {1000, 1000}, {0, 1000}, {1000, 0}},
+  };
+  for (Scalar scale : {0.25f, 1.0f, 3.0f, 40.0f}) {
+    std::vector<Point> vectorized;
+    std::vector<Point> scalar;
+    for (const auto& quad : quads) {
+      quad.AppendPolylinePoints(scale, vectorized, true);
+      quad.AppendPolylinePoints(scale, scalar, false);
+    }
+    for (const auto& cubic : cubics) {
+      cubic.AppendPolylinePoints(scale, vectorized, true);
+      cubic.AppendPolylinePoints(scale, scalar, false);
+    }
+    ASSERT_EQ(vectorized.size(), scalar.size());
+    for (size_t i = 0; i < scalar.size(); i++) {
+      // The vectorized points are evaluated in single precision.
+      EXPECT_NEAR(vectorized[i].x, scalar[i].x, 1e-2) << i << " " << scale;
+      EXPECT_NEAR(vectorized[i].y, scalar[i].y, 1e-2) << i << " " << scale;
+    }
+  }
+}
+
 TEST(PathTest, PathCreatePolyLineDoesNotDuplicatePoints) {
   PathBuilder builder;
   builder.MoveTo({10, 10});
@@ -460,6 +494,7 @@ TEST(PathTest, CanBeCloned) {
   builder.LineTo({20, 20});
   builder.SetBounds(Rect::MakeLTRB(0, 0, 100, 100));
   builder.SetConvexity(Convexity::kConvex);
+  builder.SetVolatile(true);
 
   auto path_a = builder.TakePath(FillType::kAbsGeqTwo);
   auto path_b = path_a.Clone();
@@ -467,6 +502,7 @@ TEST(PathTest, CanBeCloned) {
   EXPECT_EQ(path_a.GetBoundingBox(), path_b.GetBoundingBox());
   EXPECT_EQ(path_a.GetFillType(), path_b.GetFillType());
   EXPECT_EQ(path_a.IsConvex(), path_b.IsConvex());
+  EXPECT_TRUE(path_b.IsVolatile());
 
   auto poly_a = path_a.CreatePolyline(1.0);
   auto poly_b = path_b.CreatePolyline(1.0);
@@ -485,5 +521,70 @@ TEST(PathTest, CanBeCloned) {
   }
 }
 
+TEST(PathTest, ClonesAreIndependentAfterModification) {
+  PathBuilder builder;
+  builder.AddRect(Rect::MakeLTRB(0, 0, 10, 10));
+  auto copy = builder.CopyPath();
+  auto copy_clone = copy.Clone();
+  EXPECT_EQ(copy.GetStorageByteSize(), copy_clone.GetStorageByteSize());
+  EXPECT_TRUE(copy.IsEqual(copy_clone));
+  EXPECT_EQ(copy.GetHash(), copy_clone.GetHash());
+
+  // Modifying the builder does not change the paths copied from it.
+  builder.LineTo({20, 20});
+  builder.Shift({5, 5});
+  auto modified = builder.TakePath();
+  EXPECT_FALSE(modified.IsEqual(copy));
+  EXPECT_EQ(copy.GetComponentCount(), modified.GetComponentCount() - 1);
+
+  ContourComponent contour;
+  ASSERT_TRUE(copy.GetContourComponentAtIndex(0, contour));
+  EXPECT_EQ(contour.destination, Point(0, 0));
+  EXPECT_TRUE(contour.is_closed);
+  ASSERT_TRUE(modified.GetContourComponentAtIndex(0, contour));
+  EXPECT_EQ(contour.destination, Point(5, 5));
+  EXPECT_TRUE(copy.IsEqual(copy_clone));
+
+  // An equal path that was built separately is equal but does not share
+  // storage.
+  auto rebuilt = PathBuilder{}.AddRect(Rect::MakeLTRB(0, 0, 10, 10)).TakePath();
+  EXPECT_TRUE(rebuilt.IsEqual(copy));
+  EXPECT_EQ(rebuilt.GetHash(), copy.GetHash());
+}
+
+TEST(PathTest, ComponentsAreFoundByIndexInTheStream) {
+  auto path = PathBuilder{}
+                  .MoveTo({0, 0})
+                  .CubicCurveTo({1, 1}, {2, 2}, {3, 3})
+                  .QuadraticCurveTo({4, 4}, {5, 5})
+                  .LineTo({6, 6})
+                  .Close()
+                  .MoveTo({7, 7})
+                  .LineTo({8, 8})
+                  .TakePath();
+
+  ASSERT_EQ(path.GetComponentCount(), 7u);
+  EXPECT_EQ(path.GetComponentCount(Path::ComponentType::kContour), 2u);
+  EXPECT_EQ(path.GetComponentCount(Path::ComponentType::kLinear), 3u);
+
+  CubicPathComponent cubic;
+  ASSERT_TRUE(path.GetCubicComponentAtIndex(1, cubic));
+  EXPECT_EQ(cubic.p1, Point(0, 0));
+  EXPECT_EQ(cubic.p2, Point(3, 3));
+  QuadraticPathComponent quad;
+  ASSERT_TRUE(path.GetQuadraticComponentAtIndex(2, quad));
+  EXPECT_EQ(quad.cp, Point(4, 4));
+  LinearPathComponent linear;
+  ASSERT_TRUE(path.GetLinearComponentAtIndex(6, linear));
+  EXPECT_EQ(linear.p1, Point(7, 7));
+  EXPECT_EQ(linear.p2, Point(8, 8));
+  ContourComponent contour;
+  ASSERT_TRUE(path.GetContourComponentAtIndex(5, contour));
+  EXPECT_EQ(contour.destination, Point(7, 7));
+  EXPECT_FALSE(contour.is_closed);
+  EXPECT_FALSE(path.GetCubicComponentAtIndex(2, cubic));
+  EXPECT_FALSE(path.GetLinearComponentAtIndex(7, linear));
+}
+
 }  // namespace testing
 }  // namespace impeller
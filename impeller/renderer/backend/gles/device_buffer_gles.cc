@@ -4,6 +4,7 @@
 
 #include "impeller/renderer/backend/gles/device_buffer_gles.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -38,6 +39,19 @@ uint8_t* DeviceBufferGLES::OnGetContents() const {
   return backing_store_->GetBuffer();
 }
 
+// |DeviceBuffer|
+void DeviceBufferGLES::Flush(Range range) const {
+  // Only the flushed ranges are uploaded the next time the buffer is bound.
+  if (!dirty_range_.has_value()) {
+    dirty_range_ = range;
+    return;
+  }
+  const size_t begin = std::min(dirty_range_->offset, range.offset);
+  const size_t end = std::max(dirty_range_->offset + dirty_range_->length,
+                              range.offset + range.length);
+  dirty_range_ = Range{begin, end - begin};
+}
+
 // |DeviceBuffer|
 bool DeviceBufferGLES::OnCopyHostBuffer(const uint8_t* source,
                                         Range source_range,
@@ -82,12 +96,20 @@ bool DeviceBufferGLES::BindAndUploadDataIfNecessary(BindingType type) const {
 
   gl.BindBuffer(target_type, buffer.value());
 
-  if (upload_generation_ != generation_) {
+  if (!initialized_ || upload_generation_ != generation_) {
     TRACE_EVENT1("impeller", "BufferData", "Bytes",
                  std::to_string(backing_store_->GetLength()).c_str());
     gl.BufferData(target_type, backing_store_->GetLength(),
                   backing_store_->GetBuffer(), GL_STATIC_DRAW);
     upload_generation_ = generation_;
+    initialized_ = true;
+    dirty_range_.reset();
+  } else if (dirty_range_.has_value()) {
+    TRACE_EVENT1("impeller", "BufferSubData", "Bytes",
+                 std::to_string(dirty_range_->length).c_str());
+    gl.BufferSubData(target_type, dirty_range_->offset, dirty_range_->length,
+                     backing_store_->GetBuffer() + dirty_range_->offset);
+    dirty_range_.reset();
   }
 
   return true;
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "flutter/fml/macros.h"
 #include "impeller/base/allocation.h"
@@ -45,10 +46,16 @@ class DeviceBufferGLES final
   mutable std::shared_ptr<Allocation> backing_store_;
   mutable uint32_t generation_ = 0;
   mutable uint32_t upload_generation_ = 0;
+  mutable bool initialized_ = false;
+  // The range written through |Flush| since the last upload.
+  mutable std::optional<Range> dirty_range_;
 
   // |DeviceBuffer|
   uint8_t* OnGetContents() const override;
 
+  // |DeviceBuffer|
+  void Flush(Range range) const override;
+
   // |DeviceBuffer|
   bool OnCopyHostBuffer(const uint8_t* source,
                         Range source_range,
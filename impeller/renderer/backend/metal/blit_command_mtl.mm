@@ -114,10 +114,10 @@ bool BlitCopyBufferToTextureCommandMTL::Encode(
   }
 
   auto destination_origin_mtl =
-      MTLOriginMake(destination_origin.x, destination_origin.y, 0);
+      MTLOriginMake(destination_region.GetX(), destination_region.GetY(), 0);
 
-  auto image_size = destination->GetTextureDescriptor().size;
-  auto source_size_mtl = MTLSizeMake(image_size.width, image_size.height, 1);
+  auto source_size_mtl = MTLSizeMake(destination_region.GetWidth(),
+                                     destination_region.GetHeight(), 1);
 
   auto destination_bytes_per_pixel =
       BytesPerPixelForPixelFormat(destination->GetTextureDescriptor().format);
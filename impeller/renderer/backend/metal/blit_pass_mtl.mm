@@ -126,13 +126,13 @@ bool BlitPassMTL::OnCopyTextureToBufferCommand(
 bool BlitPassMTL::OnCopyBufferToTextureCommand(
     BufferView source,
     std::shared_ptr<Texture> destination,
-    IPoint destination_origin,
+    IRect destination_region,
     std::string label) {
   auto command = std::make_unique<BlitCopyBufferToTextureCommandMTL>();
   command->label = label;
   command->source = std::move(source);
   command->destination = std::move(destination);
-  command->destination_origin = destination_origin;
+  command->destination_region = destination_region;
 
   commands_.emplace_back(std::move(command));
   return true;
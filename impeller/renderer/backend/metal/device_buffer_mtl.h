@@ -41,6 +41,9 @@ class DeviceBufferMTL final : public DeviceBuffer,
                                      const TextureDescriptor& descriptor,
                                      uint16_t row_bytes) const override;
 
+  // |DeviceBuffer|
+  void Flush(Range range) const override;
+
   // |DeviceBuffer|
   bool OnCopyHostBuffer(const uint8_t* source,
                         Range source_range,
@@ -29,6 +29,14 @@ uint8_t* DeviceBufferMTL::OnGetContents() const {
   return reinterpret_cast<uint8_t*>(buffer_.contents);
 }
 
+void DeviceBufferMTL::Flush(Range range) const {
+#if !FML_OS_IOS
+  if (storage_mode_ == MTLStorageModeManaged) {
+    [buffer_ didModifyRange:NSMakeRange(range.offset, range.length)];
+  }
+#endif
+}
+
 std::shared_ptr<Texture> DeviceBufferMTL::AsTexture(
     Allocator& allocator,
     const TextureDescriptor& descriptor,
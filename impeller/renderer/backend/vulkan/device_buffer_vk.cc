@@ -26,6 +26,12 @@ uint8_t* DeviceBufferVK::OnGetContents() const {
   return static_cast<uint8_t*>(resource_->info.pMappedData);
 }
 
+void DeviceBufferVK::Flush(Range range) const {
+  ::vmaFlushAllocation(resource_->buffer.get().allocator,
+                       resource_->buffer.get().allocation, range.offset,
+                       range.length);
+}
+
 bool DeviceBufferVK::OnCopyHostBuffer(const uint8_t* source,
                                       Range source_range,
                                       size_t offset) {
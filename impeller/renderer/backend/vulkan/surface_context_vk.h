@@ -62,6 +62,8 @@ class SurfaceContextVK : public Context,
 
   std::unique_ptr<Surface> AcquireNextSurface();
 
+  const std::shared_ptr<ContextVK>& GetParent() const;
+
 #ifdef FML_OS_ANDROID
   vk::UniqueSurfaceKHR CreateAndroidSurface(ANativeWindow* window) const;
 #endif  // FML_OS_ANDROID
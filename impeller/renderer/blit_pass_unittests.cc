@@ -4,6 +4,7 @@
 
 #include "gtest/gtest.h"
 #include "impeller/base/validation.h"
+#include "impeller/core/device_buffer_descriptor.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/playground/playground_test.h"
@@ -73,5 +74,37 @@ TEST_P(BlitPassTest, BlitPassesForMatchingFormats) {
   EXPECT_TRUE(blit_pass->AddCopy(src, dst));
 }
 
+TEST_P(BlitPassTest, BufferToTextureBlitsAreLimitedToTheDestinationRegion) {
+  ScopedValidationDisable scope;  // avoid noise in output.
+  auto context = GetContext();
+  if (!context->GetCapabilities()->SupportsBufferToTextureBlits()) {
+    GTEST_SKIP() << "Buffer to texture blits are not supported.";
+  }
+  auto cmd_buffer = context->CreateCommandBuffer();
+  auto blit_pass = cmd_buffer->CreateBlitPass();
+
+  TextureDescriptor dst_format;
+  dst_format.format = PixelFormat::kR8G8B8A8UNormInt;
+  dst_format.size = {100, 100};
+  auto dst = context->GetResourceAllocator()->CreateTexture(dst_format);
+
+  DeviceBufferDescriptor src_desc;
+  src_desc.storage_mode = StorageMode::kHostVisible;
+  src_desc.size = 10 * 20 * 4;
+  auto src = context->GetResourceAllocator()->CreateBuffer(src_desc);
+  ASSERT_TRUE(src);
+
+  // The whole texture needs more bytes than the buffer holds.
+  EXPECT_FALSE(blit_pass->AddCopy(src->AsBufferView(), dst));
+  // The region must be inside of the texture.
+  EXPECT_FALSE(blit_pass->AddCopy(src->AsBufferView(), dst,
+                                  IRect::MakeXYWH(95, 0, 10, 20)));
+  // The region must match the size of the buffer.
+  EXPECT_FALSE(blit_pass->AddCopy(src->AsBufferView(), dst,
+                                  IRect::MakeXYWH(0, 0, 20, 20)));
+  EXPECT_TRUE(blit_pass->AddCopy(src->AsBufferView(), dst,
+                                 IRect::MakeXYWH(90, 80, 10, 20)));
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -2,12 +2,79 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
+#include <vector>
+
 #include "flutter/testing/testing.h"
+#include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer.h"
 #include "impeller/core/host_buffer.h"
+#include "impeller/geometry/vector.h"
 
 namespace impeller {
 namespace testing {
 
+namespace {
+
+class TestDeviceBuffer : public DeviceBuffer {
+ public:
+  TestDeviceBuffer(const DeviceBufferDescriptor& desc, bool mapped)
+      : DeviceBuffer(desc), mapped_(mapped), contents_(desc.size) {}
+
+  bool SetLabel(const std::string& label) override { return true; }
+
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  uint8_t* OnGetContents() const override {
+    return mapped_ ? contents_.data() : nullptr;
+  }
+
+  void Flush(Range range) const override { flushed_ranges.push_back(range); }
+
+  bool OnCopyHostBuffer(const uint8_t* source,
+                        Range source_range,
+                        size_t offset) override {
+    ::memmove(contents_.data() + offset, source + source_range.offset,
+              source_range.length);
+    return true;
+  }
+
+  mutable std::vector<Range> flushed_ranges;
+
+ private:
+  const bool mapped_;
+  mutable std::vector<uint8_t> contents_;
+};
+
+class TestAllocator : public Allocator {
+ public:
+  explicit TestAllocator(bool mapped = true) : mapped_(mapped) {}
+
+  ISize GetMaxTextureSizeSupported() const override {
+    return ISize(1024, 1024);
+  }
+
+  std::shared_ptr<DeviceBuffer> OnCreateBuffer(
+      const DeviceBufferDescriptor& desc) override {
+    buffer_count++;
+    return std::make_shared<TestDeviceBuffer>(desc, mapped_);
+  }
+
+  std::shared_ptr<Texture> OnCreateTexture(
+      const TextureDescriptor& desc) override {
+    return nullptr;
+  }
+
+  size_t buffer_count = 0u;
+
+ private:
+  const bool mapped_;
+};
+
+}  // namespace
+
 TEST(HostBufferTest, TestInitialization) {
   ASSERT_TRUE(HostBuffer::Create());
   // Newly allocated buffers don't touch the heap till they have to.
@@ -75,5 +142,163 @@ TEST(HostBufferTest, CanEmplaceWithAlignment) {
   }
 }
 
+TEST(HostBufferTest, EmplacesDirectlyIntoDeviceBuffers) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+  // Device buffers are only created once there is something to emplace.
+  ASSERT_EQ(allocator->buffer_count, 0u);
+
+  struct alignas(16) Align16 {
+    uint32_t value[4];
+  };
+  auto view_a = buffer->Emplace(Align16{{1, 2, 3, 4}});
+  auto view_b = buffer->Emplace(Align16{{5, 6, 7, 8}});
+  ASSERT_TRUE(view_a);
+  ASSERT_TRUE(view_b);
+  EXPECT_EQ(allocator->buffer_count, 1u);
+  EXPECT_EQ(buffer->GetDeviceBufferAllocationCount(), 1u);
+  EXPECT_EQ(view_a.buffer, view_b.buffer);
+  EXPECT_EQ(view_a.range, Range(0u, 16u));
+  EXPECT_EQ(view_b.range, Range(16u, 16u));
+  EXPECT_EQ(buffer->GetLength(), 32u);
+
+  auto device_buffer =
+      std::static_pointer_cast<const TestDeviceBuffer>(view_b.buffer);
+  ASSERT_EQ(view_b.contents, device_buffer->OnGetContents());
+  auto* value = reinterpret_cast<const uint32_t*>(view_b.contents +
+                                                  view_b.range.offset);
+  EXPECT_EQ(value[0], 5u);
+  EXPECT_EQ(value[3], 8u);
+  // Writes are flushed together once the render pass is encoded.
+  EXPECT_TRUE(device_buffer->flushed_ranges.empty());
+
+  auto view_c = buffer->Emplace(4u, 4u, [](uint8_t* data) {
+    uint32_t value = 9u;
+    ::memcpy(data, &value, sizeof(value));
+  });
+  ASSERT_TRUE(view_c);
+  EXPECT_EQ(view_c.buffer, view_a.buffer);
+  EXPECT_EQ(view_c.range, Range(32u, 4u));
+  EXPECT_EQ(*reinterpret_cast<const uint32_t*>(view_c.contents + 32u), 9u);
+
+  buffer->FlushPendingWrites();
+  ASSERT_EQ(device_buffer->flushed_ranges.size(), 1u);
+  EXPECT_EQ(device_buffer->flushed_ranges[0], Range(0u, 36u));
+  buffer->FlushPendingWrites();
+  EXPECT_EQ(device_buffer->flushed_ranges.size(), 1u);
+}
+
+TEST(HostBufferTest, ReusesDeviceBuffersOfFramesThatAreNoLongerInFlight) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+
+  std::vector<std::shared_ptr<const Buffer>> frame_buffers;
+  for (size_t frame = 0; frame < kHostBufferArenaSize * 3; frame++) {
+    EXPECT_EQ(buffer->GetFrameIndex(), frame % kHostBufferArenaSize);
+    auto view = buffer->Emplace(Vector4(frame, 0, 0, 0));
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view.range.offset, 0u);
+    if (frame < kHostBufferArenaSize) {
+      for (const auto& previous : frame_buffers) {
+        EXPECT_NE(view.buffer, previous);
+      }
+      frame_buffers.push_back(view.buffer);
+    } else {
+      EXPECT_EQ(view.buffer, frame_buffers[frame % kHostBufferArenaSize]);
+    }
+    buffer->Reset();
+  }
+  EXPECT_EQ(allocator->buffer_count, kHostBufferArenaSize);
+}
+
+TEST(HostBufferTest, OverflowsIntoAdditionalDeviceBuffers) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+  constexpr size_t kBlockSize = HostBuffer::kDeviceBufferBlockSize;
+  std::vector<uint8_t> data(kBlockSize / 2 + 1, 0xAB);
+
+  auto view_a = buffer->Emplace(data.data(), data.size(), 1u);
+  auto view_b = buffer->Emplace(data.data(), data.size(), 1u);
+  ASSERT_TRUE(view_a);
+  ASSERT_TRUE(view_b);
+  EXPECT_NE(view_a.buffer, view_b.buffer);
+  EXPECT_EQ(view_b.range, Range(0u, data.size()));
+  EXPECT_EQ(allocator->buffer_count, 2u);
+
+  // Data larger than a device buffer of the ring gets a buffer of its own.
+  std::vector<uint8_t> large_data(kBlockSize * 2, 0xCD);
+  auto view_c = buffer->Emplace(large_data.data(), large_data.size(), 1u);
+  ASSERT_TRUE(view_c);
+  EXPECT_EQ(view_c.range, Range(0u, large_data.size()));
+  EXPECT_EQ(view_c.contents[large_data.size() - 1], 0xCD);
+  EXPECT_EQ(allocator->buffer_count, 3u);
+
+  // The overflow buffer is reused when the frame comes around again, as long
+  // as the frames in between needed it too.
+  for (size_t frame = 0; frame < kHostBufferArenaSize; frame++) {
+    buffer->Reset();
+    ASSERT_TRUE(buffer->Emplace(data.data(), data.size(), 1u));
+    ASSERT_TRUE(buffer->Emplace(data.data(), data.size(), 1u));
+  }
+  EXPECT_EQ(buffer->GetFrameIndex(), 0u);
+  EXPECT_EQ(allocator->buffer_count, 3u + 2u * (kHostBufferArenaSize - 1u));
+}
+
+TEST(HostBufferTest, ReleasesOverflowBuffersAfterSmallerFrames) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+  std::vector<uint8_t> data(HostBuffer::kDeviceBufferBlockSize, 0);
+
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_TRUE(buffer->Emplace(data.data(), data.size(), 1u));
+  }
+  EXPECT_EQ(buffer->GetSize(), 3u * HostBuffer::kDeviceBufferBlockSize);
+
+  for (size_t frame = 0; frame < kHostBufferArenaSize; frame++) {
+    buffer->Reset();
+    ASSERT_TRUE(buffer->Emplace(Vector4()));
+  }
+  EXPECT_EQ(buffer->GetSize(),
+            kHostBufferArenaSize * HostBuffer::kDeviceBufferBlockSize);
+}
+
+TEST(HostBufferTest, BoundsDeviceBuffersOfFramesThatAreNeverReset) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+  std::vector<uint8_t> data(HostBuffer::kDeviceBufferBlockSize, 0);
+
+  // Offscreen renders never reset the host buffer.
+  std::vector<BufferView> views;
+  for (size_t i = 0; i < HostBuffer::kMaxFrameDeviceBufferCount * 2; i++) {
+    auto view = buffer->Emplace(data.data(), data.size(), 1u);
+    ASSERT_TRUE(view);
+    views.push_back(view);
+  }
+  EXPECT_EQ(allocator->buffer_count,
+            HostBuffer::kMaxFrameDeviceBufferCount * 2);
+  EXPECT_EQ(buffer->GetSize(), HostBuffer::kMaxFrameDeviceBufferCount *
+                                   HostBuffer::kDeviceBufferBlockSize);
+  // Buffers that were replaced stay alive while their views reference them.
+  for (size_t i = 1; i < views.size(); i++) {
+    EXPECT_NE(views[i].buffer, views[i - 1].buffer);
+  }
+}
+
+TEST(HostBufferTest, StagesInHostMemoryIfDeviceBuffersAreNotMapped) {
+  auto allocator = std::make_shared<TestAllocator>(/*mapped=*/false);
+  auto buffer = HostBuffer::Create(allocator);
+
+  auto view = buffer->Emplace(Vector4(1, 2, 3, 4));
+  ASSERT_TRUE(view);
+  EXPECT_EQ(view.range, Range(0u, sizeof(Vector4)));
+  EXPECT_EQ(buffer->GetLength(), sizeof(Vector4));
+  EXPECT_EQ(allocator->buffer_count, 1u);
+  EXPECT_EQ(buffer->GetDeviceBufferAllocationCount(), 0u);
+
+  auto device_buffer = view.buffer->GetDeviceBuffer(*allocator);
+  ASSERT_TRUE(device_buffer);
+  EXPECT_EQ(allocator->buffer_count, 2u);
+}
+
 }  // namespace  testing
 }  // namespace impeller
@@ -22,7 +22,7 @@ RenderPass::RenderPass(std::weak_ptr<const Context> context,
 
 RenderPass::~RenderPass() {
   auto strong_context = context_.lock();
-  if (strong_context) {
+  if (strong_context && transients_buffer_is_pooled_) {
     strong_context->GetHostBufferPool().Recycle(transients_buffer_);
   }
 }
@@ -51,11 +51,24 @@ HostBuffer& RenderPass::GetTransientsBuffer() {
   return *transients_buffer_;
 }
 
+void RenderPass::SetTransientsBuffer(
+    std::shared_ptr<HostBuffer> transients_buffer) {
+  FML_DCHECK(transients_buffer);
+  auto strong_context = context_.lock();
+  if (strong_context && transients_buffer_is_pooled_) {
+    strong_context->GetHostBufferPool().Recycle(transients_buffer_);
+  }
+  transients_buffer_ = std::move(transients_buffer);
+  transients_buffer_is_pooled_ = false;
+}
+
 void RenderPass::SetLabel(std::string label) {
   if (label.empty()) {
     return;
   }
-  transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  if (transients_buffer_is_pooled_) {
+    transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  }
   OnSetLabel(std::move(label));
 }
 
@@ -91,6 +104,9 @@ bool RenderPass::EncodeCommands() const {
   if (!context) {
     return false;
   }
+  // Transients written directly into device buffers are flushed once for the
+  // whole pass instead of once per write.
+  transients_buffer_->FlushPendingWrites();
   return OnEncodeCommands(*context);
 }
 
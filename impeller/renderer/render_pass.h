@@ -49,6 +49,15 @@ class RenderPass {
 
   HostBuffer& GetTransientsBuffer();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replaces the transients buffer of the pass, which comes from
+  ///             the host buffer pool of the context by default, with one
+  ///             that outlives the pass, such as a host buffer that is
+  ///             cycled across frames. Must be called before anything is
+  ///             emplaced in the transients buffer.
+  ///
+  void SetTransientsBuffer(std::shared_ptr<HostBuffer> transients_buffer);
+
   //----------------------------------------------------------------------------
   /// @brief      Record a command for subsequent encoding to the underlying
   ///             command buffer. No work is encoded into the command buffer at
@@ -100,6 +109,7 @@ class RenderPass {
   const ISize render_target_size_;
   const RenderTarget render_target_;
   std::shared_ptr<HostBuffer> transients_buffer_;
+  bool transients_buffer_is_pooled_ = true;
   std::vector<Command> commands_;
 
   RenderPass(std::weak_ptr<const Context> context, const RenderTarget& target);
@@ -81,7 +81,7 @@ class MockBlitPass : public BlitPass {
               OnCopyBufferToTextureCommand,
               (BufferView source,
                std::shared_ptr<Texture> destination,
-               IPoint destination_origin,
+               IRect destination_region,
                std::string label),
               (override));
   MOCK_METHOD(bool,
@@ -76,6 +76,14 @@ class VertexBufferBuilder {
     return *this;
   }
 
+  /// Appends the vertices of another builder, which must not have indices.
+  VertexBufferBuilder& AppendVertices(const VertexBufferBuilder& other) {
+    FML_DCHECK(other.indices_.empty());
+    vertices_.insert(vertices_.end(), other.vertices_.begin(),
+                     other.vertices_.end());
+    return *this;
+  }
+
   VertexBufferBuilder& AppendIndex(IndexType_ index) {
     indices_.emplace_back(index);
     return *this;
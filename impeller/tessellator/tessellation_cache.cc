@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/tessellator/tessellation_cache.h"
+
+#include <cmath>
+#include <iterator>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+TessellationCache::TessellationCache(size_t byte_budget)
+    : byte_budget_(byte_budget) {}
+
+TessellationCache::~TessellationCache() = default;
+
+Scalar TessellationCache::QuantizeScale(Scalar scale) {
+  if (!(scale > 0) || !std::isfinite(scale)) {
+    return scale;
+  }
+  Scalar bucket = std::ceil(std::log2(scale) * kScaleBucketsPerOctave);
+  return std::exp2(bucket / kScaleBucketsPerOctave);
+}
+
+std::size_t TessellationCache::ComputeKey(const Path& path, Scalar scale) {
+  return fml::HashCombine(path.GetHash(), scale);
+}
+
+const TessellationCache::Vertices* TessellationCache::Get(const Path& path,
+                                                          Scalar scale) {
+  auto [begin, end] = index_.equal_range(ComputeKey(path, scale));
+  for (auto it = begin; it != end; ++it) {
+    EntryList::iterator entry = it->second;
+    if (entry->scale == scale && entry->path.IsEqual(path)) {
+      entries_.splice(entries_.begin(), entries_, entry);
+      hit_count_++;
+      return &entry->vertices;
+    }
+  }
+  miss_count_++;
+  return nullptr;
+}
+
+size_t TessellationCache::GetEntryByteSize(const Path& path,
+                                           const Vertices& vertices) {
+  return vertices.GetByteSize() + path.GetStorageByteSize();
+}
+
+bool TessellationCache::CanCache(const Path& path,
+                                 const Vertices& vertices) const {
+  // Paths with NaN points never compare equal to themselves, so their
+  // entries could only ever take up space.
+  return !path.IsVolatile() &&
+         GetEntryByteSize(path, vertices) <= byte_budget_ && path.IsFinite();
+}
+
+const TessellationCache::Vertices* TessellationCache::Put(const Path& path,
+                                                          Scalar scale,
+                                                          Vertices vertices) {
+  if (!CanCache(path, vertices)) {
+    return nullptr;
+  }
+  size_t byte_size = GetEntryByteSize(path, vertices);
+  EvictToBudget(byte_budget_ - byte_size);
+  std::size_t key = ComputeKey(path, scale);
+  entries_.push_front({
+      .key = key,
+      .path = path.Clone(),
+      .scale = scale,
+      .vertices = std::move(vertices),
+      .byte_size = byte_size,
+  });
+  index_.emplace(key, entries_.begin());
+  byte_size_ += byte_size;
+  return &entries_.front().vertices;
+}
+
+void TessellationCache::SetByteBudget(size_t byte_budget) {
+  byte_budget_ = byte_budget;
+  EvictToBudget(byte_budget);
+}
+
+void TessellationCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  byte_size_ = 0;
+}
+
+void TessellationCache::EvictToBudget(size_t byte_budget) {
+  while (byte_size_ > byte_budget) {
+    FML_DCHECK(!entries_.empty());
+    const Entry& entry = entries_.back();
+    auto [begin, end] = index_.equal_range(entry.key);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second == std::prev(entries_.end())) {
+        index_.erase(it);
+        break;
+      }
+    }
+    byte_size_ -= entry.byte_size;
+    entries_.pop_back();
+  }
+}
+
+}  // namespace impeller
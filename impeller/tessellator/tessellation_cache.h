@@ -0,0 +1,136 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
+#define FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/scalar.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A least recently used cache of the triangles that fill paths,
+///             keyed by the contents of the path and the scale at which it
+///             was tessellated.
+///
+///             Scales are grouped into buckets so that a path drawn at the
+///             same or a similar scale in every frame reuses the same
+///             triangles. Each bucket is tessellated at its largest scale,
+///             so the triangles are never coarser than the scale asks for.
+///
+///             The cache holds at most a byte budget of vertex and index
+///             data and of the paths that key them, and evicts the least
+///             recently used entries to stay within it. Volatile paths and
+///             paths with points that are not finite are never cached.
+///
+///             This object is not thread safe.
+///
+class TessellationCache {
+ public:
+  /// @brief  The triangles of a tessellated path, as they are delivered by
+  ///         |Tessellator::Tessellate|.
+  struct Vertices {
+    /// The x and y coordinates of each vertex.
+    std::vector<float> vertices;
+    /// The vertex indices of the triangles, or empty if every 3 vertices
+    /// form a triangle.
+    std::vector<uint16_t> indices;
+
+    size_t GetByteSize() const {
+      return vertices.size() * sizeof(float) +
+             indices.size() * sizeof(uint16_t);
+    }
+  };
+
+  static constexpr size_t kDefaultByteBudget = 4 * 1024 * 1024;
+
+  /// @brief  The number of scale buckets per doubling of the scale.
+  static constexpr int kScaleBucketsPerOctave = 4;
+
+  explicit TessellationCache(size_t byte_budget = kDefaultByteBudget);
+
+  ~TessellationCache();
+
+  /// @brief  Returns the largest scale of the bucket that |scale| falls in,
+  ///         at which the path is tessellated for the cache. Scales that are
+  ///         not positive and finite are returned as they are.
+  static Scalar QuantizeScale(Scalar scale);
+
+  /// @brief  Returns the triangles cached for the path at the quantized
+  ///         |scale|, or nullptr if there are none. The pointer is valid
+  ///         until the next call that modifies the cache.
+  const Vertices* Get(const Path& path, Scalar scale);
+
+  /// @brief  Returns the bytes that caching the triangles of the path
+  ///         counts against the byte budget.
+  static size_t GetEntryByteSize(const Path& path, const Vertices& vertices);
+
+  /// @brief  Returns whether the triangles of the path would be cached by
+  ///         |Put|.
+  bool CanCache(const Path& path, const Vertices& vertices) const;
+
+  /// @brief  Caches the triangles of the path at the quantized |scale|,
+  ///         evicting the least recently used entries as needed. Returns
+  ///         the cached triangles, or nullptr if they were not cached, see
+  ///         |CanCache|.
+  const Vertices* Put(const Path& path, Scalar scale, Vertices vertices);
+
+  /// @brief  Sets the byte budget and evicts entries to stay within it.
+  void SetByteBudget(size_t byte_budget);
+
+  size_t GetByteBudget() const { return byte_budget_; }
+
+  /// @brief  Returns the bytes of the entries in the cache, see
+  ///         |GetEntryByteSize|.
+  size_t GetByteSize() const { return byte_size_; }
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  /// @brief  Returns the number of calls to |Get| that found triangles.
+  size_t GetHitCount() const { return hit_count_; }
+
+  /// @brief  Returns the number of calls to |Get| that found none.
+  size_t GetMissCount() const { return miss_count_; }
+
+  /// @brief  Removes all entries. The counters are kept.
+  void Clear();
+
+ private:
+  struct Entry {
+    std::size_t key;
+    Path path;
+    Scalar scale;
+    Vertices vertices;
+    size_t byte_size;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static std::size_t ComputeKey(const Path& path, Scalar scale);
+
+  void EvictToBudget(size_t byte_budget);
+
+  size_t byte_budget_;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  // The most recently used entry is at the front.
+  EntryList entries_;
+  std::unordered_multimap<std::size_t, EntryList::iterator> index_;
+
+  TessellationCache(const TessellationCache&) = delete;
+
+  TessellationCache& operator=(const TessellationCache&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
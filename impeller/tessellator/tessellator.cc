@@ -63,7 +63,8 @@ static int ToTessWindingRule(FillType fill_type) {
 
 Tessellator::Result Tessellator::Tessellate(const Path& path,
                                             Scalar tolerance,
-                                            const BuilderCallback& callback) {
+                                            const BuilderCallback& callback,
+                                            FillEngine engine) {
   if (!callback) {
     return Result::kInputError;
   }
@@ -81,6 +82,25 @@ Tessellator::Result Tessellator::Tessellate(const Path& path,
     return Result::kInputError;
   }
 
+  if (engine == FillEngine::kTrapezoids &&
+      TrapezoidTessellator::SupportsFillType(fill_type) &&
+      trapezoid_tessellator_.Tessellate(polyline, fill_type, USHRT_MAX)) {
+    const std::vector<float>& vertices = trapezoid_tessellator_.GetVertices();
+    const std::vector<uint16_t>& indices = trapezoid_tessellator_.GetIndices();
+    if (!callback(vertices.data(), trapezoid_tessellator_.GetVertexCount(),
+                  indices.data(), indices.size())) {
+      return Result::kInputError;
+    }
+    return Result::kSuccess;
+  }
+
+  return TessellateWithLibtess(polyline, fill_type, callback);
+}
+
+Tessellator::Result Tessellator::TessellateWithLibtess(
+    const Path::Polyline& polyline,
+    FillType fill_type,
+    const BuilderCallback& callback) {
   auto tessellator = c_tessellator_.get();
   if (!tessellator) {
     return Result::kTessellationError;
@@ -170,6 +190,54 @@ Tessellator::Result Tessellator::Tessellate(const Path& path,
   return Result::kSuccess;
 }
 
+static Tessellator::Result DeliverVertices(
+    const TessellationCache::Vertices& vertices,
+    const Tessellator::BuilderCallback& callback) {
+  const std::vector<uint16_t>& indices = vertices.indices;
+  if (!callback(vertices.vertices.data(), vertices.vertices.size() / 2,
+                indices.empty() ? nullptr : indices.data(), indices.size())) {
+    return Tessellator::Result::kInputError;
+  }
+  return Tessellator::Result::kSuccess;
+}
+
+Tessellator::Result Tessellator::TessellateCached(
+    const Path& path,
+    Scalar tolerance,
+    const BuilderCallback& callback) {
+  if (!callback) {
+    return Result::kInputError;
+  }
+
+  Scalar scale = TessellationCache::QuantizeScale(tolerance);
+  if (path.IsVolatile()) {
+    // The path is not expected to be drawn again, skip the lookup.
+    return Tessellate(path, scale, callback);
+  }
+  const TessellationCache::Vertices* cached = cache_.Get(path, scale);
+  if (!cached) {
+    TessellationCache::Vertices vertices;
+    auto result = Tessellate(
+        path, scale,
+        [&vertices](const float* points, size_t points_count,
+                    const uint16_t* indices, size_t indices_count) {
+          vertices.vertices.assign(points, points + points_count * 2);
+          if (indices != nullptr) {
+            vertices.indices.assign(indices, indices + indices_count);
+          }
+          return true;
+        });
+    if (result != Result::kSuccess) {
+      return result;
+    }
+    if (!cache_.CanCache(path, vertices)) {
+      return DeliverVertices(vertices, callback);
+    }
+    cached = cache_.Put(path, scale, std::move(vertices));
+  }
+  return DeliverVertices(*cached, callback);
+}
+
 std::vector<Point> Tessellator::TessellateConvex(const Path& path,
                                                  Scalar tolerance) {
   std::vector<Point> output;
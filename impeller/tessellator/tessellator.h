@@ -14,6 +14,8 @@
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/point.h"
 #include "impeller/geometry/trig.h"
+#include "impeller/tessellator/tessellation_cache.h"
+#include "impeller/tessellator/trapezoid_tessellator.h"
 
 struct TESStesselator;
 
@@ -188,6 +190,16 @@ class Tessellator {
                                              const uint16_t* indices,
                                              size_t indices_count)>;
 
+  /// @brief  The algorithms that |Tessellate| can fill paths with.
+  enum class FillEngine {
+    /// Decompose the path into trapezoids with a |TrapezoidTessellator|,
+    /// falling back to libtess2 for fill types it does not support and for
+    /// paths that need more vertices than 16 bit indices can address.
+    kTrapezoids,
+    /// Always use libtess2.
+    kLibtess,
+  };
+
   //----------------------------------------------------------------------------
   /// @brief      Generates filled triangles from the path. A callback is
   ///             invoked once for the entire tessellation.
@@ -198,12 +210,39 @@ class Tessellator {
   ///                        Matrix::GetMaxBasisLength of the CTM applied to the
   ///                        path for rendering.
   /// @param[in]  callback  The callback, return false to indicate failure.
+  /// @param[in]  engine  The algorithm to fill the path with.
   ///
   /// @return The result status of the tessellation.
   ///
   Tessellator::Result Tessellate(const Path& path,
                                  Scalar tolerance,
-                                 const BuilderCallback& callback);
+                                 const BuilderCallback& callback,
+                                 FillEngine engine = FillEngine::kTrapezoids);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Generates filled triangles from the path like |Tessellate|,
+  ///             reusing the triangles of an equal path that was tessellated
+  ///             at a similar tolerance if they are in the cache.
+  ///
+  ///             The path is tessellated at the tolerance quantized by
+  ///             |TessellationCache::QuantizeScale|, whether or not the
+  ///             triangles are cached. Volatile paths are not looked up.
+  ///
+  /// @param[in]  path  The path to tessellate.
+  /// @param[in]  tolerance  The tolerance value for conversion of the path to
+  ///                        a polyline. This value is often derived from the
+  ///                        Matrix::GetMaxBasisLength of the CTM applied to the
+  ///                        path for rendering.
+  /// @param[in]  callback  The callback, return false to indicate failure.
+  ///
+  /// @return The result status of the tessellation.
+  ///
+  Tessellator::Result TessellateCached(const Path& path,
+                                       Scalar tolerance,
+                                       const BuilderCallback& callback);
+
+  /// @brief  The cache of triangles used by |TessellateCached|.
+  TessellationCache& GetCache() { return cache_; }
 
   //----------------------------------------------------------------------------
   /// @brief      Given a convex path, create a triangle fan structure.
@@ -298,6 +337,8 @@ class Tessellator {
   /// Used for polyline generation.
   std::unique_ptr<std::vector<Point>> point_buffer_;
   CTessellator c_tessellator_;
+  TrapezoidTessellator trapezoid_tessellator_;
+  TessellationCache cache_;
 
   // Data for variouos Circle/EllipseGenerator classes, cached per
   // Tessellator instance which is usually the foreground life of an app
@@ -307,6 +348,10 @@ class Tessellator {
 
   Trigs GetTrigsForDivisions(size_t divisions);
 
+  Tessellator::Result TessellateWithLibtess(const Path::Polyline& polyline,
+                                            FillType fill_type,
+                                            const BuilderCallback& callback);
+
   static void GenerateFilledCircle(const Trigs& trigs,
                                    const EllipticalVertexGenerator::Data& data,
                                    const TessellatedVertexProc& proc);
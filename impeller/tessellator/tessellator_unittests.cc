@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cmath>
+
 #include "flutter/testing/testing.h"
 #include "gtest/gtest.h"
 
@@ -106,6 +108,303 @@ TEST(TessellatorTest, TessellatorBuilderReturnsCorrectResultStatus) {
   }
 }
 
+namespace {
+struct Triangles {
+  std::vector<float> vertices;
+  std::vector<uint16_t> indices;
+};
+
+Tessellator::BuilderCallback CollectTriangles(Triangles& triangles) {
+  return [&triangles](const float* vertices, size_t vertices_count,
+                      const uint16_t* indices, size_t indices_count) {
+    triangles.vertices.assign(vertices, vertices + vertices_count * 2);
+    if (indices != nullptr) {
+      triangles.indices.assign(indices, indices + indices_count);
+    } else {
+      triangles.indices.clear();
+    }
+    return true;
+  };
+}
+
+Path CreateStar(Scalar offset) {
+  return PathBuilder{}
+      .MoveTo({offset + 50, 0})
+      .QuadraticCurveTo({offset + 60, 40}, {offset + 100, 40})
+      .LineTo({offset + 20, 100})
+      .LineTo({offset + 50, 0})
+      .LineTo({offset + 80, 100})
+      .Close()
+      .TakePath();
+}
+}  // namespace
+
+TEST(TessellatorTest, TessellateCachedReusesTrianglesOfEqualPaths) {
+  Tessellator t;
+  Triangles first;
+  Triangles second;
+  Path path = CreateStar(0);
+  Path copy = path.Clone();
+
+  ASSERT_EQ(t.TessellateCached(path, 1.0, CollectTriangles(first)),
+            Tessellator::Result::kSuccess);
+  ASSERT_EQ(t.TessellateCached(copy, 1.0, CollectTriangles(second)),
+            Tessellator::Result::kSuccess);
+  EXPECT_EQ(t.GetCache().GetMissCount(), 1u);
+  EXPECT_EQ(t.GetCache().GetHitCount(), 1u);
+  EXPECT_EQ(t.GetCache().GetEntryCount(), 1u);
+  EXPECT_EQ(first.vertices, second.vertices);
+  EXPECT_EQ(first.indices, second.indices);
+
+  // The cached triangles are those of the path at the quantized scale.
+  Triangles expected;
+  ASSERT_EQ(t.Tessellate(path, TessellationCache::QuantizeScale(1.0),
+                         CollectTriangles(expected)),
+            Tessellator::Result::kSuccess);
+  EXPECT_EQ(first.vertices, expected.vertices);
+  EXPECT_EQ(first.indices, expected.indices);
+
+  // A different path misses.
+  ASSERT_EQ(t.TessellateCached(CreateStar(1), 1.0, CollectTriangles(second)),
+            Tessellator::Result::kSuccess);
+  EXPECT_EQ(t.GetCache().GetMissCount(), 2u);
+  EXPECT_NE(first.vertices, second.vertices);
+}
+
+TEST(TessellatorTest, TessellateCachedBucketsScales) {
+  EXPECT_EQ(TessellationCache::QuantizeScale(1.0), 1.0);
+  EXPECT_EQ(TessellationCache::QuantizeScale(2.0), 2.0);
+  EXPECT_GE(TessellationCache::QuantizeScale(1.1), 1.1);
+  EXPECT_EQ(TessellationCache::QuantizeScale(1.1),
+            TessellationCache::QuantizeScale(1.15));
+  EXPECT_EQ(TessellationCache::QuantizeScale(0), 0);
+
+  Tessellator t;
+  Triangles triangles;
+  Path path = CreateStar(0);
+  t.TessellateCached(path, 1.1, CollectTriangles(triangles));
+  t.TessellateCached(path, 1.15, CollectTriangles(triangles));
+  EXPECT_EQ(t.GetCache().GetHitCount(), 1u);
+  t.TessellateCached(path, 4.0, CollectTriangles(triangles));
+  EXPECT_EQ(t.GetCache().GetMissCount(), 2u);
+  EXPECT_EQ(t.GetCache().GetEntryCount(), 2u);
+}
+
+TEST(TessellatorTest, TessellationCacheEvictsLeastRecentlyUsed) {
+  TessellationCache::Vertices vertices;
+  vertices.vertices.resize(100);
+  Path path_a = CreateStar(0);
+  Path path_b = CreateStar(1);
+  Path path_c = CreateStar(2);
+  // The key paths count against the budget too.
+  size_t entry_size = TessellationCache::GetEntryByteSize(path_a, vertices);
+  EXPECT_GT(entry_size, vertices.GetByteSize());
+  TessellationCache cache(entry_size * 2);
+
+  ASSERT_NE(cache.Put(path_a, 1, vertices), nullptr);
+  ASSERT_NE(cache.Put(path_b, 1, vertices), nullptr);
+  EXPECT_EQ(cache.GetByteSize(), entry_size * 2);
+  // Use path_a so that path_b is the least recently used.
+  EXPECT_NE(cache.Get(path_a, 1), nullptr);
+  ASSERT_NE(cache.Put(path_c, 1, vertices), nullptr);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+  EXPECT_EQ(cache.GetByteSize(), entry_size * 2);
+  EXPECT_NE(cache.Get(path_a, 1), nullptr);
+  EXPECT_EQ(cache.Get(path_b, 1), nullptr);
+  EXPECT_NE(cache.Get(path_c, 1), nullptr);
+
+  // Entries larger than the budget are not cached.
+  vertices.vertices.resize(1000);
+  EXPECT_EQ(cache.Put(path_b, 1, vertices), nullptr);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  cache.SetByteBudget(entry_size);
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+  EXPECT_NE(cache.Get(path_c, 1), nullptr);
+  cache.Clear();
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+  EXPECT_EQ(cache.GetByteSize(), 0u);
+}
+
+TEST(TessellatorTest, TessellationCacheSkipsVolatileAndNonFinitePaths) {
+  Tessellator t;
+  Triangles triangles;
+  Path volatile_path = PathBuilder{}
+                           .AddPath(CreateStar(0))
+                           .SetVolatile(true)
+                           .TakePath();
+  ASSERT_TRUE(volatile_path.IsVolatile());
+  ASSERT_EQ(t.TessellateCached(volatile_path, 1.0, CollectTriangles(triangles)),
+            Tessellator::Result::kSuccess);
+  EXPECT_FALSE(triangles.vertices.empty());
+  EXPECT_EQ(t.GetCache().GetMissCount(), 0u);
+  EXPECT_EQ(t.GetCache().GetEntryCount(), 0u);
+
+  TessellationCache::Vertices vertices;
+  vertices.vertices.resize(6);
+  Path nan_path = PathBuilder{}
+                      .MoveTo({0, 0})
+                      .LineTo({std::nanf(""), 10})
+                      .LineTo({10, 10})
+                      .Close()
+                      .TakePath();
+  EXPECT_FALSE(nan_path.IsFinite());
+  EXPECT_FALSE(t.GetCache().CanCache(nan_path, vertices));
+  EXPECT_EQ(t.GetCache().Put(nan_path, 1, vertices), nullptr);
+  EXPECT_EQ(t.GetCache().Put(volatile_path, 1, vertices), nullptr);
+  EXPECT_EQ(t.GetCache().GetEntryCount(), 0u);
+  EXPECT_EQ(t.GetCache().GetByteSize(), 0u);
+}
+
+namespace {
+// The winding number of the closed contours of the polyline around the point.
+int ComputeWinding(const Path::Polyline& polyline, Point point) {
+  int winding = 0;
+  for (size_t i = 0; i < polyline.contours.size(); i++) {
+    auto [start, end] = polyline.GetContourPointBounds(i);
+    for (size_t j = start; j < end; j++) {
+      Point p = polyline.GetPoint(j);
+      Point q = polyline.GetPoint(j + 1 < end ? j + 1 : start);
+      bool down = p.y < q.y;
+      Point top = down ? p : q;
+      Point bottom = down ? q : p;
+      if (point.y < top.y || point.y >= bottom.y) {
+        continue;
+      }
+      Scalar x = top.x + (point.y - top.y) * (bottom.x - top.x) /
+                             (bottom.y - top.y);
+      if (x > point.x) {
+        winding += down ? 1 : -1;
+      }
+    }
+  }
+  return winding;
+}
+
+bool IsInside(FillType fill_type, int winding) {
+  switch (fill_type) {
+    case FillType::kNonZero:
+      return winding != 0;
+    case FillType::kOdd:
+      return (winding & 1) != 0;
+    case FillType::kPositive:
+      return winding > 0;
+    case FillType::kNegative:
+      return winding < 0;
+    case FillType::kAbsGeqTwo:
+      return std::abs(winding) >= 2;
+  }
+  return false;
+}
+
+bool TriangleContains(Point a, Point b, Point c, Point point) {
+  Scalar ab = (b - a).Cross(point - a);
+  Scalar bc = (c - b).Cross(point - b);
+  Scalar ca = (a - c).Cross(point - c);
+  return (ab >= 0 && bc >= 0 && ca >= 0) || (ab <= 0 && bc <= 0 && ca <= 0);
+}
+
+// Rasterizes the triangles of the path on the CPU at a grid of sample points
+// over the path bounds, and returns the number of samples at which they
+// disagree with the winding of the path.
+size_t CountCoverageErrors(const Path& path, Tessellator::FillEngine engine) {
+  Tessellator t;
+  Triangles triangles;
+  EXPECT_EQ(t.Tessellate(path, 1.0, CollectTriangles(triangles), engine),
+            Tessellator::Result::kSuccess);
+  auto vertex = [&triangles](size_t index) {
+    return Point(triangles.vertices[index * 2],
+                 triangles.vertices[index * 2 + 1]);
+  };
+  std::vector<Point> corners;
+  size_t corner_count = triangles.indices.empty()
+                            ? triangles.vertices.size() / 2
+                            : triangles.indices.size();
+  for (size_t i = 0; i < corner_count; i++) {
+    corners.push_back(triangles.indices.empty()
+                          ? vertex(i)
+                          : vertex(triangles.indices[i]));
+  }
+
+  auto polyline = path.CreatePolyline(1.0);
+  Rect bounds = path.GetBoundingBox().value();
+  size_t errors = 0;
+  // Sample off the integer grid so that samples rarely land on an edge.
+  for (Scalar y = bounds.GetTop() + 0.37; y < bounds.GetBottom(); y += 0.93) {
+    for (Scalar x = bounds.GetLeft() + 0.21; x < bounds.GetRight();
+         x += 0.87) {
+      Point point(x, y);
+      bool covered = false;
+      for (size_t i = 0; i + 2 < corners.size() && !covered; i += 3) {
+        covered = TriangleContains(corners[i], corners[i + 1], corners[i + 2],
+                                   point);
+      }
+      if (covered != IsInside(path.GetFillType(),
+                              ComputeWinding(polyline, point))) {
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+Path CreateCoverageTestPath(FillType fill_type) {
+  return PathBuilder{}
+      // A self intersecting star.
+      .MoveTo({50, 0})
+      .LineTo({80, 100})
+      .LineTo({0, 35})
+      .LineTo({100, 35})
+      .LineTo({20, 100})
+      .Close()
+      // A ring that overlaps the star, with a hole wound the same way.
+      .AddCircle({100, 60}, 40)
+      .AddCircle({100, 60}, 20)
+      // A curved shape.
+      .MoveTo({0, 120})
+      .CubicCurveTo({60, 60}, {100, 220}, {160, 120})
+      .QuadraticCurveTo({80, 200}, {0, 120})
+      .Close()
+      .TakePath(fill_type);
+}
+}  // namespace
+
+TEST(TessellatorTest, TrapezoidCoverageMatchesWinding) {
+  for (FillType fill_type :
+       {FillType::kNonZero, FillType::kOdd, FillType::kAbsGeqTwo}) {
+    Path path = CreateCoverageTestPath(fill_type);
+    // A few samples may land within rounding error of an edge.
+    EXPECT_LE(CountCoverageErrors(path, Tessellator::FillEngine::kTrapezoids),
+              2u)
+        << static_cast<int>(fill_type);
+    EXPECT_LE(CountCoverageErrors(path, Tessellator::FillEngine::kLibtess),
+              2u)
+        << static_cast<int>(fill_type);
+  }
+}
+
+TEST(TessellatorTest, TrapezoidTessellatorMergesTrapezoids) {
+  TrapezoidTessellator tessellator;
+  // Two rectangles whose sides are interrupted by the vertices of a
+  // triangle between them.
+  auto path = PathBuilder{}
+                  .AddRect(Rect::MakeLTRB(0, 0, 10, 100))
+                  .AddRect(Rect::MakeLTRB(50, 0, 60, 100))
+                  .MoveTo({20, 10})
+                  .LineTo({40, 50})
+                  .LineTo({20, 90})
+                  .Close()
+                  .TakePath();
+  auto polyline = path.CreatePolyline(1.0);
+  ASSERT_TRUE(tessellator.Tessellate(polyline, FillType::kNonZero, 1000));
+  // One trapezoid for each rectangle and one for each half of the triangle.
+  EXPECT_EQ(tessellator.GetVertexCount(), 16u);
+  EXPECT_EQ(tessellator.GetIndices().size(), 24u);
+
+  // Gives up at the vertex limit.
+  EXPECT_FALSE(tessellator.Tessellate(polyline, FillType::kNonZero, 8));
+}
+
 TEST(TessellatorTest, TessellateConvex) {
   {
     Tessellator t;
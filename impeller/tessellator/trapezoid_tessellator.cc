@@ -0,0 +1,268 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/tessellator/trapezoid_tessellator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+TrapezoidTessellator::TrapezoidTessellator() = default;
+
+TrapezoidTessellator::~TrapezoidTessellator() = default;
+
+bool TrapezoidTessellator::SupportsFillType(FillType fill_type) {
+  switch (fill_type) {
+    case FillType::kNonZero:
+    case FillType::kOdd:
+    case FillType::kAbsGeqTwo:
+      return true;
+    case FillType::kPositive:
+    case FillType::kNegative:
+      return false;
+  }
+  return false;
+}
+
+bool TrapezoidTessellator::IsInside(FillType fill_type, int winding) const {
+  switch (fill_type) {
+    case FillType::kNonZero:
+      return winding != 0;
+    case FillType::kOdd:
+      return (winding & 1) != 0;
+    case FillType::kAbsGeqTwo:
+      return std::abs(winding) >= 2;
+    case FillType::kPositive:
+      return winding > 0;
+    case FillType::kNegative:
+      return winding < 0;
+  }
+  return false;
+}
+
+bool TrapezoidTessellator::AddEdges(const Path::Polyline& polyline) {
+  edges_.clear();
+  for (size_t i = 0; i < polyline.contours.size(); i++) {
+    auto [start, end] = polyline.GetContourPointBounds(i);
+    if (end - start < 2) {
+      continue;
+    }
+    // Contours are filled as if they were closed.
+    for (size_t j = start; j < end; j++) {
+      const Point& p = polyline.GetPoint(j);
+      const Point& q = polyline.GetPoint(j + 1 < end ? j + 1 : start);
+      if (!std::isfinite(p.x) || !std::isfinite(p.y) ||
+          !std::isfinite(q.x) || !std::isfinite(q.y)) {
+        return false;
+      }
+      if (p.y == q.y) {
+        continue;
+      }
+      if (p.y < q.y) {
+        edges_.push_back({p.x, p.y, q.y, (q.x - p.x) / (q.y - p.y), 1});
+      } else {
+        edges_.push_back({q.x, q.y, p.y, (p.x - q.x) / (p.y - q.y), -1});
+      }
+    }
+  }
+  return true;
+}
+
+bool TrapezoidTessellator::Tessellate(const Path::Polyline& polyline,
+                                      FillType fill_type,
+                                      size_t max_vertices) {
+  FML_DCHECK(SupportsFillType(fill_type));
+  vertices_.clear();
+  indices_.clear();
+  max_vertices_ = max_vertices;
+
+  if (!AddEdges(polyline)) {
+    return false;
+  }
+  if (edges_.empty()) {
+    return true;
+  }
+  std::sort(edges_.begin(), edges_.end(),
+            [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+
+  stops_.clear();
+  for (const Edge& edge : edges_) {
+    stops_.push_back(edge.y0);
+    stops_.push_back(edge.y1);
+  }
+  std::sort(stops_.begin(), stops_.end());
+  stops_.erase(std::unique(stops_.begin(), stops_.end()), stops_.end());
+
+  size_t edge_count = edges_.size();
+  top_x_.resize(edge_count);
+  bottom_x_.resize(edge_count);
+  span_right_.assign(edge_count, -1);
+  span_top_.resize(edge_count);
+  span_stamp_.assign(edge_count, 0);
+  open_spans_.clear();
+  active_.clear();
+
+  uint32_t stamp = 0;
+  size_t next_edge = 0;
+  for (size_t i = 0; i + 1 < stops_.size(); i++) {
+    Scalar top = stops_[i];
+    Scalar bottom = stops_[i + 1];
+    active_.erase(std::remove_if(active_.begin(), active_.end(),
+                                 [this, top](uint32_t edge) {
+                                   return edges_[edge].y1 <= top;
+                                 }),
+                  active_.end());
+    while (next_edge < edge_count && edges_[next_edge].y0 <= top) {
+      active_.push_back(next_edge++);
+    }
+
+    Scalar y = top;
+    while (y < bottom) {
+      for (uint32_t edge : active_) {
+        top_x_[edge] = edges_[edge].XAt(y);
+        bottom_x_[edge] = edges_[edge].XAt(bottom);
+      }
+      // The order of the edges changes little from one band to the next, so
+      // an insertion sort is close to linear.
+      for (size_t j = 1; j < active_.size(); j++) {
+        uint32_t edge = active_[j];
+        size_t k = j;
+        for (; k > 0; k--) {
+          uint32_t other = active_[k - 1];
+          if (top_x_[other] < top_x_[edge] ||
+              (top_x_[other] == top_x_[edge] &&
+               bottom_x_[other] <= bottom_x_[edge])) {
+            break;
+          }
+          active_[k] = other;
+        }
+        active_[k] = edge;
+      }
+
+      // Stop at the first crossing of two edges, which are next to each
+      // other in the order before they cross.
+      Scalar split = bottom;
+      for (size_t j = 0; j + 1 < active_.size(); j++) {
+        uint32_t a = active_[j];
+        uint32_t b = active_[j + 1];
+        if (bottom_x_[a] > bottom_x_[b]) {
+          Scalar closing_rate = edges_[a].slope - edges_[b].slope;
+          if (closing_rate > 0) {
+            Scalar crossing = y + (top_x_[b] - top_x_[a]) / closing_rate;
+            split = std::min(split, crossing);
+          }
+        }
+      }
+      if (!(split > y)) {
+        split = std::nextafter(y, bottom);
+      }
+
+      if (!FillBand(fill_type, y, split, ++stamp)) {
+        return false;
+      }
+      y = split;
+    }
+  }
+
+  Scalar end = stops_.back();
+  for (uint32_t left : open_spans_) {
+    if (!EmitTrapezoid(left, span_right_[left], span_top_[left], end)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TrapezoidTessellator::FillBand(FillType fill_type,
+                                    Scalar top,
+                                    Scalar bottom,
+                                    uint32_t stamp) {
+  next_open_spans_.clear();
+  int winding = 0;
+  uint32_t left = 0;
+  for (uint32_t edge : active_) {
+    bool was_inside = IsInside(fill_type, winding);
+    winding += edges_[edge].winding;
+    bool inside = IsInside(fill_type, winding);
+    if (inside == was_inside) {
+      continue;
+    }
+    if (inside) {
+      left = edge;
+      continue;
+    }
+    int right = static_cast<int>(edge);
+    if (span_right_[left] != right) {
+      if (span_right_[left] >= 0 &&
+          !EmitTrapezoid(left, span_right_[left], span_top_[left], top)) {
+        return false;
+      }
+      span_right_[left] = right;
+      span_top_[left] = top;
+    }
+    span_stamp_[left] = stamp;
+    next_open_spans_.push_back(left);
+  }
+
+  // Trapezoids that did not continue into this band end at its top.
+  for (uint32_t open_left : open_spans_) {
+    if (span_stamp_[open_left] != stamp) {
+      if (!EmitTrapezoid(open_left, span_right_[open_left],
+                         span_top_[open_left], top)) {
+        return false;
+      }
+      span_right_[open_left] = -1;
+    }
+  }
+  std::swap(open_spans_, next_open_spans_);
+  return true;
+}
+
+bool TrapezoidTessellator::EmitTrapezoid(uint32_t left,
+                                         uint32_t right,
+                                         Scalar top,
+                                         Scalar bottom) {
+  if (!(bottom > top)) {
+    return true;
+  }
+  const Edge& left_edge = edges_[left];
+  const Edge& right_edge = edges_[right];
+  Scalar top_left = left_edge.XAt(top);
+  Scalar top_right = right_edge.XAt(top);
+  Scalar bottom_left = left_edge.XAt(bottom);
+  Scalar bottom_right = right_edge.XAt(bottom);
+  if (top_right <= top_left && bottom_right <= bottom_left) {
+    return true;
+  }
+
+  size_t base = GetVertexCount();
+  if (base + 4 > max_vertices_) {
+    return false;
+  }
+  vertices_.insert(vertices_.end(), {
+                                        top_left,
+                                        top,
+                                        top_right,
+                                        top,
+                                        bottom_right,
+                                        bottom,
+                                        bottom_left,
+                                        bottom,
+                                    });
+  uint16_t index = static_cast<uint16_t>(base);
+  indices_.insert(indices_.end(), {
+                                      index,
+                                      static_cast<uint16_t>(index + 1),
+                                      static_cast<uint16_t>(index + 2),
+                                      index,
+                                      static_cast<uint16_t>(index + 2),
+                                      static_cast<uint16_t>(index + 3),
+                                  });
+  return true;
+}
+
+}  // namespace impeller
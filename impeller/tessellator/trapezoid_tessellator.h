@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_TESSELLATOR_TRAPEZOID_TESSELLATOR_H_
+#define FLUTTER_IMPELLER_TESSELLATOR_TRAPEZOID_TESSELLATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/scalar.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Fills a polyline by decomposing it into trapezoids with a
+///             sweep line, as an alternative to libtess2 that needs no
+///             allocations once its buffers have grown.
+///
+///             The sweep stops at the y coordinate of every vertex and of
+///             every crossing of two edges. Between two stops the edges do
+///             not cross, so the area between each pair of edges that
+///             enters and leaves the filled region is a trapezoid. A
+///             trapezoid that continues with the same pair of edges across
+///             stops is extended rather than split.
+///
+///             Only the fill types that do not depend on the direction of
+///             the contours are supported.
+///
+///             This object is not thread safe.
+///
+class TrapezoidTessellator {
+ public:
+  TrapezoidTessellator();
+
+  ~TrapezoidTessellator();
+
+  /// @brief  Whether |Tessellate| can fill polylines with the fill type.
+  static bool SupportsFillType(FillType fill_type);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Tessellates the closed contours of the polyline into
+  ///             indexed triangles, available from |GetVertices| and
+  ///             |GetIndices| until the next call.
+  ///
+  /// @param[in]  polyline      The polyline to fill.
+  /// @param[in]  fill_type     The fill type, which must be supported.
+  /// @param[in]  max_vertices  The number of vertices at which to give up.
+  ///
+  /// @return     Whether the polyline was tessellated in fewer than
+  ///             |max_vertices| vertices.
+  ///
+  bool Tessellate(const Path::Polyline& polyline,
+                  FillType fill_type,
+                  size_t max_vertices);
+
+  /// @brief  The x and y coordinates of the vertices of the triangles.
+  const std::vector<float>& GetVertices() const { return vertices_; }
+
+  /// @brief  The vertex indices of the triangles.
+  const std::vector<uint16_t>& GetIndices() const { return indices_; }
+
+  /// @brief  Returns the number of vertices in |GetVertices|.
+  size_t GetVertexCount() const { return vertices_.size() / 2; }
+
+ private:
+  struct Edge {
+    Scalar x0;
+    Scalar y0;
+    Scalar y1;
+    Scalar slope;
+    int winding;
+
+    Scalar XAt(Scalar y) const { return x0 + (y - y0) * slope; }
+  };
+
+  std::vector<Edge> edges_;
+  std::vector<Scalar> stops_;
+  std::vector<uint32_t> active_;
+  std::vector<Scalar> top_x_;
+  std::vector<Scalar> bottom_x_;
+
+  // For each edge that is the left side of a trapezoid that is still being
+  // extended, the right edge and the top of the trapezoid.
+  std::vector<int> span_right_;
+  std::vector<Scalar> span_top_;
+  std::vector<uint32_t> span_stamp_;
+  std::vector<uint32_t> open_spans_;
+  std::vector<uint32_t> next_open_spans_;
+
+  std::vector<float> vertices_;
+  std::vector<uint16_t> indices_;
+  size_t max_vertices_ = 0;
+
+  bool IsInside(FillType fill_type, int winding) const;
+
+  bool AddEdges(const Path::Polyline& polyline);
+
+  bool FillBand(FillType fill_type, Scalar top, Scalar bottom, uint32_t stamp);
+
+  bool EmitTrapezoid(uint32_t left, uint32_t right, Scalar top, Scalar bottom);
+
+  TrapezoidTessellator(const TrapezoidTessellator&) = delete;
+
+  TrapezoidTessellator& operator=(const TrapezoidTessellator&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_TESSELLATOR_TRAPEZOID_TESSELLATOR_H_
@@ -12,12 +12,12 @@ GlyphAtlasContextSkia::GlyphAtlasContextSkia() = default;
 
 GlyphAtlasContextSkia::~GlyphAtlasContextSkia() = default;
 
-std::shared_ptr<SkBitmap> GlyphAtlasContextSkia::GetBitmap() const {
-  return bitmap_;
+std::vector<GlyphAtlasContextSkia::Page>& GlyphAtlasContextSkia::GetPages() {
+  return pages_;
 }
 
-void GlyphAtlasContextSkia::UpdateBitmap(std::shared_ptr<SkBitmap> bitmap) {
-  bitmap_ = std::move(bitmap);
+uint64_t GlyphAtlasContextSkia::AdvanceFrame() {
+  return ++frame_;
 }
 
 }  // namespace impeller
@@ -5,6 +5,10 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_GLYPH_ATLAS_CONTEXT_SKIA_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_GLYPH_ATLAS_CONTEXT_SKIA_H_
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "impeller/base/backend_cast.h"
 #include "impeller/typographer/glyph_atlas.h"
 
@@ -15,22 +19,36 @@ namespace impeller {
 //------------------------------------------------------------------------------
 /// @brief      A container for caching a glyph atlas across frames.
 ///
+///             Each page of the atlas keeps the bitmap its glyphs are drawn
+///             into and the packer that places them, along with the last
+///             frame any of its glyphs were used in.
+///
 class GlyphAtlasContextSkia
     : public GlyphAtlasContext,
       public BackendCast<GlyphAtlasContextSkia, GlyphAtlasContext> {
  public:
+  struct Page {
+    std::shared_ptr<SkBitmap> bitmap;
+    std::shared_ptr<RectanglePacker> rect_packer;
+    uint64_t last_used_frame = 0u;
+  };
+
   GlyphAtlasContextSkia();
 
   ~GlyphAtlasContextSkia() override;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the previous (if any) SkBitmap instance.
-  std::shared_ptr<SkBitmap> GetBitmap() const;
+  /// @brief      The pages of the current glyph atlas, in the same order.
+  std::vector<Page>& GetPages();
 
-  void UpdateBitmap(std::shared_ptr<SkBitmap> bitmap);
+  //----------------------------------------------------------------------------
+  /// @brief      Start a new frame and return its number. Frames are numbered
+  ///             from one.
+  uint64_t AdvanceFrame();
 
  private:
-  std::shared_ptr<SkBitmap> bitmap_;
+  std::vector<Page> pages_;
+  uint64_t frame_ = 0u;
 
   GlyphAtlasContextSkia(const GlyphAtlasContextSkia&) = delete;
 
@@ -4,13 +4,21 @@
 
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 
-#include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <optional>
 #include <utility>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/parallel_for.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
 #include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer_descriptor.h"
+#include "impeller/core/formats.h"
+#include "impeller/renderer/blit_pass.h"
+#include "impeller/renderer/command_buffer.h"
 #include "impeller/typographer/backends/skia/glyph_atlas_context_skia.h"
 #include "impeller/typographer/backends/skia/typeface_skia.h"
 #include "impeller/typographer/rectangle_packer.h"
@@ -27,11 +35,31 @@ namespace impeller {
 //              https://github.com/flutter/flutter/issues/114563
 constexpr auto kPadding = 2;
 
-std::shared_ptr<TypographerContext> TypographerContextSkia::Make() {
-  return std::make_shared<TypographerContextSkia>();
+// Glyphs are handed to other threads in chunks of at least this many, as
+// rendering a single glyph is cheap compared to posting a task.
+constexpr size_t kMinGlyphsPerChunk = 16;
+
+// The width and height of a page of the atlas of each type. A glyph too
+// large for a page of this size gets a page that fits it.
+constexpr uint32_t kAlphaBitmapPageSize = 1024u;
+constexpr uint32_t kColorBitmapPageSize = 512u;
+
+// The number of pages past which new glyphs replace the least recently used
+// glyphs rather than going into a new page. Glyphs of the current frame are
+// never replaced, so an atlas grows past this when the glyphs of one frame do
+// not fit. The pages past it are dropped again by the first frame that uses
+// none of their glyphs, which bounds the atlas by the glyphs of one frame.
+constexpr size_t kMaxPageCount = 4u;
+
+std::shared_ptr<TypographerContext> TypographerContextSkia::Make(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  return std::make_shared<TypographerContextSkia>(
+      std::move(worker_task_runner));
 }
 
-TypographerContextSkia::TypographerContextSkia() = default;
+TypographerContextSkia::TypographerContextSkia(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : worker_task_runner_(std::move(worker_task_runner)) {}
 
 TypographerContextSkia::~TypographerContextSkia() = default;
 
@@ -40,118 +68,6 @@ TypographerContextSkia::CreateGlyphAtlasContext() const {
   return std::make_shared<GlyphAtlasContextSkia>();
 }
 
-static size_t PairsFitInAtlasOfSize(
-    const std::vector<FontGlyphPair>& pairs,
-    const ISize& atlas_size,
-    std::vector<Rect>& glyph_positions,
-    const std::shared_ptr<RectanglePacker>& rect_packer) {
-  if (atlas_size.IsEmpty()) {
-    return false;
-  }
-
-  glyph_positions.clear();
-  glyph_positions.reserve(pairs.size());
-
-  size_t i = 0;
-  for (auto it = pairs.begin(); it != pairs.end(); ++i, ++it) {
-    const auto& pair = *it;
-
-    const auto glyph_size =
-        ISize::Ceil(pair.glyph.bounds.GetSize() * pair.scaled_font.scale);
-    IPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
-      return pairs.size() - i;
-    }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
-  }
-
-  return 0;
-}
-
-static bool CanAppendToExistingAtlas(
-    const std::shared_ptr<GlyphAtlas>& atlas,
-    const std::vector<FontGlyphPair>& extra_pairs,
-    std::vector<Rect>& glyph_positions,
-    ISize atlas_size,
-    const std::shared_ptr<RectanglePacker>& rect_packer) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!rect_packer || atlas_size.IsEmpty()) {
-    return false;
-  }
-
-  // We assume that all existing glyphs will fit. After all, they fit before.
-  // The glyph_positions only contains the values for the additional glyphs
-  // from extra_pairs.
-  FML_DCHECK(glyph_positions.size() == 0);
-  glyph_positions.reserve(extra_pairs.size());
-  for (size_t i = 0; i < extra_pairs.size(); i++) {
-    const FontGlyphPair& pair = extra_pairs[i];
-
-    const auto glyph_size =
-        ISize::Ceil(pair.glyph.bounds.GetSize() * pair.scaled_font.scale);
-    IPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
-      return false;
-    }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
-  }
-
-  return true;
-}
-
-static ISize OptimumAtlasSizeForFontGlyphPairs(
-    const std::vector<FontGlyphPair>& pairs,
-    std::vector<Rect>& glyph_positions,
-    const std::shared_ptr<GlyphAtlasContext>& atlas_context,
-    GlyphAtlas::Type type,
-    const ISize& max_texture_size) {
-  static constexpr auto kMinAtlasSize = 8u;
-  static constexpr auto kMinAlphaBitmapSize = 1024u;
-
-  TRACE_EVENT0("impeller", __FUNCTION__);
-
-  ISize current_size = type == GlyphAtlas::Type::kAlphaBitmap
-                           ? ISize(kMinAlphaBitmapSize, kMinAlphaBitmapSize)
-                           : ISize(kMinAtlasSize, kMinAtlasSize);
-  size_t total_pairs = pairs.size() + 1;
-  do {
-    auto rect_packer = std::shared_ptr<RectanglePacker>(
-        RectanglePacker::Factory(current_size.width, current_size.height));
-
-    auto remaining_pairs = PairsFitInAtlasOfSize(pairs, current_size,
-                                                 glyph_positions, rect_packer);
-    if (remaining_pairs == 0) {
-      atlas_context->UpdateRectPacker(rect_packer);
-      return current_size;
-    } else if (remaining_pairs < std::ceil(total_pairs / 2)) {
-      current_size = ISize::MakeWH(
-          std::max(current_size.width, current_size.height),
-          Allocation::NextPowerOfTwoSize(
-              std::min(current_size.width, current_size.height) + 1));
-    } else {
-      current_size = ISize::MakeWH(
-          Allocation::NextPowerOfTwoSize(current_size.width + 1),
-          Allocation::NextPowerOfTwoSize(current_size.height + 1));
-    }
-  } while (current_size.width <= max_texture_size.width &&
-           current_size.height <= max_texture_size.height);
-  return ISize{0, 0};
-}
-
 static void DrawGlyph(SkCanvas* canvas,
                       const ScaledFont& scaled_font,
                       const Glyph& glyph,
@@ -185,129 +101,356 @@ static void DrawGlyph(SkCanvas* canvas,
   );
 }
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              const std::shared_ptr<SkBitmap>& bitmap,
-                              const std::vector<FontGlyphPair>& new_pairs) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  FML_DCHECK(bitmap != nullptr);
-
-  auto surface = SkSurfaces::WrapPixels(bitmap->pixmap());
-  if (!surface) {
-    return false;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return false;
-  }
+struct GlyphToDraw {
+  const ScaledFont* scaled_font;
+  const Glyph* glyph;
+  Rect location;
+};
+
+// Draws the glyphs into the bitmap, spreading them over the workers of
+// |worker_task_runner| if there is one. Every chunk of glyphs draws through
+// its own surface. Each glyph is clipped to its cell in the atlas grown by
+// half the padding, which covers the anti-aliased fringe while keeping the
+// pixels touched by different glyphs disjoint. The cell is cleared first as
+// it may hold a glyph that has been evicted.
+static bool DrawGlyphs(
+    const std::shared_ptr<SkBitmap>& bitmap,
+    const std::vector<GlyphToDraw>& glyphs,
+    bool has_color,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  std::atomic_bool success = true;
+  fml::ParallelFor(
+      worker_task_runner, glyphs.size(),
+      [&](size_t begin, size_t end) {
+        auto surface = SkSurfaces::WrapPixels(bitmap->pixmap());
+        auto canvas = surface ? surface->getCanvas() : nullptr;
+        if (!canvas) {
+          success = false;
+          return;
+        }
+        for (size_t i = begin; i < end; i++) {
+          const GlyphToDraw& glyph = glyphs[i];
+          canvas->save();
+          canvas->resetMatrix();
+          canvas->clipRect(SkRect::MakeXYWH(
+              glyph.location.GetX() - kPadding / 2,
+              glyph.location.GetY() - kPadding / 2,
+              glyph.location.GetWidth() + kPadding,
+              glyph.location.GetHeight() + kPadding));
+          canvas->clear(SK_ColorTRANSPARENT);
+          DrawGlyph(canvas, *glyph.scaled_font, *glyph.glyph, glyph.location,
+                    has_color);
+          canvas->restore();
+        }
+      },
+      kMinGlyphsPerChunk);
+  return success;
+}
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+// Returns the region of a page that |DrawGlyphs| may touch for a glyph.
+static std::optional<IRect> GetGlyphCell(const Rect& location,
+                                         const ISize& page_size) {
+  return IRect::MakeXYWH(static_cast<int64_t>(location.GetX()) - kPadding / 2,
+                         static_cast<int64_t>(location.GetY()) - kPadding / 2,
+                         static_cast<int64_t>(location.GetWidth()) + kPadding,
+                         static_cast<int64_t>(location.GetHeight()) + kPadding)
+      .Intersection(IRect::MakeSize(page_size));
+}
 
-  for (const FontGlyphPair& pair : new_pairs) {
-    auto pos = atlas.FindFontGlyphBounds(pair);
-    if (!pos.has_value()) {
-      continue;
-    }
-    DrawGlyph(canvas, pair.scaled_font, pair.glyph, pos.value(), has_color);
+static PixelFormat GetAtlasPixelFormat(GlyphAtlas::Type type) {
+  switch (type) {
+    case GlyphAtlas::Type::kAlphaBitmap:
+      return PixelFormat::kA8UNormInt;
+    case GlyphAtlas::Type::kColorBitmap:
+      return PixelFormat::kR8G8B8A8UNormInt;
   }
-  return true;
+  FML_UNREACHABLE();
 }
 
-static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
-                                                   const ISize& atlas_size) {
+// Adds an empty page of the given size to the atlas, along with the bitmap
+// its glyphs are drawn into and the packer that places them.
+static bool AddPage(Allocator& allocator,
+                    GlyphAtlas& atlas,
+                    GlyphAtlasContextSkia& atlas_context,
+                    const ISize& size) {
   TRACE_EVENT0("impeller", __FUNCTION__);
-  auto bitmap = std::make_shared<SkBitmap>();
   SkImageInfo image_info;
-
   switch (atlas.GetType()) {
     case GlyphAtlas::Type::kAlphaBitmap:
-      image_info = SkImageInfo::MakeA8(atlas_size.width, atlas_size.height);
+      image_info = SkImageInfo::MakeA8(size.width, size.height);
       break;
     case GlyphAtlas::Type::kColorBitmap:
-      image_info =
-          SkImageInfo::MakeN32Premul(atlas_size.width, atlas_size.height);
+      image_info = SkImageInfo::MakeN32Premul(size.width, size.height);
       break;
   }
-
+  auto bitmap = std::make_shared<SkBitmap>();
   if (!bitmap->tryAllocPixels(image_info)) {
-    return nullptr;
+    return false;
   }
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
 
-  auto surface = SkSurfaces::WrapPixels(bitmap->pixmap());
-  if (!surface) {
-    return nullptr;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return nullptr;
+  TextureDescriptor texture_descriptor;
+  texture_descriptor.storage_mode = StorageMode::kHostVisible;
+  texture_descriptor.format = GetAtlasPixelFormat(atlas.GetType());
+  texture_descriptor.size = size;
+
+  const auto& pixmap = bitmap->pixmap();
+  if (pixmap.rowBytes() * pixmap.height() !=
+      texture_descriptor.GetByteSizeOfBaseMipLevel()) {
+    return false;
   }
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+  auto texture = allocator.CreateTexture(texture_descriptor);
+  if (!texture || !texture->IsValid()) {
+    return false;
+  }
+  texture->SetLabel("GlyphAtlas");
 
-  atlas.IterateGlyphs([canvas, has_color](const ScaledFont& scaled_font,
-                                          const Glyph& glyph,
-                                          const Rect& location) -> bool {
-    DrawGlyph(canvas, scaled_font, glyph, location, has_color);
-    return true;
+  std::vector<GlyphAtlasContextSkia::Page>& pages = atlas_context.GetPages();
+  atlas.SetTexture(pages.size(), std::move(texture));
+  pages.push_back({
+      .bitmap = std::move(bitmap),
+      .rect_packer = std::shared_ptr<RectanglePacker>(
+          RectanglePacker::MaxRectsFactory(size.width, size.height)),
   });
+  return true;
+}
 
-  return bitmap;
+// A glyph in the atlas that no glyph of the frame being prepared uses.
+struct StaleGlyph {
+  ScaledFont scaled_font;
+  Glyph glyph;
+  GlyphAtlas::Slot slot;
+};
+
+// Returns the glyphs of the atlas that are not used by |frame|, with the
+// least recently used last.
+static std::vector<StaleGlyph> CollectStaleGlyphs(const GlyphAtlas& atlas,
+                                                  uint64_t frame) {
+  std::vector<StaleGlyph> stale_glyphs;
+  atlas.IterateGlyphSlots([&](const ScaledFont& scaled_font,
+                              const Glyph& glyph,
+                              const GlyphAtlas::Slot& slot) {
+    if (slot.last_used_frame != frame) {
+      stale_glyphs.push_back({scaled_font, glyph, slot});
+    }
+  });
+  std::sort(stale_glyphs.begin(), stale_glyphs.end(),
+            [](const StaleGlyph& a, const StaleGlyph& b) {
+              return a.slot.last_used_frame > b.slot.last_used_frame;
+            });
+  return stale_glyphs;
 }
 
-static bool UpdateGlyphTextureAtlas(std::shared_ptr<SkBitmap> bitmap,
-                                    const std::shared_ptr<Texture>& texture) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
+// Finds room for a glyph of the given size in the first page that has some.
+// When no page does and the atlas already has |kMaxPageCount| pages, the
+// least recently used glyphs are evicted one at a time, returning their cells
+// to the packer of their page, until the glyph fits in the page of the last
+// one. A page is added when there are no glyphs left to evict or the atlas
+// has fewer pages. |stale_glyphs| is collected on first use and shared by
+// the glyphs placed in the same frame.
+static std::optional<GlyphAtlas::Slot> PlaceGlyph(
+    Allocator& allocator,
+    GlyphAtlas& atlas,
+    GlyphAtlasContextSkia& atlas_context,
+    const ISize& glyph_size,
+    uint64_t frame,
+    std::optional<std::vector<StaleGlyph>>& stale_glyphs,
+    GlyphAtlasContext::UpdateStats& stats) {
+  const int64_t cell_width = glyph_size.width + kPadding;
+  const int64_t cell_height = glyph_size.height + kPadding;
+
+  auto add_to_page = [&](size_t index) -> std::optional<GlyphAtlas::Slot> {
+    GlyphAtlasContextSkia::Page& page = atlas_context.GetPages()[index];
+    IPoint16 location_in_atlas;
+    if (!page.rect_packer->addRect(cell_width,          //
+                                   cell_height,         //
+                                   &location_in_atlas)  //
+    ) {
+      return std::nullopt;
+    }
+    page.last_used_frame = frame;
+    return GlyphAtlas::Slot{
+        .bounds = Rect::MakeXYWH(location_in_atlas.x(),  //
+                                 location_in_atlas.y(),  //
+                                 glyph_size.width,       //
+                                 glyph_size.height       //
+                                 ),
+        .page = index,
+        .last_used_frame = frame,
+    };
+  };
+
+  const std::vector<GlyphAtlasContextSkia::Page>& pages =
+      atlas_context.GetPages();
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (auto slot = add_to_page(i)) {
+      return slot;
+    }
+  }
 
-  FML_DCHECK(bitmap != nullptr);
-  auto texture_descriptor = texture->GetTextureDescriptor();
+  const uint32_t min_page_size =
+      atlas.GetType() == GlyphAtlas::Type::kAlphaBitmap ? kAlphaBitmapPageSize
+                                                        : kColorBitmapPageSize;
 
-  auto mapping = std::make_shared<fml::NonOwnedMapping>(
-      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
-      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
-      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
-  );
+  // Glyphs too large for a page of the minimum size get a page of their own,
+  // as evicting glyphs of smaller pages would not make room for them.
+  if (pages.size() >= kMaxPageCount && cell_width <= min_page_size &&
+      cell_height <= min_page_size) {
+    if (!stale_glyphs.has_value()) {
+      stale_glyphs = CollectStaleGlyphs(atlas, frame);
+    }
+    while (!stale_glyphs->empty()) {
+      StaleGlyph stale = std::move(stale_glyphs->back());
+      stale_glyphs->pop_back();
+      const Rect& bounds = stale.slot.bounds;
+      pages[stale.slot.page].rect_packer->removeRect(
+          static_cast<int>(bounds.GetX()),                 //
+          static_cast<int>(bounds.GetY()),                 //
+          static_cast<int>(bounds.GetWidth()) + kPadding,  //
+          static_cast<int>(bounds.GetHeight()) + kPadding  //
+      );
+      atlas.RemoveFontGlyph({stale.scaled_font, stale.glyph});
+      stats.evicted_glyph_count++;
+      if (auto slot = add_to_page(stale.slot.page)) {
+        return slot;
+      }
+    }
+  }
 
-  return texture->SetContents(mapping);
+  const ISize max_texture_size = allocator.GetMaxTextureSizeSupported();
+  const ISize page_size(
+      std::min<int64_t>(
+          std::max(min_page_size, Allocation::NextPowerOfTwoSize(cell_width)),
+          max_texture_size.width),
+      std::min<int64_t>(
+          std::max(min_page_size, Allocation::NextPowerOfTwoSize(cell_height)),
+          max_texture_size.height));
+  if (page_size.width < cell_width || page_size.height < cell_height) {
+    return std::nullopt;
+  }
+  if (!AddPage(allocator, atlas, atlas_context, page_size)) {
+    return std::nullopt;
+  }
+  return add_to_page(pages.size() - 1);
 }
 
-static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
-    const std::shared_ptr<Allocator>& allocator,
-    std::shared_ptr<SkBitmap> bitmap,
-    const ISize& atlas_size,
-    PixelFormat format) {
+// Uploads the whole bitmap of each page with new glyphs to its texture, for
+// backends that cannot blit from a buffer to a texture.
+static bool UploadGlyphPages(
+    const GlyphAtlas& atlas,
+    const std::vector<GlyphAtlasContextSkia::Page>& pages,
+    const std::vector<std::vector<GlyphToDraw>>& new_glyphs_by_page,
+    GlyphAtlasContext::UpdateStats& stats) {
   TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!allocator) {
-    return nullptr;
+  for (size_t i = 0; i < new_glyphs_by_page.size(); i++) {
+    if (new_glyphs_by_page[i].empty()) {
+      continue;
+    }
+    std::shared_ptr<SkBitmap> bitmap = pages[i].bitmap;
+    const std::shared_ptr<Texture>& texture = atlas.GetTexture(i);
+    size_t byte_size =
+        texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+    auto mapping = std::make_shared<fml::NonOwnedMapping>(
+        reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
+        byte_size,                                                // size
+        [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
+    );
+    if (!texture->SetContents(mapping)) {
+      return false;
+    }
+    stats.uploaded_byte_count += byte_size;
   }
+  return true;
+}
 
-  FML_DCHECK(bitmap != nullptr);
-  const auto& pixmap = bitmap->pixmap();
-
-  TextureDescriptor texture_descriptor;
-  texture_descriptor.storage_mode = StorageMode::kHostVisible;
-  texture_descriptor.format = format;
-  texture_descriptor.size = atlas_size;
-
-  if (pixmap.rowBytes() * pixmap.height() !=
-      texture_descriptor.GetByteSizeOfBaseMipLevel()) {
-    return nullptr;
+// Uploads only the cells of the new glyphs, staging them in one buffer that
+// is copied to the textures of their pages by a blit pass.
+static bool UploadGlyphCells(
+    Context& context,
+    const GlyphAtlas& atlas,
+    const std::vector<GlyphAtlasContextSkia::Page>& pages,
+    const std::vector<std::vector<GlyphToDraw>>& new_glyphs_by_page,
+    GlyphAtlasContext::UpdateStats& stats) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  // Offsets into the staging buffer are kept aligned to four bytes, which
+  // satisfies the requirements of every backend for both pixel formats.
+  constexpr size_t kCellAlignment = 4u;
+
+  struct CellUpload {
+    size_t page;
+    IRect region;
+    Range range;
+  };
+  const size_t bytes_per_pixel =
+      BytesPerPixelForPixelFormat(GetAtlasPixelFormat(atlas.GetType()));
+  std::vector<CellUpload> uploads;
+  size_t buffer_size = 0u;
+  for (size_t i = 0; i < new_glyphs_by_page.size(); i++) {
+    ISize page_size = atlas.GetTexture(i)->GetSize();
+    for (const GlyphToDraw& glyph : new_glyphs_by_page[i]) {
+      std::optional<IRect> region = GetGlyphCell(glyph.location, page_size);
+      if (!region.has_value() || region->IsEmpty()) {
+        continue;
+      }
+      size_t length = region->Area() * bytes_per_pixel;
+      uploads.push_back({i, region.value(), Range(buffer_size, length)});
+      buffer_size += (length + kCellAlignment - 1) & ~(kCellAlignment - 1);
+    }
   }
-
-  auto texture = allocator->CreateTexture(texture_descriptor);
-  if (!texture || !texture->IsValid()) {
-    return nullptr;
+  if (uploads.empty()) {
+    return true;
   }
-  texture->SetLabel("GlyphAtlas");
 
-  auto mapping = std::make_shared<fml::NonOwnedMapping>(
-      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
-      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
-      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
-  );
+  DeviceBufferDescriptor buffer_descriptor;
+  buffer_descriptor.storage_mode = StorageMode::kHostVisible;
+  buffer_descriptor.size = buffer_size;
+  auto buffer =
+      context.GetResourceAllocator()->CreateBuffer(buffer_descriptor);
+  uint8_t* contents = buffer ? buffer->OnGetContents() : nullptr;
+  if (!contents) {
+    return false;
+  }
+  for (const CellUpload& upload : uploads) {
+    const SkBitmap& bitmap = *pages[upload.page].bitmap;
+    size_t row_bytes = upload.region.GetWidth() * bytes_per_pixel;
+    for (int64_t row = 0; row < upload.region.GetHeight(); row++) {
+      ::memcpy(contents + upload.range.offset + row * row_bytes,
+               bitmap.getAddr(upload.region.GetX(), upload.region.GetY() + row),
+               row_bytes);
+    }
+  }
+  buffer->Flush(Range(0u, buffer_size));
 
-  if (!texture->SetContents(mapping)) {
-    return nullptr;
+  auto command_buffer = context.CreateCommandBuffer();
+  if (!command_buffer) {
+    return false;
   }
-  return texture;
+  command_buffer->SetLabel("GlyphAtlas Upload");
+  auto blit_pass = command_buffer->CreateBlitPass();
+  if (!blit_pass) {
+    return false;
+  }
+  blit_pass->SetLabel("GlyphAtlas Upload");
+  for (const CellUpload& upload : uploads) {
+    BufferView source{buffer, contents, upload.range};
+    if (!blit_pass->AddCopy(std::move(source), atlas.GetTexture(upload.page),
+                            upload.region, "Glyph")) {
+      return false;
+    }
+    stats.uploaded_byte_count += upload.range.length;
+  }
+  return command_buffer->EncodeAndSubmit(blit_pass,
+                                         context.GetResourceAllocator());
+}
+
+// Replaces the atlas with an empty one, so that glyphs that were recorded by
+// a failed update are not used.
+static void ResetGlyphAtlas(GlyphAtlasContextSkia& atlas_context,
+                            GlyphAtlas::Type type) {
+  atlas_context.GetPages().clear();
+  atlas_context.UpdateGlyphAtlas(std::make_shared<GlyphAtlas>(type), {});
+  atlas_context.UpdateRectPacker(nullptr);
 }
 
 std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
@@ -320,170 +463,119 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     return nullptr;
   }
   auto& atlas_context_skia = GlyphAtlasContextSkia::Cast(*atlas_context);
-  std::shared_ptr<GlyphAtlas> last_atlas = atlas_context->GetGlyphAtlas();
 
   if (font_glyph_map.empty()) {
-    return last_atlas;
+    return atlas_context->GetGlyphAtlas();
+  }
+
+  const uint64_t frame = atlas_context_skia.AdvanceFrame();
+  GlyphAtlasContext::UpdateStats stats;
+
+  // ---------------------------------------------------------------------------
+  // Step 1: Start over with an empty atlas if the type of the atlas changed.
+  // ---------------------------------------------------------------------------
+  if (atlas_context->GetGlyphAtlas()->GetType() != type) {
+    ResetGlyphAtlas(atlas_context_skia, type);
   }
+  std::shared_ptr<GlyphAtlas> atlas = atlas_context->GetGlyphAtlas();
 
   // ---------------------------------------------------------------------------
-  // Step 1: Determine if the atlas type and font glyph pairs are compatible
-  //         with the current atlas and reuse if possible.
+  // Step 2: Mark the glyphs already in the atlas and their pages as used by
+  //         this frame and collect the glyphs that are not in the atlas.
   // ---------------------------------------------------------------------------
   std::vector<FontGlyphPair> new_glyphs;
-  for (const auto& font_value : font_glyph_map) {
-    const ScaledFont& scaled_font = font_value.first;
-    const FontGlyphAtlas* font_glyph_atlas =
-        last_atlas->GetFontGlyphAtlas(scaled_font.font, scaled_font.scale);
-    if (font_glyph_atlas) {
+  {
+    std::vector<GlyphAtlasContextSkia::Page>& pages =
+        atlas_context_skia.GetPages();
+    for (const auto& font_value : font_glyph_map) {
+      const ScaledFont& scaled_font = font_value.first;
       for (const Glyph& glyph : font_value.second) {
-        if (!font_glyph_atlas->FindGlyphBounds(glyph)) {
+        const GlyphAtlas::Slot* slot =
+            atlas->MarkFontGlyphUsed({scaled_font, glyph}, frame);
+        if (slot) {
+          pages[slot->page].last_used_frame = frame;
+        } else {
           new_glyphs.emplace_back(scaled_font, glyph);
         }
       }
-    } else {
-      for (const Glyph& glyph : font_value.second) {
-        new_glyphs.emplace_back(scaled_font, glyph);
-      }
     }
   }
-  if (last_atlas->GetType() == type && new_glyphs.size() == 0) {
-    return last_atlas;
+  if (new_glyphs.empty()) {
+    atlas_context->SetLastUpdateStats(stats);
+    return atlas;
   }
 
   // ---------------------------------------------------------------------------
-  // Step 2: Determine if the additional missing glyphs can be appended to the
-  //         existing bitmap without recreating the atlas. This requires that
-  //         the type is identical.
+  // Step 3: Drop the pages past |kMaxPageCount| that this frame does not use.
   // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_positions;
-  if (last_atlas->GetType() == type &&
-      CanAppendToExistingAtlas(last_atlas, new_glyphs, glyph_positions,
-                               atlas_context->GetAtlasSize(),
-                               atlas_context->GetRectPacker())) {
-    // The old bitmap will be reused and only the additional glyphs will be
-    // added.
-
-    // ---------------------------------------------------------------------------
-    // Step 3a: Record the positions in the glyph atlas of the newly added
-    //          glyphs.
-    // ---------------------------------------------------------------------------
-    for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
-      last_atlas->AddTypefaceGlyphPosition(new_glyphs[i], glyph_positions[i]);
-    }
-
-    // ---------------------------------------------------------------------------
-    // Step 4a: Draw new font-glyph pairs into the existing bitmap.
-    // ---------------------------------------------------------------------------
-    auto bitmap = atlas_context_skia.GetBitmap();
-    if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_glyphs)) {
-      return nullptr;
-    }
-
-    // ---------------------------------------------------------------------------
-    // Step 5a: Update the existing texture with the updated bitmap.
-    // ---------------------------------------------------------------------------
-    if (!UpdateGlyphTextureAtlas(bitmap, last_atlas->GetTexture())) {
-      return nullptr;
+  {
+    std::vector<GlyphAtlasContextSkia::Page>& pages =
+        atlas_context_skia.GetPages();
+    while (pages.size() > kMaxPageCount &&
+           pages.back().last_used_frame != frame) {
+      stats.evicted_glyph_count += atlas->RemoveLastPage();
+      pages.pop_back();
     }
-    return last_atlas;
   }
-  // A new glyph atlas must be created.
 
   // ---------------------------------------------------------------------------
-  // Step 3b: Get the optimum size of the texture atlas.
+  // Step 4: Find room for the new glyphs, evicting glyphs or adding pages as
+  //         needed, and record their slots in the atlas.
   // ---------------------------------------------------------------------------
-  std::vector<FontGlyphPair> font_glyph_pairs;
-  font_glyph_pairs.reserve(std::accumulate(
-      font_glyph_map.begin(), font_glyph_map.end(), 0,
-      [](const int a, const auto& b) { return a + b.second.size(); }));
-  for (const auto& font_value : font_glyph_map) {
-    const ScaledFont& scaled_font = font_value.first;
-    for (const Glyph& glyph : font_value.second) {
-      font_glyph_pairs.push_back({scaled_font, glyph});
+  std::vector<std::vector<GlyphToDraw>> new_glyphs_by_page;
+  std::optional<std::vector<StaleGlyph>> stale_glyphs;
+  for (const FontGlyphPair& pair : new_glyphs) {
+    const auto glyph_size =
+        ISize::Ceil(pair.glyph.bounds.GetSize() * pair.scaled_font.scale);
+    std::optional<GlyphAtlas::Slot> slot =
+        PlaceGlyph(*context.GetResourceAllocator(), *atlas, atlas_context_skia,
+                   glyph_size, frame, stale_glyphs, stats);
+    if (!slot.has_value()) {
+      ResetGlyphAtlas(atlas_context_skia, type);
+      return nullptr;
     }
-  }
-  auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
-  auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
-      font_glyph_pairs,                                             //
-      glyph_positions,                                              //
-      atlas_context,                                                //
-      type,                                                         //
-      context.GetResourceAllocator()->GetMaxTextureSizeSupported()  //
-  );
-
-  atlas_context->UpdateGlyphAtlas(glyph_atlas, atlas_size);
-  if (atlas_size.IsEmpty()) {
-    return nullptr;
-  }
-  // ---------------------------------------------------------------------------
-  // Step 4b: Find location of font-glyph pairs in the atlas. We have this from
-  // the last step. So no need to do create another rect packer. But just do a
-  // sanity check of counts. This could also be just an assertion as only a
-  // construction issue would cause such a failure.
-  // ---------------------------------------------------------------------------
-  if (glyph_positions.size() != font_glyph_pairs.size()) {
-    return nullptr;
-  }
-
-  // ---------------------------------------------------------------------------
-  // Step 5b: Record the positions in the glyph atlas.
-  // ---------------------------------------------------------------------------
-  {
-    size_t i = 0;
-    for (auto it = font_glyph_pairs.begin(); it != font_glyph_pairs.end();
-         ++i, ++it) {
-      glyph_atlas->AddTypefaceGlyphPosition(*it, glyph_positions[i]);
+    atlas->AddTypefaceGlyphSlot(pair, slot.value());
+    if (slot->page >= new_glyphs_by_page.size()) {
+      new_glyphs_by_page.resize(slot->page + 1);
     }
+    new_glyphs_by_page[slot->page].push_back(
+        {&pair.scaled_font, &pair.glyph, slot->bounds});
   }
 
   // ---------------------------------------------------------------------------
-  // Step 6b: Draw font-glyph pairs in the correct spot in the atlas.
+  // Step 5: Draw the new glyphs into the bitmaps of their pages.
   // ---------------------------------------------------------------------------
-  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
-  if (!bitmap) {
-    return nullptr;
-  }
-  atlas_context_skia.UpdateBitmap(bitmap);
-
-  // If the new atlas size is the same size as the previous texture, reuse the
-  // texture and treat this as an updated that replaces all glyphs.
-  if (last_atlas && last_atlas->GetTexture()) {
-    std::shared_ptr<Texture> last_texture = last_atlas->GetTexture();
-    if (atlas_size == last_texture->GetSize()) {
-      if (!UpdateGlyphTextureAtlas(bitmap, last_texture)) {
-        return nullptr;
-      }
-
-      glyph_atlas->SetTexture(last_texture);
-      return glyph_atlas;
+  const std::vector<GlyphAtlasContextSkia::Page>& pages =
+      atlas_context_skia.GetPages();
+  bool has_color = type == GlyphAtlas::Type::kColorBitmap;
+  for (size_t i = 0; i < new_glyphs_by_page.size(); i++) {
+    if (new_glyphs_by_page[i].empty()) {
+      continue;
     }
+    if (!DrawGlyphs(pages[i].bitmap, new_glyphs_by_page[i], has_color,
+                    worker_task_runner_)) {
+      ResetGlyphAtlas(atlas_context_skia, type);
+      return nullptr;
+    }
+    stats.rasterized_glyph_count += new_glyphs_by_page[i].size();
   }
 
   // ---------------------------------------------------------------------------
-  // Step 7b: Upload the atlas as a texture.
+  // Step 6: Upload what changed to the textures of the pages.
   // ---------------------------------------------------------------------------
-  PixelFormat format;
-  switch (type) {
-    case GlyphAtlas::Type::kAlphaBitmap:
-      format = PixelFormat::kA8UNormInt;
-      break;
-    case GlyphAtlas::Type::kColorBitmap:
-      format = PixelFormat::kR8G8B8A8UNormInt;
-      break;
-  }
-  auto texture = UploadGlyphTextureAtlas(context.GetResourceAllocator(), bitmap,
-                                         atlas_size, format);
-  if (!texture) {
+  bool uploaded =
+      context.GetCapabilities()->SupportsBufferToTextureBlits()
+          ? UploadGlyphCells(context, *atlas, pages, new_glyphs_by_page, stats)
+          : UploadGlyphPages(*atlas, pages, new_glyphs_by_page, stats);
+  if (!uploaded) {
+    ResetGlyphAtlas(atlas_context_skia, type);
     return nullptr;
   }
 
-  // ---------------------------------------------------------------------------
-  // Step 8b: Record the texture in the glyph atlas.
-  // ---------------------------------------------------------------------------
-  glyph_atlas->SetTexture(std::move(texture));
-
-  return glyph_atlas;
+  atlas_context->UpdateGlyphAtlas(atlas, atlas->GetTexture()->GetSize());
+  atlas_context->UpdateRectPacker(pages.front().rect_packer);
+  atlas_context->SetLastUpdateStats(stats);
+  return atlas;
 }
 
 }  // namespace impeller
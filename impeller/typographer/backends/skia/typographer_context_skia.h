@@ -5,6 +5,7 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "impeller/typographer/typographer_context.h"
 
@@ -12,9 +13,13 @@ namespace impeller {
 
 class TypographerContextSkia : public TypographerContext {
  public:
-  static std::shared_ptr<TypographerContext> Make();
+  /// If a |worker_task_runner| is given, glyphs are rendered into the atlas
+  /// bitmap in parallel on its workers.
+  static std::shared_ptr<TypographerContext> Make(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
-  TypographerContextSkia();
+  explicit TypographerContextSkia(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
   ~TypographerContextSkia() override;
 
@@ -29,6 +34,8 @@ class TypographerContextSkia : public TypographerContext {
       const FontGlyphMap& font_glyph_map) const override;
 
  private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+
   TypographerContextSkia(const TypographerContextSkia&) = delete;
 
   TypographerContextSkia& operator=(const TypographerContextSkia&) = delete;
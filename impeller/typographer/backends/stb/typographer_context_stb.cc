@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/parallel_for.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
 #include "impeller/core/allocator.h"
@@ -26,11 +27,19 @@ namespace impeller {
 
 constexpr size_t kPadding = 1;
 
-std::unique_ptr<TypographerContext> TypographerContextSTB::Make() {
-  return std::make_unique<TypographerContextSTB>();
+// Glyphs are handed to other threads in chunks of at least this many, as
+// rendering a single glyph is cheap compared to posting a task.
+constexpr size_t kMinGlyphsPerChunk = 16;
+
+std::unique_ptr<TypographerContext> TypographerContextSTB::Make(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  return std::make_unique<TypographerContextSTB>(std::move(worker_task_runner));
 }
 
-TypographerContextSTB::TypographerContextSTB() : TypographerContext() {}
+TypographerContextSTB::TypographerContextSTB(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : TypographerContext(),
+      worker_task_runner_(std::move(worker_task_runner)) {}
 
 TypographerContextSTB::~TypographerContextSTB() = default;
 
@@ -173,7 +182,8 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
   size_t total_pairs = pairs.size() + 1;
   do {
     auto rect_packer = std::shared_ptr<RectanglePacker>(
-        RectanglePacker::Factory(current_size.width, current_size.height));
+        RectanglePacker::MaxRectsFactory(current_size.width,
+                                         current_size.height));
 
     auto remaining_pairs = PairsFitInAtlasOfSize(pairs, current_size,
                                                  glyph_positions, rect_packer);
@@ -269,27 +279,59 @@ static void DrawGlyph(BitmapSTB* bitmap,
   }
 }
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              const std::shared_ptr<BitmapSTB>& bitmap,
-                              const std::vector<FontGlyphPair>& new_pairs) {
+struct GlyphToDraw {
+  const ScaledFont* scaled_font;
+  const Glyph* glyph;
+  Rect location;
+};
+
+// Draws the glyphs into the bitmap, spreading them over the workers of
+// |worker_task_runner| if there is one. The glyphs have been packed already,
+// so each one writes to its own disjoint region of the bitmap.
+static void DrawGlyphs(
+    BitmapSTB* bitmap,
+    const std::vector<GlyphToDraw>& glyphs,
+    bool has_color,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  fml::ParallelFor(
+      worker_task_runner, glyphs.size(),
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          const GlyphToDraw& glyph = glyphs[i];
+          DrawGlyph(bitmap, *glyph.scaled_font, *glyph.glyph, glyph.location,
+                    has_color);
+        }
+      },
+      kMinGlyphsPerChunk);
+}
+
+static bool UpdateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    const std::shared_ptr<BitmapSTB>& bitmap,
+    const std::vector<FontGlyphPair>& new_pairs,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   FML_DCHECK(bitmap != nullptr);
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
 
+  std::vector<GlyphToDraw> glyphs;
+  glyphs.reserve(new_pairs.size());
   for (const FontGlyphPair& pair : new_pairs) {
     auto pos = atlas.FindFontGlyphBounds(pair);
     if (!pos.has_value()) {
       continue;
     }
-    DrawGlyph(bitmap.get(), pair.scaled_font, pair.glyph, pos.value(),
-              has_color);
+    glyphs.push_back({&pair.scaled_font, &pair.glyph, pos.value()});
   }
+  DrawGlyphs(bitmap.get(), glyphs, has_color, worker_task_runner);
   return true;
 }
 
-static std::shared_ptr<BitmapSTB> CreateAtlasBitmap(const GlyphAtlas& atlas,
-                                                    const ISize& atlas_size) {
+static std::shared_ptr<BitmapSTB> CreateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    const ISize& atlas_size,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
   TRACE_EVENT0("impeller", __FUNCTION__);
 
   size_t bytes_per_pixel = 1;
@@ -302,12 +344,15 @@ static std::shared_ptr<BitmapSTB> CreateAtlasBitmap(const GlyphAtlas& atlas,
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
 
-  atlas.IterateGlyphs([&bitmap, has_color](const ScaledFont& scaled_font,
-                                           const Glyph& glyph,
-                                           const Rect& location) -> bool {
-    DrawGlyph(bitmap.get(), scaled_font, glyph, location, has_color);
+  std::vector<GlyphToDraw> glyphs;
+  glyphs.reserve(atlas.GetGlyphCount());
+  atlas.IterateGlyphs([&glyphs](const ScaledFont& scaled_font,
+                                const Glyph& glyph,
+                                const Rect& location) -> bool {
+    glyphs.push_back({&scaled_font, &glyph, location});
     return true;
   });
+  DrawGlyphs(bitmap.get(), glyphs, has_color, worker_task_runner);
 
   return bitmap;
 }
@@ -439,7 +484,8 @@ std::shared_ptr<GlyphAtlas> TypographerContextSTB::CreateGlyphAtlas(
     // ---------------------------------------------------------------------------
     // auto bitmap = atlas_context->GetBitmap();
     auto bitmap = atlas_context_stb.GetBitmap();
-    if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_glyphs)) {
+    if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_glyphs,
+                           worker_task_runner_)) {
       return nullptr;
     }
 
@@ -504,7 +550,8 @@ std::shared_ptr<GlyphAtlas> TypographerContextSTB::CreateGlyphAtlas(
   // ---------------------------------------------------------------------------
   // Step 6b: Draw font-glyph pairs in the correct spot in the atlas.
   // ---------------------------------------------------------------------------
-  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
+  auto bitmap =
+      CreateAtlasBitmap(*glyph_atlas, atlas_size, worker_task_runner_);
   if (!bitmap) {
     return nullptr;
   }
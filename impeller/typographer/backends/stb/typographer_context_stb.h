@@ -8,15 +8,20 @@
 #include "impeller/typographer/typographer_context.h"
 
 #include <memory>
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 
 namespace impeller {
 
 class TypographerContextSTB : public TypographerContext {
  public:
-  static std::unique_ptr<TypographerContext> Make();
+  /// If a |worker_task_runner| is given, glyphs are rendered into the atlas
+  /// bitmap in parallel on its workers.
+  static std::unique_ptr<TypographerContext> Make(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
-  TypographerContextSTB();
+  explicit TypographerContextSTB(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
   ~TypographerContextSTB() override;
 
@@ -31,6 +36,8 @@ class TypographerContextSTB : public TypographerContext {
       const FontGlyphMap& font_glyph_map) const override;
 
  private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+
   TypographerContextSTB(const TypographerContextSTB&) = delete;
 
   TypographerContextSTB& operator=(const TypographerContextSTB&) = delete;
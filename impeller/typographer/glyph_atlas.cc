@@ -7,6 +7,8 @@
 #include <numeric>
 #include <utility>
 
+#include "flutter/fml/logging.h"
+
 namespace impeller {
 
 GlyphAtlasContext::GlyphAtlasContext()
@@ -38,12 +40,21 @@ void GlyphAtlasContext::UpdateRectPacker(
   rect_packer_ = std::move(rect_packer);
 }
 
-GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
+const GlyphAtlasContext::UpdateStats& GlyphAtlasContext::GetLastUpdateStats()
+    const {
+  return last_update_stats_;
+}
+
+void GlyphAtlasContext::SetLastUpdateStats(const UpdateStats& stats) {
+  last_update_stats_ = stats;
+}
+
+GlyphAtlas::GlyphAtlas(Type type) : type_(type), textures_(1u) {}
 
 GlyphAtlas::~GlyphAtlas() = default;
 
 bool GlyphAtlas::IsValid() const {
-  return !!texture_;
+  return !!textures_.front();
 }
 
 GlyphAtlas::Type GlyphAtlas::GetType() const {
@@ -51,16 +62,89 @@ GlyphAtlas::Type GlyphAtlas::GetType() const {
 }
 
 const std::shared_ptr<Texture>& GlyphAtlas::GetTexture() const {
-  return texture_;
+  return textures_.front();
 }
 
 void GlyphAtlas::SetTexture(std::shared_ptr<Texture> texture) {
-  texture_ = std::move(texture);
+  textures_.front() = std::move(texture);
+}
+
+const std::shared_ptr<Texture>& GlyphAtlas::GetTexture(size_t page) const {
+  FML_DCHECK(page < textures_.size());
+  return textures_[page];
+}
+
+void GlyphAtlas::SetTexture(size_t page, std::shared_ptr<Texture> texture) {
+  if (page >= textures_.size()) {
+    textures_.resize(page + 1);
+  }
+  textures_[page] = std::move(texture);
+}
+
+size_t GlyphAtlas::GetPageCount() const {
+  return textures_.size();
 }
 
 void GlyphAtlas::AddTypefaceGlyphPosition(const FontGlyphPair& pair,
-                                          Rect rect) {
-  font_atlas_map_[pair.scaled_font].positions_[pair.glyph] = rect;
+                                          Rect rect,
+                                          size_t page) {
+  font_atlas_map_[pair.scaled_font].positions_[pair.glyph] = {rect, page};
+}
+
+void GlyphAtlas::AddTypefaceGlyphSlot(const FontGlyphPair& pair,
+                                      const Slot& slot) {
+  font_atlas_map_[pair.scaled_font].positions_[pair.glyph] = slot;
+}
+
+const GlyphAtlas::Slot* GlyphAtlas::MarkFontGlyphUsed(const FontGlyphPair& pair,
+                                                      uint64_t frame) {
+  auto font_it = font_atlas_map_.find(pair.scaled_font);
+  if (font_it == font_atlas_map_.end()) {
+    return nullptr;
+  }
+  auto it = font_it->second.positions_.find(pair.glyph);
+  if (it == font_it->second.positions_.end()) {
+    return nullptr;
+  }
+  it->second.last_used_frame = frame;
+  return &it->second;
+}
+
+bool GlyphAtlas::RemoveFontGlyph(const FontGlyphPair& pair) {
+  auto font_it = font_atlas_map_.find(pair.scaled_font);
+  if (font_it == font_atlas_map_.end() ||
+      font_it->second.positions_.erase(pair.glyph) == 0u) {
+    return false;
+  }
+  if (font_it->second.positions_.empty()) {
+    font_atlas_map_.erase(font_it);
+  }
+  return true;
+}
+
+size_t GlyphAtlas::RemoveLastPage() {
+  FML_DCHECK(textures_.size() > 1u);
+  const size_t page = textures_.size() - 1u;
+  textures_.pop_back();
+  size_t count = 0u;
+  for (auto font_it = font_atlas_map_.begin();
+       font_it != font_atlas_map_.end();) {
+    auto& positions = font_it->second.positions_;
+    for (auto it = positions.begin(); it != positions.end();) {
+      if (it->second.page == page) {
+        it = positions.erase(it);
+        count++;
+      } else {
+        ++it;
+      }
+    }
+    if (positions.empty()) {
+      font_it = font_atlas_map_.erase(font_it);
+    } else {
+      ++font_it;
+    }
+  }
+  return count;
 }
 
 std::optional<Rect> GlyphAtlas::FindFontGlyphBounds(
@@ -72,6 +156,15 @@ std::optional<Rect> GlyphAtlas::FindFontGlyphBounds(
   return found->second.FindGlyphBounds(pair.glyph);
 }
 
+const GlyphAtlas::Slot* GlyphAtlas::FindFontGlyphSlot(
+    const FontGlyphPair& pair) const {
+  const auto& found = font_atlas_map_.find(pair.scaled_font);
+  if (found == font_atlas_map_.end()) {
+    return nullptr;
+  }
+  return found->second.FindGlyphSlot(pair.glyph);
+}
+
 const FontGlyphAtlas* GlyphAtlas::GetFontGlyphAtlas(const Font& font,
                                                     Scalar scale) const {
   const auto& found = font_atlas_map_.find({font, scale});
@@ -88,6 +181,17 @@ size_t GlyphAtlas::GetGlyphCount() const {
                          });
 }
 
+void GlyphAtlas::IterateGlyphSlots(
+    const std::function<void(const ScaledFont& scaled_font,
+                             const Glyph& glyph,
+                             const Slot& slot)>& iterator) const {
+  for (const auto& font_value : font_atlas_map_) {
+    for (const auto& glyph_value : font_value.second.positions_) {
+      iterator(font_value.first, glyph_value.first, glyph_value.second);
+    }
+  }
+}
+
 size_t GlyphAtlas::IterateGlyphs(
     const std::function<bool(const ScaledFont& scaled_font,
                              const Glyph& glyph,
@@ -100,7 +204,8 @@ size_t GlyphAtlas::IterateGlyphs(
   for (const auto& font_value : font_atlas_map_) {
     for (const auto& glyph_value : font_value.second.positions_) {
       count++;
-      if (!iterator(font_value.first, glyph_value.first, glyph_value.second)) {
+      if (!iterator(font_value.first, glyph_value.first,
+                    glyph_value.second.bounds)) {
         return count;
       }
     }
@@ -113,7 +218,16 @@ std::optional<Rect> FontGlyphAtlas::FindGlyphBounds(const Glyph& glyph) const {
   if (found == positions_.end()) {
     return std::nullopt;
   }
-  return found->second;
+  return found->second.bounds;
+}
+
+const GlyphAtlas::Slot* FontGlyphAtlas::FindGlyphSlot(
+    const Glyph& glyph) const {
+  const auto& found = positions_.find(glyph);
+  if (found == positions_.end()) {
+    return nullptr;
+  }
+  return &found->second;
 }
 
 }  // namespace impeller
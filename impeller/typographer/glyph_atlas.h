@@ -5,10 +5,12 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_GLYPH_ATLAS_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_GLYPH_ATLAS_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/core/texture.h"
@@ -22,12 +24,25 @@ namespace impeller {
 class FontGlyphAtlas;
 
 //------------------------------------------------------------------------------
-/// @brief      A texture containing the bitmap representation of glyphs in
-///             different fonts along with the ability to query the location of
-///             specific font glyphs within the texture.
+/// @brief      A set of textures (pages) containing the bitmap representation
+///             of glyphs in different fonts along with the ability to query
+///             the location of specific font glyphs within the textures.
 ///
 class GlyphAtlas {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief      The location of a glyph in the atlas.
+  ///
+  struct Slot {
+    /// The bounds of the glyph in the texture of its page.
+    Rect bounds;
+    /// The index of the page the glyph is in.
+    size_t page = 0u;
+    /// The last frame the glyph was used in, as numbered by the context that
+    /// maintains the atlas.
+    uint64_t last_used_frame = 0u;
+  };
+
   //----------------------------------------------------------------------------
   /// @brief      Describes how the glyphs are represented in the texture.
   enum class Type {
@@ -61,27 +76,93 @@ class GlyphAtlas {
   Type GetType() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Set the texture for the glyph atlas.
+  /// @brief      Set the texture for the first page of the glyph atlas.
   ///
   /// @param[in]  texture  The texture
   ///
   void SetTexture(std::shared_ptr<Texture> texture);
 
   //----------------------------------------------------------------------------
-  /// @brief      Get the texture for the glyph atlas.
+  /// @brief      Get the texture for the first page of the glyph atlas.
   ///
   /// @return     The texture.
   ///
   const std::shared_ptr<Texture>& GetTexture() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Set the texture for a page of the glyph atlas, adding pages
+  ///             up to it as needed.
+  ///
+  /// @param[in]  page     The index of the page
+  /// @param[in]  texture  The texture
+  ///
+  void SetTexture(size_t page, std::shared_ptr<Texture> texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture for a page of the glyph atlas.
+  ///
+  /// @param[in]  page  The index of the page, which must be less than
+  ///                   |GetPageCount|.
+  ///
+  /// @return     The texture.
+  ///
+  const std::shared_ptr<Texture>& GetTexture(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the number of pages, each with its own texture.
+  ///
+  size_t GetPageCount() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Record the location of a specific font-glyph pair within the
   ///             atlas.
   ///
   /// @param[in]  pair  The font-glyph pair
   /// @param[in]  rect  The rectangle
+  /// @param[in]  page  The page the rectangle is in
+  ///
+  void AddTypefaceGlyphPosition(const FontGlyphPair& pair,
+                                Rect rect,
+                                size_t page = 0u);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record the slot of a specific font-glyph pair within the
+  ///             atlas.
+  ///
+  /// @param[in]  pair  The font-glyph pair
+  /// @param[in]  slot  The slot
+  ///
+  void AddTypefaceGlyphSlot(const FontGlyphPair& pair, const Slot& slot);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find a specific font-glyph pair in the atlas and record that
+  ///             a frame uses it.
+  ///
+  /// @param[in]  pair   The font-glyph pair
+  /// @param[in]  frame  The frame
+  ///
+  /// @return     The slot of the font-glyph pair in the atlas, or nullptr if
+  ///             the pair is not in the atlas.
+  ///
+  const Slot* MarkFontGlyphUsed(const FontGlyphPair& pair, uint64_t frame);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the location of a specific font-glyph pair so that
+  ///             its slot can be filled with another glyph.
   ///
-  void AddTypefaceGlyphPosition(const FontGlyphPair& pair, Rect rect);
+  /// @param[in]  pair  The font-glyph pair
+  ///
+  /// @return     Whether the pair was in the atlas.
+  ///
+  bool RemoveFontGlyph(const FontGlyphPair& pair);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Remove the last page along with the glyphs in it. The atlas
+  ///             must have more than one page.
+  ///
+  /// @return     The number of glyphs removed.
+  ///
+  size_t RemoveLastPage();
 
   //----------------------------------------------------------------------------
   /// @brief      Get the number of unique font-glyph pairs in this atlas.
@@ -104,6 +185,17 @@ class GlyphAtlas {
                                const Glyph& glyph,
                                const Rect& rect)>& iterator) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Iterate of all the glyphs along with their slots in the
+  ///             atlas.
+  ///
+  /// @param[in]  iterator  The iterator.
+  ///
+  void IterateGlyphSlots(
+      const std::function<void(const ScaledFont& scaled_font,
+                               const Glyph& glyph,
+                               const Slot& slot)>& iterator) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Find the location of a specific font-glyph pair in the atlas.
   ///
@@ -114,6 +206,18 @@ class GlyphAtlas {
   ///
   std::optional<Rect> FindFontGlyphBounds(const FontGlyphPair& pair) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the location and page of a specific font-glyph pair in
+  ///             the atlas.
+  ///
+  /// @param[in]  pair  The font-glyph pair
+  ///
+  /// @return     The slot of the font-glyph pair in the atlas, or nullptr if
+  ///             the pair is not in the atlas. The pointer is only valid
+  ///             until the atlas is next modified.
+  ///
+  const Slot* FindFontGlyphSlot(const FontGlyphPair& pair) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Obtain an interface for querying the location of glyphs in the
   ///             atlas for the given font and scale.  This provides a more
@@ -130,7 +234,7 @@ class GlyphAtlas {
 
  private:
   const Type type_;
-  std::shared_ptr<Texture> texture_;
+  std::vector<std::shared_ptr<Texture>> textures_;
 
   std::unordered_map<ScaledFont, FontGlyphAtlas> font_atlas_map_;
 
@@ -144,6 +248,18 @@ class GlyphAtlas {
 ///
 class GlyphAtlasContext {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief      The work done by the last update of the glyph atlas.
+  ///
+  struct UpdateStats {
+    /// The number of glyphs drawn into the atlas.
+    size_t rasterized_glyph_count = 0u;
+    /// The number of bytes uploaded to the textures of the atlas.
+    size_t uploaded_byte_count = 0u;
+    /// The number of glyphs removed from the atlas to make room.
+    size_t evicted_glyph_count = 0u;
+  };
+
   virtual ~GlyphAtlasContext();
 
   //----------------------------------------------------------------------------
@@ -164,6 +280,12 @@ class GlyphAtlasContext {
 
   void UpdateRectPacker(std::shared_ptr<RectanglePacker> rect_packer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the work done by the last update of the atlas.
+  const UpdateStats& GetLastUpdateStats() const;
+
+  void SetLastUpdateStats(const UpdateStats& stats);
+
  protected:
   GlyphAtlasContext();
 
@@ -171,6 +293,7 @@ class GlyphAtlasContext {
   std::shared_ptr<GlyphAtlas> atlas_;
   ISize atlas_size_;
   std::shared_ptr<RectanglePacker> rect_packer_;
+  UpdateStats last_update_stats_;
 
   GlyphAtlasContext(const GlyphAtlasContext&) = delete;
 
@@ -195,9 +318,19 @@ class FontGlyphAtlas {
   ///
   std::optional<Rect> FindGlyphBounds(const Glyph& glyph) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the location and page of a glyph in the atlas.
+  ///
+  /// @param[in]  glyph The glyph
+  ///
+  /// @return     The slot of the glyph in the atlas, or nullptr if the glyph
+  ///             is not in the atlas.
+  ///
+  const GlyphAtlas::Slot* FindGlyphSlot(const Glyph& glyph) const;
+
  private:
   friend class GlyphAtlas;
-  std::unordered_map<Glyph, Rect> positions_;
+  std::unordered_map<Glyph, GlyphAtlas::Slot> positions_;
 
   FontGlyphAtlas(const FontGlyphAtlas&) = delete;
 
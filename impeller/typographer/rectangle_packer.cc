@@ -5,10 +5,96 @@
 #include "impeller/typographer/rectangle_packer.h"
 
 #include <algorithm>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace impeller {
 
+namespace {
+
+struct PackerRect {
+  int x_;
+  int y_;
+  int width_;
+  int height_;
+
+  int right() const { return x_ + width_; }
+  int bottom() const { return y_ + height_; }
+
+  int64_t area() const { return static_cast<int64_t>(width_) * height_; }
+
+  bool contains(const PackerRect& other) const {
+    return other.x_ >= x_ && other.y_ >= y_ && other.right() <= right() &&
+           other.bottom() <= bottom();
+  }
+
+  bool intersects(const PackerRect& other) const {
+    return other.x_ < right() && other.right() > x_ && other.y_ < bottom() &&
+           other.bottom() > y_;
+  }
+};
+
+// The area covered by the union of |rects|, found by sweeping the vertical
+// slabs between consecutive left and right edges.
+int64_t UnionArea(const std::vector<PackerRect>& rects) {
+  std::vector<int> xs;
+  xs.reserve(rects.size() * 2);
+  for (const PackerRect& rect : rects) {
+    xs.push_back(rect.x_);
+    xs.push_back(rect.right());
+  }
+  std::sort(xs.begin(), xs.end());
+  xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+  int64_t area = 0;
+  std::vector<std::pair<int, int>> spans;
+  for (size_t i = 0; i + 1 < xs.size(); ++i) {
+    spans.clear();
+    for (const PackerRect& rect : rects) {
+      if (rect.x_ <= xs[i] && rect.right() >= xs[i + 1]) {
+        spans.emplace_back(rect.y_, rect.bottom());
+      }
+    }
+    std::sort(spans.begin(), spans.end());
+    int64_t covered = 0;
+    int top = std::numeric_limits<int>::min();
+    int bottom = std::numeric_limits<int>::min();
+    for (const auto& span : spans) {
+      if (span.first > bottom) {
+        covered += bottom - top;
+        top = span.first;
+        bottom = span.second;
+      } else {
+        bottom = std::max(bottom, span.second);
+      }
+    }
+    covered += bottom - top;
+    area += covered * (xs[i + 1] - xs[i]);
+  }
+  return area;
+}
+
+RectanglePacker::Stats MakeStats(size_t rect_count,
+                                 int64_t total_area,
+                                 int64_t used_area,
+                                 int64_t wasted_area,
+                                 int64_t largest_free_area) {
+  RectanglePacker::Stats stats;
+  stats.rect_count = rect_count;
+  stats.used_area = used_area;
+  stats.wasted_area = wasted_area;
+  stats.largest_free_area = largest_free_area;
+  int64_t free_area = total_area - used_area - wasted_area;
+  if (free_area > 0) {
+    stats.fragmentation =
+        1.0f - static_cast<float>(largest_free_area) / free_area;
+  }
+  return stats;
+}
+
+}  // namespace
+
 // Pack rectangles and track the current silhouette
 // Based, in part, on Jukka Jylanki's work at http://clb.demon.fi
 // and ported from Skia's implementation
@@ -23,6 +109,7 @@ class SkylineRectanglePacker final : public RectanglePacker {
 
   void reset() final {
     area_so_far_ = 0;
+    rect_count_ = 0;
     skyline_.clear();
     skyline_.push_back(SkylineSegment{0, 0, this->width()});
   }
@@ -33,6 +120,8 @@ class SkylineRectanglePacker final : public RectanglePacker {
     return area_so_far_ / ((float)this->width() * this->height());
   }
 
+  Stats getStats() const final;
+
  private:
   struct SkylineSegment {
     int x_;
@@ -43,6 +132,7 @@ class SkylineRectanglePacker final : public RectanglePacker {
   std::vector<SkylineSegment> skyline_;
 
   int32_t area_so_far_;
+  size_t rect_count_;
 
   // Can a width x height rectangle fit in the free space represented by
   // the skyline segments >= 'skylineIndex'? If so, return true and fill in
@@ -85,6 +175,7 @@ bool SkylineRectanglePacker::addRect(int width, int height, IPoint16* loc) {
     loc->y_ = bestY;
 
     area_so_far_ += width * height;
+    rect_count_++;
     return true;
   }
 
@@ -160,14 +251,284 @@ void SkylineRectanglePacker::addSkylineLevel(int skylineIndex,
   for (int i = 0; i < ((int)skyline_.size()) - 1; ++i) {
     if (skyline_[i].y_ == skyline_[i + 1].y_) {
       skyline_[i].width_ += skyline_[i + 1].width_;
-      skyline_.erase(std::next(skyline_.begin(), i));
+      skyline_.erase(std::next(skyline_.begin(), i + 1));
       --i;
     }
   }
 }
 
+RectanglePacker::Stats SkylineRectanglePacker::getStats() const {
+  // Everything below the skyline that is not covered by a rectangle can no
+  // longer be reached.
+  int64_t below_skyline = 0;
+  for (const SkylineSegment& segment : skyline_) {
+    below_skyline += static_cast<int64_t>(segment.width_) * segment.y_;
+  }
+
+  // The largest free rectangle sits on top of a run of segments, as high as
+  // the highest of them allows.
+  int64_t largest_free_area = 0;
+  for (size_t i = 0; i < skyline_.size(); ++i) {
+    int y = 0;
+    int width = 0;
+    for (size_t j = i; j < skyline_.size(); ++j) {
+      y = std::max(y, skyline_[j].y_);
+      width += skyline_[j].width_;
+      largest_free_area = std::max(
+          largest_free_area, static_cast<int64_t>(width) * (height() - y));
+    }
+  }
+
+  return MakeStats(rect_count_,
+                   static_cast<int64_t>(width()) * height(),  //
+                   area_so_far_,                              //
+                   below_skyline - area_so_far_,              //
+                   largest_free_area);
+}
+
 RectanglePacker* RectanglePacker::Factory(int width, int height) {
   return new SkylineRectanglePacker(width, height);
 }
 
+// Pack rectangles and track every maximal free rectangle of the area. Each
+// rectangle goes where it leaves the shortest leftover side (Best Short Side
+// Fit). Based on Jukka Jylanki's "A Thousand Ways to Pack the Bin".
+class MaxRectsRectanglePacker final : public RectanglePacker {
+ public:
+  MaxRectsRectanglePacker(int w, int h) : RectanglePacker(w, h) {
+    this->reset();
+  }
+
+  ~MaxRectsRectanglePacker() final {}
+
+  void reset() final {
+    area_so_far_ = 0;
+    rect_count_ = 0;
+    min_width_ = std::numeric_limits<int>::max();
+    min_height_ = std::numeric_limits<int>::max();
+    free_rects_.clear();
+    free_rects_.push_back(PackerRect{0, 0, this->width(), this->height()});
+  }
+
+  bool addRect(int w, int h, IPoint16* loc) final;
+
+  bool removeRect(int x, int y, int w, int h) final;
+
+  float percentFull() const final {
+    return area_so_far_ / ((float)this->width() * this->height());
+  }
+
+  Stats getStats() const final;
+
+ private:
+  // Free rectangles. They may overlap each other but never a placed
+  // rectangle, and none is contained in another.
+  std::vector<PackerRect> free_rects_;
+
+  int64_t area_so_far_;
+  size_t rect_count_;
+
+  // The smallest width and height added since the last reset. Free space
+  // that cannot hold a rectangle this size is counted as wasted.
+  int min_width_;
+  int min_height_;
+
+  // Replace every free rectangle that overlaps |used| with the up to four
+  // maximal rectangles that remain around it. The new rectangles are
+  // appended after the untouched ones, whose count is returned.
+  size_t splitFreeRects(const PackerRect& used);
+  // Join pairs of free rectangles that share a whole edge, which is how
+  // space that was freed by |removeRect| grows back to its neighbours.
+  void mergeFreeRects();
+  // Remove free rectangles that are contained in another one. Only the ones
+  // from |first_new| on are checked, so those before it must not be
+  // contained in any other.
+  void pruneFreeRects(size_t first_new = 0);
+};
+
+bool MaxRectsRectanglePacker::addRect(int width, int height, IPoint16* loc) {
+  if (width <= 0 || height <= 0 || width > this->width() ||
+      height > this->height()) {
+    loc->x_ = 0;
+    loc->y_ = 0;
+    return false;
+  }
+
+  // find the free rectangle that fits most snugly
+  int bestShortSide = std::numeric_limits<int>::max();
+  int bestLongSide = std::numeric_limits<int>::max();
+  int bestIndex = -1;
+  for (int i = 0; i < (int)free_rects_.size(); ++i) {
+    const PackerRect& free_rect = free_rects_[i];
+    if (free_rect.width_ < width || free_rect.height_ < height) {
+      continue;
+    }
+    int leftoverX = free_rect.width_ - width;
+    int leftoverY = free_rect.height_ - height;
+    int shortSide = std::min(leftoverX, leftoverY);
+    int longSide = std::max(leftoverX, leftoverY);
+    if (shortSide < bestShortSide ||
+        (shortSide == bestShortSide && longSide < bestLongSide)) {
+      bestIndex = i;
+      bestShortSide = shortSide;
+      bestLongSide = longSide;
+    }
+  }
+
+  if (-1 == bestIndex) {
+    loc->x_ = 0;
+    loc->y_ = 0;
+    return false;
+  }
+
+  PackerRect used{free_rects_[bestIndex].x_, free_rects_[bestIndex].y_, width,
+                  height};
+  // The untouched free rectangles did not contain each other before and
+  // cannot be contained in the pieces of the split ones, so only the pieces
+  // need to be pruned.
+  this->pruneFreeRects(this->splitFreeRects(used));
+
+  loc->x_ = used.x_;
+  loc->y_ = used.y_;
+  area_so_far_ += used.area();
+  rect_count_++;
+  min_width_ = std::min(min_width_, width);
+  min_height_ = std::min(min_height_, height);
+  return true;
+}
+
+bool MaxRectsRectanglePacker::removeRect(int x, int y, int width, int height) {
+  PackerRect freed{x, y, width, height};
+  if (width <= 0 || height <= 0 || x < 0 || y < 0 ||
+      freed.right() > this->width() || freed.bottom() > this->height() ||
+      rect_count_ == 0 || area_so_far_ < freed.area()) {
+    return false;
+  }
+  // Free rectangles never overlap a placed rectangle, so a rectangle that
+  // overlaps one was already freed, in whole or in part.
+  for (const PackerRect& free_rect : free_rects_) {
+    if (free_rect.intersects(freed)) {
+      return false;
+    }
+  }
+
+  free_rects_.push_back(freed);
+  this->mergeFreeRects();
+  this->pruneFreeRects();
+
+  area_so_far_ -= freed.area();
+  rect_count_--;
+  if (rect_count_ == 0) {
+    this->reset();
+  }
+  return true;
+}
+
+size_t MaxRectsRectanglePacker::splitFreeRects(const PackerRect& used) {
+  size_t count = free_rects_.size();
+  for (size_t i = 0; i < count;) {
+    PackerRect free_rect = free_rects_[i];
+    if (!free_rect.intersects(used)) {
+      ++i;
+      continue;
+    }
+
+    // split into the free space left, right, above and below |used|
+    if (used.x_ > free_rect.x_) {
+      free_rects_.push_back(PackerRect{free_rect.x_, free_rect.y_,
+                                       used.x_ - free_rect.x_,
+                                       free_rect.height_});
+    }
+    if (used.right() < free_rect.right()) {
+      free_rects_.push_back(PackerRect{used.right(), free_rect.y_,
+                                       free_rect.right() - used.right(),
+                                       free_rect.height_});
+    }
+    if (used.y_ > free_rect.y_) {
+      free_rects_.push_back(PackerRect{free_rect.x_, free_rect.y_,
+                                       free_rect.width_,
+                                       used.y_ - free_rect.y_});
+    }
+    if (used.bottom() < free_rect.bottom()) {
+      free_rects_.push_back(PackerRect{free_rect.x_, used.bottom(),
+                                       free_rect.width_,
+                                       free_rect.bottom() - used.bottom()});
+    }
+
+    // remove the split rectangle, keeping the unvisited ones in front
+    free_rects_[i] = free_rects_[count - 1];
+    free_rects_.erase(std::next(free_rects_.begin(), count - 1));
+    --count;
+  }
+  return count;
+}
+
+void MaxRectsRectanglePacker::mergeFreeRects() {
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < free_rects_.size() && !merged; ++i) {
+      for (size_t j = i + 1; j < free_rects_.size(); ++j) {
+        PackerRect& a = free_rects_[i];
+        const PackerRect& b = free_rects_[j];
+        if (a.y_ == b.y_ && a.height_ == b.height_ &&
+            (a.right() == b.x_ || b.right() == a.x_)) {
+          a.x_ = std::min(a.x_, b.x_);
+          a.width_ += b.width_;
+        } else if (a.x_ == b.x_ && a.width_ == b.width_ &&
+                   (a.bottom() == b.y_ || b.bottom() == a.y_)) {
+          a.y_ = std::min(a.y_, b.y_);
+          a.height_ += b.height_;
+        } else {
+          continue;
+        }
+        free_rects_.erase(std::next(free_rects_.begin(), j));
+        merged = true;
+        break;
+      }
+    }
+  }
+}
+
+void MaxRectsRectanglePacker::pruneFreeRects(size_t first_new) {
+  for (size_t i = first_new; i < free_rects_.size();) {
+    bool contained = false;
+    for (size_t j = 0; j < free_rects_.size() && !contained; ++j) {
+      contained = j != i && free_rects_[j].contains(free_rects_[i]);
+    }
+    if (!contained) {
+      ++i;
+      continue;
+    }
+    // only rectangles at or after |first_new| are ever moved
+    free_rects_[i] = free_rects_.back();
+    free_rects_.pop_back();
+  }
+}
+
+RectanglePacker::Stats MaxRectsRectanglePacker::getStats() const {
+  int64_t total_area = static_cast<int64_t>(width()) * height();
+  if (rect_count_ == 0) {
+    return MakeStats(0, total_area, 0, 0, total_area);
+  }
+
+  // Free space that cannot hold the smallest rectangle added so far is
+  // wasted.
+  std::vector<PackerRect> usable;
+  int64_t largest_free_area = 0;
+  for (const PackerRect& free_rect : free_rects_) {
+    if (free_rect.width_ >= min_width_ && free_rect.height_ >= min_height_) {
+      usable.push_back(free_rect);
+      largest_free_area = std::max(largest_free_area, free_rect.area());
+    }
+  }
+  return MakeStats(rect_count_, total_area, area_so_far_,
+                   total_area - area_so_far_ - UnionArea(usable),
+                   largest_free_area);
+}
+
+RectanglePacker* RectanglePacker::MaxRectsFactory(int width, int height) {
+  return new MaxRectsRectanglePacker(width, height);
+}
+
 }  // namespace impeller
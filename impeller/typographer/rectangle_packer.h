@@ -7,6 +7,7 @@
 
 #include "flutter/fml/logging.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace impeller {
@@ -24,11 +25,42 @@ struct IPoint16 {
 ///
 class RectanglePacker {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief     How well the packer is using its area.
+  ///
+  struct Stats {
+    /// The number of rectangles in the packer.
+    size_t rect_count = 0;
+    /// The area covered by rectangles.
+    int64_t used_area = 0;
+    /// The area that is not covered by rectangles but that no rectangle can
+    /// be placed in anymore.
+    int64_t wasted_area = 0;
+    /// The area of the largest rectangle that can still be added.
+    int64_t largest_free_area = 0;
+    /// How much of the area that can still be filled is not part of the
+    /// largest free rectangle, as a decimal between 0.0 and 1.0.
+    float fragmentation = 0.0f;
+  };
+
   //----------------------------------------------------------------------------
   /// @brief     Return an empty packer with area specified by width and height.
   ///
+  ///            The packer tracks a skyline of the placed rectangles, which is
+  ///            fast but cannot free rectangles.
+  ///
   static RectanglePacker* Factory(int width, int height);
 
+  //----------------------------------------------------------------------------
+  /// @brief     Return an empty packer with area specified by width and height
+  ///            that tracks the maximal free rectangles of its area.
+  ///
+  ///            This packs rectangles of mixed sizes more densely than
+  ///            |Factory| and can free rectangles, at a higher cost per
+  ///            rectangle.
+  ///
+  static RectanglePacker* MaxRectsFactory(int width, int height);
+
   virtual ~RectanglePacker() {}
 
   //----------------------------------------------------------------------------
@@ -43,6 +75,23 @@ class RectanglePacker {
   ///
   virtual bool addRect(int width, int height, IPoint16* loc) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief     Free the area of a rectangle that was added, so that it can
+  ///            be used by rectangles that are added later. The glyph atlas
+  ///            frees the cells of the glyphs it evicts this way.
+  ///
+  /// @param[in]  x       The x position returned by |addRect|.
+  /// @param[in]  y       The y position returned by |addRect|.
+  /// @param[in]  width   The width the rectangle was added with.
+  /// @param[in]  height  The height the rectangle was added with.
+  ///
+  /// @return     Return true on success; false if the packer cannot free
+  ///             rectangles.
+  ///
+  virtual bool removeRect(int x, int y, int width, int height) {
+    return false;
+  }
+
   //----------------------------------------------------------------------------
   /// @brief     Returns how much area has been filled with rectangles.
   ///
@@ -50,6 +99,11 @@ class RectanglePacker {
   ///
   virtual float percentFull() const = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief     Returns the occupancy, waste and fragmentation of the area.
+  ///
+  virtual Stats getStats() const = 0;
+
   //----------------------------------------------------------------------------
   /// @brief     Empty out all previously added rectangles.
   ///
@@ -0,0 +1,221 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/capabilities.h"
+#include "impeller/renderer/testing/mocks.h"
+#include "impeller/typographer/backends/skia/text_frame_skia.h"
+#include "impeller/typographer/backends/skia/typographer_context_skia.h"
+#include "impeller/typographer/rectangle_packer.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace impeller {
+namespace testing {
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+namespace {
+
+// A context whose textures accept any contents, so that the benchmark
+// measures the placement and rasterization of the glyphs rather than a GPU.
+class BenchmarkContext {
+ public:
+  BenchmarkContext()
+      : allocator_(std::make_shared<NiceMock<MockAllocator>>()),
+        capabilities_(CapabilitiesBuilder()
+                          .SetSupportsBufferToTextureBlits(false)
+                          .Build()) {
+    ON_CALL(*allocator_, GetMaxTextureSizeSupported)
+        .WillByDefault(Return(ISize(4096, 4096)));
+    ON_CALL(*allocator_, OnCreateTexture)
+        .WillByDefault([](const TextureDescriptor& desc) {
+          auto texture = std::make_shared<NiceMock<MockTexture>>(desc);
+          ON_CALL(*texture, IsValid).WillByDefault(Return(true));
+          ON_CALL(*texture, GetSize).WillByDefault(Return(desc.size));
+          ON_CALL(*texture, OnSetContents(_, _)).WillByDefault(Return(true));
+          return texture;
+        });
+    ON_CALL(context_, GetResourceAllocator)
+        .WillByDefault(Return(allocator_));
+    ON_CALL(context_, GetCapabilities)
+        .WillByDefault(ReturnRef(capabilities_));
+  }
+
+  Context& Get() { return context_; }
+
+ private:
+  std::shared_ptr<NiceMock<MockAllocator>> allocator_;
+  std::shared_ptr<const Capabilities> capabilities_;
+  NiceMock<MockImpellerContext> context_;
+};
+
+FontGlyphMap CollectGlyphs(size_t scale_count) {
+  const char* test_string =
+      "QWERTYUIOPASDFGHJKLZXCVBNMqewrtyuiopasdfghjklzxcvbnm,.<>[]{};':"
+      "2134567890-=!@#$%^&*()_+";
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(24);
+  auto blob = SkTextBlob::MakeFromString(test_string, sk_font);
+  auto frame = MakeTextFrameFromTextBlobSkia(blob);
+
+  FontGlyphMap font_glyph_map;
+  for (size_t i = 0; i < scale_count; i++) {
+    frame->CollectUniqueFontGlyphPairs(font_glyph_map, 1.0 + 0.25 * i);
+  }
+  return font_glyph_map;
+}
+
+// The text that |BM_PackGlyphs| collects glyphs from, as a paragraph of
+// mixed case Latin text would use them.
+constexpr const char* kPackingCorpus =
+    "This is a very long sentence to test if the text will properly wrap "
+    "around and go to the next line. Sometimes, short sentence. Longer "
+    "sentences are okay too because they are necessary. Very short. "
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+    "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+    "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+    "commodo consequat. 0123456789 !@#$%^&*()_+-=[]{};':\",./<>?";
+
+// The padded sizes of the unique glyphs of |kPackingCorpus| in |font_fixture|
+// at a spread of font sizes, in the order they are first seen.
+std::vector<ISize> CollectGlyphSizes(const char* font_fixture) {
+  auto mapping = flutter::testing::OpenFixtureAsSkData(font_fixture);
+  if (!mapping) {
+    return {};
+  }
+  sk_sp<SkTypeface> typeface =
+      SkFontMgr::RefDefault()->makeFromData(std::move(mapping));
+
+  std::vector<ISize> sizes;
+  for (SkScalar font_size : {12.0f, 14.0f, 17.0f, 24.0f, 32.0f, 48.0f}) {
+    SkFont font(typeface, font_size);
+    size_t length = strlen(kPackingCorpus);
+    std::vector<SkGlyphID> glyphs(length);
+    int glyph_count = font.textToGlyphs(kPackingCorpus, length,
+                                        SkTextEncoding::kUTF8, glyphs.data(),
+                                        glyphs.size());
+    std::sort(glyphs.begin(), glyphs.begin() + glyph_count);
+    glyph_count = std::unique(glyphs.begin(), glyphs.begin() + glyph_count) -
+                  glyphs.begin();
+    std::vector<SkRect> bounds(glyph_count);
+    font.getBounds(glyphs.data(), glyph_count, bounds.data(), nullptr);
+    for (const SkRect& rect : bounds) {
+      SkIRect rounded = rect.roundOut();
+      if (!rounded.isEmpty()) {
+        sizes.emplace_back(rounded.width() + 2, rounded.height() + 2);
+      }
+    }
+  }
+  return sizes;
+}
+
+// Packs all of |sizes| into the smallest atlas that holds them, growing it
+// the same way the STB typographer does, and returns the final packer.
+std::unique_ptr<RectanglePacker> PackAll(
+    RectanglePacker* (*factory)(int, int),
+    const std::vector<ISize>& sizes,
+    ISize& atlas_size) {
+  atlas_size = ISize(64, 64);
+  while (true) {
+    std::unique_ptr<RectanglePacker> packer(
+        factory(atlas_size.width, atlas_size.height));
+    bool fits = true;
+    for (const ISize& size : sizes) {
+      IPoint16 location;
+      if (!packer->addRect(size.width, size.height, &location)) {
+        fits = false;
+        break;
+      }
+    }
+    if (fits) {
+      return packer;
+    }
+    if (atlas_size.width > atlas_size.height) {
+      atlas_size.height *= 2;
+    } else {
+      atlas_size.width *= 2;
+    }
+  }
+}
+
+}  // namespace
+
+// Packs the glyphs of a paragraph in a real font into the smallest atlas
+// that holds them, with the skyline (0) or MaxRects (1) packer.
+static void BM_PackGlyphs(benchmark::State& state, const char* font_fixture) {
+  auto factory = state.range(0) == 0 ? &RectanglePacker::Factory
+                                     : &RectanglePacker::MaxRectsFactory;
+  std::vector<ISize> sizes = CollectGlyphSizes(font_fixture);
+  if (sizes.empty()) {
+    state.SkipWithError("Could not load the font.");
+    return;
+  }
+
+  ISize atlas_size;
+  std::unique_ptr<RectanglePacker> packer;
+  for (auto _ : state) {
+    packer = PackAll(factory, sizes, atlas_size);
+  }
+  RectanglePacker::Stats stats = packer->getStats();
+  state.counters["Glyphs"] = stats.rect_count;
+  state.counters["AtlasArea"] = atlas_size.Area();
+  state.counters["PercentFull"] = packer->percentFull() * 100;
+  state.counters["WastedArea"] = stats.wasted_area;
+  state.counters["Fragmentation"] = stats.fragmentation;
+}
+
+BENCHMARK_CAPTURE(BM_PackGlyphs, roboto, "Roboto-Regular.ttf")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PackGlyphs, homemade_apple, "HomemadeApple.ttf")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+// Builds a glyph atlas from scratch with the given number of workers, or on
+// the calling thread if there are none.
+static void BM_ColdGlyphAtlas(benchmark::State& state) {
+  size_t worker_count = state.range(0);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  if (worker_count > 0) {
+    loop = fml::ConcurrentMessageLoop::Create(worker_count);
+  }
+  auto typographer_context =
+      TypographerContextSkia::Make(loop ? loop->GetTaskRunner() : nullptr);
+  BenchmarkContext context;
+  FontGlyphMap font_glyph_map = CollectGlyphs(8);
+
+  size_t glyph_count = 0;
+  for (auto _ : state) {
+    auto atlas_context = typographer_context->CreateGlyphAtlasContext();
+    auto atlas = typographer_context->CreateGlyphAtlas(
+        context.Get(), GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+        font_glyph_map);
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      break;
+    }
+    glyph_count = atlas->GetGlyphCount();
+  }
+  state.counters["Glyphs"] = glyph_count;
+}
+
+BENCHMARK(BM_ColdGlyphAtlas)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace testing
+}  // namespace impeller
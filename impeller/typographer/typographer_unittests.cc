@@ -5,6 +5,7 @@
 #include "flutter/display_list/testing/dl_test_snippets.h"
 #include "flutter/testing/testing.h"
 #include "impeller/playground/playground_test.h"
+#include "impeller/typographer/backends/skia/glyph_atlas_context_skia.h"
 #include "impeller/typographer/backends/skia/text_frame_skia.h"
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 #include "impeller/typographer/lazy_glyph_atlas.h"
@@ -338,6 +339,114 @@ TEST_P(TypographerTest, RectanglePackerAddsNonoverlapingRectangles) {
   ASSERT_EQ(packer->percentFull(), 0);
 }
 
+TEST_P(TypographerTest, MaxRectsPackerAddsNonoverlapingRectangles) {
+  auto packer = std::unique_ptr<RectanglePacker>(
+      RectanglePacker::MaxRectsFactory(200, 100));
+  ASSERT_NE(packer, nullptr);
+  ASSERT_EQ(packer->percentFull(), 0);
+
+  const SkIRect packer_area = SkIRect::MakeXYWH(0, 0, 200, 100);
+
+  std::vector<SkIRect> rects;
+  for (int i = 0; i < 20; i++) {
+    int width = 10 + (i % 4) * 5;
+    int height = 10 + (i % 3) * 7;
+    IPoint16 output = {-1, -1};
+    ASSERT_TRUE(packer->addRect(width, height, &output));
+    SkIRect rect = SkIRect::MakeXYWH(output.x(), output.y(), width, height);
+    ASSERT_TRUE(packer_area.contains(rect));
+    for (const SkIRect& other : rects) {
+      ASSERT_FALSE(SkIRect::Intersects(rect, other));
+    }
+    rects.push_back(rect);
+  }
+
+  IPoint16 output;
+  ASSERT_FALSE(packer->addRect(201, 10, &output));
+  ASSERT_FALSE(packer->addRect(10, 101, &output));
+
+  packer->reset();
+  ASSERT_EQ(packer->percentFull(), 0);
+}
+
+TEST_P(TypographerTest, MaxRectsPackerReusesRemovedRectangles) {
+  auto packer = std::unique_ptr<RectanglePacker>(
+      RectanglePacker::MaxRectsFactory(100, 100));
+
+  // Fill the area with four quadrants.
+  std::array<IPoint16, 4> locations;
+  for (IPoint16& location : locations) {
+    ASSERT_TRUE(packer->addRect(50, 50, &location));
+  }
+  ASSERT_TRUE(flutter::testing::NumberNear(packer->percentFull(), 1.0));
+  IPoint16 output;
+  ASSERT_FALSE(packer->addRect(50, 50, &output));
+
+  // Freeing two quadrants next to each other makes room for a rectangle that
+  // spans both of them.
+  std::sort(locations.begin(), locations.end(),
+            [](const IPoint16& a, const IPoint16& b) {
+              return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+            });
+  ASSERT_TRUE(packer->removeRect(locations[0].x(), locations[0].y(), 50, 50));
+  ASSERT_TRUE(packer->removeRect(locations[1].x(), locations[1].y(), 50, 50));
+  ASSERT_TRUE(flutter::testing::NumberNear(packer->percentFull(), 0.5));
+
+  // Freeing space that is already free, in whole or in part, is rejected.
+  ASSERT_FALSE(packer->removeRect(locations[0].x(), locations[0].y(), 50, 50));
+  ASSERT_FALSE(packer->removeRect(25, 25, 50, 50));
+  ASSERT_TRUE(flutter::testing::NumberNear(packer->percentFull(), 0.5));
+
+  ASSERT_TRUE(packer->addRect(100, 50, &output));
+  ASSERT_EQ(output.x(), 0);
+  ASSERT_EQ(output.y(), 0);
+  ASSERT_TRUE(flutter::testing::NumberNear(packer->percentFull(), 1.0));
+
+  // The skyline packer cannot free rectangles.
+  auto skyline =
+      std::unique_ptr<RectanglePacker>(RectanglePacker::Factory(100, 100));
+  ASSERT_TRUE(skyline->addRect(50, 50, &output));
+  ASSERT_FALSE(skyline->removeRect(output.x(), output.y(), 50, 50));
+}
+
+TEST_P(TypographerTest, RectanglePackersReportWasteAndFragmentation) {
+  for (auto factory :
+       {&RectanglePacker::Factory, &RectanglePacker::MaxRectsFactory}) {
+    auto packer = std::unique_ptr<RectanglePacker>(factory(100, 100));
+
+    RectanglePacker::Stats stats = packer->getStats();
+    ASSERT_EQ(stats.rect_count, 0u);
+    ASSERT_EQ(stats.used_area, 0);
+    ASSERT_EQ(stats.wasted_area, 0);
+    ASSERT_EQ(stats.largest_free_area, 100 * 100);
+    ASSERT_EQ(stats.fragmentation, 0);
+
+    // Two rectangles of different heights side by side leave a free area of
+    // 8_500 units, of which the largest free rectangle is 100 x 80 = 8_000.
+    IPoint16 output;
+    ASSERT_TRUE(packer->addRect(50, 20, &output));
+    ASSERT_TRUE(packer->addRect(50, 10, &output));
+
+    stats = packer->getStats();
+    ASSERT_EQ(stats.rect_count, 2u);
+    ASSERT_EQ(stats.used_area, 1500);
+    ASSERT_EQ(stats.wasted_area, 0);
+    ASSERT_EQ(stats.largest_free_area, 8000);
+    ASSERT_TRUE(
+        flutter::testing::NumberNear(stats.fragmentation, 1.0 - 8000 / 8500.0));
+  }
+
+  // A rectangle that spans both skyline segments leaves a 10 x 10 hole below
+  // it that the skyline can no longer reach.
+  auto skyline =
+      std::unique_ptr<RectanglePacker>(RectanglePacker::Factory(100, 100));
+  IPoint16 output;
+  ASSERT_TRUE(skyline->addRect(50, 20, &output));
+  ASSERT_TRUE(skyline->addRect(50, 10, &output));
+  ASSERT_TRUE(skyline->addRect(60, 10, &output));
+  ASSERT_EQ(skyline->getStats().wasted_area, 100);
+}
+
 TEST_P(TypographerTest, GlyphAtlasTextureIsRecycledWhenContentsAreRecreated) {
   auto context = TypographerContextSkia::Make();
   auto atlas_context = context->CreateGlyphAtlasContext();
@@ -357,21 +466,196 @@ TEST_P(TypographerTest, GlyphAtlasTextureIsRecycledWhenContentsAreRecreated) {
 
   auto* first_texture = atlas->GetTexture().get();
 
-  // Now create a new glyph atlas with a completely different textblob.
-  // everything should be different except for the underlying atlas texture.
+  // Now update the glyph atlas with a mostly different textblob. The new
+  // glyphs replace the ones that are not used anymore in the same pages.
 
   auto blob2 = SkTextBlob::MakeFromString("abcdefghijklmnopqrstuvwxyz123456789",
                                           sk_font);
   auto next_atlas = CreateGlyphAtlas(
       *GetContext(), context.get(), GlyphAtlas::Type::kColorBitmap, 32.0f,
       atlas_context, *MakeTextFrameFromTextBlobSkia(blob2));
-  ASSERT_NE(atlas, next_atlas);
+  ASSERT_EQ(atlas, next_atlas);
   auto* second_texture = next_atlas->GetTexture().get();
 
   auto new_packer = atlas_context->GetRectPacker();
 
   ASSERT_EQ(second_texture, first_texture);
-  ASSERT_NE(old_packer, new_packer);
+  ASSERT_EQ(old_packer, new_packer);
+  EXPECT_GT(atlas_context->GetLastUpdateStats().evicted_glyph_count, 0u);
+}
+
+TEST_P(TypographerTest, GlyphAtlasOnlyRasterizesAndUploadsNewGlyphs) {
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context = context->CreateGlyphAtlasContext();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(12);
+
+  // "spooky 1" has 7 unique glyphs.
+  auto blob = SkTextBlob::MakeFromString("spooky 1", sk_font);
+  auto atlas = CreateGlyphAtlas(
+      *GetContext(), context.get(), GlyphAtlas::Type::kAlphaBitmap, 1.0f,
+      atlas_context, *MakeTextFrameFromTextBlobSkia(blob));
+  ASSERT_NE(atlas, nullptr);
+  size_t page_byte_size =
+      atlas->GetTexture()->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().rasterized_glyph_count, 7u);
+  EXPECT_GT(atlas_context->GetLastUpdateStats().uploaded_byte_count, 0u);
+
+  // The same glyphs in the next frame need no work at all.
+  atlas = CreateGlyphAtlas(*GetContext(), context.get(),
+                           GlyphAtlas::Type::kAlphaBitmap, 1.0f, atlas_context,
+                           *MakeTextFrameFromTextBlobSkia(blob));
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().rasterized_glyph_count, 0u);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().uploaded_byte_count, 0u);
+
+  // A single new glyph is the only one drawn and uploaded.
+  auto blob2 = SkTextBlob::MakeFromString("spooky 2", sk_font);
+  atlas = CreateGlyphAtlas(*GetContext(), context.get(),
+                           GlyphAtlas::Type::kAlphaBitmap, 1.0f, atlas_context,
+                           *MakeTextFrameFromTextBlobSkia(blob2));
+  ASSERT_NE(atlas, nullptr);
+  EXPECT_EQ(atlas->GetGlyphCount(), 8u);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().rasterized_glyph_count, 1u);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().evicted_glyph_count, 0u);
+  if (GetContext()->GetCapabilities()->SupportsBufferToTextureBlits()) {
+    EXPECT_GT(atlas_context->GetLastUpdateStats().uploaded_byte_count, 0u);
+    EXPECT_LT(atlas_context->GetLastUpdateStats().uploaded_byte_count,
+              page_byte_size);
+  } else {
+    EXPECT_EQ(atlas_context->GetLastUpdateStats().uploaded_byte_count,
+              page_byte_size);
+  }
+}
+
+static FontGlyphMap CollectFontGlyphs(const sk_sp<SkTextBlob>& blob,
+                                      Scalar scale) {
+  FontGlyphMap font_glyph_map;
+  MakeTextFrameFromTextBlobSkia(blob)->CollectUniqueFontGlyphPairs(
+      font_glyph_map, scale);
+  return font_glyph_map;
+}
+
+TEST_P(TypographerTest, GlyphAtlasEvictsLeastRecentlyUsedGlyphs) {
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context = context->CreateGlyphAtlasContext();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(12);
+  FontGlyphMap upper_glyphs = CollectFontGlyphs(
+      SkTextBlob::MakeFromString("ABCDEFGHIJKLMNOPQRSTUVWXYZ", sk_font), 48.0f);
+  FontGlyphMap lower_glyphs = CollectFontGlyphs(
+      SkTextBlob::MakeFromString("abcdefghij", sk_font), 48.0f);
+
+  // Glyphs this large fill more pages than the atlas keeps.
+  auto atlas = context->CreateGlyphAtlas(
+      *GetContext(), GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+      upper_glyphs);
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_GT(atlas->GetPageCount(), 4u);
+
+  // A frame that uses only the glyphs of the first page makes them the most
+  // recently used ones.
+  FontGlyphMap recent_glyphs;
+  FontGlyphMap older_glyphs;
+  for (const auto& [scaled_font, glyphs] : upper_glyphs) {
+    for (const Glyph& glyph : glyphs) {
+      const GlyphAtlas::Slot* slot =
+          atlas->FindFontGlyphSlot({scaled_font, glyph});
+      ASSERT_NE(slot, nullptr);
+      (slot->page == 0u ? recent_glyphs : older_glyphs)[scaled_font].insert(
+          glyph);
+    }
+  }
+  ASSERT_FALSE(recent_glyphs.empty());
+  atlas = context->CreateGlyphAtlas(*GetContext(),
+                                    GlyphAtlas::Type::kAlphaBitmap,
+                                    atlas_context, recent_glyphs);
+  ASSERT_NE(atlas, nullptr);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().rasterized_glyph_count, 0u);
+
+  // New glyphs drop the pages past the limit and take the cells of the
+  // least recently used glyphs, which keeps the recent ones while any older
+  // one is left.
+  atlas = context->CreateGlyphAtlas(*GetContext(),
+                                    GlyphAtlas::Type::kAlphaBitmap,
+                                    atlas_context, lower_glyphs);
+  ASSERT_NE(atlas, nullptr);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().rasterized_glyph_count, 10u);
+  EXPECT_GT(atlas_context->GetLastUpdateStats().evicted_glyph_count, 0u);
+  EXPECT_EQ(atlas->GetPageCount(), 4u);
+  auto count_glyphs_in_atlas = [&atlas](const FontGlyphMap& font_glyph_map) {
+    size_t count = 0u;
+    for (const auto& [scaled_font, glyphs] : font_glyph_map) {
+      for (const Glyph& glyph : glyphs) {
+        count += atlas->FindFontGlyphSlot({scaled_font, glyph}) ? 1u : 0u;
+      }
+    }
+    return count;
+  };
+  EXPECT_EQ(count_glyphs_in_atlas(lower_glyphs), 10u);
+  if (count_glyphs_in_atlas(older_glyphs) > 0u) {
+    size_t recent_glyph_count = 0u;
+    for (const auto& [scaled_font, glyphs] : recent_glyphs) {
+      recent_glyph_count += glyphs.size();
+    }
+    EXPECT_EQ(count_glyphs_in_atlas(recent_glyphs), recent_glyph_count);
+  }
+
+  // Glyphs used by the frame being prepared are never evicted, so drawing
+  // both sets at once grows the atlas past the limit.
+  FontGlyphMap all_glyphs = upper_glyphs;
+  for (const auto& [scaled_font, glyphs] : lower_glyphs) {
+    all_glyphs[scaled_font].insert(glyphs.begin(), glyphs.end());
+  }
+  atlas = context->CreateGlyphAtlas(*GetContext(),
+                                    GlyphAtlas::Type::kAlphaBitmap,
+                                    atlas_context, all_glyphs);
+  ASSERT_NE(atlas, nullptr);
+  EXPECT_EQ(atlas_context->GetLastUpdateStats().evicted_glyph_count, 0u);
+  EXPECT_GT(atlas->GetPageCount(), 4u);
+  EXPECT_EQ(count_glyphs_in_atlas(all_glyphs), 36u);
+
+  // The next frame that does not use the pages past the limit drops them.
+  atlas = CreateGlyphAtlas(
+      *GetContext(), context.get(), GlyphAtlas::Type::kAlphaBitmap, 48.0f,
+      atlas_context,
+      *MakeTextFrameFromTextBlobSkia(
+          SkTextBlob::MakeFromString("0123456789", sk_font)));
+  ASSERT_NE(atlas, nullptr);
+  EXPECT_GT(atlas_context->GetLastUpdateStats().evicted_glyph_count, 0u);
+  EXPECT_EQ(atlas->GetPageCount(), 4u);
+}
+
+TEST_P(TypographerTest, GlyphAtlasReturnsCellsOfEvictedGlyphsToPackers) {
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context = context->CreateGlyphAtlasContext();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(12);
+  std::shared_ptr<GlyphAtlas> atlas;
+  size_t evicted_glyph_count = 0u;
+  for (const char* text : {"ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+                           "abcdefghijklmnopqrstuvwxyz", "0123456789"}) {
+    atlas = CreateGlyphAtlas(
+        *GetContext(), context.get(), GlyphAtlas::Type::kAlphaBitmap, 48.0f,
+        atlas_context,
+        *MakeTextFrameFromTextBlobSkia(
+            SkTextBlob::MakeFromString(text, sk_font)));
+    ASSERT_NE(atlas, nullptr);
+    evicted_glyph_count +=
+        atlas_context->GetLastUpdateStats().evicted_glyph_count;
+  }
+  EXPECT_GT(evicted_glyph_count, 0u);
+
+  // Every packer holds exactly the cells of the glyphs left in its page.
+  std::vector<size_t> glyph_counts(atlas->GetPageCount());
+  atlas->IterateGlyphSlots([&](const ScaledFont&, const Glyph&,
+                               const GlyphAtlas::Slot& slot) {
+    glyph_counts[slot.page]++;
+  });
+  const auto& pages = GlyphAtlasContextSkia::Cast(*atlas_context).GetPages();
+  ASSERT_EQ(pages.size(), glyph_counts.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    EXPECT_EQ(pages[i].rect_packer->getStats().rect_count, glyph_counts[i]);
+  }
 }
 
 }  // namespace testing
@@ -86,6 +86,7 @@ typedef CanvasPath Path;
   V(SemanticsUpdateBuilder::Create, 1)                                \
   /* Other */                                                         \
   V(FontCollection::LoadFontFromList, 3)                              \
+  V(ImageDescriptor::decodeBatch, 3)                                  \
   V(ImageDescriptor::initEncoded, 3)                                  \
   V(ImmutableBuffer::init, 3)                                         \
   V(ImmutableBuffer::initFromAsset, 3)                                \
@@ -194,6 +195,8 @@ typedef CanvasPath Path;
   V(Image, toByteData, 3)                              \
   V(Image, colorSpace, 1)                              \
   V(ImageDescriptor, bytesPerPixel, 1)                 \
+  V(ImageDescriptor, decodeProgressively, 5)           \
+  V(ImageDescriptor, decodeRegion, 8)                  \
   V(ImageDescriptor, dispose, 1)                       \
   V(ImageDescriptor, height, 1)                        \
   V(ImageDescriptor, instantiateCodec, 4)              \
@@ -6777,6 +6777,73 @@ abstract class ImageDescriptor {
     }).then((_) => descriptor);
   }
 
+  /// Decodes the images of all the `descriptors` as a single batch.
+  ///
+  /// Each image is decoded at the size that [instantiateCodec] would give it
+  /// for `targetWidth` and `targetHeight`. If `priorities` is given, it holds
+  /// one priority per descriptor, and images with a higher priority, such as
+  /// those that are on screen, are started before the rest.
+  ///
+  /// The returned future completes once every image is decoded, with the
+  /// images in the order of the descriptors. This costs the UI thread a single
+  /// task for the whole batch, rather than one per image, which makes it
+  /// cheaper than decoding each image on its own when many images are needed
+  /// at once, such as for a grid of thumbnails. If any image fails to decode,
+  /// the other images are disposed and the future completes with an error.
+  ///
+  /// The descriptors must have been created by this class.
+  static Future<List<Image>> decodeBatch(
+    List<ImageDescriptor> descriptors, {
+    int? targetWidth,
+    int? targetHeight,
+    List<int>? priorities,
+  }) {
+    if (priorities != null && priorities.length != descriptors.length) {
+      throw ArgumentError.value(priorities, 'priorities', 'must have one priority per descriptor');
+    }
+    if (descriptors.isEmpty) {
+      return Future<List<Image>>.value(<Image>[]);
+    }
+    final Int32List requests = Int32List(descriptors.length * 3);
+    for (int i = 0; i < descriptors.length; i++) {
+      final ImageDescriptor descriptor = descriptors[i];
+      if (descriptor is! _NativeImageDescriptor) {
+        throw ArgumentError.value(descriptors, 'descriptors', 'must have been created by ImageDescriptor');
+      }
+      final (int, int) targetSize = _NativeImageDescriptor._targetSize(
+        descriptor.width,
+        descriptor.height,
+        targetWidth,
+        targetHeight,
+      );
+      requests[i * 3] = targetSize.$1;
+      requests[i * 3 + 1] = targetSize.$2;
+      requests[i * 3 + 2] = priorities?[i] ?? 0;
+    }
+    final List<Image?> images = List<Image?>.filled(descriptors.length, null);
+    String? error;
+    return _futurizeWithError((_CallbackWithError<List<Image>?> callback) {
+      return _NativeImageDescriptor._decodeBatch(descriptors, requests, (int index, _Image? image, String decodeError) {
+        if (image != null) {
+          images[index] = Image._(image, image.width, image.height);
+        } else {
+          error ??= decodeError;
+        }
+        if (index < descriptors.length - 1) {
+          return;
+        }
+        if (error != null) {
+          for (final Image? image in images) {
+            image?.dispose();
+          }
+          callback(null, error);
+        } else {
+          callback(images.cast<Image>(), null);
+        }
+      });
+    });
+  }
+
   /// The width, in pixels, of the image.
   ///
   /// On the Web, this is only supported for [raw] images.
@@ -6809,6 +6876,32 @@ abstract class ImageDescriptor {
   /// If either targetWidth or targetHeight is less than or equal to zero, it
   /// will be treated as if it is null.
   Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight});
+
+  /// Decodes only the pixels of the image that are within `region`, and
+  /// returns them as an [Image].
+  ///
+  /// The `region` is in the pixel coordinates of the image, and is rounded
+  /// out to whole pixels. The decoded region is resized to `targetWidth` and
+  /// `targetHeight`, which are treated like those of [instantiateCodec] except
+  /// that they scale the region rather than the whole image.
+  ///
+  /// This is cheaper than decoding the whole image when only part of it is
+  /// shown, for example when zooming into a large photo.
+  ///
+  /// On the Web, this is not supported.
+  Future<Image> decodeRegion(Rect region, {int? targetWidth, int? targetHeight});
+
+  /// Decodes the image to an [Image] at the size given by `targetWidth` and
+  /// `targetHeight`, which are treated like those of [instantiateCodec].
+  ///
+  /// If the image can be decoded cheaply at a reduced size first, that image is
+  /// passed to `onFirstPass` before the returned future completes, so that it
+  /// can be shown in the meantime. Otherwise `onFirstPass` is not called.
+  Future<Image> decodeProgressively({
+    int? targetWidth,
+    int? targetHeight,
+    void Function(Image image)? onFirstPass,
+  });
 }
 
 base class _NativeImageDescriptor extends NativeFieldWrapperClass1 implements ImageDescriptor {
@@ -6841,6 +6934,13 @@ base class _NativeImageDescriptor extends NativeFieldWrapperClass1 implements Im
   @Native<Handle Function(Handle, Pointer<Void>, Handle)>(symbol: 'ImageDescriptor::initEncoded')
   external String? _initEncoded(ImmutableBuffer buffer, _Callback<void> callback);
 
+  @Native<Handle Function(Handle, Handle, Handle)>(symbol: 'ImageDescriptor::decodeBatch')
+  external static String? _decodeBatch(
+    List<ImageDescriptor> descriptors,
+    Int32List requests,
+    void Function(int, _Image?, String) callback,
+  );
+
   @Native<Void Function(Handle, Handle, Int32, Int32, Int32, Int32)>(symbol: 'ImageDescriptor::initRaw')
   external static void _initRaw(ImageDescriptor outDescriptor, ImmutableBuffer buffer, int width, int height, int rowBytes, int pixelFormat);
 
@@ -6874,6 +6974,74 @@ base class _NativeImageDescriptor extends NativeFieldWrapperClass1 implements Im
 
   @override
   Future<Codec> instantiateCodec({int? targetWidth, int? targetHeight}) async {
+    final (int, int) targetSize = _targetSize(width, height, targetWidth, targetHeight);
+    final Codec codec = _NativeCodec._();
+    _instantiateCodec(codec, targetSize.$1, targetSize.$2);
+    return codec;
+  }
+
+  @Native<Void Function(Pointer<Void>, Handle, Int32, Int32)>(symbol: 'ImageDescriptor::instantiateCodec')
+  external void _instantiateCodec(Codec outCodec, int targetWidth, int targetHeight);
+
+  @override
+  Future<Image> decodeRegion(Rect region, {int? targetWidth, int? targetHeight}) {
+    final int left = region.left.floor();
+    final int top = region.top.floor();
+    final int right = region.right.ceil();
+    final int bottom = region.bottom.ceil();
+    final (int, int) targetSize = _targetSize(right - left, bottom - top, targetWidth, targetHeight);
+    return _futurizeWithError((_CallbackWithError<Image?> callback) {
+      return _decodeRegion((_Image? image, String decodeError) {
+        callback(image == null ? null : Image._(image, image.width, image.height), decodeError);
+      }, left, top, right, bottom, targetSize.$1, targetSize.$2);
+    });
+  }
+
+  @Native<Handle Function(Pointer<Void>, Handle, Int32, Int32, Int32, Int32, Int32, Int32)>(symbol: 'ImageDescriptor::decodeRegion')
+  external String? _decodeRegion(
+    void Function(_Image?, String) callback,
+    int left,
+    int top,
+    int right,
+    int bottom,
+    int targetWidth,
+    int targetHeight,
+  );
+
+  @override
+  Future<Image> decodeProgressively({
+    int? targetWidth,
+    int? targetHeight,
+    void Function(Image image)? onFirstPass,
+  }) {
+    final (int, int) targetSize = _targetSize(width, height, targetWidth, targetHeight);
+    return _futurizeWithError((_CallbackWithError<Image?> callback) {
+      return _decodeProgressively(
+        onFirstPass == null ? null : (_Image? image, String decodeError) {
+          if (image != null) {
+            onFirstPass(Image._(image, image.width, image.height));
+          }
+        },
+        (_Image? image, String decodeError) {
+          callback(image == null ? null : Image._(image, image.width, image.height), decodeError);
+        },
+        targetSize.$1,
+        targetSize.$2,
+      );
+    });
+  }
+
+  @Native<Handle Function(Pointer<Void>, Handle, Handle, Int32, Int32)>(symbol: 'ImageDescriptor::decodeProgressively')
+  external String? _decodeProgressively(
+    void Function(_Image?, String)? firstPassCallback,
+    void Function(_Image?, String) callback,
+    int targetWidth,
+    int targetHeight,
+  );
+
+  // Resolves the target size of an image of the given size the way
+  // [instantiateCodec] documents.
+  static (int, int) _targetSize(int width, int height, int? targetWidth, int? targetHeight) {
     if (targetWidth != null && targetWidth <= 0) {
       targetWidth = null;
     }
@@ -6889,16 +7057,8 @@ base class _NativeImageDescriptor extends NativeFieldWrapperClass1 implements Im
     } else if (targetHeight == null && targetWidth != null) {
       targetHeight = targetWidth ~/ (width / height);
     }
-    assert(targetWidth != null);
-    assert(targetHeight != null);
-
-    final Codec codec = _NativeCodec._();
-    _instantiateCodec(codec, targetWidth!, targetHeight!);
-    return codec;
+    return (targetWidth!, targetHeight!);
   }
-
-  @Native<Void Function(Pointer<Void>, Handle, Int32, Int32)>(symbol: 'ImageDescriptor::instantiateCodec')
-  external void _instantiateCodec(Codec outCodec, int targetWidth, int targetHeight);
 }
 
 /// Generic callback signature, used by [_futurize].
@@ -0,0 +1,261 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/codec/SkCodecAnimation.h"
+#include "third_party/skia/include/core/SkPixelRef.h"
+
+namespace flutter {
+
+static SkImageInfo MakeFrameInfo(ImageGenerator& generator) {
+  SkImageInfo info = generator.GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+int AnimatedFrameDecoder::DefaultLookaheadFrameCount(size_t frame_byte_size) {
+  if (frame_byte_size == 0) {
+    return 0;
+  }
+  return static_cast<int>(
+      std::min(kLookaheadByteBudget / frame_byte_size,
+               static_cast<size_t>(kMaxLookaheadFrameCount)));
+}
+
+int AnimatedFrameDecoder::DefaultLookaheadFrameCount(
+    ImageGenerator& generator) {
+  return DefaultLookaheadFrameCount(
+      MakeFrameInfo(generator).computeMinByteSize());
+}
+
+AnimatedFrameDecoder::AnimatedFrameDecoder(
+    std::shared_ptr<ImageGenerator> generator,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+    int lookahead_frame_count,
+    std::shared_ptr<std::mutex> generator_mutex)
+    : generator_(std::move(generator)),
+      generator_mutex_(generator_mutex ? std::move(generator_mutex)
+                                       : std::make_shared<std::mutex>()),
+      worker_task_runner_(std::move(worker_task_runner)) {
+  {
+    std::scoped_lock generator_lock(*generator_mutex_);
+    frame_count_ = generator_->GetFrameCount();
+    play_count_ = generator_->GetPlayCount();
+    frame_info_ = MakeFrameInfo(*generator_);
+  }
+  lookahead_frame_count_ = worker_task_runner_ && frame_count_ > 1
+                               ? std::max(lookahead_frame_count, 0)
+                               : 0;
+  // The decoded frames, the frame held by the consumer and the one being
+  // decoded.
+  max_pooled_frame_count_ = lookahead_frame_count_ + 2;
+}
+
+AnimatedFrameDecoder::~AnimatedFrameDecoder() = default;
+
+AnimatedFrameDecoder::Frame AnimatedFrameDecoder::GetNextFrame() {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::GetNextFrame");
+  Frame frame;
+  if (!TakeDecodedFrame(frame)) {
+    std::scoped_lock decode_lock(decode_mutex_);
+    // The worker may have finished decoding the frame while this thread was
+    // waiting for it.
+    if (!TakeDecodedFrame(frame)) {
+      frame = DecodeNextFrameLocked();
+    }
+  }
+  ScheduleLookahead();
+  return frame;
+}
+
+void AnimatedFrameDecoder::RecycleFrame(SkBitmap bitmap) {
+  // The pixels may still be shared with the required frame or with an image
+  // that was made from the bitmap without copying it.
+  if (bitmap.info() != frame_info_ || !bitmap.pixelRef() ||
+      !bitmap.pixelRef()->unique()) {
+    return;
+  }
+  std::scoped_lock frames_lock(frames_mutex_);
+  if (pooled_frames_.size() < max_pooled_frame_count_) {
+    pooled_frames_.push_back(std::move(bitmap));
+  }
+}
+
+bool AnimatedFrameDecoder::TakeDecodedFrame(Frame& frame) {
+  std::scoped_lock frames_lock(frames_mutex_);
+  if (decoded_frames_.empty()) {
+    return false;
+  }
+  frame = std::move(decoded_frames_.front());
+  decoded_frames_.pop_front();
+  return true;
+}
+
+bool AnimatedFrameDecoder::AcquireFrameBitmap(SkBitmap& bitmap) {
+  {
+    std::scoped_lock frames_lock(frames_mutex_);
+    if (!pooled_frames_.empty()) {
+      bitmap = std::move(pooled_frames_.back());
+      pooled_frames_.pop_back();
+      return true;
+    }
+  }
+  return bitmap.tryAllocPixels(frame_info_);
+}
+
+AnimatedFrameDecoder::Frame AnimatedFrameDecoder::DecodeNextFrameLocked() {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::DecodeNextFrame");
+  Frame frame;
+  frame.index = next_decode_index_;
+  next_decode_index_ = (next_decode_index_ + 1) % frame_count_;
+
+  SkBitmap bitmap;
+  if (!AcquireFrameBitmap(bitmap)) {
+    std::ostringstream ostr;
+    ostr << "Failed to allocate memory for bitmap of size "
+         << frame_info_.computeMinByteSize() << "B";
+    frame.decode_error = ostr.str();
+    FML_LOG(ERROR) << frame.decode_error;
+    return frame;
+  }
+
+  std::unique_lock generator_lock(*generator_mutex_);
+  ImageGenerator::FrameInfo frameInfo = generator_->GetFrameInfo(frame.index);
+  generator_lock.unlock();
+  frame.duration = frameInfo.duration;
+
+  const int requiredFrameIndex =
+      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
+
+  if (requiredFrameIndex != SkCodec::kNoFrame &&
+      last_required_frame_.has_value()) {
+    // We are here when the frame said |disposal_method| is
+    // `DisposalMethod::kKeep` or `DisposalMethod::kRestorePrevious` and
+    // |requiredFrameIndex| is set to ex-frame or ex-ex-frame. Copy the
+    // previous frame's output buffer into the current frame as the starting
+    // point.
+    bitmap.writePixels(last_required_frame_->pixmap());
+    if (restore_bg_color_rect_.has_value()) {
+      bitmap.erase(SK_ColorTRANSPARENT, restore_bg_color_rect_.value());
+    }
+  } else {
+    if (requiredFrameIndex != SkCodec::kNoFrame) {
+      FML_DLOG(INFO)
+          << "Frame " << frame.index << " depends on frame "
+          << requiredFrameIndex
+          << " and no required frames are cached. Using blank slate instead.";
+    }
+    // A pooled bitmap still holds the pixels of an earlier frame.
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+  }
+
+  // Write the new frame to the output buffer. The bitmap pixels as supplied
+  // are already set in accordance with the previous frame's disposal policy.
+  generator_lock.lock();
+  const bool decoded =
+      generator_->GetPixels(frame_info_, bitmap.getPixels(), bitmap.rowBytes(),
+                            frame.index, requiredFrameIndex);
+  generator_lock.unlock();
+  if (!decoded) {
+    std::ostringstream ostr;
+    ostr << "Could not getPixels for frame " << frame.index;
+    frame.decode_error = ostr.str();
+    FML_LOG(ERROR) << frame.decode_error;
+    RecycleFrame(std::move(bitmap));
+    return frame;
+  }
+
+  const bool keep_current_frame =
+      frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep;
+  const bool restore_previous_frame =
+      frameInfo.disposal_method ==
+      SkCodecAnimation::DisposalMethod::kRestorePrevious;
+  const bool previous_frame_available = last_required_frame_.has_value();
+
+  // Store the current frame in `last_required_frame_` if the frame's disposal
+  // method indicates we should do so.
+  // * When the disposal method is "Keep", the stored frame should always be
+  //   overwritten with the new frame we just crafted.
+  // * When the disposal method is "RestorePrevious", the previously stored
+  //   frame should be retained and used as the backdrop for the next frame
+  //   again. If there isn't already a stored frame, that means we haven't
+  //   rendered any frames yet! When this happens, we just fall back to "Keep"
+  //   behavior and store the current frame as the backdrop of the next frame.
+  //
+  // Only this one frame is ever retained for later frames, so the memory held
+  // for composition is bounded to a single frame however long the animation
+  // is. The replaced frame goes back to the pool once nothing else uses it.
+  if (keep_current_frame ||
+      (previous_frame_available && !restore_previous_frame)) {
+    std::optional<SkBitmap> replaced_frame = std::move(last_required_frame_);
+    last_required_frame_ = bitmap;
+    if (replaced_frame.has_value()) {
+      RecycleFrame(std::move(replaced_frame.value()));
+    }
+  }
+
+  if (frameInfo.disposal_method ==
+      SkCodecAnimation::DisposalMethod::kRestoreBGColor) {
+    restore_bg_color_rect_ = frameInfo.disposal_rect;
+  } else {
+    restore_bg_color_rect_.reset();
+  }
+
+  frame.bitmap = std::move(bitmap);
+  return frame;
+}
+
+void AnimatedFrameDecoder::ScheduleLookahead() {
+  if (lookahead_frame_count_ == 0) {
+    return;
+  }
+  {
+    std::scoped_lock frames_lock(frames_mutex_);
+    if (lookahead_scheduled_ ||
+        decoded_frames_.size() >=
+            static_cast<size_t>(lookahead_frame_count_)) {
+      return;
+    }
+    lookahead_scheduled_ = true;
+  }
+  worker_task_runner_->PostTask(
+      [weak_decoder = std::weak_ptr<AnimatedFrameDecoder>(
+           shared_from_this())]() {
+        // Only hold on to the decoder while a frame is decoded so that it can
+        // be collected between frames.
+        while (auto decoder = weak_decoder.lock()) {
+          if (!decoder->DecodeAheadOneFrame()) {
+            return;
+          }
+        }
+      });
+}
+
+bool AnimatedFrameDecoder::DecodeAheadOneFrame() {
+  std::scoped_lock decode_lock(decode_mutex_);
+  {
+    std::scoped_lock frames_lock(frames_mutex_);
+    if (decoded_frames_.size() >=
+        static_cast<size_t>(lookahead_frame_count_)) {
+      lookahead_scheduled_ = false;
+      return false;
+    }
+  }
+  Frame frame = DecodeNextFrameLocked();
+  std::scoped_lock frames_lock(frames_mutex_);
+  decoded_frames_.push_back(std::move(frame));
+  return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,165 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Composes the frames of an animated image in display order.
+///
+///             Each frame is decoded on top of the frame it depends on, so
+///             frames can only be decoded one after another. When a lookahead
+///             is requested, the frames that follow the one that was last
+///             returned are decoded ahead of time on a worker, so that
+///             returning a frame does not have to wait for its decode.
+///
+///             Frame bitmaps are taken from a small pool that the consumer
+///             returns them to once it no longer needs their pixels, and the
+///             only frame that is kept for later frames to be composed on is
+///             the last one that they can depend on.
+///
+///             `GetNextFrame` and `RecycleFrame` may be called from any one
+///             thread at a time. The decoder must be owned by a
+///             `std::shared_ptr`. Decoders that share a generator, such as
+///             the ones of the codecs of an `ImageDescriptor`, must also share
+///             the mutex that guards it, as they may decode on different
+///             workers at the same time.
+///
+class AnimatedFrameDecoder
+    : public std::enable_shared_from_this<AnimatedFrameDecoder> {
+ public:
+  struct Frame {
+    /// The index of the frame in the animation.
+    int index = 0;
+    /// The duration of the frame in milliseconds.
+    int duration = 0;
+    /// The pixels of the frame, or an empty bitmap if it could not be decoded.
+    SkBitmap bitmap;
+    std::string decode_error;
+  };
+
+  /// The most frames that are decoded ahead by default.
+  static constexpr int kMaxLookaheadFrameCount = 3;
+
+  /// The bytes of decoded frames that each animation may hold ahead of the
+  /// frame that was last returned by default.
+  static constexpr size_t kLookaheadByteBudget = 1 << 20;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of frames of the given size, in bytes, to decode
+  ///             ahead of time by default, which is as many as fit in
+  ///             |kLookaheadByteBudget| up to |kMaxLookaheadFrameCount|. This
+  ///             is 0, for decoding on demand, if not even one frame fits.
+  ///
+  static int DefaultLookaheadFrameCount(size_t frame_byte_size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of frames to decode ahead of time by default for
+  ///             an animation of the given generator.
+  ///
+  static int DefaultLookaheadFrameCount(ImageGenerator& generator);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a decoder for the frames of the generator.
+  ///
+  /// @param[in]  generator              The generator of the animated image.
+  /// @param[in]  worker_task_runner     The runner to decode frames ahead of
+  ///                                    time on. If null, frames are always
+  ///                                    decoded on demand.
+  /// @param[in]  lookahead_frame_count  The number of frames to keep decoded
+  ///                                    ahead of the last returned one.
+  /// @param[in]  generator_mutex        The mutex held while the generator is
+  ///                                    used. If null, the generator must not
+  ///                                    be used anywhere else.
+  ///
+  AnimatedFrameDecoder(
+      std::shared_ptr<ImageGenerator> generator,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+      int lookahead_frame_count,
+      std::shared_ptr<std::mutex> generator_mutex = nullptr);
+
+  ~AnimatedFrameDecoder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the next frame of the animation, which is decoded now
+  ///             unless it was decoded ahead, and starts decoding the frames
+  ///             after it on the worker.
+  ///
+  Frame GetNextFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Hands back the bitmap of a returned frame, so that its memory
+  ///             can be reused for a later frame. This has no effect if the
+  ///             pixels of the bitmap are still referenced elsewhere.
+  ///
+  void RecycleFrame(SkBitmap bitmap);
+
+  int frame_count() const { return frame_count_; }
+
+  unsigned int play_count() const { return play_count_; }
+
+  int lookahead_frame_count() const { return lookahead_frame_count_; }
+
+ private:
+  const std::shared_ptr<ImageGenerator> generator_;
+  // Held while the generator is used, possibly shared with other decoders.
+  // Always acquired last.
+  const std::shared_ptr<std::mutex> generator_mutex_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  // Read from the generator on construction.
+  int frame_count_ = 0;
+  unsigned int play_count_ = 0;
+  int lookahead_frame_count_ = 0;
+  size_t max_pooled_frame_count_ = 0;
+  SkImageInfo frame_info_;
+
+  // Held while decoding a frame. Guards the members below, which carry the
+  // composition state from one frame to the next.
+  std::mutex decode_mutex_;
+  int next_decode_index_ = 0;
+  // The last decoded frame that's required to decode any subsequent frames.
+  std::optional<SkBitmap> last_required_frame_;
+  // The rectangle that should be cleared if the previous frame's disposal
+  // method was kRestoreBGColor.
+  std::optional<SkIRect> restore_bg_color_rect_;
+
+  // Guards the decoded frames, the frame pool and whether a lookahead task is
+  // scheduled. Never held while decoding. When both mutexes are needed,
+  // `decode_mutex_` is acquired first.
+  std::mutex frames_mutex_;
+  std::deque<Frame> decoded_frames_;
+  std::vector<SkBitmap> pooled_frames_;
+  bool lookahead_scheduled_ = false;
+
+  bool TakeDecodedFrame(Frame& frame);
+
+  bool AcquireFrameBitmap(SkBitmap& bitmap);
+
+  Frame DecodeNextFrameLocked();
+
+  void ScheduleLookahead();
+
+  bool DecodeAheadOneFrame();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AnimatedFrameDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
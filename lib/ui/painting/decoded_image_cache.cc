@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  return content_hash == other.content_hash &&
+         content_size == other.content_size &&
+         image_width == other.image_width &&
+         image_height == other.image_height && row_bytes == other.row_bytes &&
+         target_width == other.target_width &&
+         target_height == other.target_height &&
+         color_type == other.color_type && alpha_type == other.alpha_type;
+}
+
+std::size_t DecodedImageCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.content_hash, key.content_size, key.image_width,
+                          key.image_height, key.row_bytes, key.target_width,
+                          key.target_height, key.color_type, key.alpha_type);
+}
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(
+    const ImageDescriptor& descriptor,
+    uint32_t target_width,
+    uint32_t target_height) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  const sk_sp<SkData> data = descriptor.data();
+  FML_DCHECK(data);
+  return {
+      .content_hash = std::hash<std::string_view>{}(std::string_view(
+          static_cast<const char*>(data->data()), data->size())),
+      .content_size = data->size(),
+      .image_width = descriptor.image_info().width(),
+      .image_height = descriptor.image_info().height(),
+      .row_bytes = static_cast<size_t>(descriptor.row_bytes()),
+      .target_width = target_width,
+      .target_height = target_height,
+      .color_type = descriptor.image_info().colorType(),
+      .alpha_type = descriptor.image_info().alphaType(),
+  };
+}
+
+size_t DecodedImageCache::Entry::GetByteSize() const {
+  return image->GetApproximateByteSize() + content->size();
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+sk_sp<DlImage> DecodedImageCache::Get(const Key& key, const SkData& content) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end() ||
+      !(found->second->content.get() == &content ||
+        found->second->content->equals(&content))) {
+    miss_count_++;
+    TraceStatsToTimelineLocked();
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  TraceStatsToTimelineLocked();
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const Key& key,
+                            sk_sp<SkData> content,
+                            sk_sp<DlImage> image) {
+  if (!image || !content) {
+    return;
+  }
+  Entry entry{key, std::move(content), std::move(image)};
+  const size_t entry_size = entry.GetByteSize();
+
+  std::scoped_lock lock(mutex_);
+  if (entry_size > max_bytes_) {
+    return;
+  }
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    byte_size_ -= found->second->GetByteSize();
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+
+  TrimLocked(max_bytes_ - entry_size);
+  entries_.push_front(std::move(entry));
+  index_[key] = entries_.begin();
+  byte_size_ += entry_size;
+  TraceStatsToTimelineLocked();
+}
+
+void DecodedImageCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  TrimLocked(0);
+  TraceStatsToTimelineLocked();
+}
+
+void DecodedImageCache::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  TrimLocked(max_bytes_);
+  TraceStatsToTimelineLocked();
+}
+
+size_t DecodedImageCache::GetMaxBytes() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_;
+}
+
+size_t DecodedImageCache::GetByteSize() const {
+  std::scoped_lock lock(mutex_);
+  return byte_size_;
+}
+
+size_t DecodedImageCache::GetImageCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t DecodedImageCache::GetHitCount() const {
+  std::scoped_lock lock(mutex_);
+  return hit_count_;
+}
+
+size_t DecodedImageCache::GetMissCount() const {
+  std::scoped_lock lock(mutex_);
+  return miss_count_;
+}
+
+void DecodedImageCache::TrimLocked(size_t max_bytes) {
+  while (byte_size_ > max_bytes && !entries_.empty()) {
+    const Entry& least_recent = entries_.back();
+    byte_size_ -= least_recent.GetByteSize();
+    index_.erase(least_recent.key);
+    entries_.pop_back();
+  }
+}
+
+void DecodedImageCache::TraceStatsToTimelineLocked() const {
+#if !FLUTTER_RELEASE
+  const size_t lookup_count = hit_count_ + miss_count_;
+  FML_TRACE_COUNTER(
+      "flutter",                                                 //
+      "DecodedImageCache", reinterpret_cast<int64_t>(this),      //
+      "ImageCount", entries_.size(),                             //
+      "KBytes", byte_size_ >> 10,                                //
+      "HitCount", hit_count_,                                    //
+      "MissCount", miss_count_,                                  //
+      "HitRatePercent",                                          //
+      lookup_count == 0 ? 0 : hit_count_ * 100 / lookup_count);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "flutter/display_list/image/dl_image.h"
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_descriptor.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A least recently used cache of decoded images, keyed by the
+///             content of the buffer they were decoded from and the size and
+///             pixel format they were decoded to.
+///
+///             This lets the `ImageDecoder` skip decoding an image again when
+///             the same encoded bytes are instantiated again, as happens when
+///             list items that show the same asset scroll in and out of view.
+///
+///             Each image is kept along with the buffer it was decoded from,
+///             which is compared with the buffer of a lookup whose key matches
+///             so that a hash collision never returns the wrong image. The
+///             buffers count towards the budget.
+///
+///             The cache may be used from any thread, so that the buffers can
+///             be hashed and compared on a worker.
+///
+class DecodedImageCache {
+ public:
+  struct Key {
+    uint64_t content_hash = 0;
+    size_t content_size = 0;
+    // The size and row bytes of the image that the buffer holds, which set
+    // apart buffers of raw pixels of the same length.
+    int32_t image_width = 0;
+    int32_t image_height = 0;
+    size_t row_bytes = 0;
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+    SkColorType color_type = kUnknown_SkColorType;
+    SkAlphaType alpha_type = kUnknown_SkAlphaType;
+
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const;
+    };
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the key for decoding the descriptor to the target
+  ///             size. This hashes the whole buffer of the descriptor, which
+  ///             must not have been disposed, and should be done on a worker.
+  ///
+  static Key MakeKey(const ImageDescriptor& descriptor,
+                     uint32_t target_width,
+                     uint32_t target_height);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a cache that holds at most `max_bytes` of images. A
+  ///             budget of 0 disables the cache.
+  ///
+  explicit DecodedImageCache(size_t max_bytes);
+
+  ~DecodedImageCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the image for the key and marks it as the most
+  ///             recently used one, or null if the image is not cached or was
+  ///             decoded from a buffer with other bytes than `content`.
+  ///
+  sk_sp<DlImage> Get(const Key& key, const SkData& content);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an image decoded from `content` to the cache, evicting
+  ///             the least recently used images until the cache is within its
+  ///             budget. Images that are larger than the budget are not
+  ///             cached.
+  ///
+  void Put(const Key& key, sk_sp<SkData> content, sk_sp<DlImage> image);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Evicts all images. Called when the platform is low on memory.
+  ///
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Changes the budget, evicting images to fit in it.
+  ///
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const;
+
+  size_t GetByteSize() const;
+
+  size_t GetImageCount() const;
+
+  size_t GetHitCount() const;
+
+  size_t GetMissCount() const;
+
+ private:
+  struct Entry {
+    Key key;
+    sk_sp<SkData> content;
+    sk_sp<DlImage> image;
+
+    size_t GetByteSize() const;
+  };
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, Key::Hash> index_;
+  size_t max_bytes_ = 0;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  void TrimLocked(size_t max_bytes);
+
+  void TraceStatsToTimelineLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
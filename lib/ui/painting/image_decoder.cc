@@ -4,7 +4,15 @@
 
 #include "flutter/lib/ui/painting/image_decoder.h"
 
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image_decoder_skia.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 
 #if IMPELLER_SUPPORTS_RENDERING
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
@@ -18,9 +26,10 @@ std::unique_ptr<ImageDecoder> ImageDecoder::Make(
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     fml::WeakPtr<IOManager> io_manager,
     const std::shared_ptr<fml::SyncSwitch>& gpu_disabled_switch) {
+  std::unique_ptr<ImageDecoder> decoder;
 #if IMPELLER_SUPPORTS_RENDERING
   if (settings.enable_impeller) {
-    return std::make_unique<ImageDecoderImpeller>(
+    decoder = std::make_unique<ImageDecoderImpeller>(
         runners,                            //
         std::move(concurrent_task_runner),  //
         std::move(io_manager),              //
@@ -28,11 +37,16 @@ std::unique_ptr<ImageDecoder> ImageDecoder::Make(
         gpu_disabled_switch);
   }
 #endif  // IMPELLER_SUPPORTS_RENDERING
-  return std::make_unique<ImageDecoderSkia>(
-      runners,                            //
-      std::move(concurrent_task_runner),  //
-      std::move(io_manager)               //
-  );
+  if (!decoder) {
+    decoder = std::make_unique<ImageDecoderSkia>(
+        runners,                            //
+        std::move(concurrent_task_runner),  //
+        std::move(io_manager)               //
+    );
+  }
+  decoder->SetDecodedImageCacheMaxBytes(
+      settings.decoded_image_cache_max_bytes);
+  return decoder;
 }
 
 ImageDecoder::ImageDecoder(
@@ -42,6 +56,7 @@ ImageDecoder::ImageDecoder(
     : runners_(runners),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      decoded_image_cache_(std::make_shared<DecodedImageCache>(0)),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -50,8 +65,448 @@ ImageDecoder::ImageDecoder(
 
 ImageDecoder::~ImageDecoder() = default;
 
+void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor,
+                          uint32_t target_width,
+                          uint32_t target_height,
+                          const ImageResult& result) {
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  if (decoded_image_cache_->GetMaxBytes() == 0 || !descriptor->data()) {
+    DecodeImage(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  // Hashing the buffer takes about as long as reading all of it, so the cache
+  // is looked up on a worker. The descriptor is manually reference counted so
+  // that it is only ever released on the UI thread, as it is a Dart wrapper.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+
+  concurrent_task_runner_->PostTask(
+      [raw_descriptor, target_width, target_height, result,
+       cache = decoded_image_cache_, decoder = GetWeakPtr(),
+       ui_runner = runners_.GetUITaskRunner()]() {
+        const DecodedImageCache::Key key = DecodedImageCache::MakeKey(
+            *raw_descriptor, target_width, target_height);
+        sk_sp<SkData> content = raw_descriptor->data();
+        sk_sp<DlImage> image = cache->Get(key, *content);
+
+        // Like decoded images, cached images are returned in a later task on
+        // the UI thread.
+        ui_runner->PostTask(fml::MakeCopyable(
+            [raw_descriptor, target_width, target_height, result, cache,
+             decoder, key, content = std::move(content),
+             image = std::move(image)]() mutable {
+              auto descriptor = fml::Ref(raw_descriptor);
+              raw_descriptor->Release();
+              if (image) {
+                result(image, {});
+                return;
+              }
+              if (!decoder) {
+                result(nullptr, "The image decoder was collected.");
+                return;
+              }
+              decoder->DecodeImage(
+                  std::move(descriptor), target_width, target_height,
+                  [cache, key, content = std::move(content), result](
+                      const sk_sp<DlImage>& image,
+                      const std::string& decode_error) {
+                    if (image) {
+                      cache->Put(key, content, image);
+                    }
+                    result(image, decode_error);
+                  });
+            }));
+      });
+}
+
+void ImageDecoder::SetDecodedImageCacheMaxBytes(size_t max_bytes) {
+  decoded_image_cache_->SetMaxBytes(max_bytes);
+}
+
+void ImageDecoder::NotifyLowMemoryWarning() {
+  decoded_image_cache_->Clear();
+}
+
+const DecodedImageCache& ImageDecoder::GetDecodedImageCache() const {
+  return *decoded_image_cache_;
+}
+
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
+void ImageDecoder::DecodeImage(fml::RefPtr<ImageDescriptor> descriptor,
+                               uint32_t target_width,
+                               uint32_t target_height,
+                               const ImageResult& result) {
+  FML_DCHECK(result);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  // ImageDescriptors have Dart peers that must be collected on the UI thread.
+  // However, the closures of the decode capture the descriptor, and the
+  // captures of copyable closures may be collected on any of the threads
+  // participating in task execution.
+  //
+  // To avoid this issue, we resort to manually reference counting the
+  // descriptor. Since all task flows invoke the `result` callback, the raw
+  // descriptor is retained here and released in the `result` callback, which
+  // is always serviced on the UI thread.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+
+  DecodeAndUploadImage(
+      raw_descriptor, target_width, target_height,
+      [result, raw_descriptor, ui_runner = runners_.GetUITaskRunner()](
+          sk_sp<DlImage> image, std::string decode_error) {
+        ui_runner->PostTask(fml::MakeCopyable(
+            [result, raw_descriptor, image = std::move(image),
+             decode_error = std::move(decode_error)]() mutable {
+              result(std::move(image), std::move(decode_error));
+              raw_descriptor->Release();
+            }));
+      });
+}
+
+namespace {
+
+// The state of a call to `ImageDecoder::DecodeBatch`, shared by the threads
+// that decode and upload its images.
+struct BatchDecode {
+  struct Request {
+    // The index of the request in the batch.
+    size_t index = 0;
+    // Retained until the results are returned on the UI thread.
+    ImageDescriptor* descriptor = nullptr;
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+    // Set on a worker for the images that are looked up in the cache.
+    bool cacheable = false;
+    bool found_in_cache = false;
+    DecodedImageCache::Key key;
+    sk_sp<SkData> content;
+  };
+
+  // In the order in which the decodes are started.
+  std::vector<Request> requests;
+  std::shared_ptr<DecodedImageCache> cache;
+  fml::RefPtr<fml::TaskRunner> ui_runner;
+  ImageDecoder::BatchResult result;
+
+  std::mutex mutex;
+  std::vector<ImageDecoder::BatchDecodeResult> results;
+  size_t pending_count = 0;
+};
+
+// Records the result of a request. Once all the requests of the batch are
+// done, returns their results in one task on the UI thread. May be called on
+// any thread.
+void CompleteBatchRequest(const std::shared_ptr<BatchDecode>& batch,
+                          size_t index,
+                          sk_sp<DlImage> image,
+                          std::string decode_error) {
+  {
+    std::scoped_lock lock(batch->mutex);
+    batch->results[index] = {std::move(image), std::move(decode_error)};
+    if (--batch->pending_count != 0) {
+      return;
+    }
+  }
+  batch->ui_runner->PostTask([batch]() {
+    TRACE_EVENT0("flutter", "ImageDecodeBatchCallback");
+    for (const BatchDecode::Request& request : batch->requests) {
+      request.descriptor->Release();
+    }
+    batch->result(std::move(batch->results));
+  });
+}
+
+}  // namespace
+
+void ImageDecoder::DecodeBatch(std::vector<BatchDecodeRequest> requests,
+                               const BatchResult& result) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  FML_DCHECK(result);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  if (requests.empty()) {
+    runners_.GetUITaskRunner()->PostTask([result]() { result({}); });
+    return;
+  }
+
+  // The workers of the concurrent task runner take decodes in the order they
+  // are posted. Starting the largest decodes first keeps the workers busy
+  // until the end of the batch instead of leaving one of them to finish a
+  // large image on its own.
+  auto decoded_pixel_count = [](const BatchDecodeRequest& request) -> int64_t {
+    if (request.target_width && request.target_height) {
+      return static_cast<int64_t>(request.target_width) *
+             request.target_height;
+    }
+    return request.descriptor->image_info().dimensions().area();
+  };
+  std::vector<size_t> order(requests.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (requests[a].priority != requests[b].priority) {
+      return requests[a].priority > requests[b].priority;
+    }
+    return decoded_pixel_count(requests[a]) > decoded_pixel_count(requests[b]);
+  });
+
+  // The descriptors are manually reference counted for the same reason as in
+  // `DecodeImage`, and are all released along with the results.
+  auto batch = std::make_shared<BatchDecode>();
+  batch->requests.reserve(requests.size());
+  for (size_t index : order) {
+    BatchDecode::Request request;
+    request.index = index;
+    request.descriptor = requests[index].descriptor.get();
+    request.descriptor->AddRef();
+    request.target_width = requests[index].target_width;
+    request.target_height = requests[index].target_height;
+    batch->requests.push_back(std::move(request));
+  }
+  batch->cache = decoded_image_cache_;
+  batch->ui_runner = runners_.GetUITaskRunner();
+  batch->result = result;
+  batch->results.resize(requests.size());
+  batch->pending_count = requests.size();
+
+  // Starts the decodes of the images that were not found in the cache, in
+  // order. Results are collected on the IO thread and the cache is filled from
+  // there.
+  auto start_decodes = [](ImageDecoder& decoder,
+                          const std::shared_ptr<BatchDecode>& batch) {
+    for (const BatchDecode::Request& request : batch->requests) {
+      if (request.found_in_cache) {
+        continue;
+      }
+      decoder.DecodeAndUploadImage(
+          request.descriptor, request.target_width, request.target_height,
+          [batch, &request](sk_sp<DlImage> image, std::string decode_error) {
+            if (image && request.cacheable) {
+              batch->cache->Put(request.key, request.content, image);
+            }
+            CompleteBatchRequest(batch, request.index, std::move(image),
+                                 std::move(decode_error));
+          });
+    }
+  };
+
+  if (decoded_image_cache_->GetMaxBytes() == 0) {
+    start_decodes(*this, batch);
+    return;
+  }
+
+  // Like `Decode`, look up all the images in the cache on a worker first.
+  concurrent_task_runner_->PostTask([batch, start_decodes,
+                                     decoder = GetWeakPtr()]() {
+    bool has_misses = false;
+    for (BatchDecode::Request& request : batch->requests) {
+      if (!request.descriptor->data()) {
+        has_misses = true;
+        continue;
+      }
+      request.cacheable = true;
+      request.key = DecodedImageCache::MakeKey(
+          *request.descriptor, request.target_width, request.target_height);
+      request.content = request.descriptor->data();
+      if (sk_sp<DlImage> image =
+              batch->cache->Get(request.key, *request.content)) {
+        request.found_in_cache = true;
+        CompleteBatchRequest(batch, request.index, std::move(image), {});
+      } else {
+        has_misses = true;
+      }
+    }
+    if (!has_misses) {
+      return;
+    }
+    batch->ui_runner->PostTask([batch, start_decodes, decoder]() {
+      if (decoder) {
+        start_decodes(*decoder, batch);
+        return;
+      }
+      for (const BatchDecode::Request& request : batch->requests) {
+        if (!request.found_in_cache) {
+          CompleteBatchRequest(batch, request.index, nullptr,
+                               "The image decoder was collected.");
+        }
+      }
+    });
+  });
+}
+
+// The smallest scale of the image dimensions that covers the target size when
+// the image is sized to `source`.
+static float ScaleToTarget(const SkISize& source,
+                           uint32_t target_width,
+                           uint32_t target_height) {
+  if (source.isEmpty() || (!target_width && !target_height)) {
+    return 1.0f;
+  }
+  return std::min(
+      1.0f, std::max(static_cast<float>(target_width) / source.width(),
+                     static_cast<float>(target_height) / source.height()));
+}
+
+// Decodes `region` of the descriptor, at the smallest size the codec supports
+// that is at least `target_size`, into a tightly packed buffer described by
+// `info`.
+static sk_sp<SkData> DecodeRegionPixels(ImageDescriptor* descriptor,
+                                        const SkIRect& region,
+                                        const SkISize& target_size,
+                                        SkImageInfo* info) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+
+  const SkISize source_size = descriptor->image_info().dimensions();
+  SkISize scaled_size = source_size;
+  SkIRect subset = region;
+  if (descriptor->is_compressed()) {
+    scaled_size = descriptor->get_scaled_dimensions(ScaleToTarget(
+        region.size(), target_size.width(), target_size.height()));
+    if (scaled_size != source_size) {
+      const SkRect scaled_region = SkRect::Make(region).makeScale(
+          static_cast<float>(scaled_size.width()) / source_size.width(),
+          static_cast<float>(scaled_size.height()) / source_size.height());
+      if (!subset.intersect(scaled_region.roundOut(),
+                            SkIRect::MakeSize(scaled_size))) {
+        return nullptr;
+      }
+    }
+  }
+
+  *info = descriptor->image_info().makeDimensions(subset.size());
+  const size_t byte_size = info->computeMinByteSize();
+  if (SkImageInfo::ByteSizeOverflowed(byte_size)) {
+    return nullptr;
+  }
+  sk_sp<SkData> pixels = SkData::MakeUninitialized(byte_size);
+  SkPixmap pixmap(*info, pixels->writable_data(), info->minRowBytes());
+
+  if (descriptor->is_compressed()) {
+    if (!descriptor->get_pixels_in_subset(pixmap, scaled_size, subset)) {
+      return nullptr;
+    }
+  } else {
+    SkPixmap source(descriptor->image_info(), descriptor->data()->data(),
+                    descriptor->row_bytes());
+    if (!source.readPixels(pixmap, subset.x(), subset.y())) {
+      return nullptr;
+    }
+  }
+  return pixels;
+}
+
+void ImageDecoder::DecodeProgressively(fml::RefPtr<ImageDescriptor> descriptor,
+                                       uint32_t target_width,
+                                       uint32_t target_height,
+                                       const ImageResult& first_pass,
+                                       const ImageResult& result) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  FML_DCHECK(first_pass && result);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  const SkISize target_size =
+      target_width && target_height
+          ? SkISize::Make(target_width, target_height)
+          : descriptor->image_info().dimensions();
+  const SkISize first_pass_size = descriptor->get_scaled_dimensions(
+      kFirstPassScale * ScaleToTarget(descriptor->image_info().dimensions(),
+                                      target_width, target_height));
+
+  // A first pass is only worth its decode if it is much smaller than the
+  // target size.
+  if (first_pass_size.isEmpty() ||
+      first_pass_size.area() * 4 > target_size.area()) {
+    Decode(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  // Both passes use the same codec, which cannot decode concurrently, so the
+  // second pass is only started once the first one is done. The descriptor is
+  // manually reference counted for the same reason as in `Decode`, and is
+  // released on the UI thread once the second pass has been started.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+
+  DecodeImage(
+      std::move(descriptor), first_pass_size.width(), first_pass_size.height(),
+      [decoder = GetWeakPtr(), raw_descriptor, target_width, target_height,
+       first_pass, result](const sk_sp<DlImage>& image,
+                           const std::string& decode_error) {
+        if (image) {
+          first_pass(image, decode_error);
+        }
+        if (decoder) {
+          decoder->Decode(fml::Ref(raw_descriptor), target_width, target_height,
+                          result);
+        } else {
+          result(nullptr, "The image decoder was collected.");
+        }
+        raw_descriptor->Release();
+      });
+}
+
+void ImageDecoder::DecodeRegion(fml::RefPtr<ImageDescriptor> descriptor,
+                                const SkIRect& region,
+                                uint32_t target_width,
+                                uint32_t target_height,
+                                const ImageResult& result) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  FML_DCHECK(result);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  // The descriptor is manually reference counted for the same reason as in
+  // `Decode`. It is released on the UI thread once the pixels of the region
+  // have been decoded.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+
+  SkIRect clipped_region = region;
+  if (!raw_descriptor->data() ||
+      !clipped_region.intersect(
+          SkIRect::MakeSize(raw_descriptor->image_info().dimensions()))) {
+    runners_.GetUITaskRunner()->PostTask([raw_descriptor, result]() {
+      result(nullptr, "The region does not intersect the image.");
+      raw_descriptor->Release();
+    });
+    return;
+  }
+
+  const SkISize target_size = target_width && target_height
+                                  ? SkISize::Make(target_width, target_height)
+                                  : clipped_region.size();
+
+  concurrent_task_runner_->PostTask(
+      [raw_descriptor, region = clipped_region, target_size, result,
+       decoder = GetWeakPtr(), ui_runner = runners_.GetUITaskRunner()]() {
+        SkImageInfo info;
+        sk_sp<SkData> pixels =
+            DecodeRegionPixels(raw_descriptor, region, target_size, &info);
+
+        ui_runner->PostTask(fml::MakeCopyable(
+            [raw_descriptor, target_size, result, decoder,
+             info = std::move(info), pixels = std::move(pixels)]() mutable {
+              raw_descriptor->Release();
+              if (!pixels) {
+                result(nullptr, "Could not decode the region of the image.");
+                return;
+              }
+              if (!decoder) {
+                result(nullptr, "The image decoder was collected.");
+                return;
+              }
+              // The region is uploaded (and resized) like any other image with
+              // raw pixels.
+              decoder->DecodeImage(
+                  fml::MakeRefCounted<ImageDescriptor>(
+                      std::move(pixels), info, info.minRowBytes()),
+                  target_size.width(), target_size.height(), result);
+            }));
+      });
+}
+
 }  // namespace flutter
@@ -6,13 +6,17 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/display_list/image/dl_image.h"
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
+#include "third_party/skia/include/core/SkRect.h"
 
 namespace flutter {
 
@@ -38,11 +42,82 @@ class ImageDecoder {
   // GPU. All image decompression and resizes are done on a worker thread
   // concurrently. Texture upload is done on the IO thread and the result
   // returned back on the UI thread. On error, the texture is null but the
-  // callback is guaranteed to return on the UI thread.
-  virtual void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-                      uint32_t target_width,
-                      uint32_t target_height,
-                      const ImageResult& result) = 0;
+  // callback is guaranteed to return on the UI thread. If the same encoded
+  // bytes were recently decoded to the same size, the image is returned from
+  // the decoded image cache instead. The cache is looked up on a worker, as
+  // that hashes the whole buffer.
+  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
+              uint32_t target_width,
+              uint32_t target_height,
+              const ImageResult& result);
+
+  // An image to decode with `DecodeBatch`.
+  struct BatchDecodeRequest {
+    fml::RefPtr<ImageDescriptor> descriptor;
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+    // Requests with a higher priority, such as images that are on screen, are
+    // started before requests with a lower one.
+    int priority = 0;
+  };
+
+  struct BatchDecodeResult {
+    sk_sp<DlImage> image;
+    std::string decode_error;
+  };
+
+  // Receives the results of `DecodeBatch` in the order of the requests.
+  using BatchResult = std::function<void(std::vector<BatchDecodeResult>)>;
+
+  // Decodes a batch of images as if by `Decode`, and returns all the results in
+  // a single callback on the UI thread once the last image is done. Within
+  // each priority, the largest images are started first, so that the batch is
+  // not held up by a large image that was started last on a busy worker. The
+  // results are collected where the images are uploaded, so the UI thread
+  // only runs one task for the whole batch.
+  void DecodeBatch(std::vector<BatchDecodeRequest> requests,
+                   const BatchResult& result);
+
+  // The fraction of the target size at which the first pass of
+  // `DecodeProgressively` decodes the image.
+  static constexpr float kFirstPassScale = 1.0f / 8.0f;
+
+  // Decodes the image in two passes. The first pass decodes the image at a
+  // fraction of the target size that the codec can produce cheaply (for JPEG,
+  // by skipping the high frequency DCT coefficients), and is handed to
+  // `first_pass` so that something can be shown while the second pass decodes
+  // the image at the target size into `result`. If the codec cannot decode the
+  // image at a smaller size, there is no first pass. `result` is serviced
+  // exactly like the callback of `Decode`, and `first_pass` is always invoked
+  // on the UI thread before it, if at all.
+  void DecodeProgressively(fml::RefPtr<ImageDescriptor> descriptor,
+                           uint32_t target_width,
+                           uint32_t target_height,
+                           const ImageResult& first_pass,
+                           const ImageResult& result);
+
+  // Decodes only the pixels of the image that are within `region`, in the
+  // coordinates of the EXIF oriented image, and returns them resized to the
+  // target size. If the target size is empty, the region is returned at its
+  // own size. When the target size is smaller than the region, the codec
+  // decodes the region at a reduced size if it can. Codecs that cannot skip
+  // the rest of the image still decode all of it, but only the region is kept
+  // once decoding is done. The callback is serviced exactly like that of
+  // `Decode`.
+  void DecodeRegion(fml::RefPtr<ImageDescriptor> descriptor,
+                    const SkIRect& region,
+                    uint32_t target_width,
+                    uint32_t target_height,
+                    const ImageResult& result);
+
+  // Sets the budget of the decoded image cache. A budget of 0 disables it.
+  void SetDecodedImageCacheMaxBytes(size_t max_bytes);
+
+  // Evicts all images from the decoded image cache and releases any memory the
+  // decoder keeps for reuse.
+  virtual void NotifyLowMemoryWarning();
+
+  const DecodedImageCache& GetDecodedImageCache() const;
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
@@ -56,7 +131,25 @@ class ImageDecoder {
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
       fml::WeakPtr<IOManager> io_manager);
 
+  // Decodes the image as described by `Decode`, without consulting the decoded
+  // image cache.
+  void DecodeImage(fml::RefPtr<ImageDescriptor> descriptor,
+                   uint32_t target_width,
+                   uint32_t target_height,
+                   const ImageResult& result);
+
+  // Decompresses the image on a worker and uploads it on the IO thread.
+  // `result` is invoked on the IO thread, or on whichever thread finds that the
+  // image cannot be decoded. The descriptor is not retained, the caller must
+  // keep it alive until `result` is invoked and release it on the UI thread.
+  virtual void DecodeAndUploadImage(ImageDescriptor* descriptor,
+                                    uint32_t target_width,
+                                    uint32_t target_height,
+                                    const ImageResult& result) = 0;
+
  private:
+  // Shared with the workers that look up images in it.
+  std::shared_ptr<DecodedImageCache> decoded_image_cache_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
@@ -475,25 +475,13 @@ ImageDecoderImpeller::UploadTextureToStorage(
 }
 
 // |ImageDecoder|
-void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
-                                  uint32_t target_width,
-                                  uint32_t target_height,
-                                  const ImageResult& p_result) {
-  FML_DCHECK(descriptor);
-  FML_DCHECK(p_result);
-
-  // Wrap the result callback so that it can be invoked from any thread.
-  auto raw_descriptor = descriptor.get();
-  raw_descriptor->AddRef();
-  ImageResult result = [p_result,                               //
-                        raw_descriptor,                         //
-                        ui_runner = runners_.GetUITaskRunner()  //
-  ](auto image, auto decode_error) {
-    ui_runner->PostTask([raw_descriptor, p_result, image, decode_error]() {
-      raw_descriptor->Release();
-      p_result(std::move(image), decode_error);
-    });
-  };
+void ImageDecoderImpeller::DecodeAndUploadImage(
+    ImageDescriptor* raw_descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const ImageResult& result) {
+  FML_DCHECK(raw_descriptor);
+  FML_DCHECK(result);
 
   concurrent_task_runner_->PostTask(
       [raw_descriptor,                                            //
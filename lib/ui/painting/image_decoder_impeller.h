@@ -55,12 +55,6 @@ class ImageDecoderImpeller final : public ImageDecoder {
 
   ~ImageDecoderImpeller() override;
 
-  // |ImageDecoder|
-  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-              uint32_t target_width,
-              uint32_t target_height,
-              const ImageResult& result) override;
-
   static DecompressResult DecompressTexture(
       ImageDescriptor* descriptor,
       SkISize target_size,
@@ -104,6 +98,12 @@ class ImageDecoderImpeller final : public ImageDecoder {
   const bool supports_wide_gamut_;
   std::shared_ptr<fml::SyncSwitch> gpu_disabled_switch_;
 
+  // |ImageDecoder|
+  void DecodeAndUploadImage(ImageDescriptor* descriptor,
+                            uint32_t target_width,
+                            uint32_t target_height,
+                            const ImageResult& result) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderImpeller);
 };
 
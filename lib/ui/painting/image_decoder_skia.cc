@@ -5,6 +5,9 @@
 #include "flutter/lib/ui/painting/image_decoder_skia.h"
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
@@ -97,6 +100,91 @@ static sk_sp<SkImage> ImageFromDecompressedData(
                            flow);
 }
 
+namespace {
+
+// Images that are decoded at a reduced size before they are resized to the
+// target size are decoded into an intermediate bitmap that is dropped once
+// resized. The memory of small intermediate bitmaps, like those of thumbnails
+// decoded in a batch, is returned to this pool when they are dropped and
+// reused by the next decode on any worker. The pool holds at most
+// |kMaxPooledByteSize| bytes and is emptied on low memory warnings.
+class ScratchPixelsPool {
+ public:
+  static constexpr size_t kMaxBufferByteSize = 4 << 20;
+  static constexpr size_t kMaxPooledByteSize = 8 << 20;
+
+  static ScratchPixelsPool& GetInstance() {
+    static ScratchPixelsPool* pool = new ScratchPixelsPool();
+    return *pool;
+  }
+
+  bool AllocPixels(SkBitmap& bitmap, const SkImageInfo& info) {
+    const size_t byte_size = info.computeMinByteSize();
+    if (SkImageInfo::ByteSizeOverflowed(byte_size) ||
+        byte_size > kMaxBufferByteSize) {
+      return bitmap.tryAllocPixels(info);
+    }
+    std::unique_ptr<std::vector<uint8_t>> buffer = TakeBuffer(byte_size);
+    if (!buffer) {
+      buffer = std::make_unique<std::vector<uint8_t>>(byte_size);
+    }
+    // The buffer comes back to the pool once the pixels are released, which
+    // also happens if they cannot be installed.
+    auto* released_buffer = buffer.release();
+    return bitmap.installPixels(
+        info, released_buffer->data(), info.minRowBytes(),
+        [](void* pixels, void* context) {
+          GetInstance().Recycle(std::unique_ptr<std::vector<uint8_t>>(
+              static_cast<std::vector<uint8_t>*>(context)));
+        },
+        released_buffer);
+  }
+
+  void Purge() {
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> buffers;
+    {
+      std::scoped_lock lock(mutex_);
+      buffers.swap(buffers_);
+      pooled_byte_size_ = 0;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<std::vector<uint8_t>>> buffers_;
+  size_t pooled_byte_size_ = 0;
+
+  // Takes the smallest pooled buffer that holds |byte_size| bytes, if any.
+  std::unique_ptr<std::vector<uint8_t>> TakeBuffer(size_t byte_size) {
+    std::scoped_lock lock(mutex_);
+    auto best = buffers_.end();
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+      if ((*it)->size() >= byte_size &&
+          (best == buffers_.end() || (*it)->size() < (*best)->size())) {
+        best = it;
+      }
+    }
+    if (best == buffers_.end()) {
+      return nullptr;
+    }
+    std::unique_ptr<std::vector<uint8_t>> buffer = std::move(*best);
+    buffers_.erase(best);
+    pooled_byte_size_ -= buffer->size();
+    return buffer;
+  }
+
+  void Recycle(std::unique_ptr<std::vector<uint8_t>> buffer) {
+    std::scoped_lock lock(mutex_);
+    if (pooled_byte_size_ + buffer->size() > kMaxPooledByteSize) {
+      return;
+    }
+    pooled_byte_size_ += buffer->size();
+    buffers_.push_back(std::move(buffer));
+  }
+};
+
+}  // namespace
+
 sk_sp<SkImage> ImageDecoderSkia::ImageFromCompressedData(
     ImageDescriptor* descriptor,
     uint32_t target_width,
@@ -127,8 +215,13 @@ sk_sp<SkImage> ImageDecoderSkia::ImageFromCompressedData(
     auto scaled_image_info =
         descriptor->image_info().makeDimensions(decode_dimensions);
 
+    // The resized image only shares the pixels of the scaled image when they
+    // have the same size, so the scaled image cannot use scratch pixels then.
     SkBitmap scaled_bitmap;
-    if (!scaled_bitmap.tryAllocPixels(scaled_image_info)) {
+    if (!(decode_dimensions != resized_dimensions
+              ? ScratchPixelsPool::GetInstance().AllocPixels(
+                    scaled_bitmap, scaled_image_info)
+              : scaled_bitmap.tryAllocPixels(scaled_image_info))) {
       FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
                      << scaled_image_info.computeMinByteSize() << "B";
       return nullptr;
@@ -217,47 +310,30 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
 }
 
 // |ImageDecoder|
-void ImageDecoderSkia::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
-                              uint32_t target_width,
-                              uint32_t target_height,
-                              const ImageResult& callback) {
+void ImageDecoderSkia::NotifyLowMemoryWarning() {
+  ImageDecoder::NotifyLowMemoryWarning();
+  ScratchPixelsPool::GetInstance().Purge();
+}
+
+// |ImageDecoder|
+void ImageDecoderSkia::DecodeAndUploadImage(ImageDescriptor* raw_descriptor,
+                                            uint32_t target_width,
+                                            uint32_t target_height,
+                                            const ImageResult& callback) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
 
-  // ImageDescriptors have Dart peers that must be collected on the UI thread.
-  // However, closures in MakeCopyable below capture the descriptor. The
-  // captures of copyable closures may be collected on any of the thread
-  // participating in task execution.
-  //
-  // To avoid this issue, we resort to manually reference counting the
-  // descriptor. Since all task flows invoke the `result` callback, the raw
-  // descriptor is retained in the beginning and released in the `result`
-  // callback.
-  //
-  // `ImageDecoder::Decode` itself is invoked on the UI thread, so the
-  // collection of the smart pointer from which we obtained the raw descriptor
-  // is fine in this scope.
-  auto raw_descriptor = descriptor_ref_ptr.get();
-  raw_descriptor->AddRef();
-
+  FML_DCHECK(raw_descriptor);
   FML_DCHECK(callback);
-  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
-
-  // Always service the callback (and cleanup the descriptor) on the UI thread.
-  auto result =
-      [callback, raw_descriptor, ui_runner = runners_.GetUITaskRunner()](
-          SkiaGPUObject<SkImage> image, fml::tracing::TraceFlow flow) {
-        ui_runner->PostTask(fml::MakeCopyable(
-            [callback, raw_descriptor, image = std::move(image),
-             flow = std::move(flow)]() mutable {
-              // We are going to terminate the trace flow here. Flows cannot
-              // terminate without a base trace. Add one explicitly.
-              TRACE_EVENT0("flutter", "ImageDecodeCallback");
-              flow.End();
-              callback(DlImageGPU::Make(std::move(image)), {});
-              raw_descriptor->Release();
-            }));
-      };
+
+  auto result = [callback](SkiaGPUObject<SkImage> image,
+                           fml::tracing::TraceFlow flow) {
+    // We are going to terminate the trace flow here. Flows cannot terminate
+    // without a base trace. Add one explicitly.
+    TRACE_EVENT0("flutter", "ImageDecodeCallback");
+    flow.End();
+    callback(DlImageGPU::Make(std::move(image)), {});
+  };
 
   if (!raw_descriptor->data() || raw_descriptor->data()->size() == 0) {
     result({}, std::move(flow));
@@ -20,10 +20,7 @@ class ImageDecoderSkia final : public ImageDecoder {
   ~ImageDecoderSkia() override;
 
   // |ImageDecoder|
-  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-              uint32_t target_width,
-              uint32_t target_height,
-              const ImageResult& result) override;
+  void NotifyLowMemoryWarning() override;
 
   static sk_sp<SkImage> ImageFromCompressedData(
       ImageDescriptor* descriptor,
@@ -32,6 +29,12 @@ class ImageDecoderSkia final : public ImageDecoder {
       const fml::tracing::TraceFlow& flow);
 
  private:
+  // |ImageDecoder|
+  void DecodeAndUploadImage(ImageDescriptor* descriptor,
+                            uint32_t target_width,
+                            uint32_t target_height,
+                            const ImageResult& result) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderSkia);
 };
 
@@ -9,6 +9,7 @@
 #include "flutter/impeller/core/device_buffer.h"
 #include "flutter/impeller/geometry/size.h"
 #include "flutter/impeller/renderer/context.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 #include "flutter/lib/ui/painting/image_decoder_no_gl_unittests.h"
@@ -24,12 +25,20 @@
 #include "flutter/testing/test_gl_surface.h"
 #include "flutter/testing/testing.h"
 #include "third_party/skia/include/codec/SkCodecAnimation.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/encode/SkPngEncoder.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 // CREATE_NATIVE_ENTRY is leaky by design
 // NOLINTBEGIN(clang-analyzer-core.StackAddressEscape)
 
@@ -673,6 +682,424 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
 }
 
+/// An image generator that records the order in which images start decoding.
+class RecordingImageGenerator : public ImageGenerator {
+ public:
+  RecordingImageGenerator(std::unique_ptr<ImageGenerator> generator,
+                          std::string name,
+                          std::mutex& mutex,
+                          std::vector<std::string>& decode_order)
+      : generator_(std::move(generator)),
+        name_(std::move(name)),
+        mutex_(mutex),
+        decode_order_(decode_order) {}
+  ~RecordingImageGenerator() = default;
+
+  const SkImageInfo& GetInfo() { return generator_->GetInfo(); }
+
+  unsigned int GetFrameCount() const { return generator_->GetFrameCount(); }
+
+  unsigned int GetPlayCount() const { return generator_->GetPlayCount(); }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(unsigned int frame_index) {
+    return generator_->GetFrameInfo(frame_index);
+  }
+
+  SkISize GetScaledDimensions(float scale) {
+    return generator_->GetScaledDimensions(scale);
+  }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) {
+    {
+      std::scoped_lock lock(mutex_);
+      decode_order_.push_back(name_);
+    }
+    return generator_->GetPixels(info, pixels, row_bytes, frame_index,
+                                 prior_frame);
+  };
+
+ private:
+  std::unique_ptr<ImageGenerator> generator_;
+  std::string name_;
+  std::mutex& mutex_;
+  std::vector<std::string>& decode_order_;
+};
+
+TEST_F(ImageDecoderFixtureTest, CanDecodeBatches) {
+  // A single worker starts the decodes in the order they are posted.
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  // Setup the IO manager.
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  // Setup the image decoder.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    Settings settings;
+    image_decoder = ImageDecoder::Make(settings, runners, loop->GetTaskRunner(),
+                                       io_manager->GetWeakIOManager(),
+                                       std::make_shared<fml::SyncSwitch>());
+  });
+
+  std::mutex decode_order_mutex;
+  std::vector<std::string> decode_order;
+  auto make_descriptor = [&](const char* fixture) {
+    auto data = flutter::testing::OpenFixtureAsSkData(fixture);
+    auto generator = std::make_unique<RecordingImageGenerator>(
+        BuiltinSkiaCodecImageGenerator::MakeFromData(data), fixture,
+        decode_order_mutex, decode_order);
+    return fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                std::move(generator));
+  };
+
+  int callback_count = 0;
+  std::vector<ImageDecoder::BatchDecodeResult> results;
+  runners.GetUITaskRunner()->PostTask([&]() {
+    std::vector<ImageDecoder::BatchDecodeRequest> requests;
+    requests.push_back({.descriptor = make_descriptor("Horizontal.jpg"),
+                        .target_width = 60,
+                        .target_height = 20});
+    requests.push_back({.descriptor = make_descriptor("DashInNooglerHat.jpg"),
+                        .target_width = 300,
+                        .target_height = 400,
+                        .priority = 1});
+    requests.push_back({.descriptor = make_descriptor("heart_end.png"),
+                        .target_width = 250,
+                        .target_height = 250});
+    image_decoder->DecodeBatch(
+        std::move(requests),
+        [&](std::vector<ImageDecoder::BatchDecodeResult> batch_results) {
+          ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+          callback_count++;
+          results = std::move(batch_results);
+          latch.Signal();
+        });
+  });
+  latch.Wait();
+
+  // All the results are returned at once, in the order of the requests.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    ASSERT_EQ(callback_count, 1);
+    ASSERT_EQ(results.size(), 3u);
+    for (const auto& result : results) {
+      ASSERT_TRUE(result.image && result.image->skia_image());
+    }
+    ASSERT_EQ(results[0].image->dimensions(), SkISize::Make(60, 20));
+    ASSERT_EQ(results[1].image->dimensions(), SkISize::Make(300, 400));
+    ASSERT_EQ(results[2].image->dimensions(), SkISize::Make(250, 250));
+    results.clear();
+  });
+
+  // The decodes start by descending priority, then largest target first.
+  {
+    std::scoped_lock lock(decode_order_mutex);
+    ASSERT_EQ(decode_order,
+              std::vector<std::string>({"DashInNooglerHat.jpg", "heart_end.png",
+                                        "Horizontal.jpg"}));
+  }
+
+  // Destroy the IO manager
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+
+  // Destroy the image decoder
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+}
+
+/// An image generator that counts how many times its pixels were decoded.
+class CountingImageGenerator : public ImageGenerator {
+ public:
+  CountingImageGenerator(std::unique_ptr<ImageGenerator> generator,
+                         std::atomic<int>& decode_count)
+      : generator_(std::move(generator)), decode_count_(decode_count) {}
+  ~CountingImageGenerator() = default;
+
+  const SkImageInfo& GetInfo() { return generator_->GetInfo(); }
+
+  unsigned int GetFrameCount() const { return generator_->GetFrameCount(); }
+
+  unsigned int GetPlayCount() const { return generator_->GetPlayCount(); }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(unsigned int frame_index) {
+    return generator_->GetFrameInfo(frame_index);
+  }
+
+  SkISize GetScaledDimensions(float scale) {
+    return generator_->GetScaledDimensions(scale);
+  }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) {
+    decode_count_++;
+    return generator_->GetPixels(info, pixels, row_bytes, frame_index,
+                                 prior_frame);
+  };
+
+ private:
+  std::unique_ptr<ImageGenerator> generator_;
+  std::atomic<int>& decode_count_;
+};
+
+TEST_F(ImageDecoderFixtureTest, DecodedImageCacheSkipsSecondDecode) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  // Setup the IO manager.
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  // Setup the image decoder.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    // The cache is enabled by default.
+    Settings settings;
+    ASSERT_GT(settings.decoded_image_cache_max_bytes, 0u);
+    image_decoder = ImageDecoder::Make(settings, runners, loop->GetTaskRunner(),
+                                       io_manager->GetWeakIOManager(),
+                                       std::make_shared<fml::SyncSwitch>());
+  });
+
+  // Every decode uses a new buffer and descriptor, like an asset that is
+  // loaded again each time it is shown.
+  std::atomic<int> decode_count = 0;
+  auto decode = [&](uint32_t target_width,
+                    uint32_t target_height) -> sk_sp<DlImage> {
+    sk_sp<DlImage> result;
+    runners.GetUITaskRunner()->PostTask([&]() {
+      auto data = flutter::testing::OpenFixtureAsSkData("DashInNooglerHat.jpg");
+      ASSERT_TRUE(data);
+      auto generator = std::make_unique<CountingImageGenerator>(
+          BuiltinSkiaCodecImageGenerator::MakeFromData(data), decode_count);
+      auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+          std::move(data), std::move(generator));
+
+      ImageDecoder::ImageResult callback =
+          [&](const sk_sp<DlImage>& image, const std::string& decode_error) {
+            ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+            ASSERT_TRUE(image && image->skia_image());
+            result = image;
+            latch.Signal();
+          };
+      image_decoder->Decode(descriptor, target_width, target_height, callback);
+    });
+    latch.Wait();
+    return result;
+  };
+
+  auto first = decode(100, 100);
+  ASSERT_EQ(decode_count.load(), 1);
+
+  // The second decode of the same bytes at the same size is skipped.
+  auto second = decode(100, 100);
+  ASSERT_EQ(decode_count.load(), 1);
+  ASSERT_EQ(first, second);
+
+  // Other sizes are decoded.
+  ASSERT_EQ(decode(200, 200)->dimensions(), SkISize::Make(200, 200));
+  ASSERT_EQ(decode_count.load(), 2);
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    const DecodedImageCache& cache = image_decoder->GetDecodedImageCache();
+    ASSERT_EQ(cache.GetHitCount(), 1u);
+    ASSERT_EQ(cache.GetMissCount(), 2u);
+    ASSERT_EQ(cache.GetImageCount(), 2u);
+
+    // Low memory warnings evict all images.
+    image_decoder->NotifyLowMemoryWarning();
+    ASSERT_EQ(cache.GetImageCount(), 0u);
+    ASSERT_EQ(cache.GetByteSize(), 0u);
+  });
+  decode(100, 100);
+  ASSERT_EQ(decode_count.load(), 3);
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    first.reset();
+    second.reset();
+  });
+
+  // Destroy the IO manager
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+
+  // Destroy the image decoder
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+}
+
+TEST(DecodedImageCacheTest, ComparesBuffersOfMatchingKeys) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(4, 4);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  sk_sp<DlImage> image = DlImage::Make(SkImages::RasterFromBitmap(bitmap));
+  ASSERT_TRUE(image);
+
+  std::vector<uint8_t> bytes(64, 1);
+  sk_sp<SkData> content = SkData::MakeWithCopy(bytes.data(), bytes.size());
+  sk_sp<SkData> same_content =
+      SkData::MakeWithCopy(bytes.data(), bytes.size());
+  bytes[10] = 2;
+  sk_sp<SkData> other_content =
+      SkData::MakeWithCopy(bytes.data(), bytes.size());
+
+  DecodedImageCache cache(1 << 20);
+  // Stands in for a hash collision between the buffers.
+  const DecodedImageCache::Key key = {.content_hash = 42,
+                                      .content_size = bytes.size()};
+  cache.Put(key, content, image);
+  ASSERT_EQ(cache.GetByteSize(),
+            image->GetApproximateByteSize() + content->size());
+
+  EXPECT_EQ(cache.Get(key, *content), image);
+  EXPECT_EQ(cache.Get(key, *same_content), image);
+  EXPECT_EQ(cache.Get(key, *other_content), nullptr);
+  EXPECT_EQ(cache.GetHitCount(), 2u);
+  EXPECT_EQ(cache.GetMissCount(), 1u);
+}
+
+TEST(DecodedImageCacheTest, KeysRawPixelsByTheirLayout) {
+  sk_sp<SkData> pixels = SkData::MakeZeroInitialized(64);
+  auto square = fml::MakeRefCounted<ImageDescriptor>(
+      pixels, SkImageInfo::MakeN32Premul(4, 4), 16);
+  auto wide = fml::MakeRefCounted<ImageDescriptor>(
+      pixels, SkImageInfo::MakeN32Premul(8, 2), 32);
+  auto tight = fml::MakeRefCounted<ImageDescriptor>(
+      pixels, SkImageInfo::MakeN32Premul(2, 4), 8);
+  auto padded = fml::MakeRefCounted<ImageDescriptor>(
+      pixels, SkImageInfo::MakeN32Premul(2, 4), 16);
+
+  // The same bytes hold different images.
+  const auto square_key = DecodedImageCache::MakeKey(*square, 0, 0);
+  EXPECT_EQ(square_key, DecodedImageCache::MakeKey(*square, 0, 0));
+  EXPECT_FALSE(square_key == DecodedImageCache::MakeKey(*wide, 0, 0));
+  EXPECT_FALSE(DecodedImageCache::MakeKey(*tight, 0, 0) ==
+               DecodedImageCache::MakeKey(*padded, 0, 0));
+}
+
+TEST_F(ImageDecoderFixtureTest, CanDecodeRegionsAndProgressively) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  // Setup the IO manager.
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  // Setup the image decoder.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    Settings settings;
+    image_decoder = ImageDecoder::Make(settings, runners, loop->GetTaskRunner(),
+                                       io_manager->GetWeakIOManager(),
+                                       std::make_shared<fml::SyncSwitch>());
+  });
+
+  auto make_descriptor = []() {
+    auto data = flutter::testing::OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    ImageGeneratorRegistry registry;
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    FML_CHECK(generator);
+    return fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                std::move(generator));
+  };
+
+  // Decodes a region and gives us its final size, which is empty on errors.
+  auto decoded_region_size = [&](const SkIRect& region, uint32_t target_width,
+                                 uint32_t target_height) -> SkISize {
+    SkISize final_size = SkISize::MakeEmpty();
+    runners.GetUITaskRunner()->PostTask([&]() {
+      ImageDecoder::ImageResult callback =
+          [&](const sk_sp<DlImage>& image, const std::string& decode_error) {
+            ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+            if (image) {
+              ASSERT_TRUE(image->skia_image());
+              final_size = image->skia_image()->dimensions();
+            }
+            latch.Signal();
+          };
+      image_decoder->DecodeRegion(make_descriptor(), region, target_width,
+                                  target_height, callback);
+    });
+    latch.Wait();
+    return final_size;
+  };
+
+  const SkIRect region = SkIRect::MakeXYWH(1000, 1000, 1024, 1024);
+  ASSERT_EQ(decoded_region_size(region, 0, 0), SkISize::Make(1024, 1024));
+  ASSERT_EQ(decoded_region_size(region, 256, 256), SkISize::Make(256, 256));
+  ASSERT_EQ(decoded_region_size(region, 100, 50), SkISize::Make(100, 50));
+  // Regions are clipped to the image.
+  ASSERT_EQ(decoded_region_size(SkIRect::MakeXYWH(2024, 3032, 2000, 2000), 0,
+                                0),
+            SkISize::Make(1000, 1000));
+  ASSERT_TRUE(decoded_region_size(SkIRect::MakeXYWH(4000, 0, 100, 100), 0, 0)
+                  .isEmpty());
+
+  // The first pass must be delivered before the final image, at a fraction of
+  // its size.
+  std::vector<SkISize> pass_sizes;
+  runners.GetUITaskRunner()->PostTask([&]() {
+    ImageDecoder::ImageResult first_pass = [&](const sk_sp<DlImage>& image,
+                                               const std::string&) {
+      ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+      ASSERT_TRUE(image && image->skia_image());
+      pass_sizes.push_back(image->skia_image()->dimensions());
+    };
+    ImageDecoder::ImageResult result = [&](const sk_sp<DlImage>& image,
+                                           const std::string&) {
+      ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+      ASSERT_TRUE(image && image->skia_image());
+      pass_sizes.push_back(image->skia_image()->dimensions());
+      latch.Signal();
+    };
+    image_decoder->DecodeProgressively(make_descriptor(), 3024, 4032,
+                                       first_pass, result);
+  });
+  latch.Wait();
+  ASSERT_EQ(pass_sizes.size(), 2u);
+  ASSERT_EQ(pass_sizes[0], SkISize::Make(378, 504));
+  ASSERT_EQ(pass_sizes[1], SkISize::Make(3024, 4032));
+
+  // Destroy the IO manager
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+
+  // Destroy the image decoder
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+}
+
 // Verifies https://skia-review.googlesource.com/c/skia/+/259161 is present in
 // Flutter.
 TEST(ImageDecoderTest,
@@ -792,6 +1219,214 @@ TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   assert_image(decode(300, 100), {});
 }
 
+TEST(ImageDecoderTest, DecodingSubsetsMatchesDecodingTheWholeImage) {
+  auto assert_subset_matches = [](const char* fixture, float scale,
+                                  const SkIRect& subset) {
+    auto data = flutter::testing::OpenFixtureAsSkData(fixture);
+    ASSERT_TRUE(data);
+    ImageGeneratorRegistry registry;
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    ASSERT_TRUE(generator);
+
+    const SkISize scaled_size = generator->GetScaledDimensions(scale);
+    SkBitmap whole;
+    whole.allocPixels(generator->GetInfo().makeDimensions(scaled_size));
+    ASSERT_TRUE(generator->GetPixels(whole.info(), whole.getPixels(),
+                                     whole.rowBytes()));
+
+    SkBitmap part;
+    part.allocPixels(generator->GetInfo().makeDimensions(subset.size()));
+    ASSERT_TRUE(generator->GetPixelsInSubset(part.info(), part.getPixels(),
+                                             part.rowBytes(), scaled_size,
+                                             subset));
+
+    // Codecs may round the subset out to block boundaries, which can change
+    // the filtering of chroma samples at its edges by a little.
+    int max_difference = 0;
+    for (int y = 0; y < subset.height(); y++) {
+      const uint8_t* expected = static_cast<const uint8_t*>(
+          whole.getAddr(subset.x(), subset.y() + y));
+      const uint8_t* actual = static_cast<const uint8_t*>(part.getAddr(0, y));
+      for (int i = 0; i < subset.width() * part.bytesPerPixel(); i++) {
+        max_difference =
+            std::max(max_difference, std::abs(expected[i] - actual[i]));
+      }
+    }
+    ASSERT_LE(max_difference, 2) << fixture << " at scale " << scale;
+  };
+
+  assert_subset_matches("DashInNooglerHat.jpg", 1.0f,
+                        SkIRect::MakeXYWH(1003, 2011, 517, 301));
+  assert_subset_matches("DashInNooglerHat.jpg", 0.25f,
+                        SkIRect::MakeXYWH(101, 203, 256, 256));
+  // EXIF oriented images are decoded through the whole image.
+  assert_subset_matches("Horizontal.jpg", 1.0f,
+                        SkIRect::MakeXYWH(150, 50, 300, 100));
+  assert_subset_matches("heart_end.png", 1.0f, SkIRect::MakeXYWH(5, 7, 50, 60));
+}
+
+TEST(ImageDecoderTest, AnimatedFrameDecoderLookaheadMatchesDecodingOnDemand) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+
+  auto assert_frames_match = [&loop](const char* fixture) {
+    auto data = flutter::testing::OpenFixtureAsSkData(fixture);
+    ASSERT_TRUE(data);
+    ImageGeneratorRegistry registry;
+    auto on_demand = std::make_shared<AnimatedFrameDecoder>(
+        registry.CreateCompatibleGenerator(data), nullptr, 0);
+    auto lookahead = std::make_shared<AnimatedFrameDecoder>(
+        registry.CreateCompatibleGenerator(data), loop->GetTaskRunner(), 3);
+    ASSERT_GT(on_demand->frame_count(), 1) << fixture;
+    ASSERT_EQ(lookahead->lookahead_frame_count(), 3);
+
+    // Play the animation twice so that pooled buffers are reused across loops.
+    for (int i = 0; i < on_demand->frame_count() * 2; i++) {
+      AnimatedFrameDecoder::Frame expected = on_demand->GetNextFrame();
+      AnimatedFrameDecoder::Frame actual = lookahead->GetNextFrame();
+      ASSERT_EQ(expected.index, i % on_demand->frame_count());
+      ASSERT_EQ(actual.index, expected.index) << fixture;
+      ASSERT_EQ(actual.duration, expected.duration) << fixture;
+      ASSERT_FALSE(expected.bitmap.drawsNothing()) << expected.decode_error;
+      ASSERT_FALSE(actual.bitmap.drawsNothing()) << actual.decode_error;
+      ASSERT_EQ(actual.bitmap.info(), expected.bitmap.info());
+      for (int y = 0; y < expected.bitmap.height(); y++) {
+        ASSERT_EQ(memcmp(expected.bitmap.getAddr(0, y),
+                         actual.bitmap.getAddr(0, y),
+                         expected.bitmap.info().minRowBytes()),
+                  0)
+            << fixture << " frame " << expected.index << " row " << y;
+      }
+      on_demand->RecycleFrame(std::move(expected.bitmap));
+      lookahead->RecycleFrame(std::move(actual.bitmap));
+    }
+  };
+
+  assert_frames_match("2_dispose_op_restore_previous.apng");
+  assert_frames_match("alpha_animated.apng");
+  assert_frames_match("dispose_op_background.apng");
+  assert_frames_match("hello_loop_2.gif");
+  assert_frames_match("hello_loop_2.webp");
+}
+
+/// An image generator that counts the calls that overlapped with another call
+/// on a different thread.
+class ExclusiveImageGenerator : public ImageGenerator {
+ public:
+  explicit ExclusiveImageGenerator(std::unique_ptr<ImageGenerator> generator)
+      : generator_(std::move(generator)) {}
+  ~ExclusiveImageGenerator() = default;
+
+  const SkImageInfo& GetInfo() {
+    Use use(*this);
+    return generator_->GetInfo();
+  }
+
+  unsigned int GetFrameCount() const {
+    Use use(*this);
+    return generator_->GetFrameCount();
+  }
+
+  unsigned int GetPlayCount() const {
+    Use use(*this);
+    return generator_->GetPlayCount();
+  }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(unsigned int frame_index) {
+    Use use(*this);
+    return generator_->GetFrameInfo(frame_index);
+  }
+
+  SkISize GetScaledDimensions(float scale) {
+    Use use(*this);
+    return generator_->GetScaledDimensions(scale);
+  }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) {
+    Use use(*this);
+    // Give the other decoders time to overlap with this call.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return generator_->GetPixels(info, pixels, row_bytes, frame_index,
+                                 prior_frame);
+  }
+
+  int overlap_count() const { return overlap_count_; }
+
+ private:
+  class Use {
+   public:
+    explicit Use(const ExclusiveImageGenerator& generator)
+        : generator_(generator) {
+      if (generator_.use_count_++ > 0) {
+        generator_.overlap_count_++;
+      }
+    }
+
+    ~Use() { generator_.use_count_--; }
+
+   private:
+    const ExclusiveImageGenerator& generator_;
+  };
+
+  std::unique_ptr<ImageGenerator> generator_;
+  mutable std::atomic<int> use_count_ = 0;
+  mutable std::atomic<int> overlap_count_ = 0;
+};
+
+TEST(ImageDecoderTest, FrameDecodersOfOneDescriptorSerializeGeneratorUse) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto data = flutter::testing::OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(data);
+  ImageGeneratorRegistry registry;
+  auto generator = std::make_shared<ExclusiveImageGenerator>(
+      registry.CreateCompatibleGenerator(data));
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(data, generator);
+
+  // Like the codecs of two images made from the same descriptor, both decode
+  // ahead on the workers.
+  std::shared_ptr<AnimatedFrameDecoder> decoders[] = {
+      descriptor->CreateFrameDecoder(loop->GetTaskRunner(), 3),
+      descriptor->CreateFrameDecoder(loop->GetTaskRunner(), 3),
+  };
+  ASSERT_GT(decoders[0]->frame_count(), 1);
+  ASSERT_EQ(decoders[0]->lookahead_frame_count(), 3);
+  ASSERT_EQ(decoders[1]->lookahead_frame_count(), 3);
+
+  auto play = [&](AnimatedFrameDecoder& decoder) {
+    for (int i = 0; i < decoder.frame_count() * 4; i++) {
+      AnimatedFrameDecoder::Frame frame = decoder.GetNextFrame();
+      EXPECT_EQ(frame.index, i % decoder.frame_count());
+      EXPECT_FALSE(frame.bitmap.drawsNothing()) << frame.decode_error;
+      // The descriptor uses the generator too.
+      descriptor->get_scaled_dimensions(1.0f);
+      decoder.RecycleFrame(std::move(frame.bitmap));
+    }
+  };
+  std::thread other_player([&]() { play(*decoders[1]); });
+  play(*decoders[0]);
+  other_player.join();
+
+  EXPECT_EQ(generator->overlap_count(), 0);
+}
+
+TEST(ImageDecoderTest, AnimatedFrameDecoderLookaheadFitsByteBudget) {
+  constexpr size_t kBudget = AnimatedFrameDecoder::kLookaheadByteBudget;
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(0), 0);
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(100 * 100 * 4),
+            AnimatedFrameDecoder::kMaxLookaheadFrameCount);
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(kBudget / 2), 2);
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(kBudget), 1);
+  // Large frames, such as those of a full screen animation, are decoded on
+  // demand.
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(kBudget + 1), 0);
+  EXPECT_EQ(AnimatedFrameDecoder::DefaultLookaheadFrameCount(1080 * 1920 * 4),
+            0);
+}
+
 TEST_F(ImageDecoderFixtureTest,
        MultiFrameCodecCanBeCollectedBeforeIOTasksFinish) {
   // This test verifies that the MultiFrameCodec safely shares state between
@@ -4,9 +4,14 @@
 
 #include "flutter/lib/ui/painting/image_descriptor.h"
 
+#include <algorithm>
+
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -110,25 +115,230 @@ void ImageDescriptor::initRaw(Dart_Handle descriptor_handle,
 void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
                                        int target_width,
                                        int target_height) {
+  bool is_animated = false;
+  int lookahead_frame_count = 0;
+  if (generator_) {
+    std::scoped_lock generator_lock(*generator_mutex_);
+    is_animated = generator_->GetFrameCount() > 1;
+    if (is_animated) {
+      lookahead_frame_count =
+          AnimatedFrameDecoder::DefaultLookaheadFrameCount(*generator_);
+    }
+  }
+
   fml::RefPtr<Codec> ui_codec;
-  if (!generator_ || generator_->GetFrameCount() == 1) {
+  if (!is_animated) {
     ui_codec = fml::MakeRefCounted<SingleFrameCodec>(
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
         target_height);
   } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
+    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(
+        CreateFrameDecoder(UIDartState::Current()->GetConcurrentTaskRunner(),
+                           lookahead_frame_count));
   }
   ui_codec->AssociateWithDartWrapper(codec_handle);
 }
 
+// Returns a decoder callback that invokes the Dart callback with the image and
+// the error. The persistent handle is cleared when the callback is invoked
+// with `last` set, so that it is not released on another thread when the
+// decoder drops its copies of the callback.
+static ImageDecoder::ImageResult MakeDartImageResult(
+    const std::shared_ptr<tonic::DartPersistentValue>& callback,
+    bool last) {
+  return [callback, last](const sk_sp<DlImage>& image,
+                          const std::string& decode_error) {
+    auto dart_state = callback->dart_state().lock();
+    if (!dart_state) {
+      // The isolate was terminated before the image could be decoded.
+      return;
+    }
+    tonic::DartState::Scope scope(dart_state.get());
+    fml::RefPtr<CanvasImage> canvas_image;
+    if (image) {
+      canvas_image = fml::MakeRefCounted<CanvasImage>();
+      canvas_image->set_image(image);
+    }
+    tonic::DartInvoke(callback->value(), {tonic::ToDart(canvas_image),
+                                          tonic::ToDart(decode_error)});
+    if (last) {
+      callback->Clear();
+    }
+  };
+}
+
+Dart_Handle ImageDescriptor::decodeBatch(Dart_Handle descriptors_handle,
+                                         const tonic::Int32List& requests,
+                                         Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+  intptr_t length = 0;
+  if (!Dart_IsList(descriptors_handle) ||
+      Dart_IsError(Dart_ListLength(descriptors_handle, &length)) ||
+      requests.num_elements() != length * 3) {
+    return tonic::ToDart("Requests must match the descriptors");
+  }
+
+  std::vector<ImageDecoder::BatchDecodeRequest> batch;
+  batch.reserve(length);
+  for (intptr_t i = 0; i < length; i++) {
+    auto* descriptor = tonic::DartConverter<ImageDescriptor*>::FromDart(
+        Dart_ListGetAt(descriptors_handle, i));
+    if (!descriptor) {
+      return tonic::ToDart("Descriptor must not be null");
+    }
+    batch.push_back({
+        .descriptor = fml::Ref(descriptor),
+        .target_width = static_cast<uint32_t>(std::max(requests[i * 3], 0)),
+        .target_height =
+            static_cast<uint32_t>(std::max(requests[i * 3 + 1], 0)),
+        .priority = requests[i * 3 + 2],
+    });
+  }
+
+  // This has to be valid because this method is called from Dart.
+  auto dart_state = UIDartState::Current();
+  auto decoder = dart_state->GetImageDecoder();
+  if (!decoder) {
+    return tonic::ToDart(
+        "Failed to access the internal image decoder "
+        "registry on this isolate. Please file a bug on "
+        "https://github.com/flutter/flutter/issues.");
+  }
+
+  auto callback =
+      std::make_shared<tonic::DartPersistentValue>(dart_state, callback_handle);
+  decoder->DecodeBatch(
+      std::move(batch),
+      [callback](std::vector<ImageDecoder::BatchDecodeResult> results) {
+        auto dart_state = callback->dart_state().lock();
+        if (!dart_state) {
+          // The isolate was terminated before the images could be decoded.
+          return;
+        }
+        tonic::DartState::Scope scope(dart_state.get());
+        for (size_t i = 0; i < results.size(); i++) {
+          fml::RefPtr<CanvasImage> canvas_image;
+          if (results[i].image) {
+            canvas_image = fml::MakeRefCounted<CanvasImage>();
+            canvas_image->set_image(results[i].image);
+          }
+          tonic::DartInvoke(callback->value(),
+                            {tonic::ToDart(static_cast<int>(i)),
+                             tonic::ToDart(canvas_image),
+                             tonic::ToDart(results[i].decode_error)});
+        }
+        callback->Clear();
+      });
+  return Dart_Null();
+}
+
+Dart_Handle ImageDescriptor::decodeRegion(Dart_Handle callback_handle,
+                                          int left,
+                                          int top,
+                                          int right,
+                                          int bottom,
+                                          int target_width,
+                                          int target_height) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+  if (left >= right || top >= bottom) {
+    return tonic::ToDart("Region must not be empty");
+  }
+
+  // This has to be valid because this method is called from Dart.
+  auto dart_state = UIDartState::Current();
+  auto decoder = dart_state->GetImageDecoder();
+  if (!decoder) {
+    return tonic::ToDart(
+        "Failed to access the internal image decoder "
+        "registry on this isolate. Please file a bug on "
+        "https://github.com/flutter/flutter/issues.");
+  }
+
+  auto callback =
+      std::make_shared<tonic::DartPersistentValue>(dart_state, callback_handle);
+  decoder->DecodeRegion(fml::Ref(this),
+                        SkIRect::MakeLTRB(left, top, right, bottom),
+                        std::max(target_width, 0), std::max(target_height, 0),
+                        MakeDartImageResult(callback, /*last=*/true));
+  return Dart_Null();
+}
+
+Dart_Handle ImageDescriptor::decodeProgressively(Dart_Handle first_pass_handle,
+                                                 Dart_Handle callback_handle,
+                                                 int target_width,
+                                                 int target_height) {
+  if (!Dart_IsClosure(callback_handle) ||
+      !(Dart_IsNull(first_pass_handle) || Dart_IsClosure(first_pass_handle))) {
+    return tonic::ToDart("Callback must be a function");
+  }
+
+  // This has to be valid because this method is called from Dart.
+  auto dart_state = UIDartState::Current();
+  auto decoder = dart_state->GetImageDecoder();
+  if (!decoder) {
+    return tonic::ToDart(
+        "Failed to access the internal image decoder "
+        "registry on this isolate. Please file a bug on "
+        "https://github.com/flutter/flutter/issues.");
+  }
+
+  auto callback =
+      std::make_shared<tonic::DartPersistentValue>(dart_state, callback_handle);
+  ImageDecoder::ImageResult result;
+  ImageDecoder::ImageResult first_pass = [](auto, auto) {};
+  if (Dart_IsNull(first_pass_handle)) {
+    result = MakeDartImageResult(callback, /*last=*/true);
+  } else {
+    // The first pass is always reported before the result, so the result
+    // clears both handles.
+    auto first_pass_callback = std::make_shared<tonic::DartPersistentValue>(
+        dart_state, first_pass_handle);
+    first_pass = MakeDartImageResult(first_pass_callback, /*last=*/false);
+    result = [first_pass_callback,
+              last_result = MakeDartImageResult(callback, /*last=*/true)](
+                 const sk_sp<DlImage>& image,
+                 const std::string& decode_error) {
+      last_result(image, decode_error);
+      first_pass_callback->Clear();
+    };
+  }
+  decoder->DecodeProgressively(fml::Ref(this), std::max(target_width, 0),
+                               std::max(target_height, 0), first_pass, result);
+  return Dart_Null();
+}
+
+std::shared_ptr<AnimatedFrameDecoder> ImageDescriptor::CreateFrameDecoder(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+    int lookahead_frame_count) const {
+  FML_DCHECK(generator_);
+  return std::make_shared<AnimatedFrameDecoder>(
+      generator_, std::move(worker_task_runner), lookahead_frame_count,
+      generator_mutex_);
+}
+
 sk_sp<SkImage> ImageDescriptor::image() const {
+  std::scoped_lock generator_lock(*generator_mutex_);
   return generator_->GetImage();
 }
 
 bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
   FML_DCHECK(generator_);
+  std::scoped_lock generator_lock(*generator_mutex_);
   return generator_->GetPixels(pixmap.info(), pixmap.writable_addr(),
                                pixmap.rowBytes());
 }
 
+bool ImageDescriptor::get_pixels_in_subset(const SkPixmap& pixmap,
+                                           const SkISize& scaled_size,
+                                           const SkIRect& subset) const {
+  FML_DCHECK(generator_);
+  std::scoped_lock generator_lock(*generator_mutex_);
+  return generator_->GetPixelsInSubset(pixmap.info(), pixmap.writable_addr(),
+                                       pixmap.rowBytes(), scaled_size, subset);
+}
+
 }  // namespace flutter
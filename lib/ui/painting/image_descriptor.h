@@ -7,10 +7,12 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/dart_wrapper.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
 #include "flutter/lib/ui/painting/image_generator_registry.h"
 #include "flutter/lib/ui/painting/immutable_buffer.h"
 #include "third_party/skia/include/core/SkData.h"
@@ -19,6 +21,7 @@
 #include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/typed_data/typed_list.h"
 
 namespace flutter {
 
@@ -59,9 +62,42 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
                       int row_bytes,
                       PixelFormat pixel_format);
 
+  /// @brief  Decodes the `ImageDescriptor`s in the `descriptors_handle` list
+  ///         as a single batch. `requests` holds the target width, target
+  ///         height and priority of each descriptor in turn. Once the whole
+  ///         batch is done, `callback_handle` is invoked on the UI thread with
+  ///         the index, the image (or null) and the error message of each
+  ///         descriptor in order.
+  /// @see    `ImageDecoder::DecodeBatch`
+  static Dart_Handle decodeBatch(Dart_Handle descriptors_handle,
+                                 const tonic::Int32List& requests,
+                                 Dart_Handle callback_handle);
+
   /// @brief  Associates a flutter::Codec object with the dart.ui Codec handle.
   void instantiateCodec(Dart_Handle codec, int target_width, int target_height);
 
+  /// @brief  Decodes the pixels of this image within the region from `left`,
+  ///         `top` to `right`, `bottom`, and invokes `callback_handle` on the
+  ///         UI thread with the image (or null) and an error message.
+  /// @see    `ImageDecoder::DecodeRegion`
+  Dart_Handle decodeRegion(Dart_Handle callback_handle,
+                           int left,
+                           int top,
+                           int right,
+                           int bottom,
+                           int target_width,
+                           int target_height);
+
+  /// @brief  Decodes this image in two passes. `first_pass_handle` may be
+  ///         null, and is otherwise invoked with the image of the first pass,
+  ///         if there is one, before `callback_handle` is invoked like the
+  ///         callback of `decodeRegion`.
+  /// @see    `ImageDecoder::DecodeProgressively`
+  Dart_Handle decodeProgressively(Dart_Handle first_pass_handle,
+                                  Dart_Handle callback_handle,
+                                  int target_width,
+                                  int target_height);
+
   /// @brief  The width of this image, EXIF oriented if applicable.
   int width() const { return image_info_.width(); }
 
@@ -101,6 +137,7 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   /// @see    `ImageGenerator::GetScaledDimensions`
   SkISize get_scaled_dimensions(float scale) {
     if (generator_) {
+      std::scoped_lock generator_lock(*generator_mutex_);
       return generator_->GetScaledDimensions(scale);
     }
     return image_info_.dimensions();
@@ -110,6 +147,22 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         orientation tag, if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// @brief  Gets the pixels of a subset of this image, scaled to a size
+  ///         returned by `get_scaled_dimensions`, transformed based on the EXIF
+  ///         orientation tag, if applicable.
+  /// @see    `ImageGenerator::GetPixelsInSubset`
+  bool get_pixels_in_subset(const SkPixmap& pixmap,
+                            const SkISize& scaled_size,
+                            const SkIRect& subset) const;
+
+  /// @brief  Creates a decoder for the frames of this animated image. The
+  ///         decoders of a descriptor share its generator, and hold the same
+  ///         mutex as the descriptor whenever they use it.
+  /// @see    `AnimatedFrameDecoder`
+  std::shared_ptr<AnimatedFrameDecoder> CreateFrameDecoder(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+      int lookahead_frame_count) const;
+
   void dispose() {
     buffer_.reset();
     generator_.reset();
@@ -125,6 +178,10 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
 
   sk_sp<SkData> buffer_;
   std::shared_ptr<ImageGenerator> generator_;
+  // Held while the generator is used. The generator may be used by the frame
+  // decoders of the codecs of this descriptor on workers at the same time.
+  const std::shared_ptr<std::mutex> generator_mutex_ =
+      std::make_shared<std::mutex>();
   const SkImageInfo image_info_;
   std::optional<size_t> row_bytes_;
 
@@ -35,6 +35,29 @@ sk_sp<SkImage> ImageGenerator::GetImage() {
   return SkImages::RasterFromBitmap(bitmap);
 }
 
+bool ImageGenerator::GetPixelsInSubset(const SkImageInfo& info,
+                                       void* pixels,
+                                       size_t row_bytes,
+                                       const SkISize& scaled_size,
+                                       const SkIRect& subset) {
+  FML_DCHECK(info.dimensions() == subset.size());
+  FML_DCHECK(SkIRect::MakeSize(scaled_size).contains(subset));
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info.makeDimensions(scaled_size))) {
+    FML_DLOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                    << bitmap.info().computeMinByteSize() << "B";
+    return false;
+  }
+
+  const auto& pixmap = bitmap.pixmap();
+  if (!GetPixels(pixmap.info(), pixmap.writable_addr(), pixmap.rowBytes())) {
+    FML_DLOG(ERROR) << "Failed to get pixels for image.";
+    return false;
+  }
+  return pixmap.readPixels(info, pixels, row_bytes, subset.x(), subset.y());
+}
+
 BuiltinSkiaImageGenerator::~BuiltinSkiaImageGenerator() = default;
 
 BuiltinSkiaImageGenerator::BuiltinSkiaImageGenerator(
@@ -188,6 +211,47 @@ bool BuiltinSkiaCodecImageGenerator::GetPixels(
   return SkPixmapUtils::Orient(output_pixmap, temp_pixmap, origin);
 }
 
+bool BuiltinSkiaCodecImageGenerator::GetPixelsInSubset(
+    const SkImageInfo& info,
+    void* pixels,
+    size_t row_bytes,
+    const SkISize& scaled_size,
+    const SkIRect& subset) {
+  FML_DCHECK(info.dimensions() == subset.size());
+  FML_DCHECK(SkIRect::MakeSize(scaled_size).contains(subset));
+
+  // Subsets of rotated or flipped images are decoded through the full image
+  // so that the orientation is applied.
+  if (codec_->getOrigin() == kTopLeft_SkEncodedOrigin) {
+    SkCodec::Options options;
+
+    // Some codecs, like WebP, decode a subset of the unscaled image directly.
+    if (scaled_size == codec_->dimensions()) {
+      options.fSubset = &subset;
+      if (codec_->getPixels(info, pixels, row_bytes, &options) ==
+          SkCodec::kSuccess) {
+        return true;
+      }
+    }
+
+    // Scanline decoders, like JPEG, decode a span of columns and skip the
+    // rows above the subset without converting their pixels.
+    const SkIRect columns = SkIRect::MakeLTRB(subset.left(), 0, subset.right(),
+                                              scaled_size.height());
+    options.fSubset = &columns;
+    if (codec_->startScanlineDecode(info.makeDimensions(scaled_size),
+                                    &options) == SkCodec::kSuccess &&
+        codec_->skipScanlines(subset.top()) &&
+        codec_->getScanlines(pixels, subset.height(), row_bytes) ==
+            subset.height()) {
+      return true;
+    }
+  }
+
+  return ImageGenerator::GetPixelsInSubset(info, pixels, row_bytes,
+                                           scaled_size, subset);
+}
+
 std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
     sk_sp<SkData> data) {
   auto codec = SkCodec::MakeFromData(std::move(data));
@@ -135,6 +135,38 @@ class ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) = 0;
 
+  /// @brief      Decode a subset of the first frame of the image, at one of the
+  ///             sizes returned by `GetScaledDimensions`, into a given buffer.
+  ///             The default implementation decodes the whole image at that
+  ///             size and copies the subset out of it. Decoders that can skip
+  ///             the parts of the image outside of the subset should override
+  ///             this method.
+  ///
+  /// @param[in]  info         The desired size and color info of the decoded
+  ///                          subset. Its dimensions must match those of
+  ///                          `subset`.
+  /// @param[in]  pixels       The location where the raw decoded image data
+  ///                          should be written.
+  /// @param[in]  row_bytes    The total number of bytes that should make up a
+  ///                          single row of decoded image data.
+  /// @param[in]  scaled_size  The size of the whole image to decode the subset
+  ///                          at, as returned by `GetScaledDimensions`.
+  /// @param[in]  subset       The part of the image to decode, in the
+  ///                          coordinates of the image at `scaled_size`.
+  ///
+  /// @return     True if the subset was successfully decoded.
+  ///
+  /// @note       Like `GetPixels`, this method performs potentially long
+  ///             synchronous work and should never be executed on the UI
+  ///             thread.
+  ///
+  /// @see        `GetScaledDimensions`, `GetPixels`
+  virtual bool GetPixelsInSubset(const SkImageInfo& info,
+                                 void* pixels,
+                                 size_t row_bytes,
+                                 const SkISize& scaled_size,
+                                 const SkIRect& subset);
+
   /// @brief   Creates an `SkImage` based on the current `ImageInfo` of this
   ///          `ImageGenerator`.
   /// @return  A new `SkImage` containing the decoded image data.
@@ -212,6 +244,13 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) override;
 
+  // |ImageGenerator|
+  bool GetPixelsInSubset(const SkImageInfo& info,
+                         void* pixels,
+                         size_t row_bytes,
+                         const SkISize& scaled_size,
+                         const SkIRect& subset) override;
+
   static std::unique_ptr<ImageGenerator> MakeFromData(sk_sp<SkData> data);
 
  private:
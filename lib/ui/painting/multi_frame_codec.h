@@ -6,6 +6,7 @@
 #define FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_CODEC_H_
 
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
@@ -15,7 +16,24 @@ namespace flutter {
 
 class MultiFrameCodec : public Codec {
  public:
-  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a codec for the frames of an animated image.
+  ///
+  /// @param[in]  generator              The generator of the animated image.
+  /// @param[in]  lookahead_frame_count  The number of frames to decode ahead
+  ///                                    of the one that was last requested,
+  ///                                    on the concurrent task runner. If 0,
+  ///                                    each frame is decoded on the IO task
+  ///                                    runner when it is requested.
+  ///
+  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                           int lookahead_frame_count = 0);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a codec that returns the frames of the decoder, such
+  ///             as one made by `ImageDescriptor::CreateFrameDecoder`.
+  ///
+  explicit MultiFrameCodec(std::shared_ptr<AnimatedFrameDecoder> frame_decoder);
 
   ~MultiFrameCodec() override;
 
@@ -39,27 +57,20 @@ class MultiFrameCodec : public Codec {
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
   struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+    explicit State(std::shared_ptr<AnimatedFrameDecoder> frame_decoder);
 
-    const std::shared_ptr<ImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
     bool is_impeller_enabled_ = false;
 
-    // The non-const members and functions below here are only read or written
-    // to on the IO thread. They are not safe to access or write on the UI
-    // thread.
-    int nextFrameIndex_ = 0;
-    // The last decoded frame that's required to decode any subsequent frames.
-    std::optional<SkBitmap> lastRequiredFrame_;
-    // The index of the last decoded required frame.
-    int lastRequiredFrameIndex_ = -1;
+    // Composes the frames, possibly ahead of time on a worker. Frames are only
+    // requested from the IO thread.
+    const std::shared_ptr<AnimatedFrameDecoder> frame_decoder_;
 
-    // The rectangle that should be cleared if the previous frame's disposal
-    // method was kRestoreBGColor.
-    std::optional<SkIRect> restoreBGColorRect_;
-
-    std::pair<sk_sp<DlImage>, std::string> GetNextFrameImage(
+    // Uploads the frame. The pixels of the frame may be reused for a later
+    // frame once this returns.
+    std::pair<sk_sp<DlImage>, std::string> UploadFrameImage(
+        const SkBitmap& bitmap,
         fml::WeakPtr<GrDirectContext> resourceContext,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         const std::shared_ptr<impeller::Context>& impeller_context,
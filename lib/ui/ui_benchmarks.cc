@@ -4,14 +4,34 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/sync_switch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/encode/SkJpegEncoder.h"
 
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <future>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace flutter {
 
@@ -112,9 +132,351 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// Encodes a JPEG of smooth gradients with some detail, so that the encoded
+// size is realistic.
+static sk_sp<SkData> EncodeJpeg(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height, /*isOpaque=*/true);
+  for (int y = 0; y < bitmap.height(); y++) {
+    uint32_t* row = bitmap.getAddr32(0, y);
+    for (int x = 0; x < bitmap.width(); x++) {
+      const int detail = ((x * 7) ^ (y * 13)) & 0x1f;
+      row[x] = SkColorSetARGB(0xff, ((x >> 5) + detail) & 0xff,
+                              ((y >> 5) + detail) & 0xff,
+                              (((x + y) >> 6) + detail) & 0xff);
+    }
+  }
+  SkJpegEncoder::Options options;
+  options.fQuality = 90;
+  return SkJpegEncoder::Encode(bitmap.pixmap(), options);
+}
+
+// A photo sized JPEG of roughly 50 megapixels. It is encoded once and shared
+// by all the large image decoding benchmarks.
+static sk_sp<SkData> LargeJpeg() {
+  static const sk_sp<SkData> jpeg = EncodeJpeg(8192, 6144);
+  return jpeg;
+}
+
+// Reports the peak resident memory of the benchmark. This is only available on
+// Linux, where the peak can be reset before the benchmark runs so that it does
+// not include the memory used to create the benchmark input.
+static void ResetPeakResidentMemory() {
+#if defined(FML_OS_LINUX)
+  // Writing 5 resets the peak resident set size of the process.
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif  // defined(FML_OS_LINUX)
+}
+
+static void ReportPeakResidentMemory(benchmark::State& state) {
+#if defined(FML_OS_LINUX)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      state.counters["PeakRSS"] = benchmark::Counter(
+          std::stod(line.substr(6)) * 1024, benchmark::Counter::kDefaults,
+          benchmark::Counter::kIs1024);
+      return;
+    }
+  }
+#endif  // defined(FML_OS_LINUX)
+}
+
+enum class LargeImageDecode {
+  // Decode the whole image at its full size.
+  kFull,
+  // Decode the whole image at the size of the first pass of a progressive
+  // decode, which is the time until the first pixels can be shown.
+  kFirstPass,
+  // Decode a 1024x1024 region from the middle of the image at its full size.
+  kRegion,
+};
+
+static void BM_DecodeLargeJpeg(benchmark::State& state,
+                               LargeImageDecode decode) {
+  auto generator = BuiltinSkiaCodecImageGenerator::MakeFromData(LargeJpeg());
+  FML_CHECK(generator);
+  const SkImageInfo& info = generator->GetInfo();
+
+  SkISize scaled_size = info.dimensions();
+  SkIRect subset = SkIRect::MakeSize(scaled_size);
+  switch (decode) {
+    case LargeImageDecode::kFull:
+      break;
+    case LargeImageDecode::kFirstPass:
+      scaled_size =
+          generator->GetScaledDimensions(ImageDecoder::kFirstPassScale);
+      subset = SkIRect::MakeSize(scaled_size);
+      break;
+    case LargeImageDecode::kRegion:
+      subset = SkIRect::MakeXYWH((scaled_size.width() - 1024) / 2,
+                                 (scaled_size.height() - 1024) / 2, 1024, 1024);
+      break;
+  }
+
+  ResetPeakResidentMemory();
+  for (auto _ : state) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(info.makeDimensions(subset.size()));
+    const bool decoded =
+        subset == SkIRect::MakeSize(scaled_size)
+            ? generator->GetPixels(bitmap.info(), bitmap.getPixels(),
+                                   bitmap.rowBytes())
+            : generator->GetPixelsInSubset(bitmap.info(), bitmap.getPixels(),
+                                           bitmap.rowBytes(), scaled_size,
+                                           subset);
+    FML_CHECK(decoded);
+    benchmark::DoNotOptimize(bitmap.getPixels());
+  }
+  ReportPeakResidentMemory(state);
+  state.counters["DecodedPixels"] = subset.width() * subset.height();
+}
+
+// An IO manager without a GPU context, so that decoded images stay in memory.
+class BenchmarkIOManager final : public IOManager {
+ public:
+  explicit BenchmarkIOManager(const fml::RefPtr<fml::TaskRunner>& task_runner)
+      : unref_queue_(fml::MakeRefCounted<SkiaUnrefQueue>(
+            task_runner,
+            fml::TimeDelta::FromNanoseconds(0))),
+        is_gpu_disabled_sync_switch_(std::make_shared<fml::SyncSwitch>()),
+        weak_factory_(this) {
+    weak_prototype_ = weak_factory_.GetWeakPtr();
+  }
+
+  // |IOManager|
+  fml::WeakPtr<IOManager> GetWeakIOManager() const override {
+    return weak_prototype_;
+  }
+
+  // |IOManager|
+  fml::WeakPtr<GrDirectContext> GetResourceContext() const override {
+    return {};
+  }
+
+  // |IOManager|
+  fml::RefPtr<flutter::SkiaUnrefQueue> GetSkiaUnrefQueue() const override {
+    return unref_queue_;
+  }
+
+  // |IOManager|
+  std::shared_ptr<const fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() override {
+    return is_gpu_disabled_sync_switch_;
+  }
+
+ private:
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
+  fml::WeakPtr<BenchmarkIOManager> weak_prototype_;
+  fml::WeakPtrFactory<BenchmarkIOManager> weak_factory_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BenchmarkIOManager);
+};
+
+// The JPEGs of a gallery screen of mixed sizes.
+static const std::vector<sk_sp<SkData>>& GalleryJpegs() {
+  static const std::vector<sk_sp<SkData>> jpegs = []() {
+    std::vector<sk_sp<SkData>> jpegs;
+    constexpr int kJpegCount = 60;
+    for (int i = 0; i < kJpegCount; i++) {
+      const int width = 512 + (i % 6) * 256;
+      jpegs.push_back(EncodeJpeg(width, width * 3 / 4));
+    }
+    return jpegs;
+  }();
+  return jpegs;
+}
+
+// Decodes the thumbnails of a gallery screen, either one by one or as a
+// batch, and measures the time until all of them are back on the UI thread.
+static void BM_DecodeGalleryThumbnails(benchmark::State& state, bool batch) {
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "test", ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
+                  ThreadHost::Type::kIo | ThreadHost::Type::kUi));
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto loop = fml::ConcurrentMessageLoop::Create();
+
+  auto run_sync = [](const fml::RefPtr<fml::TaskRunner>& task_runner,
+                     const fml::closure& task) {
+    fml::AutoResetWaitableEvent latch;
+    task_runner->PostTask([&]() {
+      task();
+      latch.Signal();
+    });
+    latch.Wait();
+  };
+
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+  std::vector<fml::RefPtr<ImageDescriptor>> descriptors;
+  run_sync(task_runners.GetIOTaskRunner(), [&]() {
+    io_manager =
+        std::make_unique<BenchmarkIOManager>(task_runners.GetIOTaskRunner());
+  });
+  run_sync(task_runners.GetUITaskRunner(), [&]() {
+    image_decoder = ImageDecoder::Make(
+        Settings{}, task_runners, loop->GetTaskRunner(),
+        io_manager->GetWeakIOManager(), std::make_shared<fml::SyncSwitch>());
+    for (const auto& jpeg : GalleryJpegs()) {
+      descriptors.push_back(fml::MakeRefCounted<ImageDescriptor>(
+          jpeg, BuiltinSkiaCodecImageGenerator::MakeFromData(jpeg)));
+    }
+  });
+
+  constexpr uint32_t kThumbnailWidth = 256;
+  constexpr uint32_t kThumbnailHeight = 192;
+  for (auto _ : state) {
+    fml::AutoResetWaitableEvent latch;
+    task_runners.GetUITaskRunner()->PostTask([&]() {
+      if (batch) {
+        std::vector<ImageDecoder::BatchDecodeRequest> requests;
+        for (const auto& descriptor : descriptors) {
+          requests.push_back({.descriptor = descriptor,
+                              .target_width = kThumbnailWidth,
+                              .target_height = kThumbnailHeight});
+        }
+        image_decoder->DecodeBatch(
+            std::move(requests),
+            [&](std::vector<ImageDecoder::BatchDecodeResult> results) {
+              FML_CHECK(results.size() == descriptors.size());
+              latch.Signal();
+            });
+      } else {
+        auto pending_count = std::make_shared<size_t>(descriptors.size());
+        for (const auto& descriptor : descriptors) {
+          image_decoder->Decode(
+              descriptor, kThumbnailWidth, kThumbnailHeight,
+              [&latch, pending_count](const sk_sp<DlImage>& image,
+                                      const std::string& decode_error) {
+                FML_CHECK(image);
+                if (--*pending_count == 0) {
+                  latch.Signal();
+                }
+              });
+        }
+      }
+    });
+    latch.Wait();
+  }
+
+  run_sync(task_runners.GetUITaskRunner(), [&]() {
+    descriptors.clear();
+    image_decoder.reset();
+  });
+  run_sync(task_runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+// Delivers the frames of an animated image at a steady frame rate, the way the
+// IO thread requests them while the animation plays, and measures how long
+// each request waits for its frame. The spread of these waits is the jitter
+// that a decode on the critical path adds to the animation.
+static void BM_AnimatedFrameDelivery(benchmark::State& state,
+                                     const char* fixture,
+                                     int lookahead_frame_count) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  auto data = testing::OpenFixtureAsSkData(fixture);
+  FML_CHECK(data);
+  auto decoder = std::make_shared<AnimatedFrameDecoder>(
+      ImageGeneratorRegistry().CreateCompatibleGenerator(data),
+      loop->GetTaskRunner(), lookahead_frame_count);
+  FML_CHECK(decoder->frame_count() > 1);
+
+  constexpr auto kFrameInterval = std::chrono::milliseconds(8);
+  std::vector<double> waits;
+  for (auto _ : state) {
+    std::this_thread::sleep_for(kFrameInterval);
+    const auto start = std::chrono::steady_clock::now();
+    AnimatedFrameDecoder::Frame frame = decoder->GetNextFrame();
+    FML_CHECK(!frame.bitmap.drawsNothing());
+    decoder->RecycleFrame(std::move(frame.bitmap));
+    const std::chrono::duration<double> wait =
+        std::chrono::steady_clock::now() - start;
+    state.SetIterationTime(wait.count());
+    waits.push_back(wait.count() * 1e6);
+  }
+
+  double mean = 0;
+  double max = 0;
+  for (double wait : waits) {
+    mean += wait;
+    max = std::max(max, wait);
+  }
+  mean /= waits.size();
+  double variance = 0;
+  for (double wait : waits) {
+    variance += (wait - mean) * (wait - mean);
+  }
+  variance /= waits.size();
+  state.counters["MeanWaitUs"] = mean;
+  state.counters["MaxWaitUs"] = max;
+  state.counters["JitterUs"] = std::sqrt(variance);
+  state.counters["FrameCount"] = decoder->frame_count();
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK_CAPTURE(BM_DecodeLargeJpeg, Full, LargeImageDecode::kFull)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeLargeJpeg, FirstPass, LargeImageDecode::kFirstPass)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeLargeJpeg, Region, LargeImageDecode::kRegion)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_DecodeGalleryThumbnails, Individual, /*batch=*/false)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeGalleryThumbnails, Batch, /*batch=*/true)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  RestorePreviousOnDemand,
+                  "2_dispose_op_restore_previous.apng",
+                  /*lookahead_frame_count=*/0)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  RestorePreviousLookahead,
+                  "2_dispose_op_restore_previous.apng",
+                  AnimatedFrameDecoder::kMaxLookaheadFrameCount)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  AlphaOnDemand,
+                  "alpha_animated.apng",
+                  /*lookahead_frame_count=*/0)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  AlphaLookahead,
+                  "alpha_animated.apng",
+                  AnimatedFrameDecoder::kMaxLookaheadFrameCount)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  BackgroundOnDemand,
+                  "dispose_op_background.apng",
+                  /*lookahead_frame_count=*/0)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDelivery,
+                  BackgroundLookahead,
+                  "dispose_op_background.apng",
+                  AnimatedFrameDecoder::kMaxLookaheadFrameCount)
+    ->Iterations(120)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
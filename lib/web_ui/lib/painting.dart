@@ -823,6 +823,34 @@ class ImageDescriptor {
     return descriptor;
   }
 
+  // The web has no batched decoder, so the images are decoded one by one and
+  // `priorities` only needs to be validated.
+  static Future<List<Image>> decodeBatch(
+    List<ImageDescriptor> descriptors, {
+    int? targetWidth,
+    int? targetHeight,
+    List<int>? priorities,
+  }) async {
+    if (priorities != null && priorities.length != descriptors.length) {
+      throw ArgumentError.value(priorities, 'priorities', 'must have one priority per descriptor');
+    }
+    final List<Image> images = <Image>[];
+    try {
+      for (final ImageDescriptor descriptor in descriptors) {
+        images.add(await descriptor.decodeProgressively(
+          targetWidth: targetWidth,
+          targetHeight: targetHeight,
+        ));
+      }
+    } catch (_) {
+      for (final Image image in images) {
+        image.dispose();
+      }
+      rethrow;
+    }
+    return images;
+  }
+
   Uint8List? _data;
   final int? _width;
   final int? _height;
@@ -853,6 +881,26 @@ class ImageDescriptor {
 
     return createBmp(_data!, width, height, _rowBytes ?? width, _format!);
   }
+
+  Future<Image> decodeRegion(Rect region, {int? targetWidth, int? targetHeight}) =>
+      _throw('decodeRegion');
+
+  // There is no cheaper first pass on the web, so `onFirstPass` is not called.
+  Future<Image> decodeProgressively({
+    int? targetWidth,
+    int? targetHeight,
+    void Function(Image image)? onFirstPass,
+  }) async {
+    final Codec codec = await instantiateCodec(
+      targetWidth: targetWidth,
+      targetHeight: targetHeight,
+    );
+    try {
+      return (await codec.getNextFrame()).image;
+    } finally {
+      codec.dispose();
+    }
+  }
 }
 
 abstract class FragmentProgram {
@@ -12,6 +12,7 @@
 #include "flutter/common/constants.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/flow/layers/offscreen_surface.h"
+#include "flutter/fml/parallel_for.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/base64.h"
@@ -604,14 +605,30 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
   frame_timings_recorder.RecordRasterStart(fml::TimePoint::Now());
 
   // Second traverse: draw all layer trees.
+  std::vector<DrawSurfaceStatus> statuses;
+  if (CanDrawToSurfacesConcurrently(tasks)) {
+    statuses = DrawToSurfacesConcurrentlyUnsafe(frame_timings_recorder, tasks,
+                                                presentation_time);
+  } else {
+    statuses.reserve(tasks.size());
+    for (const std::unique_ptr<LayerTreeTask>& task : tasks) {
+      const fml::TimePoint view_raster_start = fml::TimePoint::Now();
+      statuses.push_back(DrawToSurfaceUnsafe(task->view_id, *task->layer_tree,
+                                             task->device_pixel_ratio,
+                                             presentation_time));
+      frame_timings_recorder.RecordViewRaster(task->view_id, view_raster_start,
+                                              fml::TimePoint::Now());
+    }
+  }
+
   std::vector<std::unique_ptr<LayerTreeTask>> resubmitted_tasks;
-  for (std::unique_ptr<LayerTreeTask>& task : tasks) {
+  for (size_t i = 0; i < tasks.size(); i++) {
+    std::unique_ptr<LayerTreeTask>& task = tasks[i];
     int64_t view_id = task->view_id;
     std::unique_ptr<LayerTree> layer_tree = std::move(task->layer_tree);
     float device_pixel_ratio = task->device_pixel_ratio;
 
-    DrawSurfaceStatus status = DrawToSurfaceUnsafe(
-        view_id, *layer_tree, device_pixel_ratio, presentation_time);
+    DrawSurfaceStatus status = statuses[i];
     FML_DCHECK(status != DrawSurfaceStatus::kDiscarded);
 
     auto& view_record = EnsureViewRecord(task->view_id);
@@ -624,6 +641,15 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
           view_id, std::move(layer_tree), device_pixel_ratio));
     }
   }
+#if IMPELLER_SUPPORTS_RENDERING
+  // The views and backing stores of a frame all write their transient data
+  // into the same host buffer, which must only move on to the device buffers
+  // of the next frame once all of them have been rendered.
+  if (auto aiks_context = surface_->GetAiksContext()) {
+    aiks_context->GetContentContext().GetTransientsBuffer()->Reset();
+  }
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
   // TODO(dkwingsmt): Pass in raster cache(s) for all views.
   // See https://github.com/flutter/flutter/issues/135530, item 4.
   frame_timings_recorder.RecordRasterEnd(&compositor_context_->raster_cache());
@@ -764,6 +790,101 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
   return DrawSurfaceStatus::kFailed;
 }
 
+bool Rasterizer::CanDrawToSurfacesConcurrently(
+    const std::vector<std::unique_ptr<LayerTreeTask>>& tasks) const {
+  if (tasks.size() < 2 ||
+      !delegate_.GetSettings().enable_concurrent_view_rasterization) {
+    return false;
+  }
+  // The external view embedder prepares and submits one view at a time, and
+  // Impeller records its frames for the GPU.
+  if (external_view_embedder_ || surface_->GetAiksContext() ||
+      !surface_->SupportsConcurrentViewRasterization()) {
+    return false;
+  }
+  // Leaf layer tracing records snapshots into a store shared by all views.
+  for (const std::unique_ptr<LayerTreeTask>& task : tasks) {
+    if (task->layer_tree->is_leaf_layer_tracing_enabled()) {
+      return false;
+    }
+  }
+  return delegate_.GetConcurrentWorkerTaskRunner() != nullptr;
+}
+
+std::vector<DrawSurfaceStatus> Rasterizer::DrawToSurfacesConcurrentlyUnsafe(
+    FrameTimingsRecorder& frame_timings_recorder,
+    const std::vector<std::unique_ptr<LayerTreeTask>>& tasks,
+    std::optional<fml::TimePoint> presentation_time) {
+  TRACE_EVENT0("flutter", "Rasterizer::DrawToSurfacesConcurrently");
+  FML_DCHECK(surface_);
+
+  const SkMatrix root_surface_transformation =
+      surface_->GetRootTransformation();
+  // The snapshot of each view, or null if it could not be drawn.
+  std::vector<sk_sp<SkImage>> images(tasks.size());
+  fml::ParallelFor(
+      delegate_.GetConcurrentWorkerTaskRunner(), tasks.size(),
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          TRACE_EVENT0("flutter", "Rasterizer::DrawViewConcurrently");
+          const fml::TimePoint view_raster_start = fml::TimePoint::Now();
+          LayerTree& layer_tree = *tasks[i]->layer_tree;
+          sk_sp<SkSurface> surface = SkSurfaces::Raster(
+              SkImageInfo::MakeN32Premul(layer_tree.frame_size()));
+          if (!surface) {
+            continue;
+          }
+          DlSkCanvasAdapter canvas(surface->getCanvas());
+          // Instrumentation is off because the raster stopwatch is shared.
+          auto compositor_frame = compositor_context_->AcquireFrame(
+              nullptr,                      // skia GrContext
+              &canvas,                      // root surface canvas
+              nullptr,                      // external view embedder
+              root_surface_transformation,  // root surface transformation
+              false,                        // instrumentation enabled
+              true,                         // surface supports pixel reads
+              nullptr,                      // thread merger
+              nullptr                       // aiks context
+          );
+          RasterStatus status =
+              compositor_frame->Raster(layer_tree,  // layer tree
+                                       true,        // ignore raster cache
+                                       nullptr      // frame damage
+              );
+          if (status == RasterStatus::kSuccess) {
+            images[i] = surface->makeImageSnapshot();
+          }
+          frame_timings_recorder.RecordViewRaster(
+              tasks[i]->view_id, view_raster_start, fml::TimePoint::Now());
+        }
+      });
+
+  std::vector<DrawSurfaceStatus> statuses;
+  statuses.reserve(tasks.size());
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (!images[i]) {
+      statuses.push_back(DrawSurfaceStatus::kFailed);
+      continue;
+    }
+    auto frame = surface_->AcquireFrame(tasks[i]->layer_tree->frame_size());
+    if (frame == nullptr || frame->Canvas() == nullptr) {
+      statuses.push_back(DrawSurfaceStatus::kFailed);
+      continue;
+    }
+    DlPaint paint;
+    paint.setBlendMode(DlBlendMode::kSrc);
+    frame->Canvas()->DrawImage(DlImage::Make(images[i]), SkPoint::Make(0, 0),
+                               DlImageSampling::kNearestNeighbor, &paint);
+
+    SurfaceFrame::SubmitInfo submit_info;
+    submit_info.presentation_time = presentation_time;
+    frame->set_submit_info(submit_info);
+    frame->Submit();
+    statuses.push_back(DrawSurfaceStatus::kSuccess);
+  }
+  return statuses;
+}
+
 Rasterizer::ViewRecord& Rasterizer::EnsureViewRecord(int64_t view_id) {
   return view_records_[view_id];
 }
@@ -18,6 +18,7 @@
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -171,6 +172,13 @@ class Rasterizer final : public SnapshotDelegate,
 
     virtual bool ShouldDiscardLayerTree(int64_t view_id,
                                         const flutter::LayerTree& tree) = 0;
+
+    /// The task runner of the workers that the layer trees of several views
+    /// can be drawn on concurrently, or null to draw them one by one.
+    virtual const std::shared_ptr<fml::ConcurrentTaskRunner>
+    GetConcurrentWorkerTaskRunner() const {
+      return nullptr;
+    }
   };
 
   //----------------------------------------------------------------------------
@@ -706,6 +714,29 @@ class Rasterizer final : public SnapshotDelegate,
       float device_pixel_ratio,
       std::optional<fml::TimePoint> presentation_time);
 
+  // Whether the layer trees of the specified views can be drawn on the
+  // concurrent workers by `DrawToSurfacesConcurrentlyUnsafe`.
+  bool CanDrawToSurfacesConcurrently(
+      const std::vector<std::unique_ptr<LayerTreeTask>>& tasks) const;
+
+  // Draws the layer trees to the specified views, assuming we have access to
+  // the GPU. Each layer tree is prerolled and painted into a raster surface of
+  // its own on the concurrent workers. Once all of them are done, the results
+  // are copied into the frames of the views and submitted in order on the
+  // raster thread.
+  //
+  // The raster cache is shared by all views and is not thread safe, so it is
+  // not used. No frame damage is computed either, as the raster surfaces are
+  // new every frame, so the frames of the views are always fully repainted.
+  //
+  // Returns the status of each view in the order of `tasks`. Like
+  // `DrawToSurfaceUnsafe`, this must be called between the RasterStart and
+  // RasterEnd.
+  std::vector<DrawSurfaceStatus> DrawToSurfacesConcurrentlyUnsafe(
+      FrameTimingsRecorder& frame_timings_recorder,
+      const std::vector<std::unique_ptr<LayerTreeTask>>& tasks,
+      std::optional<fml::TimePoint> presentation_time);
+
   ViewRecord& EnsureViewRecord(int64_t view_id);
 
   void FireNextFrameCallbackIfPresent();
@@ -6,10 +6,18 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <thread>
 
+#include "flutter/display_list/dl_builder.h"
 #include "flutter/flow/frame_timings.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/thread_host.h"
@@ -23,7 +31,9 @@
 #include "gmock/gmock.h"
 
 using testing::_;
+using testing::AtLeast;
 using testing::ByMove;
+using testing::Exactly;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
@@ -66,6 +76,10 @@ class MockDelegate : public Rasterizer::Delegate {
               ShouldDiscardLayerTree,
               (int64_t, const flutter::LayerTree&),
               (override));
+  MOCK_METHOD(const std::shared_ptr<fml::ConcurrentTaskRunner>,
+              GetConcurrentWorkerTaskRunner,
+              (),
+              (const, override));
 };
 
 class MockSurface : public Surface {
@@ -83,6 +97,10 @@ class MockSurface : public Surface {
               (override));
   MOCK_METHOD(bool, ClearRenderContext, (), (override));
   MOCK_METHOD(bool, AllowsDrawingWhenGpuDisabled, (), (const, override));
+  MOCK_METHOD(bool,
+              SupportsConcurrentViewRasterization,
+              (),
+              (const, override));
 };
 
 class MockExternalViewEmbedder : public ExternalViewEmbedder {
@@ -732,6 +750,179 @@ TEST(RasterizerTest, drawMultipleViewsWithExternalViewEmbedder) {
   latch.Wait();
 }
 
+// A container layer that calls |on_paint| on the thread that paints it.
+class PaintCallbackLayer : public ContainerLayer {
+ public:
+  explicit PaintCallbackLayer(
+      std::function<void(const PaintContext&)> on_paint)
+      : on_paint_(std::move(on_paint)) {}
+
+  void Paint(PaintContext& context) const override {
+    on_paint_(context);
+    ContainerLayer::Paint(context);
+  }
+
+ private:
+  std::function<void(const PaintContext&)> on_paint_;
+};
+
+struct DrawnViews {
+  // The pixels of the frames in the order they were submitted.
+  std::vector<std::vector<uint32_t>> pixels;
+  // The threads that painted the views.
+  std::set<std::thread::id> paint_threads;
+  // Whether any view was painted with the raster cache.
+  bool used_raster_cache = false;
+  // Whether any frame was submitted with frame damage.
+  bool submitted_frame_damage = false;
+};
+
+// Draws three views whose layer trees fill them with different colors into a
+// surface backed by raster surfaces that supports the raster cache and
+// partial repaint. When drawing concurrently, each view waits for the others
+// to start painting, so the draw only completes if they are painted on three
+// different threads at once.
+static DrawnViews DrawViewsIntoRasterSurfaces(bool concurrently) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::kPlatform |
+                             ThreadHost::Type::kRaster | ThreadHost::Type::kIo |
+                             ThreadHost::Type::kUi);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto worker_loop = fml::ConcurrentMessageLoop::Create(2);
+  NiceMock<MockDelegate> delegate;
+  Settings settings;
+  settings.enable_concurrent_view_rasterization = concurrently;
+  ON_CALL(delegate, GetSettings()).WillByDefault(ReturnRef(settings));
+  ON_CALL(delegate, GetTaskRunners()).WillByDefault(ReturnRef(task_runners));
+  ON_CALL(delegate, GetConcurrentWorkerTaskRunner())
+      .WillByDefault(Return(worker_loop->GetTaskRunner()));
+  EXPECT_CALL(delegate, GetConcurrentWorkerTaskRunner())
+      .Times(concurrently ? AtLeast(1) : Exactly(0));
+  ON_CALL(delegate, ShouldDiscardLayerTree).WillByDefault(Return(false));
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+
+  DrawnViews drawn;
+  auto surface = std::make_unique<NiceMock<MockSurface>>();
+  ON_CALL(*surface, AllowsDrawingWhenGpuDisabled).WillByDefault(Return(true));
+  ON_CALL(*surface, SupportsConcurrentViewRasterization)
+      .WillByDefault(Return(true));
+  ON_CALL(*surface, GetRootTransformation).WillByDefault(Return(SkMatrix()));
+  ON_CALL(*surface, MakeRenderContextCurrent).WillByDefault([] {
+    return std::make_unique<GLContextDefaultResult>(true);
+  });
+  ON_CALL(*surface, AcquireFrame).WillByDefault([&](const SkISize& size) {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_readback = true;
+    framebuffer_info.supports_partial_repaint = true;
+    framebuffer_info.existing_damage = SkIRect::MakeSize(size);
+    return std::make_unique<SurfaceFrame>(
+        /*surface=*/SkSurfaces::Raster(SkImageInfo::MakeN32Premul(size)),
+        framebuffer_info,
+        /*submit_callback=*/
+        [&](const SurfaceFrame& frame, DlCanvas*) {
+          SkPixmap pixmap;
+          EXPECT_TRUE(frame.SkiaSurface()->peekPixels(&pixmap));
+          const uint32_t* begin = pixmap.addr32();
+          drawn.pixels.emplace_back(begin,
+                                    begin + pixmap.width() * pixmap.height());
+          if (frame.submit_info().frame_damage.has_value()) {
+            drawn.submitted_frame_damage = true;
+          }
+          return true;
+        },
+        /*frame_size=*/size);
+  });
+
+  std::mutex paint_threads_mutex;
+  fml::CountDownLatch views_painting(3);
+  auto on_paint = [&](const PaintContext& context) {
+    {
+      std::scoped_lock lock(paint_threads_mutex);
+      drawn.paint_threads.insert(std::this_thread::get_id());
+      if (context.raster_cache) {
+        drawn.used_raster_cache = true;
+      }
+    }
+    views_painting.CountDown();
+    if (concurrently) {
+      views_painting.Wait();
+    }
+  };
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto pipeline = std::make_shared<FramePipeline>(/*depth=*/10);
+    std::vector<std::unique_ptr<LayerTreeTask>> tasks;
+    const DlColor colors[] = {DlColor::kRed(), DlColor::kGreen(),
+                              DlColor::kBlue()};
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      DisplayListBuilder builder;
+      builder.DrawRect(SkRect::MakeXYWH(10 * view_id, 5, 20, 30),
+                       DlPaint(colors[view_id]));
+      builder.DrawCircle(SkPoint::Make(40, 40), 15 + view_id,
+                         DlPaint(DlColor::kYellow()).setAntiAlias(true));
+      auto root_layer = std::make_shared<PaintCallbackLayer>(on_paint);
+      root_layer->Add(std::make_shared<DisplayListLayer>(
+          SkPoint::Make(0, 0), builder.Build(), false, false));
+      LayerTree::Config config;
+      config.root_layer = std::move(root_layer);
+      SkISize frame_size =
+          SkISize::Make(64 + 8 * static_cast<int32_t>(view_id), 64);
+      tasks.push_back(std::make_unique<LayerTreeTask>(
+          view_id, std::make_unique<LayerTree>(config, frame_size), 1.0));
+    }
+    auto layer_tree_item = std::make_unique<FrameItem>(
+        std::move(tasks), CreateFinishedBuildRecorder());
+    PipelineProduceResult result =
+        pipeline->Produce().Complete(std::move(layer_tree_item));
+    EXPECT_TRUE(result.success);
+    rasterizer->Draw(pipeline);
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      EXPECT_EQ(rasterizer->GetLastDrawStatus(view_id),
+                DrawSurfaceStatus::kSuccess);
+    }
+    rasterizer->Teardown();
+    latch.Signal();
+  });
+  latch.Wait();
+  return drawn;
+}
+
+TEST(RasterizerTest, drawMultipleViewsConcurrentlyByDefault) {
+  EXPECT_TRUE(Settings().enable_concurrent_view_rasterization);
+}
+
+TEST(RasterizerTest, drawMultipleViewsConcurrentlyMatchesSerialDraw) {
+  DrawnViews serial_views = DrawViewsIntoRasterSurfaces(/*concurrently=*/false);
+  DrawnViews concurrent_views =
+      DrawViewsIntoRasterSurfaces(/*concurrently=*/true);
+  // The serial draw paints all the views on the raster thread, while the
+  // concurrent one also paints them on both workers.
+  EXPECT_EQ(serial_views.paint_threads.size(), 1u);
+  EXPECT_EQ(concurrent_views.paint_threads.size(), 3u);
+  // Views drawn concurrently skip the raster cache and are fully repainted
+  // without frame damage.
+  EXPECT_TRUE(serial_views.used_raster_cache);
+  EXPECT_TRUE(serial_views.submitted_frame_damage);
+  EXPECT_FALSE(concurrent_views.used_raster_cache);
+  EXPECT_FALSE(concurrent_views.submitted_frame_damage);
+  const auto& serial = serial_views.pixels;
+  const auto& concurrent = concurrent_views.pixels;
+  ASSERT_EQ(serial.size(), 3u);
+  ASSERT_EQ(concurrent.size(), 3u);
+  for (size_t i = 0; i < serial.size(); i++) {
+    EXPECT_EQ(serial[i], concurrent[i]);
+  }
+  // The views are not blank.
+  EXPECT_NE(serial[0], std::vector<uint32_t>(serial[0].size(), 0));
+}
+
 TEST(RasterizerTest,
      drawWithGpuEnabledAndSurfaceAllowsDrawingWhenGpuDisabledDoesAcquireFrame) {
   std::string test_name =
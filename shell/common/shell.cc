@@ -631,6 +631,13 @@ void Shell::NotifyLowMemoryWarning() const {
         TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
                                trace_id);
       });
+  task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_]() {
+    if (engine) {
+      if (auto image_decoder = engine->GetImageDecoderWeakPtr()) {
+        image_decoder->NotifyLowMemoryWarning();
+      }
+    }
+  });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
   // to purge them.
 }
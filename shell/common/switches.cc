@@ -359,6 +359,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
+  settings.enable_concurrent_view_rasterization = !command_line.HasOption(
+      FlagForSwitch(Switch::DisableConcurrentViewRasterization));
+
   settings.verbose_logging =
       command_line.HasOption(FlagForSwitch(Switch::VerboseLogging));
 
@@ -518,6 +521,16 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    std::string decoded_image_cache_max_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::DecodedImageCacheMaxBytes),
+        &decoded_image_cache_max_bytes);
+    settings.decoded_image_cache_max_bytes =
+        std::stoull(decoded_image_cache_max_bytes);
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::MsaaSamples))) {
     std::string msaa_samples;
     command_line.GetOptionValue(FlagForSwitch(Switch::MsaaSamples),
@@ -141,6 +141,12 @@ DEF_SWITCH(SkiaDeterministicRendering,
            "Skips the call to SkGraphics::Init(), thus avoiding swapping out "
            "some Skia function pointers based on available CPU features. This "
            "is used to obtain 100% deterministic behavior in Skia rendering.")
+DEF_SWITCH(DisableConcurrentViewRasterization,
+           "disable-concurrent-view-rasterization",
+           "Draw the views of a frame one after another on the raster thread "
+           "even when the surface supports drawing them concurrently on "
+           "worker threads. Views drawn concurrently do not use the raster "
+           "cache or partial repaint.")
 DEF_SWITCH(FlutterAssetsDir,
            "flutter-assets-dir",
            "Path to the Flutter assets directory.")
@@ -262,6 +268,11 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The max bytes of decoded images that are kept so that decoding the "
+           "same image at the same size again is skipped, or 0 to disable the "
+           "cache. Defaults to 16MB.")
 DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
@@ -104,6 +104,23 @@ TEST(SwitchesTest, EnableEmbedderAPI) {
   }
 }
 
+TEST(SwitchesTest, DisableConcurrentViewRasterization) {
+  {
+    // default
+    fml::CommandLine command_line =
+        fml::CommandLineFromInitializerList({"command"});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_EQ(settings.enable_concurrent_view_rasterization, true);
+  }
+  {
+    // disable
+    fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+        {"command", "--disable-concurrent-view-rasterization"});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_EQ(settings.enable_concurrent_view_rasterization, false);
+  }
+}
+
 TEST(SwitchesTest, NoEnableImpeller) {
   {
     // enable
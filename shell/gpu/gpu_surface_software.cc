@@ -96,4 +96,10 @@ GrDirectContext* GPUSurfaceSoftware::GetContext() {
   return nullptr;
 }
 
+// |Surface|
+bool GPUSurfaceSoftware::SupportsConcurrentViewRasterization() const {
+  // Frames are raster surfaces already.
+  return true;
+}
+
 }  // namespace flutter
@@ -31,6 +31,9 @@ class GPUSurfaceSoftware : public Surface {
   // |Surface|
   GrDirectContext* GetContext() override;
 
+  // |Surface|
+  bool SupportsConcurrentViewRasterization() const override;
+
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
@@ -6,6 +6,7 @@
 
 #include "flutter/fml/make_copyable.h"
 #include "impeller/display_list/dl_dispatcher.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/surface_context_vk.h"
 #include "impeller/renderer/renderer.h"
 #include "impeller/renderer/surface.h"
@@ -24,11 +25,17 @@ GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
     return;
   }
 
+  // Render the glyphs of new atlases and stroke long paths on the workers of
+  // the context.
+  auto& surface_context = impeller::SurfaceContextVK::Cast(*context);
+  auto worker_task_runner =
+      surface_context.GetParent()->GetConcurrentWorkerTaskRunner();
   auto aiks_context = std::make_shared<impeller::AiksContext>(
-      context, impeller::TypographerContextSkia::Make());
+      context, impeller::TypographerContextSkia::Make(worker_task_runner));
   if (!aiks_context->IsValid()) {
     return;
   }
+  aiks_context->GetContentContext().SetWorkerTaskRunner(worker_task_runner);
 
   impeller_context_ = std::move(context);
   impeller_renderer_ = std::move(renderer);
@@ -94,7 +101,8 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
             fml::MakeCopyable(
                 [aiks_context, picture = std::move(picture)](
                     impeller::RenderTarget& render_target) -> bool {
-                  return aiks_context->Render(picture, render_target);
+                  return aiks_context->Render(picture, render_target,
+                                              /*reset_host_buffer=*/false);
                 }));
       });
 
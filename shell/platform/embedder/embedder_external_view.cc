@@ -107,7 +107,7 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target,
     auto dispatcher = impeller::DlDispatcher();
     dispatcher.drawDisplayList(dl_builder.Build(), 1);
     return aiks_context->Render(dispatcher.EndRecordingAsPicture(),
-                                *impeller_target);
+                                *impeller_target, /*reset_host_buffer=*/false);
   }
 #endif  // IMPELLER_SUPPORTS_RENDERING
 
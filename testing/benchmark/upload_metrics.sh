@@ -50,3 +50,5 @@ cd "$SCRIPT_DIR"
   --json $ENGINE_PATH/src/out/host_release/geometry_benchmarks.json "$@"
 "$DART" --disable-dart-dev bin/parse_and_send.dart \
   --json $ENGINE_PATH/src/out/host_release/canvas_benchmarks.json "$@"
+"$DART" --disable-dart-dev bin/parse_and_send.dart \
+  --json $ENGINE_PATH/src/out/host_release/typographer_benchmarks.json "$@"
@@ -70,6 +70,86 @@ void main() {
     expect(codec.frameCount, 1);
   });
 
+  test('image descriptor - decodeRegion', () async {
+    final Uint8List bytes = await readFile('square.png');
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
+    final ImageDescriptor descriptor = await ImageDescriptor.encoded(buffer);
+
+    final Image region = await descriptor.decodeRegion(const Rect.fromLTRB(2, 3, 6, 9));
+    expect(region.width, 4);
+    expect(region.height, 6);
+    region.dispose();
+
+    final Image scaled = await descriptor.decodeRegion(
+      const Rect.fromLTRB(2, 2, 8, 8),
+      targetWidth: 3,
+    );
+    expect(scaled.width, 3);
+    expect(scaled.height, 3);
+    scaled.dispose();
+
+    Object? error;
+    try {
+      await descriptor.decodeRegion(const Rect.fromLTRB(4, 4, 4, 8));
+    } catch (e) {
+      error = e;
+    }
+    expect(error is Exception, true);
+  });
+
+  test('image descriptor - decodeProgressively', () async {
+    final Uint8List bytes = await _getSkiaResource('mandrill_512_q075.jpg').readAsBytes();
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
+    final ImageDescriptor descriptor = await ImageDescriptor.encoded(buffer);
+
+    final List<Image> firstPasses = <Image>[];
+    final Image image = await descriptor.decodeProgressively(onFirstPass: firstPasses.add);
+    expect(image.width, 512);
+    expect(image.height, 512);
+    expect(firstPasses.length, 1);
+    expect(firstPasses.single.width < image.width, true);
+    firstPasses.single.dispose();
+    image.dispose();
+
+    final Image withoutFirstPass = await descriptor.decodeProgressively(targetWidth: 256);
+    expect(withoutFirstPass.width, 256);
+    expect(withoutFirstPass.height, 256);
+    withoutFirstPass.dispose();
+  });
+
+  test('image descriptor - decodeBatch', () async {
+    Future<ImageDescriptor> encoded(Uint8List bytes) async {
+      return ImageDescriptor.encoded(await ImmutableBuffer.fromUint8List(bytes));
+    }
+
+    final ImageDescriptor square = await encoded(await readFile('square.png'));
+    final ImageDescriptor greyscale = await encoded(await readFile('2x2.png'));
+    final ImageDescriptor mandrill =
+        await encoded(await _getSkiaResource('mandrill_512_q075.jpg').readAsBytes());
+
+    final List<Image> images = await ImageDescriptor.decodeBatch(
+      <ImageDescriptor>[square, greyscale, mandrill],
+      targetWidth: 4,
+      priorities: <int>[0, 0, 1],
+    );
+    expect(images.length, 3);
+    expect(images.map((Image image) => image.width).toList(), <int>[4, 4, 4]);
+    expect(images.map((Image image) => image.height).toList(), <int>[4, 4, 4]);
+    for (final Image image in images) {
+      image.dispose();
+    }
+
+    expect((await ImageDescriptor.decodeBatch(<ImageDescriptor>[])).isEmpty, true);
+
+    Object? error;
+    try {
+      await ImageDescriptor.decodeBatch(<ImageDescriptor>[square], priorities: <int>[]);
+    } catch (e) {
+      error = e;
+    }
+    expect(error is ArgumentError, true);
+  });
+
   test('HEIC image', () async {
     final Uint8List bytes = await readFile('grill_chicken.heic');
     final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);